@@ -0,0 +1,332 @@
+#include <benchmark/benchmark.h>
+#include "biomesh/biomesh.h"
+#include "perf_counters.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+// Fixed worker count for the threaded benchmarks, so timings do not depend on the host's core
+// count; --biomesh_threads=N overrides it (the regression check runs them on one thread)
+unsigned benchThreads = 4;
+
+/**
+ * @brief Generate a globular protein-like structure
+ * @param count Number of atoms
+ * @return Unbuilt atoms (coordinates and element only)
+ */
+std::vector<Atom> makeAtoms(std::size_t count) {
+    return SyntheticMoleculeGenerator(SyntheticShape::Globular, count, 42).generate();
+}
+
+/**
+ * @brief Generate built atoms (radius and mass assigned)
+ */
+std::vector<Atom> makeBuiltAtoms(std::size_t count) {
+    return AtomBuilder().buildAtoms(makeAtoms(count));
+}
+
+void atomCountArgs(benchmark::internal::Benchmark* bench) {
+    bench->RangeMultiplier(8)->Range(1 << 10, 1 << 19)->Complexity(benchmark::oN);
+}
+
+// Shape index crossed with atom count, for the spatial-distribution benchmarks
+void shapeArgs(benchmark::internal::Benchmark* bench) {
+    for (int shape = 0; shape < 4; ++shape) {
+        for (std::int64_t count = 1 << 12; count <= (1 << 18); count <<= 3) {
+            bench->Args({shape, count});
+        }
+    }
+    bench->ArgNames({"shape", "atoms"});
+}
+
+void finish(benchmark::State& state, bench::PerfRegion& perf) {
+    perf.finish(state, state.range(0));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+    state.SetComplexityN(state.range(0));
+}
+
+} // namespace
+
+// Library-independent reference kernel: the regression check divides every timing by this
+// one, so the baseline compares across hosts. Sorting mixes arithmetic, branches and memory
+static void BM_Calibration(benchmark::State& state) {
+    std::vector<double> values(static_cast<std::size_t>(state.range(0)));
+    std::uint64_t seed = 42;
+    for (double& value : values) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        value = static_cast<double>(seed >> 11);
+    }
+    std::vector<double> work(values.size());
+    for (auto _ : state) {
+        std::copy(values.begin(), values.end(), work.begin());
+        std::sort(work.begin(), work.end());
+        benchmark::DoNotOptimize(work.data());
+    }
+}
+BENCHMARK(BM_Calibration)->Arg(1 << 16);
+
+static void BM_AtomBuilderBuildAtoms(benchmark::State& state) {
+    AtomBuilder builder;
+    const auto atoms = makeAtoms(static_cast<std::size_t>(state.range(0)));
+    bench::PerfRegion perf;
+    for (auto _ : state) {
+        auto built = builder.buildAtoms(atoms);
+        benchmark::DoNotOptimize(built.data());
+    }
+    finish(state, perf);
+}
+BENCHMARK(BM_AtomBuilderBuildAtoms)->Apply(atomCountArgs);
+
+// Interleaved (N, 3) coordinates plus element IDs, as the Python AtomArray.from_arrays() passes them
+static void BM_AtomBuilderFromArrays(benchmark::State& state) {
+    AtomBuilder builder;
+    const auto atoms = makeAtoms(static_cast<std::size_t>(state.range(0)));
+    const std::vector<std::string> symbols = {"C", "N", "O", "H", "S"};
+    std::vector<double> xyz;
+    std::vector<std::int32_t> ids;
+    for (const auto& atom : atoms) {
+        xyz.insert(xyz.end(), atom.getCoordinates().begin(), atom.getCoordinates().end());
+        ids.push_back(static_cast<std::int32_t>(std::find(symbols.begin(), symbols.end(), atom.getChemicalElement()) -
+                                                symbols.begin()));
+    }
+    const CoordinateView points = CoordinateView::interleaved(xyz.data(), atoms.size());
+    const StridedView<std::int32_t> elementIds(ids.data(), ids.size());
+    bench::PerfRegion perf;
+    for (auto _ : state) {
+        auto built = builder.buildAtoms(points, elementIds, symbols);
+        benchmark::DoNotOptimize(built.data());
+    }
+    finish(state, perf);
+}
+BENCHMARK(BM_AtomBuilderFromArrays)->Apply(atomCountArgs);
+
+static void BM_BoundingBoxCalculateFromAtoms(benchmark::State& state) {
+    const auto atoms = makeBuiltAtoms(static_cast<std::size_t>(state.range(0)));
+    BoundingBox box;
+    bench::PerfRegion perf;
+    for (auto _ : state) {
+        box.calculateFromAtoms(atoms);
+        benchmark::DoNotOptimize(box);
+    }
+    finish(state, perf);
+}
+BENCHMARK(BM_BoundingBoxCalculateFromAtoms)->Apply(atomCountArgs);
+
+static void BM_BoundingBoxAddPoint(benchmark::State& state) {
+    const auto atoms = makeAtoms(static_cast<std::size_t>(state.range(0)));
+    bench::PerfRegion perf;
+    for (auto _ : state) {
+        BoundingBox box;
+        for (const auto& atom : atoms) {
+            box.addPoint(atom.getX(), atom.getY(), atom.getZ());
+        }
+        benchmark::DoNotOptimize(box);
+    }
+    finish(state, perf);
+}
+BENCHMARK(BM_BoundingBoxAddPoint)->Apply(atomCountArgs);
+
+// Point location by repeated subdivision, as a pointer-free octree descent would do
+static void BM_BoundingBoxSubdivide(benchmark::State& state) {
+    const auto atoms = makeAtoms(static_cast<std::size_t>(state.range(0)));
+    BoundingBox root;
+    root.calculateFromAtoms(atoms);
+    bench::PerfRegion perf;
+    for (auto _ : state) {
+        for (const auto& atom : atoms) {
+            BoundingBox cell = root;
+            for (int level = 0; level < 4; ++level) {
+                for (const auto& child : cell.subdivide()) {
+                    if (child.contains(atom.getX(), atom.getY(), atom.getZ())) {
+                        cell = child;
+                        break;
+                    }
+                }
+            }
+            benchmark::DoNotOptimize(cell);
+        }
+    }
+    finish(state, perf);
+}
+BENCHMARK(BM_BoundingBoxSubdivide)->Apply(atomCountArgs);
+
+static void BM_BoundingBoxContains(benchmark::State& state) {
+    const auto atoms = makeBuiltAtoms(static_cast<std::size_t>(state.range(0)));
+    BoundingBox root;
+    root.calculateFromAtoms(atoms);
+    BoundingBox query = root.subdivide()[0];
+    bench::PerfRegion perf;
+    for (auto _ : state) {
+        std::size_t inside = 0;
+        for (const auto& atom : atoms) {
+            inside += query.contains(atom) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(inside);
+    }
+    finish(state, perf);
+}
+BENCHMARK(BM_BoundingBoxContains)->Apply(atomCountArgs);
+
+static void BM_BoundingBoxIntersects(benchmark::State& state) {
+    const auto atoms = makeBuiltAtoms(static_cast<std::size_t>(state.range(0)));
+    std::vector<BoundingBox> spheres;
+    spheres.reserve(atoms.size());
+    BoundingBox root;
+    for (const auto& atom : atoms) {
+        const double r = atom.getAtomicRadius();
+        spheres.emplace_back(atom.getX() - r, atom.getY() - r, atom.getZ() - r,
+                             atom.getX() + r, atom.getY() + r, atom.getZ() + r);
+        root.addPoint(atom.getX(), atom.getY(), atom.getZ());
+    }
+    BoundingBox query = root.subdivide()[7];
+    bench::PerfRegion perf;
+    for (auto _ : state) {
+        std::size_t hits = 0;
+        for (const auto& sphere : spheres) {
+            hits += query.intersects(sphere) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    finish(state, perf);
+}
+BENCHMARK(BM_BoundingBoxIntersects)->Apply(atomCountArgs);
+
+static void BM_LinearOctreeBuild(benchmark::State& state) {
+    const auto atoms = makeBuiltAtoms(static_cast<std::size_t>(state.range(0)));
+    BoundingBox root;
+    root.calculateFromAtoms(atoms);
+    bench::PerfRegion perf;
+    for (auto _ : state) {
+        LinearOctree tree(root);
+        tree.build(atoms);
+        benchmark::DoNotOptimize(tree.getLeaves().data());
+    }
+    finish(state, perf);
+}
+BENCHMARK(BM_LinearOctreeBuild)->Apply(atomCountArgs);
+
+static void BM_HexMeshExtract(benchmark::State& state) {
+    const auto atoms = makeBuiltAtoms(static_cast<std::size_t>(state.range(0)));
+    BoundingBox root;
+    root.calculateFromAtoms(atoms);
+    LinearOctree tree(root);
+    tree.build(atoms);
+    tree.balance();
+    HexMeshExtractor extractor(benchThreads);
+    bench::PerfRegion perf;
+    for (auto _ : state) {
+        HexMesh mesh = extractor.extract(tree);
+        benchmark::DoNotOptimize(mesh.vertices.data());
+    }
+    finish(state, perf);
+    state.counters["leaves"] = static_cast<double>(tree.getLeaves().size());
+}
+BENCHMARK(BM_HexMeshExtract)->Apply(atomCountArgs)->UseRealTime();
+
+// Octree build and meshing on globular, capsid, fibre and water-box distributions
+static void BM_OctreeMeshByShape(benchmark::State& state) {
+    const auto shape = static_cast<SyntheticShape>(state.range(0));
+    SyntheticMoleculeGenerator generator(shape, static_cast<std::size_t>(state.range(1)), 42);
+    const auto atoms = AtomBuilder().buildAtoms(generator.generate());
+    const BoundingBox root = generator.getExtent();
+    HexMeshExtractor extractor(benchThreads);
+    std::size_t hexCount = 0;
+    bench::PerfRegion perf;
+    for (auto _ : state) {
+        LinearOctree tree(root);
+        tree.build(atoms);
+        tree.balance();
+        HexMesh mesh = extractor.extract(tree);
+        hexCount = mesh.getHexCount();
+        benchmark::DoNotOptimize(mesh.hexahedra.data());
+    }
+    perf.finish(state, state.range(1));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(1));
+    state.SetLabel(SyntheticMoleculeGenerator::getShapeName(shape));
+    state.counters["hexes"] = static_cast<double>(hexCount);
+}
+BENCHMARK(BM_OctreeMeshByShape)->Apply(shapeArgs)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Per-residue bounds and centres of mass: copied sub-vectors versus one segmented pass.
+// Residues of 5-15 atoms plus one chain-sized group exercise load balancing
+static std::vector<std::uint32_t> residueOffsets(std::size_t atomCount) {
+    std::vector<std::uint32_t> offsets = {0, static_cast<std::uint32_t>(atomCount / 4)};
+    while (offsets.back() < atomCount) {
+        offsets.push_back(static_cast<std::uint32_t>(std::min(atomCount, offsets.back() + 5 + offsets.size() % 11)));
+    }
+    return offsets;
+}
+
+static void BM_GroupBoundsCopied(benchmark::State& state) {
+    const auto atoms = makeBuiltAtoms(static_cast<std::size_t>(state.range(0)));
+    const auto offsets = residueOffsets(atoms.size());
+    bench::PerfRegion perf;
+    for (auto _ : state) {
+        std::vector<BoundingBox> bounds(offsets.size() - 1);
+        for (std::size_t g = 0; g + 1 < offsets.size(); ++g) {
+            const std::vector<Atom> group(atoms.begin() + offsets[g], atoms.begin() + offsets[g + 1]);
+            bounds[g].calculateFromAtoms(group);
+        }
+        benchmark::DoNotOptimize(bounds.data());
+    }
+    finish(state, perf);
+}
+BENCHMARK(BM_GroupBoundsCopied)->Apply(atomCountArgs);
+
+static void BM_GroupReduce(benchmark::State& state) {
+    const auto columns = AtomColumns::fromAtoms(makeBuiltAtoms(static_cast<std::size_t>(state.range(0))));
+    const auto offsets = residueOffsets(columns.size());
+    const GroupReducer reducer(benchThreads);
+    bench::PerfRegion perf;
+    for (auto _ : state) {
+        GroupReduction result = reducer.reduce(columns, offsets);
+        benchmark::DoNotOptimize(result.bounds.data());
+    }
+    finish(state, perf);
+}
+BENCHMARK(BM_GroupReduce)->Apply(atomCountArgs)->UseRealTime();
+
+int main(int argc, char** argv) {
+    // Strip our own flag before Google Benchmark rejects it as unknown
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--biomesh_perf_counters") == 0) {
+            bench::PerfCounters::setEnabled(true);
+        } else if (std::strncmp(argv[i], "--biomesh_threads=", 18) == 0) {
+            benchThreads = static_cast<unsigned>(std::max(1, std::atoi(argv[i] + 18)));
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+
+    std::string counterStatus = "off";
+    if (bench::PerfCounters::isEnabled()) {
+        if (bench::PerfCounters().isAvailable()) {
+            counterStatus = "on";
+        } else {
+            std::cerr << "biomesh_bench: hardware counters unavailable (perf_event_open failed); "
+                         "reporting wall-clock numbers only" << std::endl;
+            bench::PerfCounters::setEnabled(false);
+            counterStatus = "unavailable";
+        }
+    }
+    benchmark::AddCustomContext("biomesh_perf_counters", counterStatus);
+    benchmark::AddCustomContext("biomesh_threads", std::to_string(benchThreads));
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Run a fixed subset of biomesh_bench and compare it against a stored baseline.
+
+Timings are compared relative to a calibration benchmark (BM_Calibration, a library-
+independent sort) measured in the same run, so the baseline holds on any host: each entry
+records the median real time of one benchmark divided by the calibration median, and the
+relative slowdown of that ratio tolerated before the check fails. Threaded benchmarks run on
+one thread, so the host's core count does not matter either. Runs from a different build
+type, or a different architecture than the one that recorded the baseline, are skipped
+(exit code 77); the absolute times and host in the baseline are informational.
+
+Usage:
+    compare_baseline.py --bench ./biomesh_bench --baseline bench/baseline.json --build-type Release
+    compare_baseline.py ... --update    # re-record the baseline, keeping tolerances
+    compare_baseline.py ... --any-host  # compare even if the architecture differs
+"""
+
+import argparse
+import json
+import os
+import platform
+import subprocess
+import sys
+import tempfile
+
+SKIP = 77
+DEFAULT_TOLERANCE = 0.35
+CALIBRATION = "BM_Calibration/65536"
+
+
+def run_benchmarks(bench, names, repetitions):
+    pattern = "^(" + "|".join(names) + ")$"
+    with tempfile.TemporaryDirectory() as tmp:
+        out_path = os.path.join(tmp, "results.json")
+        subprocess.run(
+            [
+                bench,
+                "--benchmark_filter=" + pattern,
+                "--benchmark_repetitions=%d" % repetitions,
+                "--benchmark_report_aggregates_only=true",
+                "--benchmark_out=" + out_path,
+                "--benchmark_out_format=json",
+                "--biomesh_threads=1",
+            ],
+            check=True,
+            stdout=subprocess.DEVNULL,
+        )
+        with open(out_path) as handle:
+            results = json.load(handle)
+
+    medians = {}
+    for entry in results["benchmarks"]:
+        if entry.get("aggregate_name") == "median":
+            medians[entry["run_name"]] = to_ns(entry["real_time"], entry["time_unit"])
+    return medians
+
+
+def host_fingerprint():
+    cpu = platform.processor() or "unknown"
+    try:
+        with open("/proc/cpuinfo") as handle:
+            for line in handle:
+                if line.startswith("model name"):
+                    cpu = line.split(":", 1)[1].strip()
+                    break
+    except OSError:
+        pass
+    return {"cpu": cpu, "logical_cpus": os.cpu_count() or 0, "machine": platform.machine()}
+
+
+def to_ns(value, unit):
+    return value * {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}[unit]
+
+
+def format_time(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return "%.2f %s" % (ns / scale, unit)
+    return "%.0f ns" % ns
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bench", required=True, help="path to the biomesh_bench executable")
+    parser.add_argument("--baseline", required=True, help="baseline JSON file")
+    parser.add_argument("--build-type", default="", help="CMAKE_BUILD_TYPE of the benchmark binary")
+    parser.add_argument("--repetitions", type=int, default=5, help="repetitions per benchmark (median is used)")
+    parser.add_argument("--update", action="store_true", help="record current results as the new baseline")
+    parser.add_argument("--any-host", action="store_true", help="compare even when the baseline host differs")
+    args = parser.parse_args()
+
+    with open(args.baseline) as handle:
+        baseline = json.load(handle)
+
+    build_type = args.build_type or "(none)"
+    if not args.update and baseline["build_type"] != build_type:
+        print("Skipping: baseline was recorded with build type %s, this build is %s"
+              % (baseline["build_type"], build_type))
+        return SKIP
+    host = host_fingerprint()
+    recorded_machine = baseline.get("host", {}).get("machine")
+    if not args.update and not args.any_host and recorded_machine != host["machine"]:
+        print("Skipping: baseline was recorded on %s, this host is %s; ratios are not comparable across "
+              "architectures" % (recorded_machine, host["machine"]))
+        return SKIP
+
+    entries = baseline["benchmarks"]
+    current = run_benchmarks(args.bench, [CALIBRATION] + [entry["name"] for entry in entries], args.repetitions)
+    if CALIBRATION not in current:
+        print("Calibration benchmark %s not produced by %s" % (CALIBRATION, args.bench))
+        return 1
+    calibration = current[CALIBRATION]
+
+    if args.update:
+        missing = [entry["name"] for entry in entries if entry["name"] not in current]
+        if missing:
+            print("Benchmarks not produced by %s: %s" % (args.bench, ", ".join(missing)))
+            return 1
+        for entry in entries:
+            entry["ratio"] = round(current[entry["name"]] / calibration, 4)
+            entry["real_time_ns"] = round(current[entry["name"]], 1)
+            entry.setdefault("tolerance", DEFAULT_TOLERANCE)
+        baseline["build_type"] = build_type
+        baseline["calibration_ns"] = round(calibration, 1)
+        baseline["host"] = host
+        with open(args.baseline, "w") as handle:
+            json.dump(baseline, handle, indent=2)
+            handle.write("\n")
+        print("Updated %d baseline entries in %s" % (len(entries), args.baseline))
+        return 0
+
+    width = max(len(entry["name"]) for entry in entries)
+    print("Calibration %s: %s (baseline host %s)" % (
+        CALIBRATION, format_time(calibration), format_time(baseline["calibration_ns"])))
+    print("Ratios are times divided by the calibration time\n")
+    print("%-*s  %12s  %12s  %8s  %6s" % (width, "benchmark", "baseline", "current", "change", "limit"))
+    regressions = []
+    for entry in entries:
+        name = entry["name"]
+        if name not in current:
+            regressions.append(name)
+            print("%-*s  %12.3f  %12s  %8s  %6s  MISSING" % (width, name, entry["ratio"], "-", "-", "-"))
+            continue
+        ratio = current[name] / calibration
+        change = ratio / entry["ratio"] - 1.0
+        tolerance = entry.get("tolerance", DEFAULT_TOLERANCE)
+        status = "SLOWER" if change > tolerance else ("faster" if change < -tolerance else "ok")
+        if status == "SLOWER":
+            regressions.append(name)
+        print("%-*s  %12.3f  %12.3f  %+7.1f%%  %5.0f%%  %s" % (
+            width, name, entry["ratio"], ratio, 100.0 * change, 100.0 * tolerance, status))
+
+    if regressions:
+        print("\n%d benchmark(s) regressed beyond tolerance:" % len(regressions))
+        for name in regressions:
+            print("  " + name)
+        return 1
+    print("\nNo regressions beyond tolerance.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,268 @@
+/**
+ * @file layout_bench.cpp
+ * @brief Identical kernels over the current Atom layout and compact AoS/SoA alternatives
+ *
+ * Layouts:
+ *   AtomVector         std::vector<Atom> as used throughout the library today
+ *   PackedAoS<T>       array of {x, y, z, radius, mass, element code} in T precision
+ *   SoA<T>             one array per field in T precision, element codes as bytes
+ *
+ * Kernels: bounds, squared distance to a probe point, octant classification and
+ * radius/mass assignment from the element table. AtomVector assigns properties through
+ * AtomBuilder::assignProperties (string-keyed lookup); the other layouts index a table by
+ * element code. Every benchmark reports ns/atom and bytes/atom (heap footprint of the layout).
+ */
+
+#include <benchmark/benchmark.h>
+#include "biomesh/biomesh.h"
+#include "perf_counters.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+/**
+ * @brief Built globular atoms, generated once per size
+ */
+const std::vector<Atom>& sourceAtoms(std::size_t count) {
+    static std::map<std::size_t, std::vector<Atom>> cache;
+    auto it = cache.find(count);
+    if (it == cache.end()) {
+        SyntheticMoleculeGenerator generator(SyntheticShape::Globular, count, 42);
+        it = cache.emplace(count, AtomBuilder().buildAtoms(generator.generate())).first;
+    }
+    return it->second;
+}
+
+/**
+ * @brief Radius and mass per element code, for the code-indexed layouts
+ */
+struct ElementTable {
+    AtomBuilder builder;   ///< Source of the specs, built once per table
+    std::vector<std::string> symbols;
+    std::vector<double> radius;
+    std::vector<double> mass;
+
+    std::uint8_t code(const std::string& symbol) {
+        auto it = std::find(symbols.begin(), symbols.end(), symbol);
+        if (it != symbols.end()) {
+            return static_cast<std::uint8_t>(it - symbols.begin());
+        }
+        const AtomicSpec spec = builder.getAtomicSpec(symbol);
+        symbols.push_back(symbol);
+        radius.push_back(spec.radius);
+        mass.push_back(spec.mass);
+        return static_cast<std::uint8_t>(symbols.size() - 1);
+    }
+};
+
+class AtomVector {
+public:
+    using Scalar = double;
+
+    AtomVector(const std::vector<Atom>& source, ElementTable&) : atoms_(source) {}
+
+    std::size_t size() const { return atoms_.size(); }
+    Scalar x(std::size_t i) const { return atoms_[i].getX(); }
+    Scalar y(std::size_t i) const { return atoms_[i].getY(); }
+    Scalar z(std::size_t i) const { return atoms_[i].getZ(); }
+    void assignProperties(const ElementTable&) { builder_.assignProperties(atoms_); }
+    const void* data() const { return atoms_.data(); }
+    std::size_t bytes() const { return memoryUsage(atoms_).reservedBytes; }
+
+private:
+    std::vector<Atom> atoms_;
+    AtomBuilder builder_;
+};
+
+template <typename T>
+class PackedAoS {
+public:
+    using Scalar = T;
+
+    PackedAoS(const std::vector<Atom>& source, ElementTable& table) : atoms_(source.size()) {
+        for (std::size_t i = 0; i < source.size(); ++i) {
+            atoms_[i] = Packed{static_cast<T>(source[i].getX()), static_cast<T>(source[i].getY()),
+                               static_cast<T>(source[i].getZ()), T(0), T(0),
+                               table.code(source[i].getChemicalElement())};
+        }
+    }
+
+    std::size_t size() const { return atoms_.size(); }
+    Scalar x(std::size_t i) const { return atoms_[i].x; }
+    Scalar y(std::size_t i) const { return atoms_[i].y; }
+    Scalar z(std::size_t i) const { return atoms_[i].z; }
+    void assignProperties(const ElementTable& table) {
+        for (auto& atom : atoms_) {
+            atom.radius = static_cast<T>(table.radius[atom.element]);
+            atom.mass = static_cast<T>(table.mass[atom.element]);
+        }
+    }
+    const void* data() const { return atoms_.data(); }
+    std::size_t bytes() const { return memoryUsage(atoms_).reservedBytes; }
+
+private:
+    struct Packed {
+        T x, y, z, radius, mass;
+        std::uint8_t element;
+    };
+    std::vector<Packed> atoms_;
+};
+
+template <typename T>
+class SoA {
+public:
+    using Scalar = T;
+
+    SoA(const std::vector<Atom>& source, ElementTable& table)
+        : x_(source.size()), y_(source.size()), z_(source.size()), radius_(source.size()),
+          mass_(source.size()), element_(source.size()) {
+        for (std::size_t i = 0; i < source.size(); ++i) {
+            x_[i] = static_cast<T>(source[i].getX());
+            y_[i] = static_cast<T>(source[i].getY());
+            z_[i] = static_cast<T>(source[i].getZ());
+            element_[i] = table.code(source[i].getChemicalElement());
+        }
+    }
+
+    std::size_t size() const { return x_.size(); }
+    Scalar x(std::size_t i) const { return x_[i]; }
+    Scalar y(std::size_t i) const { return y_[i]; }
+    Scalar z(std::size_t i) const { return z_[i]; }
+    void assignProperties(const ElementTable& table) {
+        for (std::size_t i = 0; i < element_.size(); ++i) {
+            radius_[i] = static_cast<T>(table.radius[element_[i]]);
+            mass_[i] = static_cast<T>(table.mass[element_[i]]);
+        }
+    }
+    const void* data() const { return radius_.data(); }
+    std::size_t bytes() const {
+        return (memoryUsage(x_) + memoryUsage(y_) + memoryUsage(z_) + memoryUsage(radius_) +
+                memoryUsage(mass_) + memoryUsage(element_)).reservedBytes;
+    }
+
+private:
+    std::vector<T> x_, y_, z_, radius_, mass_;
+    std::vector<std::uint8_t> element_;
+};
+
+void layoutArgs(benchmark::internal::Benchmark* bench) {
+    // Cache-resident and memory-bound sizes
+    bench->Arg(1 << 14)->Arg(1 << 20);
+}
+
+/**
+ * @brief Report ns/atom (wall clock over the timed loop), bytes/atom and hardware counters
+ */
+template <typename Layout>
+void report(benchmark::State& state, const Layout& layout, bench::PerfRegion& perf,
+            std::chrono::steady_clock::time_point start) {
+    const double elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    const auto atoms = static_cast<double>(layout.size());
+    perf.finish(state, static_cast<std::int64_t>(layout.size()));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+    state.counters["ns/atom"] = elapsedNs / (static_cast<double>(state.iterations()) * atoms);
+    state.counters["bytes/atom"] = static_cast<double>(layout.bytes()) / atoms;
+}
+
+} // namespace
+
+template <typename Layout>
+static void BM_LayoutBounds(benchmark::State& state) {
+    using T = typename Layout::Scalar;
+    ElementTable table;
+    const Layout layout(sourceAtoms(static_cast<std::size_t>(state.range(0))), table);
+    bench::PerfRegion perf;
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        T lo[3] = {std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), std::numeric_limits<T>::max()};
+        T hi[3] = {std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(),
+                   std::numeric_limits<T>::lowest()};
+        for (std::size_t i = 0; i < layout.size(); ++i) {
+            const T p[3] = {layout.x(i), layout.y(i), layout.z(i)};
+            for (int axis = 0; axis < 3; ++axis) {
+                lo[axis] = p[axis] < lo[axis] ? p[axis] : lo[axis];
+                hi[axis] = p[axis] > hi[axis] ? p[axis] : hi[axis];
+            }
+        }
+        benchmark::DoNotOptimize(lo);
+        benchmark::DoNotOptimize(hi);
+    }
+    report(state, layout, perf, start);
+}
+
+template <typename Layout>
+static void BM_LayoutDistance(benchmark::State& state) {
+    using T = typename Layout::Scalar;
+    ElementTable table;
+    const Layout layout(sourceAtoms(static_cast<std::size_t>(state.range(0))), table);
+    const T probe[3] = {T(1.5), T(-2.0), T(0.5)};
+    const T cutoff2 = T(20.0 * 20.0);
+    bench::PerfRegion perf;
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        std::size_t inside = 0;
+        for (std::size_t i = 0; i < layout.size(); ++i) {
+            const T dx = layout.x(i) - probe[0];
+            const T dy = layout.y(i) - probe[1];
+            const T dz = layout.z(i) - probe[2];
+            inside += dx * dx + dy * dy + dz * dz < cutoff2 ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(inside);
+    }
+    report(state, layout, perf, start);
+}
+
+template <typename Layout>
+static void BM_LayoutOctant(benchmark::State& state) {
+    using T = typename Layout::Scalar;
+    ElementTable table;
+    const Layout layout(sourceAtoms(static_cast<std::size_t>(state.range(0))), table);
+    std::vector<std::uint8_t> octants(layout.size());
+    const T mid[3] = {T(0), T(0), T(0)};  // synthetic structures are centred on the origin
+    bench::PerfRegion perf;
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < layout.size(); ++i) {
+            octants[i] = static_cast<std::uint8_t>((layout.x(i) >= mid[0] ? 4 : 0) |
+                                                   (layout.y(i) >= mid[1] ? 2 : 0) |
+                                                   (layout.z(i) >= mid[2] ? 1 : 0));
+        }
+        benchmark::DoNotOptimize(octants.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, layout, perf, start);
+}
+
+template <typename Layout>
+static void BM_LayoutAssignProperties(benchmark::State& state) {
+    ElementTable table;
+    Layout layout(sourceAtoms(static_cast<std::size_t>(state.range(0))), table);
+    bench::PerfRegion perf;
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        layout.assignProperties(table);
+        benchmark::DoNotOptimize(layout.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, layout, perf, start);
+}
+
+#define BIOMESH_LAYOUT_BENCHMARKS(kernel)                                   \
+    BENCHMARK_TEMPLATE(kernel, AtomVector)->Apply(layoutArgs);              \
+    BENCHMARK_TEMPLATE(kernel, PackedAoS<double>)->Apply(layoutArgs);       \
+    BENCHMARK_TEMPLATE(kernel, PackedAoS<float>)->Apply(layoutArgs);        \
+    BENCHMARK_TEMPLATE(kernel, SoA<double>)->Apply(layoutArgs);             \
+    BENCHMARK_TEMPLATE(kernel, SoA<float>)->Apply(layoutArgs)
+
+BIOMESH_LAYOUT_BENCHMARKS(BM_LayoutBounds);
+BIOMESH_LAYOUT_BENCHMARKS(BM_LayoutDistance);
+BIOMESH_LAYOUT_BENCHMARKS(BM_LayoutOctant);
+BIOMESH_LAYOUT_BENCHMARKS(BM_LayoutAssignProperties);
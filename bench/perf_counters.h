@@ -0,0 +1,197 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace BioMesh {
+namespace bench {
+
+/**
+ * @brief Hardware counters read around a benchmarked region via perf_event_open
+ *
+ * Cycles, instructions, last-level cache misses and branch misses are opened as one
+ * event group so they are scheduled together. Any counter the kernel refuses (no PMU
+ * in a container, perf_event_paranoid, non-Linux host) is simply left out; when none
+ * can be opened isAvailable() returns false and the benchmarks report wall-clock
+ * numbers only.
+ */
+class PerfCounters {
+public:
+    enum Counter { Cycles, Instructions, LlcMisses, BranchMisses, CounterCount };
+
+    /**
+     * @brief Enable or disable counter collection for every benchmark
+     * @param enabled True to open counters in subsequent PerfRegion instances
+     */
+    static void setEnabled(bool enabled) { enabledFlag() = enabled; }
+
+    /**
+     * @brief Check whether counter collection was requested
+     * @return True if enabled
+     */
+    static bool isEnabled() { return enabledFlag(); }
+
+    PerfCounters() {
+        fds_.fill(-1);
+#if defined(__linux__)
+        if (!isEnabled()) {
+            return;
+        }
+        const std::uint64_t configs[CounterCount] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+        };
+        for (int i = 0; i < CounterCount; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = leader() < 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.inherit = 1;  // include threads spawned by the benchmarked code
+            fds_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader(), 0));
+        }
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * @brief Check whether at least one counter is open
+     * @return True if counters will be reported
+     */
+    bool isAvailable() const { return leader() >= 0; }
+
+    /**
+     * @brief Reset and start the counter group
+     */
+    void start() {
+#if defined(__linux__)
+        if (isAvailable()) {
+            ioctl(leader(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    /**
+     * @brief Stop the counter group and read every open counter
+     */
+    void stop() {
+#if defined(__linux__)
+        if (!isAvailable()) {
+            return;
+        }
+        ioctl(leader(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        for (int i = 0; i < CounterCount; ++i) {
+            std::uint64_t value = 0;
+            values_[i] = fds_[i] >= 0 && read(fds_[i], &value, sizeof(value)) == sizeof(value) ? value : 0;
+        }
+#endif
+    }
+
+    /**
+     * @brief Check whether a counter is open
+     * @param counter Counter
+     * @return True if the counter was opened
+     */
+    bool has(Counter counter) const { return fds_[counter] >= 0; }
+
+    /**
+     * @brief Get the value read by the last stop()
+     * @param counter Counter
+     * @return Event count
+     */
+    std::uint64_t get(Counter counter) const { return values_[counter]; }
+
+    /**
+     * @brief Add IPC and per-item counters to a benchmark's output
+     * @param state Benchmark state
+     * @param items Items processed in total (e.g. iterations times atoms)
+     */
+    void report(benchmark::State& state, double items) const {
+        if (!isAvailable() || items <= 0.0) {
+            return;
+        }
+        if (has(Cycles) && has(Instructions) && get(Cycles) > 0) {
+            state.counters["IPC"] = static_cast<double>(get(Instructions)) / static_cast<double>(get(Cycles));
+        }
+        if (has(Cycles)) {
+            state.counters["cycles/atom"] = static_cast<double>(get(Cycles)) / items;
+        }
+        if (has(LlcMisses)) {
+            state.counters["LLC-miss/atom"] = static_cast<double>(get(LlcMisses)) / items;
+        }
+        if (has(BranchMisses)) {
+            state.counters["br-miss/atom"] = static_cast<double>(get(BranchMisses)) / items;
+        }
+    }
+
+private:
+    static bool& enabledFlag() {
+        static bool enabled = false;
+        return enabled;
+    }
+
+    /// First open counter leads the group
+    int leader() const {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                return fd;
+            }
+        }
+        return -1;
+    }
+
+    std::array<int, CounterCount> fds_;             ///< Counter file descriptors, -1 if unavailable
+    std::array<std::uint64_t, CounterCount> values_{};  ///< Values read by stop()
+};
+
+/**
+ * @brief Counts hardware events over the timed loop of one benchmark run
+ *
+ * Construct immediately before the `for (auto _ : state)` loop and call finish() after
+ * it with the number of atoms processed per iteration.
+ */
+class PerfRegion {
+public:
+    PerfRegion() { counters_.start(); }
+
+    /**
+     * @brief Stop counting and report per-atom figures
+     * @param state Benchmark state
+     * @param atomsPerIteration Atoms processed by one iteration
+     */
+    void finish(benchmark::State& state, std::int64_t atomsPerIteration) {
+        counters_.stop();
+        counters_.report(state, static_cast<double>(state.iterations()) * static_cast<double>(atomsPerIteration));
+    }
+
+private:
+    PerfCounters counters_;  ///< Counter group for this run
+};
+
+} // namespace bench
+} // namespace BioMesh
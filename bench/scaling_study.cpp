@@ -0,0 +1,318 @@
+/**
+ * @file scaling_study.cpp
+ * @brief Strong and weak thread-scaling study of the build, octree, balance, extract and write stages
+ *
+ * Every stage runs at 1, 2, 4, ... up to --max-threads workers on synthetic input:
+ *   build    AtomBuilder::buildAtoms over contiguous atom chunks, one thread per chunk
+ *   octree   DistributedOctree::build on forked shared-memory ranks
+ *   balance  DistributedOctree::balance on the same ranks
+ *   extract  HexMeshExtractor::extract with the given thread count
+ *   write    legacy VTK text formatted in per-thread blocks and written to a scratch file
+ *
+ * Strong scaling keeps the atom count fixed (efficiency = T1 / (p * Tp)); weak scaling grows
+ * it with the thread count (efficiency = T1 / Tp). The report lists, per stage, the first
+ * thread count whose efficiency falls below --threshold, and --csv writes every measurement.
+ */
+
+#include "biomesh/biomesh.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+const char* const kStages[] = {"build", "octree", "balance", "extract", "write"};
+
+struct Options {
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t strongAtoms = 200000;
+    std::size_t weakAtomsPerThread = 50000;
+    SyntheticShape shape = SyntheticShape::Globular;
+    int repeats = 3;
+    double threshold = 0.7;
+    std::string csvPath;
+};
+
+struct Measurement {
+    std::string mode;
+    std::string stage;
+    unsigned threads;
+    std::size_t atoms;
+    double seconds;
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename Body>
+void parallelChunks(unsigned threads, std::size_t count, const Body& body) {
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() { body(t, count * t / threads, count * (t + 1) / threads); });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+double timeBuild(const std::vector<Atom>& parsed, unsigned threads) {
+    AtomBuilder builder;
+    std::vector<std::vector<Atom>> parts(threads);
+    auto start = std::chrono::steady_clock::now();
+    parallelChunks(threads, parsed.size(), [&](unsigned t, std::size_t begin, std::size_t end) {
+        std::vector<Atom> chunk(parsed.begin() + static_cast<std::ptrdiff_t>(begin),
+                                parsed.begin() + static_cast<std::ptrdiff_t>(end));
+        parts[t] = builder.buildAtoms(chunk);
+    });
+    return secondsSince(start);
+}
+
+/**
+ * @brief Time DistributedOctree build and balance on forked ranks
+ * @return {build seconds, balance seconds}, the slowest rank of each
+ */
+std::pair<double, double> timeDistributed(const std::vector<Atom>& atoms, const BoundingBox& root, unsigned ranks) {
+    // Worst case every atom of a rank goes to one destination; 64 bytes covers a serialized atom
+    const std::size_t mailbox = (atoms.size() / ranks + 1) * 64 + 4096;
+    auto results = SharedMemoryCommunicator::launch(static_cast<int>(ranks), mailbox, [&](Communicator& comm) {
+        const std::size_t rank = static_cast<std::size_t>(comm.getRank());
+        std::vector<Atom> local(atoms.begin() + static_cast<std::ptrdiff_t>(atoms.size() * rank / ranks),
+                                atoms.begin() + static_cast<std::ptrdiff_t>(atoms.size() * (rank + 1) / ranks));
+        DistributedOctree tree(comm, root);
+        comm.barrier();
+        auto start = std::chrono::steady_clock::now();
+        tree.build(local);
+        comm.barrier();
+        double times[2] = {secondsSince(start), 0.0};
+        start = std::chrono::steady_clock::now();
+        tree.balance();
+        comm.barrier();
+        times[1] = secondsSince(start);
+
+        Communicator::Buffer out(sizeof(times));
+        std::memcpy(out.data(), times, sizeof(times));
+        return out;
+    });
+
+    std::pair<double, double> slowest{0.0, 0.0};
+    for (const auto& buffer : results) {
+        double times[2];
+        std::memcpy(times, buffer.data(), sizeof(times));
+        slowest.first = std::max(slowest.first, times[0]);
+        slowest.second = std::max(slowest.second, times[1]);
+    }
+    return slowest;
+}
+
+double timeWrite(const HexMesh& mesh, unsigned threads) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> vertexBlocks(threads);
+    std::vector<std::string> cellBlocks(threads);
+    parallelChunks(threads, mesh.getVertexCount(), [&](unsigned block, std::size_t vBegin, std::size_t vEnd) {
+        char line[160];
+        for (std::size_t i = vBegin; i < vEnd; ++i) {
+            int n = std::snprintf(line, sizeof(line), "%.6f %.6f %.6f\n",
+                                  mesh.vertices[i][0], mesh.vertices[i][1], mesh.vertices[i][2]);
+            vertexBlocks[block].append(line, static_cast<std::size_t>(n));
+        }
+        const std::size_t cBegin = mesh.getHexCount() * block / threads;
+        const std::size_t cEnd = mesh.getHexCount() * (block + 1) / threads;
+        for (std::size_t i = cBegin; i < cEnd; ++i) {
+            const auto& h = mesh.hexahedra[i];
+            int n = std::snprintf(line, sizeof(line), "8 %u %u %u %u %u %u %u %u\n",
+                                  h[0], h[1], h[2], h[3], h[4], h[5], h[6], h[7]);
+            cellBlocks[block].append(line, static_cast<std::size_t>(n));
+        }
+    });
+
+    std::FILE* file = std::tmpfile();
+    if (!file) {
+        throw std::runtime_error("Cannot create scratch file for the write stage");
+    }
+    std::fprintf(file, "# vtk DataFile Version 3.0\nBioMesh\nASCII\nDATASET UNSTRUCTURED_GRID\nPOINTS %zu double\n",
+                 mesh.getVertexCount());
+    for (const auto& block : vertexBlocks) {
+        std::fwrite(block.data(), 1, block.size(), file);
+    }
+    std::fprintf(file, "CELLS %zu %zu\n", mesh.getHexCount(), 9 * mesh.getHexCount());
+    for (const auto& block : cellBlocks) {
+        std::fwrite(block.data(), 1, block.size(), file);
+    }
+    std::fflush(file);
+    std::fclose(file);
+    return secondsSince(start);
+}
+
+/**
+ * @brief Run every stage once at a thread count
+ * @return Seconds per stage, in kStages order
+ */
+std::vector<double> runStages(const Options& options, std::size_t atomCount, unsigned threads) {
+    SyntheticMoleculeGenerator generator(options.shape, atomCount, 42);
+    const auto parsed = generator.generate();
+    const auto atoms = AtomBuilder().buildAtoms(parsed);
+    const BoundingBox root = generator.getExtent();
+
+    LinearOctree tree(root);
+    tree.build(atoms);
+    tree.balance();
+
+    std::vector<double> best(5, 1e300);
+    for (int repeat = 0; repeat < options.repeats; ++repeat) {
+        best[0] = std::min(best[0], timeBuild(parsed, threads));
+        auto distributed = timeDistributed(atoms, root, threads);
+        best[1] = std::min(best[1], distributed.first);
+        best[2] = std::min(best[2], distributed.second);
+
+        auto start = std::chrono::steady_clock::now();
+        HexMesh mesh = HexMeshExtractor(threads).extract(tree);
+        best[3] = std::min(best[3], secondsSince(start));
+        best[4] = std::min(best[4], timeWrite(mesh, threads));
+    }
+    return best;
+}
+
+std::vector<unsigned> threadCounts(unsigned maxThreads) {
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+void report(const std::string& mode, const std::vector<Measurement>& results, const Options& options) {
+    std::map<std::string, double> baseline;
+    for (const auto& m : results) {
+        if (m.mode == mode && m.threads == 1) {
+            baseline[m.stage] = m.seconds;
+        }
+    }
+
+    std::cout << "\n" << mode << " scaling (" << SyntheticMoleculeGenerator::getShapeName(options.shape) << ")\n";
+    std::cout << std::left << std::setw(9) << "stage" << std::right << std::setw(8) << "threads" << std::setw(11)
+              << "atoms" << std::setw(12) << "seconds" << std::setw(10) << "speedup" << std::setw(12)
+              << "efficiency" << "\n";
+    std::map<std::string, unsigned> saturation;
+    for (const char* stage : kStages) {
+        for (const auto& m : results) {
+            if (m.mode != mode || m.stage != stage) {
+                continue;
+            }
+            const double speedup = baseline[m.stage] / m.seconds;
+            const double efficiency = mode == "strong" ? speedup / m.threads : speedup;
+            if (efficiency < options.threshold && saturation.count(m.stage) == 0) {
+                saturation[m.stage] = m.threads;
+            }
+            std::cout << std::left << std::setw(9) << m.stage << std::right << std::setw(8) << m.threads
+                      << std::setw(11) << m.atoms << std::setw(12) << std::fixed << std::setprecision(4) << m.seconds
+                      << std::setw(10) << std::setprecision(2) << speedup << std::setw(11) << std::setprecision(0)
+                      << efficiency * 100.0 << "%\n";
+        }
+    }
+
+    std::cout << "Saturation (efficiency below " << std::setprecision(0) << options.threshold * 100.0 << "%):\n";
+    for (const char* stage : kStages) {
+        std::cout << "  " << std::left << std::setw(9) << stage;
+        if (saturation.count(stage)) {
+            std::cout << "at " << saturation[stage] << " threads\n";
+        } else {
+            std::cout << "scales to " << options.maxThreads << " threads\n";
+        }
+    }
+    std::cout << std::right;
+}
+
+void writeCsv(const std::string& path, const std::vector<Measurement>& results) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot open CSV file: " + path);
+    }
+    std::map<std::string, double> baseline;
+    for (const auto& m : results) {
+        if (m.threads == 1) {
+            baseline[m.mode + "/" + m.stage] = m.seconds;
+        }
+    }
+    out << "mode,stage,threads,atoms,seconds,speedup,efficiency\n";
+    for (const auto& m : results) {
+        const double speedup = baseline[m.mode + "/" + m.stage] / m.seconds;
+        const double efficiency = m.mode == "strong" ? speedup / m.threads : speedup;
+        out << m.mode << ',' << m.stage << ',' << m.threads << ',' << m.atoms << ',' << m.seconds << ','
+            << speedup << ',' << efficiency << '\n';
+    }
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--max-threads") {
+            options.maxThreads = static_cast<unsigned>(std::max(1, std::stoi(value())));
+        } else if (arg == "--atoms") {
+            options.strongAtoms = std::stoul(value());
+        } else if (arg == "--atoms-per-thread") {
+            options.weakAtomsPerThread = std::stoul(value());
+        } else if (arg == "--shape") {
+            options.shape = SyntheticMoleculeGenerator::parseShape(value());
+        } else if (arg == "--repeats") {
+            options.repeats = std::max(1, std::stoi(value()));
+        } else if (arg == "--threshold") {
+            options.threshold = std::stod(value());
+        } else if (arg == "--csv") {
+            options.csvPath = value();
+        } else {
+            throw std::invalid_argument(
+                "Usage: biomesh_scaling [--max-threads N] [--atoms N] [--atoms-per-thread N] "
+                "[--shape globular|capsid|fibre|water] [--repeats N] [--threshold F] [--csv FILE]");
+        }
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const Options options = parseOptions(argc, argv);
+        std::vector<Measurement> results;
+        for (unsigned threads : threadCounts(options.maxThreads)) {
+            const std::size_t weakAtoms = options.weakAtomsPerThread * threads;
+            auto strong = runStages(options, options.strongAtoms, threads);
+            auto weak = runStages(options, weakAtoms, threads);
+            for (std::size_t s = 0; s < 5; ++s) {
+                results.push_back(Measurement{"strong", kStages[s], threads, options.strongAtoms, strong[s]});
+                results.push_back(Measurement{"weak", kStages[s], threads, weakAtoms, weak[s]});
+            }
+        }
+
+        report("strong", results, options);
+        report("weak", results, options);
+        if (!options.csvPath.empty()) {
+            writeCsv(options.csvPath, results);
+            std::cout << "\nCSV written to " << options.csvPath << "\n";
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "biomesh/biomesh_c.h"
+
+/* Atoms stored as an array of structs, as a C simulation code might keep them */
+typedef struct {
+    double position[3];
+    int32_t element;
+    double charge;
+} Particle;
+
+int main(void) {
+    static const char* const symbols[] = {"C", "N", "O"};
+    Particle particles[] = {
+        {{0.0, 0.0, 0.0}, 0, 0.0},  {{1.5, 0.0, 0.0}, 1, -0.3}, {{0.0, 1.5, 0.0}, 2, -0.5},
+        {{1.5, 1.5, 0.0}, 0, 0.1},  {{0.0, 0.0, 1.5}, 1, 0.2},  {{1.5, 1.5, 1.5}, 2, 0.0},
+    };
+    biomesh_atoms atoms = {0};
+    biomesh_params params;
+    biomesh_mesh* mesh = NULL;
+    size_t vertexCount = 0, hexCount = 0;
+    double* vertices;
+    int32_t* hexahedra;
+
+    printf("=== BioMesh C API Demo (ABI %d) ===\n\n", biomesh_abi_version());
+
+    atoms.count = sizeof(particles) / sizeof(particles[0]);
+    atoms.x = &particles[0].position[0];
+    atoms.y = &particles[0].position[1];
+    atoms.z = &particles[0].position[2];
+    atoms.coordinate_stride = sizeof(Particle);
+    atoms.element_ids = &particles[0].element;
+    atoms.element_id_stride = sizeof(Particle);
+    atoms.element_symbols = symbols;
+    atoms.element_symbol_count = 3;
+
+    biomesh_params_init(&params);
+    params.max_level = 4;
+    params.max_atoms_per_leaf = 1;
+
+    if (biomesh_mesh_create(&atoms, &params, &mesh) != BIOMESH_OK ||
+        biomesh_mesh_get_sizes(mesh, &vertexCount, &hexCount) != BIOMESH_OK) {
+        fprintf(stderr, "Meshing failed: %s\n", biomesh_last_error());
+        biomesh_mesh_free(mesh);
+        return 1;
+    }
+
+    /* Caller-owned buffers, with 1-based vertex IDs as Fortran or most mesh formats expect */
+    vertices = malloc(3 * vertexCount * sizeof(double));
+    hexahedra = malloc(8 * hexCount * sizeof(int32_t));
+    if (biomesh_mesh_copy(mesh, vertices, vertexCount, hexahedra, hexCount, 1, NULL) != BIOMESH_OK) {
+        fprintf(stderr, "Copy failed: %s\n", biomesh_last_error());
+    } else {
+        printf("Mesh: %zu vertices, %zu hexahedra\n", vertexCount, hexCount);
+        printf("First hexahedron corners: %d %d %d %d %d %d %d %d\n", hexahedra[0], hexahedra[1], hexahedra[2],
+               hexahedra[3], hexahedra[4], hexahedra[5], hexahedra[6], hexahedra[7]);
+    }
+
+    free(vertices);
+    free(hexahedra);
+    biomesh_mesh_free(mesh);
+    return 0;
+}
@@ -1,6 +1,11 @@
 #pragma once
 
 #include "Atom.h"
+#include "biomesh/input_view.h"
+#include "biomesh/memory.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 #include <string>
@@ -21,19 +26,131 @@ struct AtomicSpec {
         : elementSymbol(symbol), radius(r), mass(m) {}
 };
 
+/**
+ * @brief Immutable, versioned atomic specification table
+ *
+ * Published by AtomBuilder; a table never changes once it is visible to readers.
+ */
+class AtomicSpecTable {
+public:
+    /**
+     * @brief Constructor
+     * @param specs Specifications keyed by element symbol
+     * @param version Publication number (1 for the default table)
+     */
+    AtomicSpecTable(std::unordered_map<std::string, AtomicSpec> specs, std::uint64_t version)
+        : specs_(std::move(specs)), version_(version) {}
+
+    /**
+     * @brief Look up an element
+     * @param element Chemical element symbol
+     * @return Specification, or nullptr if the element is unknown
+     */
+    const AtomicSpec* find(const std::string& element) const {
+        auto it = specs_.find(element);
+        return it == specs_.end() ? nullptr : &it->second;
+    }
+
+    /**
+     * @brief Get all specifications
+     * @return Specifications keyed by element symbol
+     */
+    const std::unordered_map<std::string, AtomicSpec>& getSpecs() const { return specs_; }
+
+    /**
+     * @brief Get the number of elements
+     * @return Element count
+     */
+    std::size_t size() const { return specs_.size(); }
+
+    /**
+     * @brief Get the publication number
+     * @return Version, increasing with every update of the owning AtomBuilder
+     */
+    std::uint64_t getVersion() const { return version_; }
+
+    /**
+     * @brief Report heap bytes used versus reserved
+     * @return Footprint of the table (approximate for hash nodes)
+     */
+    MemoryUsage memoryUsage() const;
+
+private:
+    std::unordered_map<std::string, AtomicSpec> specs_;  ///< Specifications by element symbol
+    std::uint64_t version_;                              ///< Publication number
+};
+
 /**
  * @brief Builder class for creating fully initialized Atom objects with atomic properties
  * 
  * AtomBuilder takes a vector of parsed Atom objects (with only chemical element and coordinates)
  * and looks up atomic properties from a specification table to create fully initialized atoms.
+ *
+ * The table can be updated while other threads build atoms. Updates are read-copy-update:
+ * a writer copies the current AtomicSpecTable, modifies the copy and publishes it with one
+ * atomic pointer store, so readers never see a partial update. Readers are lock-free: a pin
+ * claims a reader slot, loads the table pointer with acquire and announces it in the slot
+ * (a hazard pointer), retrying only if a writer published in between. Writers serialize on
+ * a mutex and free every superseded table that no slot announces, so a service that reloads
+ * forever keeps only the tables still pinned. Prefer updateAtomicSpecs() over repeated
+ * addAtomicSpec() calls for bulk reloads, since each call copies the table.
  */
 class AtomBuilder {
+    struct ReaderSlot;
+
 public:
+    /**
+     * @brief Read pin on a specification table
+     *
+     * The table stays valid, and unchanged, while the pin is held. Pins are cheap but must
+     * be released before the AtomBuilder that issued them is destroyed.
+     */
+    class SpecTablePin {
+    public:
+        SpecTablePin(SpecTablePin&& other) noexcept : slot_(other.slot_), table_(other.table_) {
+            other.slot_ = nullptr;
+            other.table_ = nullptr;
+        }
+        SpecTablePin(const SpecTablePin&) = delete;
+        SpecTablePin& operator=(const SpecTablePin&) = delete;
+        SpecTablePin& operator=(SpecTablePin&&) = delete;
+        ~SpecTablePin();
+
+        const AtomicSpecTable& operator*() const { return *table_; }
+        const AtomicSpecTable* operator->() const { return table_; }
+        const AtomicSpecTable* get() const { return table_; }
+
+    private:
+        friend class AtomBuilder;
+        SpecTablePin(ReaderSlot* slot, const AtomicSpecTable* table) : slot_(slot), table_(table) {}
+
+        ReaderSlot* slot_;                ///< Slot announcing table_ to writers
+        const AtomicSpecTable* table_;    ///< Pinned table
+    };
+
     /**
      * @brief Constructor that initializes the atomic specification table
      */
     AtomBuilder();
 
+    /**
+     * @brief Destructor; every SpecTablePin must have been released
+     */
+    ~AtomBuilder();
+
+    /**
+     * @brief Copy constructor; the copy starts from the current table of other
+     * @param other Builder to copy
+     */
+    AtomBuilder(const AtomBuilder& other);
+
+    /**
+     * @brief Copy assignment; publishes the current table of other as a new version
+     * @param other Builder to copy
+     * @return Reference to this builder
+     */
+    AtomBuilder& operator=(const AtomBuilder& other);
+
     /**
      * @brief Build fully initialized atoms from parsed atoms
      * @param parsedAtoms Vector of atoms with chemical element and coordinates
@@ -42,14 +159,89 @@ public:
      */
     std::vector<Atom> buildAtoms(const std::vector<Atom>& parsedAtoms) const;
 
+    /**
+     * @brief Build fully initialized atoms from coordinates and element IDs read in place
+     * @param coordinates Strided view of the atom coordinates
+     * @param elementIds Element ID of each atom, indexing symbols after subtracting idBase
+     * @param symbols Chemical element symbols; each is looked up once
+     * @param idBase ID of symbols[0] (1 for Fortran-style IDs)
+     * @return Vector of fully initialized atoms with radius and mass assigned
+     * @throws std::invalid_argument if the views differ in size
+     * @throws std::out_of_range if an element ID has no symbol
+     * @throws std::runtime_error if a used symbol is not found in the specification table
+     */
+    std::vector<Atom> buildAtoms(const CoordinateView& coordinates, const StridedView<std::int32_t>& elementIds,
+                                 const std::vector<std::string>& symbols, std::int32_t idBase = 0) const;
+
+    /**
+     * @brief Build fully initialized atoms from any range of input records
+     * @param first Start of the range
+     * @param last End of the range
+     * @param projection Maps an element of the range to an AtomRecord
+     * @return Vector of fully initialized atoms with radius and mass assigned
+     * @throws std::runtime_error if an element is not found in the specification table
+     * @note Consecutive atoms of the same element share one table lookup
+     */
+    template <typename Iterator, typename Projection>
+    std::vector<Atom> buildAtoms(Iterator first, Iterator last, Projection projection) const {
+        const auto table = getSpecTable();
+        const AtomicSpecTable& specs = *table;
+        std::vector<Atom> atoms;
+        const AtomicSpec* spec = nullptr;
+        for (; first != last; ++first) {
+            const AtomRecord record = projection(*first);
+            if (spec == nullptr || record.element != spec->elementSymbol) {
+                spec = specs.find(std::string(record.element));
+                if (spec == nullptr) {
+                    throw std::runtime_error("Element '" + std::string(record.element) +
+                                             "' not found in atomic specification table");
+                }
+            }
+            atoms.emplace_back(spec->elementSymbol, spec->radius, spec->mass);
+            atoms.back().setCoordinates(record.x, record.y, record.z);
+        }
+        return atoms;
+    }
+
+    /**
+     * @brief Assign radius and mass to atoms in place
+     * @param atoms Atoms whose radius and mass are overwritten from the specification table
+     * @throws std::runtime_error if an element is not found in the specification table;
+     *         atoms before the offending one have already been updated
+     * @note Performs no heap allocation, unlike buildAtoms() which copies every atom
+     */
+    void assignProperties(std::vector<Atom>& atoms) const;
+
     /**
      * @brief Add or update an atomic specification
      * @param element Chemical element symbol
      * @param radius Atomic radius in Angstroms
      * @param mass Atomic mass in Daltons
+     * @note Publishes a new table version; safe to call while other threads build atoms
      */
     void addAtomicSpec(const std::string& element, double radius, double mass);
 
+    /**
+     * @brief Add or update several specifications in one new table version
+     * @param specs Specifications to publish
+     * @param replaceAll Discard every existing element first (full reload)
+     * @note Readers see either the previous table or the complete new one
+     */
+    void updateAtomicSpecs(const std::vector<AtomicSpec>& specs, bool replaceAll = false);
+
+    /**
+     * @brief Pin the current specification table
+     * @return Pin keeping the table valid, and unchanged, for as long as it is held
+     * @note Lock-free; allocates only the first time more readers overlap than ever before
+     */
+    SpecTablePin getSpecTable() const;
+
+    /**
+     * @brief Get the current table version
+     * @return Version of the table new lookups will use
+     */
+    std::uint64_t getVersion() const { return getSpecTable()->getVersion(); }
+
     /**
      * @brief Check if an element exists in the specification table
      * @param element Chemical element symbol
@@ -60,10 +252,22 @@ public:
     /**
      * @brief Get atomic specification for an element
      * @param element Chemical element symbol
-     * @return AtomicSpec for the element
+     * @return Copy of the AtomicSpec for the element, unaffected by later updates
      * @throws std::runtime_error if element not found
      */
-    const AtomicSpec& getAtomicSpec(const std::string& element) const;
+    AtomicSpec getAtomicSpec(const std::string& element) const;
+
+    /**
+     * @brief Get the number of superseded tables kept alive by pins
+     * @return Tables retired but not yet freed
+     */
+    std::size_t getRetiredTableCount() const;
+
+    /**
+     * @brief Report heap bytes used versus reserved
+     * @return Footprint of the current and the still pinned retired tables (approximate for hash nodes)
+     */
+    MemoryUsage memoryUsage() const;
 
 private:
     /**
@@ -71,7 +275,25 @@ private:
      */
     void initializeAtomicSpecs();
 
-    std::unordered_map<std::string, AtomicSpec> atomicSpecs_;  ///< Atomic specification table
+    /**
+     * @brief Publish a table built from the current one; caller holds writeMutex_
+     */
+    void publish(std::unordered_map<std::string, AtomicSpec> specs);
+
+    /**
+     * @brief Free retired tables that no reader slot announces; caller holds writeMutex_
+     */
+    void reclaim();
+
+    /**
+     * @brief Claim a free reader slot, adding one if all are in use
+     */
+    ReaderSlot* acquireSlot() const;
+
+    std::atomic<const AtomicSpecTable*> current_{nullptr};   ///< Owned; published table
+    mutable std::atomic<ReaderSlot*> readers_{nullptr};       ///< Owned; list of reader slots, never shrinks
+    std::vector<const AtomicSpecTable*> retired_;             ///< Owned; superseded tables, guarded by writeMutex_
+    mutable std::mutex writeMutex_;   ///< Serializes writers
 };
 
 } // namespace BioMesh
\ No newline at end of file
@@ -13,6 +13,27 @@
 #include "Atom.h"
 #include "AtomBuilder.h"
 #include "biomesh/bounding_box.h"
+#include "biomesh/input_view.h"
+#include "biomesh/pipeline.h"
+#include "biomesh/shard.h"
+#include "biomesh/morton.h"
+#include "biomesh/linear_octree.h"
+#include "biomesh/communicator.h"
+#include "biomesh/distributed_octree.h"
+#include "biomesh/vertex_table.h"
+#include "biomesh/hex_mesh.h"
+#include "biomesh/task_graph.h"
+#include "biomesh/synthetic.h"
+#include "biomesh/trace.h"
+#include "biomesh/memory.h"
+#include "biomesh/mesh_stats.h"
+#include "biomesh/hash.h"
+#include "biomesh/mesh_cache.h"
+#include "biomesh/mesh_server.h"
+#include "biomesh/metrics.h"
+#include "biomesh/selection.h"
+#include "biomesh/structure.h"
+#include "biomesh/group_reduce.h"
 
 /**
  * @namespace BioMesh
@@ -21,6 +42,7 @@
  * The BioMesh namespace contains classes and utilities for:
  * - Atomic and molecular data representation (Atom, AtomBuilder)
  * - Spatial data structures for mesh generation (BoundingBox)
+ * - Streaming stage pipelines (AtomPipeline)
  * - Molecular modeling and analysis tools
  */
 namespace BioMesh {
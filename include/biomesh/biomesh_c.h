@@ -0,0 +1,144 @@
+#pragma once
+
+/**
+ * @file biomesh_c.h
+ * @brief Stable C interface for embedding BioMesh in C, Fortran and other languages
+ *
+ * Callers describe atoms with strided coordinate pointers and an element-ID array, so
+ * arrays of structs, separate x/y/z arrays and column-major (N, 3) Fortran arrays are all
+ * read in place. Meshing returns an opaque handle; the caller queries the mesh size,
+ * allocates its own buffers and has the mesh copied into them:
+ *
+ * @code
+ * biomesh_mesh* mesh;
+ * size_t vertexCount, hexCount;
+ * if (biomesh_mesh_create(&atoms, &params, &mesh) == BIOMESH_OK &&
+ *     biomesh_mesh_get_sizes(mesh, &vertexCount, &hexCount) == BIOMESH_OK) {
+ *     double* vertices = malloc(3 * vertexCount * sizeof(double));
+ *     int32_t* hexahedra = malloc(8 * hexCount * sizeof(int32_t));
+ *     biomesh_mesh_copy(mesh, vertices, vertexCount, hexahedra, hexCount, 1, NULL);
+ * }
+ * biomesh_mesh_free(mesh);
+ * @endcode
+ *
+ * Functions never throw or abort; failures return a status and biomesh_last_error() gives
+ * a message for the calling thread. All structs are plain data; the ABI version changes
+ * whenever a struct layout or function signature does.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** ABI version implemented by this header; compare with biomesh_abi_version() at run time */
+#define BIOMESH_C_ABI_VERSION 1
+
+/** Result of every fallible call */
+typedef enum biomesh_status {
+    BIOMESH_OK = 0,                       /**< Success */
+    BIOMESH_ERROR_INVALID_ARGUMENT = 1,   /**< Null pointer, bad stride, bad parameter */
+    BIOMESH_ERROR_UNKNOWN_ELEMENT = 2,    /**< Element ID or symbol has no atomic specification */
+    BIOMESH_ERROR_OUT_OF_RANGE = 3,       /**< Atom outside the root box, or IDs overflow int32 */
+    BIOMESH_ERROR_BUFFER_TOO_SMALL = 4,   /**< Output capacity below the queried size */
+    BIOMESH_ERROR_OUT_OF_MEMORY = 5,      /**< Allocation failed */
+    BIOMESH_ERROR_INTERNAL = 6            /**< Any other failure */
+} biomesh_status;
+
+/** Atoms read in place from caller memory */
+typedef struct biomesh_atoms {
+    size_t count;                          /**< Number of atoms */
+    const double* x;                       /**< First x coordinate */
+    const double* y;                       /**< First y coordinate */
+    const double* z;                       /**< First z coordinate */
+    ptrdiff_t coordinate_stride;           /**< Bytes between consecutive atoms' coordinates */
+    const int32_t* element_ids;            /**< First element ID, indexing element_symbols */
+    ptrdiff_t element_id_stride;           /**< Bytes between consecutive element IDs */
+    int32_t element_id_base;               /**< ID of element_symbols[0] (0 for C, 1 for Fortran) */
+    const char* const* element_symbols;    /**< Element symbols, e.g. "C", "N", "Fe" */
+    size_t element_symbol_count;           /**< Number of element symbols */
+} biomesh_atoms;
+
+/** Meshing parameters; initialize with biomesh_params_init() */
+typedef struct biomesh_params {
+    uint32_t max_level;             /**< Maximum octree level */
+    uint32_t max_atoms_per_leaf;    /**< Octree refinement threshold */
+    int32_t balance;                /**< Non-zero to enforce 2:1 balance */
+    int32_t occupied_leaves_only;   /**< Non-zero to mesh only leaves containing atoms */
+    uint32_t threads;               /**< Extraction threads (0 = all hardware threads) */
+    int32_t has_root;               /**< Non-zero to use root; otherwise atom bounds plus 1 Å */
+    double root[6];                 /**< min x, y, z, max x, y, z of the octree root box */
+} biomesh_params;
+
+/** Opaque mesh produced by biomesh_mesh_create() */
+typedef struct biomesh_mesh biomesh_mesh;
+
+/**
+ * @brief Get the ABI version of the linked library
+ * @return BIOMESH_C_ABI_VERSION of the library build
+ */
+int biomesh_abi_version(void);
+
+/**
+ * @brief Get the message of the calling thread's last failure
+ * @return Message valid until the thread's next call; empty after success
+ */
+const char* biomesh_last_error(void);
+
+/**
+ * @brief Fill parameters with the library defaults
+ * @param params Parameters to initialize
+ */
+void biomesh_params_init(biomesh_params* params);
+
+/**
+ * @brief Compute the bounding box of atom centres
+ * @param atoms Atoms (element fields are ignored)
+ * @param bounds Receives min x, y, z, max x, y, z
+ * @return Status
+ */
+biomesh_status biomesh_bounds(const biomesh_atoms* atoms, double bounds[6]);
+
+/**
+ * @brief Build, optionally balance, and mesh an octree over the atoms
+ * @param atoms Atoms
+ * @param params Parameters, or NULL for the defaults
+ * @param mesh Receives the mesh handle (NULL on failure); release with biomesh_mesh_free()
+ * @return Status
+ */
+biomesh_status biomesh_mesh_create(const biomesh_atoms* atoms, const biomesh_params* params, biomesh_mesh** mesh);
+
+/**
+ * @brief Query the buffer sizes a mesh needs
+ * @param mesh Mesh handle
+ * @param vertex_count Receives the number of vertices (3 doubles each)
+ * @param hex_count Receives the number of hexahedra (8 corner IDs and 1 level each)
+ * @return Status
+ */
+biomesh_status biomesh_mesh_get_sizes(const biomesh_mesh* mesh, size_t* vertex_count, size_t* hex_count);
+
+/**
+ * @brief Copy a mesh into caller-owned buffers
+ * @param mesh Mesh handle
+ * @param vertices Receives vertex_count x 3 coordinates, row-major; NULL to skip
+ * @param vertex_capacity Vertices that fit in vertices
+ * @param hexahedra Receives hex_count x 8 corner vertex IDs, row-major; NULL to skip
+ * @param hex_capacity Hexahedra that fit in hexahedra and levels
+ * @param index_base Added to every corner ID (0 for C, 1 for Fortran)
+ * @param levels Receives hex_count octree levels; NULL to skip
+ * @return Status; BIOMESH_ERROR_BUFFER_TOO_SMALL leaves the buffers untouched
+ */
+biomesh_status biomesh_mesh_copy(const biomesh_mesh* mesh, double* vertices, size_t vertex_capacity,
+                                 int32_t* hexahedra, size_t hex_capacity, int32_t index_base, uint8_t* levels);
+
+/**
+ * @brief Release a mesh handle
+ * @param mesh Mesh handle, or NULL
+ */
+void biomesh_mesh_free(biomesh_mesh* mesh);
+
+#ifdef __cplusplus
+}
+#endif
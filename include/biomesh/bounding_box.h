@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Atom.h"
+#include "biomesh/input_view.h"
+#include <cstdint>
 #include <vector>
 #include <limits>
 #include <array>
@@ -82,6 +84,38 @@ public:
      */
     void calculateFromAtoms(const std::vector<Atom>& atoms);
 
+    /**
+     * @brief Calculate bounds from a subset of atoms without copying them
+     * @param atoms All atoms
+     * @param selection Indices of the atoms to include (e.g. AtomBitset::toIndices())
+     * @throws std::out_of_range if an index is past the atoms
+     * @note This method resets the bounding box and calculates new bounds from the subset
+     */
+    void calculateFromAtoms(const std::vector<Atom>& atoms, const std::vector<std::uint32_t>& selection);
+
+    /**
+     * @brief Calculate bounds from points read in place
+     * @param points Strided view of the coordinates
+     * @note This method resets the bounding box and calculates new bounds from the points
+     */
+    void calculateFromPoints(const CoordinateView& points);
+
+    /**
+     * @brief Calculate bounds from any range of objects carrying coordinates
+     * @param first Start of the range
+     * @param last End of the range
+     * @param projection Maps an element to coordinates indexable by [0], [1], [2]
+     * @note This method resets the bounding box and calculates new bounds from the range
+     */
+    template <typename Iterator, typename Projection>
+    void calculateFromRange(Iterator first, Iterator last, Projection projection) {
+        reset();
+        for (; first != last; ++first) {
+            const auto& point = projection(*first);
+            addPoint(point[0], point[1], point[2]);
+        }
+    }
+
     // Getters for bounds
     
     /**
@@ -231,6 +265,17 @@ public:
      */
     std::array<BoundingBox, 8> subdivide() const;
 
+    /**
+     * @brief Classify a point into one of the octants returned by subdivide()
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param z Z coordinate
+     * @return Octant index in [0, 7]; points on a midplane go to the upper half
+     * @note Does not check containment; points outside the box are classified by side of
+     *       the midplanes. Returns 0 if the box is empty
+     */
+    int getOctantIndex(double x, double y, double z) const;
+
 private:
     double minX_;  ///< Minimum X coordinate
     double minY_;  ///< Minimum Y coordinate
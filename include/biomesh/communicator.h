@@ -0,0 +1,144 @@
+#pragma once
+
+#include "biomesh/shared_memory.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#ifdef BIOMESH_HAVE_MPI
+#include <mpi.h>
+#endif
+
+namespace BioMesh {
+
+/**
+ * @brief Message-passing abstraction used by distributed data structures
+ *
+ * Backends only implement rank queries, a personalized all-to-all byte exchange and
+ * a barrier; gathers and reductions are derived from allToAll(). All methods except
+ * the rank queries are collective and must be called by every rank in the same order.
+ */
+class Communicator {
+public:
+    /// Raw message payload
+    using Buffer = std::vector<std::uint8_t>;
+
+    virtual ~Communicator() = default;
+
+    /**
+     * @brief Get the rank of the calling process
+     * @return Rank in [0, getSize())
+     */
+    virtual int getRank() const = 0;
+
+    /**
+     * @brief Get the number of ranks
+     * @return Communicator size
+     */
+    virtual int getSize() const = 0;
+
+    /**
+     * @brief Exchange one buffer with every rank
+     * @param sendBuffers sendBuffers[r] is delivered to rank r (size must equal getSize())
+     * @return received[r] is the buffer rank r sent to the calling rank
+     * @throws std::invalid_argument if sendBuffers has the wrong size
+     */
+    virtual std::vector<Buffer> allToAll(const std::vector<Buffer>& sendBuffers) = 0;
+
+    /**
+     * @brief Block until every rank has reached the barrier
+     */
+    virtual void barrier() = 0;
+
+    /**
+     * @brief Gather one buffer from every rank on every rank
+     * @param buffer Buffer contributed by the calling rank
+     * @return gathered[r] is the buffer contributed by rank r
+     */
+    std::vector<Buffer> allGather(const Buffer& buffer);
+
+    /**
+     * @brief Sum a value over all ranks
+     * @param value Value contributed by the calling rank
+     * @return Global sum, identical on every rank
+     */
+    std::uint64_t allReduceSum(std::uint64_t value);
+};
+
+/**
+ * @brief Multi-process communicator over POSIX shared memory for single-machine runs
+ *
+ * launch() forks one process per rank. Ranks exchange messages through fixed-size
+ * mailboxes in a shared segment, synchronized with a process-shared barrier. This
+ * backend exists so distributed code paths can be exercised on one Linux box
+ * without an MPI installation.
+ */
+class SharedMemoryCommunicator : public Communicator {
+public:
+    /// Per-rank program; the returned buffer is handed back to the launching process
+    using RankBody = std::function<Buffer(Communicator&)>;
+
+    /**
+     * @brief Run a program on a group of forked ranks
+     * @param ranks Number of ranks to start
+     * @param mailboxBytes Capacity of each point-to-point mailbox and of each result buffer
+     * @param body Program executed by every rank
+     * @return Buffers returned by each rank, in rank order
+     * @throws std::invalid_argument if ranks is not positive
+     * @throws std::runtime_error if a process cannot be started or any rank fails; the
+     *         remaining ranks are terminated so a failed rank cannot deadlock the group
+     */
+    static std::vector<Buffer> launch(int ranks, std::size_t mailboxBytes, const RankBody& body);
+
+    int getRank() const override { return rank_; }
+    int getSize() const override { return size_; }
+
+    /**
+     * @copydoc Communicator::allToAll
+     * @throws std::runtime_error on every rank if any message exceeds the mailbox capacity
+     */
+    std::vector<Buffer> allToAll(const std::vector<Buffer>& sendBuffers) override;
+
+    void barrier() override;
+
+private:
+    struct ControlBlock;
+
+    SharedMemoryCommunicator(int rank, int size, std::size_t mailboxBytes, void* base);
+
+    std::uint8_t* mailbox(int source, int destination) const;
+
+    int rank_;                     ///< Rank of this process
+    int size_;                     ///< Number of ranks
+    std::size_t mailboxBytes_;     ///< Payload capacity per mailbox
+    ControlBlock* control_;        ///< Shared barrier and error flag
+    std::uint8_t* mailboxes_;      ///< size_ x size_ mailboxes, each a length word plus payload
+};
+
+#ifdef BIOMESH_HAVE_MPI
+/**
+ * @brief Communicator backed by an MPI communicator
+ * @note MPI must be initialized by the caller before construction
+ */
+class MpiCommunicator : public Communicator {
+public:
+    /**
+     * @brief Constructor
+     * @param comm MPI communicator to wrap (not duplicated or freed)
+     */
+    explicit MpiCommunicator(MPI_Comm comm = MPI_COMM_WORLD);
+
+    int getRank() const override { return rank_; }
+    int getSize() const override { return size_; }
+    std::vector<Buffer> allToAll(const std::vector<Buffer>& sendBuffers) override;
+    void barrier() override;
+
+private:
+    MPI_Comm comm_;   ///< Wrapped MPI communicator
+    int rank_;        ///< Rank of this process
+    int size_;        ///< Number of ranks
+};
+#endif
+
+} // namespace BioMesh
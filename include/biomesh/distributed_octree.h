@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Atom.h"
+#include "biomesh/bounding_box.h"
+#include "biomesh/communicator.h"
+#include "biomesh/linear_octree.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace BioMesh {
+
+/**
+ * @brief Linear octree partitioned across the ranks of a Communicator
+ *
+ * Each rank owns a contiguous Morton key range. build() samples the global key
+ * distribution to choose range splitters that give every rank a similar number of
+ * atoms, redistributes atoms to their owners with one all-to-all exchange and builds
+ * the rank's local LinearOctree over its range. balance() then enforces the 2:1
+ * constraint globally, forwarding refinement requests that cross rank boundaries.
+ *
+ * All methods except the getters are collective.
+ */
+class DistributedOctree {
+public:
+    /**
+     * @brief Constructor
+     * @param communicator Communicator connecting the ranks (must outlive this object)
+     * @param root Root bounding box, identical on every rank (see reduceBounds())
+     * @param maxLevel Maximum refinement level in [1, 21]
+     * @param maxAtomsPerLeaf Refinement threshold
+     * @throws std::invalid_argument for the same reasons as LinearOctree's constructor
+     */
+    DistributedOctree(Communicator& communicator, const BoundingBox& root,
+                      unsigned maxLevel = 10, std::size_t maxAtomsPerLeaf = 8);
+
+    /**
+     * @brief Redistribute atoms by Morton key and build the local subtree
+     * @param localAtoms Atoms initially held by the calling rank (any subset)
+     * @throws std::out_of_range if an atom lies outside the root box
+     */
+    void build(const std::vector<Atom>& localAtoms);
+
+    /**
+     * @brief Enforce 2:1 balance across the whole distributed tree
+     * @return Number of leaves split on all ranks together
+     */
+    std::size_t balance();
+
+    /**
+     * @brief Count the leaves on all ranks
+     * @return Global leaf count
+     */
+    std::uint64_t getGlobalLeafCount();
+
+    /**
+     * @brief Get the local subtree
+     * @return Tree covering [getKeyBegin(), getKeyEnd())
+     */
+    const LinearOctree& getLocalTree() const { return tree_; }
+
+    /**
+     * @brief Get the atoms owned by this rank after redistribution
+     * @return Owned atoms, indexed by the local tree's atom order
+     */
+    const std::vector<Atom>& getLocalAtoms() const { return localAtoms_; }
+
+    /**
+     * @brief Get the key range boundaries of all ranks
+     * @return size + 1 splitters; rank r owns [splitters[r], splitters[r + 1])
+     */
+    const std::vector<std::uint64_t>& getSplitters() const { return splitters_; }
+
+    /**
+     * @brief Report heap bytes used versus reserved
+     * @return Footprint of the local subtree, owned atoms and splitters
+     */
+    MemoryUsage memoryUsage() const;
+
+    /**
+     * @brief Collect refinement statistics of the local subtree
+     * @param statistics Receiver, owned by the caller; nullptr stops collection
+     * @note Counters are per rank; balancing time includes communication
+     */
+    void setStatistics(MeshStatistics* statistics) { tree_.setStatistics(statistics); }
+
+    /**
+     * @brief Get the first key owned by this rank
+     * @return First owned key
+     */
+    std::uint64_t getKeyBegin() const { return tree_.getKeyBegin(); }
+
+    /**
+     * @brief Get one past the last key owned by this rank
+     * @return End of the owned key range
+     */
+    std::uint64_t getKeyEnd() const { return tree_.getKeyEnd(); }
+
+    /**
+     * @brief Compute the bounding box of the atoms held by all ranks
+     * @param communicator Communicator connecting the ranks
+     * @param localAtoms Atoms held by the calling rank
+     * @return Global bounding box, identical on every rank
+     */
+    static BoundingBox reduceBounds(Communicator& communicator, const std::vector<Atom>& localAtoms);
+
+private:
+    int getOwner(std::uint64_t key) const;
+    void chooseSplitters(std::vector<std::uint64_t> localKeys);
+
+    Communicator& communicator_;             ///< Rank group
+    LinearOctree tree_;                      ///< Local subtree over the owned key range
+    std::vector<Atom> localAtoms_;           ///< Atoms owned after redistribution
+    std::vector<std::uint64_t> splitters_;   ///< Key range boundaries of all ranks
+};
+
+} // namespace BioMesh
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Atom.h"
+#include "biomesh/bounding_box.h"
+#include "biomesh/selection.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace BioMesh {
+
+/**
+ * @brief Per-group bounds, masses and centres of mass
+ */
+struct GroupReduction {
+    std::vector<BoundingBox> bounds;                    ///< Bounds of the atom centres (empty box for empty groups)
+    std::vector<double> masses;                         ///< Total atomic mass
+    std::vector<std::array<double, 3>> centersOfMass;   ///< Mass-weighted centre; centroid if the mass is zero,
+                                                        ///< NaN for empty groups
+    std::vector<std::uint32_t> atomCounts;              ///< Atoms per group
+
+    /**
+     * @brief Get the number of groups
+     * @return Group count
+     */
+    std::size_t size() const { return bounds.size(); }
+};
+
+/**
+ * @brief Segmented reductions over contiguous atom groups such as chains or residues
+ *
+ * Groups are given as an offset array (group g owns atoms [offsets[g], offsets[g + 1])),
+ * e.g. StructureHierarchy::getResidueAtomOffsets() or getChainAtomOffsets(). All groups
+ * are reduced in one pass without copying atoms.
+ *
+ * Work is split by atoms, not groups: the atom range is cut into fixed chunks that
+ * threads claim dynamically, so one huge chain among thousands of small residues does
+ * not serialize on a single thread. Groups cut by a chunk boundary are reduced as
+ * partials and merged in chunk order afterwards. Since chunking does not depend on the
+ * thread count, results are bit-identical for any number of threads. The inner loop
+ * keeps independent accumulator lanes so the compiler can vectorize it.
+ */
+class GroupReducer {
+public:
+    /**
+     * @brief Constructor
+     * @param threadCount Number of worker threads (0 uses std::thread::hardware_concurrency())
+     * @param chunkAtoms Atoms per work chunk
+     * @throws std::invalid_argument if chunkAtoms is zero
+     */
+    explicit GroupReducer(unsigned threadCount = 0, std::size_t chunkAtoms = 16384);
+
+    /**
+     * @brief Reduce groups of columnar atoms (the vectorized path)
+     * @param columns Atom columns
+     * @param offsets Non-decreasing group offsets; at least one entry
+     * @return offsets.size() - 1 group results
+     * @throws std::invalid_argument if offsets are empty, decreasing or past the atoms
+     */
+    GroupReduction reduce(const AtomColumns& columns, const std::vector<std::uint32_t>& offsets) const;
+
+    /**
+     * @brief Reduce groups of atoms in place
+     * @param atoms Atoms
+     * @param offsets Non-decreasing group offsets; at least one entry
+     * @return offsets.size() - 1 group results, identical to the columnar overload
+     * @throws std::invalid_argument if offsets are empty, decreasing or past the atoms
+     */
+    GroupReduction reduce(const std::vector<Atom>& atoms, const std::vector<std::uint32_t>& offsets) const;
+
+    /**
+     * @brief Get the number of worker threads
+     * @return Thread count
+     */
+    unsigned getThreadCount() const { return threadCount_; }
+
+    /**
+     * @brief Get the work chunk size
+     * @return Atoms per chunk
+     */
+    std::size_t getChunkAtoms() const { return chunkAtoms_; }
+
+private:
+    unsigned threadCount_;      ///< Worker threads used by reduce()
+    std::size_t chunkAtoms_;    ///< Atoms per work chunk
+};
+
+} // namespace BioMesh
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace BioMesh {
+
+/**
+ * @brief 128-bit hash value
+ */
+struct Hash128 {
+    std::uint64_t low{0};   ///< First 64-bit word (h1 of MurmurHash3_x64_128)
+    std::uint64_t high{0};  ///< Second 64-bit word (h2 of MurmurHash3_x64_128)
+
+    /**
+     * @brief Format as 32 lowercase hex digits, low word first
+     * @return Hex string, suitable as a file name
+     */
+    std::string toHex() const;
+
+    friend bool operator==(const Hash128& a, const Hash128& b) { return a.low == b.low && a.high == b.high; }
+    friend bool operator!=(const Hash128& a, const Hash128& b) { return !(a == b); }
+};
+
+/**
+ * @brief Incremental MurmurHash3_x64_128
+ *
+ * Produces the same value as the reference one-shot MurmurHash3_x64_128 over the
+ * concatenation of all update() calls, however the input is split. Not cryptographic;
+ * intended for content addressing and checksums.
+ */
+class MurmurHash3 {
+public:
+    /**
+     * @brief Constructor
+     * @param seed Hash seed
+     */
+    explicit MurmurHash3(std::uint64_t seed = 0) : h1_(seed), h2_(seed) {}
+
+    /**
+     * @brief Append bytes to the hashed input
+     * @param data Bytes
+     * @param size Number of bytes
+     */
+    void update(const void* data, std::size_t size);
+
+    /**
+     * @brief Append the object representation of a trivially copyable value
+     * @param value Value
+     */
+    template <typename T>
+    void updateValue(const T& value) {
+        update(&value, sizeof(T));
+    }
+
+    /**
+     * @brief Get the hash of everything appended so far
+     * @return Hash value; the hasher may keep receiving input afterwards
+     */
+    Hash128 finish() const;
+
+    /**
+     * @brief One-shot hash of a byte range
+     * @param data Bytes
+     * @param size Number of bytes
+     * @param seed Hash seed
+     * @return Hash value
+     */
+    static Hash128 hash(const void* data, std::size_t size, std::uint64_t seed = 0);
+
+private:
+    void processBlock(const std::uint8_t* block);
+
+    std::uint64_t h1_;             ///< First lane state
+    std::uint64_t h2_;             ///< Second lane state
+    std::uint8_t tail_[16]{};      ///< Bytes not yet forming a full block
+    std::size_t tailSize_{0};      ///< Valid bytes in tail_
+    std::uint64_t length_{0};      ///< Total bytes appended
+};
+
+} // namespace BioMesh
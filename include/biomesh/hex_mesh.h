@@ -0,0 +1,96 @@
+#pragma once
+
+#include "biomesh/linear_octree.h"
+#include "biomesh/memory.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace BioMesh {
+
+class TaskScheduler;
+
+/**
+ * @brief Hexahedral mesh extracted from octree leaves
+ *
+ * Each hexahedron lists its corner vertex IDs in VTK_HEXAHEDRON order:
+ * (0,0,0), (1,0,0), (1,1,0), (0,1,0), (0,0,1), (1,0,1), (1,1,1), (0,1,1).
+ * Vertex IDs follow ascending lattice order, so the numbering is deterministic.
+ */
+struct HexMesh {
+    std::vector<std::array<double, 3>> vertices;          ///< Vertex coordinates
+    std::vector<std::array<std::uint32_t, 8>> hexahedra;  ///< Corner vertex IDs per hexahedron
+    std::vector<std::uint8_t> levels;                     ///< Octree level of each hexahedron
+
+    /**
+     * @brief Get the number of vertices
+     * @return Vertex count
+     */
+    std::size_t getVertexCount() const { return vertices.size(); }
+
+    /**
+     * @brief Get the number of hexahedra
+     * @return Hexahedron count
+     */
+    std::size_t getHexCount() const { return hexahedra.size(); }
+
+    /**
+     * @brief Report heap bytes used versus reserved
+     * @return Footprint of vertices, hexahedra and levels
+     */
+    MemoryUsage memoryUsage() const {
+        return BioMesh::memoryUsage(vertices) + BioMesh::memoryUsage(hexahedra) + BioMesh::memoryUsage(levels);
+    }
+};
+
+/**
+ * @brief Parallel extraction of a hexahedral mesh from a LinearOctree
+ *
+ * Leaves are split into contiguous blocks, one per thread. Threads deduplicate shared
+ * corners through a ConcurrentVertexTable sized from the leaf count, after which the
+ * table is compacted into dense vertex IDs and the corner slots are remapped in
+ * parallel.
+ */
+class HexMeshExtractor {
+public:
+    /**
+     * @brief Constructor
+     * @param threadCount Number of worker threads (0 uses std::thread::hardware_concurrency())
+     */
+    explicit HexMeshExtractor(unsigned threadCount = 0);
+
+    /**
+     * @brief Extract one hexahedron per leaf
+     * @param tree Octree to mesh
+     * @param occupiedLeavesOnly If true, only leaves containing at least one atom are meshed
+     * @return Extracted mesh
+     */
+    HexMesh extract(const LinearOctree& tree, bool occupiedLeavesOnly = false) const;
+
+    /**
+     * @brief Get the number of worker threads
+     * @return Thread count
+     */
+    unsigned getThreadCount() const { return threadCount_; }
+
+    /**
+     * @brief Collect per-phase times and hexahedra per level during extract()
+     * @param statistics Receiver, owned by the caller; nullptr stops collection
+     */
+    void setStatistics(MeshStatistics* statistics) { statistics_ = statistics; }
+
+    /**
+     * @brief Run extract() blocks on a scheduler's persistent workers instead of new threads
+     * @param scheduler Scheduler, owned by the caller; nullptr starts threads per call
+     * @note Intended for use inside a TaskScheduler task granted getThreadCount() slots
+     */
+    void setScheduler(TaskScheduler* scheduler) { scheduler_ = scheduler; }
+
+private:
+    unsigned threadCount_;                  ///< Worker threads used by extract()
+    MeshStatistics* statistics_{nullptr};   ///< Optional statistics receiver
+    TaskScheduler* scheduler_{nullptr};     ///< Optional worker pool for extract()
+};
+
+} // namespace BioMesh
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace BioMesh {
+
+/**
+ * @brief Non-owning view of count values at a fixed byte stride in caller memory
+ *
+ * Reads one field of an array of structs, a column of a column-major array or a
+ * plain array without copying it. The viewed memory must outlive the view.
+ */
+template <typename T>
+class StridedView {
+public:
+    /**
+     * @brief Default constructor creates an empty view
+     */
+    StridedView() = default;
+
+    /**
+     * @brief Constructor
+     * @param first First value
+     * @param count Number of values
+     * @param stride Bytes between consecutive values (sizeof(T) for a plain array)
+     * @throws std::invalid_argument if first is null or stride is zero for a non-empty view
+     */
+    StridedView(const T* first, std::size_t count, std::ptrdiff_t stride = sizeof(T))
+        : first_(reinterpret_cast<const char*>(first)), count_(count), stride_(stride) {
+        if (count > 0 && first == nullptr) {
+            throw std::invalid_argument("Strided view of a null pointer");
+        }
+        if (count > 1 && stride == 0) {
+            throw std::invalid_argument("Strided view needs a non-zero stride");
+        }
+    }
+
+    /**
+     * @brief Get the number of values
+     * @return Value count
+     */
+    std::size_t size() const { return count_; }
+
+    /**
+     * @brief Check if the view has no values
+     * @return true if empty
+     */
+    bool empty() const { return count_ == 0; }
+
+    /**
+     * @brief Get a value
+     * @param index Value index in [0, size())
+     * @return Value at index
+     */
+    const T& operator[](std::size_t index) const {
+        return *reinterpret_cast<const T*>(first_ + stride_ * static_cast<std::ptrdiff_t>(index));
+    }
+
+private:
+    const char* first_ = nullptr;   ///< First value
+    std::size_t count_ = 0;         ///< Number of values
+    std::ptrdiff_t stride_ = 0;     ///< Bytes between values
+};
+
+/**
+ * @brief Non-owning view of count points whose x, y and z share one byte stride
+ *
+ * Covers interleaved xyz arrays, separate x/y/z arrays, column-major (N, 3) arrays and
+ * coordinate fields of arrays of structs, so bounds and atoms can be computed from
+ * mmapped files, NumPy arrays or trajectory frames in place.
+ */
+class CoordinateView {
+public:
+    /**
+     * @brief Default constructor creates an empty view
+     */
+    CoordinateView() = default;
+
+    /**
+     * @brief Constructor
+     * @param x First x coordinate
+     * @param y First y coordinate
+     * @param z First z coordinate
+     * @param count Number of points
+     * @param stride Bytes between consecutive points' coordinates
+     * @throws std::invalid_argument if a pointer is null or stride is zero for a non-empty view
+     */
+    CoordinateView(const double* x, const double* y, const double* z, std::size_t count, std::ptrdiff_t stride)
+        : x_(x, count, stride), y_(y, count, stride), z_(z, count, stride) {}
+
+    /**
+     * @brief View an interleaved x0 y0 z0 x1 y1 z1 ... array
+     * @param xyz First x coordinate
+     * @param count Number of points
+     * @return View of the points
+     */
+    static CoordinateView interleaved(const double* xyz, std::size_t count) {
+        return CoordinateView(xyz, xyz + (count ? 1 : 0), xyz + (count ? 2 : 0), count, 3 * sizeof(double));
+    }
+
+    /**
+     * @brief View separate x, y and z arrays
+     * @param x X coordinates
+     * @param y Y coordinates
+     * @param z Z coordinates
+     * @param count Number of points
+     * @return View of the points
+     */
+    static CoordinateView separate(const double* x, const double* y, const double* z, std::size_t count) {
+        return CoordinateView(x, y, z, count, sizeof(double));
+    }
+
+    /**
+     * @brief View a column-major (count, 3) array, e.g. a Fortran coordinates(N, 3)
+     * @param coordinates All x, then all y, then all z
+     * @param count Number of points
+     * @return View of the points
+     */
+    static CoordinateView columnMajor(const double* coordinates, std::size_t count) {
+        return separate(coordinates, coordinates + count, coordinates + 2 * count, count);
+    }
+
+    /**
+     * @brief Get the number of points
+     * @return Point count
+     */
+    std::size_t size() const { return x_.size(); }
+
+    /**
+     * @brief Check if the view has no points
+     * @return true if empty
+     */
+    bool empty() const { return x_.empty(); }
+
+    double x(std::size_t index) const { return x_[index]; }   ///< X coordinate of a point
+    double y(std::size_t index) const { return y_[index]; }   ///< Y coordinate of a point
+    double z(std::size_t index) const { return z_[index]; }   ///< Z coordinate of a point
+
+    /**
+     * @brief Get a point
+     * @param index Point index in [0, size())
+     * @return Coordinates of the point
+     */
+    std::array<double, 3> operator[](std::size_t index) const { return {x_[index], y_[index], z_[index]}; }
+
+private:
+    StridedView<double> x_;  ///< X coordinates
+    StridedView<double> y_;  ///< Y coordinates
+    StridedView<double> z_;  ///< Z coordinates
+};
+
+/**
+ * @brief Coordinates and element of one input atom, as returned by a projection
+ *
+ * The element only has to stay valid until the projection is called again.
+ */
+struct AtomRecord {
+    double x;                   ///< X coordinate
+    double y;                   ///< Y coordinate
+    double z;                   ///< Z coordinate
+    std::string_view element;   ///< Chemical element symbol
+};
+
+} // namespace BioMesh
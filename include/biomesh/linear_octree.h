@@ -0,0 +1,219 @@
+#pragma once
+
+#include "Atom.h"
+#include "biomesh/bounding_box.h"
+#include "biomesh/memory.h"
+#include "biomesh/morton.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace BioMesh {
+
+class MeshStatistics;
+
+/**
+ * @brief Leaf of a linear octree
+ *
+ * A leaf is identified by its anchor Morton key and level; it covers the keys
+ * [key, key + mortonSpan(level)). Its atoms form a contiguous range of the tree's
+ * key-sorted atom order.
+ */
+struct OctreeLeaf {
+    std::uint64_t key{0};          ///< Anchor (smallest) Morton key of the leaf
+    std::uint32_t firstAtom{0};    ///< Offset of the leaf's first atom in the sorted atom order
+    std::uint32_t atomCount{0};    ///< Number of atoms inside the leaf
+    std::uint8_t level{0};         ///< Octree level (0 = root)
+};
+
+/**
+ * @brief Request that the leaf containing a key be refined to at least a given level
+ *
+ * Produced by 2:1 balancing; in distributed builds requests for keys owned by another
+ * rank are forwarded to that rank.
+ */
+struct SplitRequest {
+    std::uint64_t key{0};       ///< Finest-level key inside the leaf to refine
+    std::uint8_t minLevel{0};   ///< Minimum level the containing leaf must reach
+};
+
+/**
+ * @brief Complete linear octree over a Morton key range
+ *
+ * Leaves are stored in Morton order and tile their key range without gaps, empty
+ * leaves included, so they form a hexahedral decomposition of the covered region.
+ * A node is refined while it holds more than maxAtomsPerLeaf atoms and is above
+ * maxLevel. Restricting the key range lets each rank of a distributed build own a
+ * contiguous slice of the global tree.
+ */
+class LinearOctree {
+public:
+    /// Returned by findLeaf() when no leaf contains the key
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * @brief Constructor
+     * @param root Root bounding box; atoms must lie inside it
+     * @param maxLevel Maximum refinement level in [1, 21]
+     * @param maxAtomsPerLeaf Refinement threshold
+     * @throws std::invalid_argument if root is empty, maxLevel is out of range or maxAtomsPerLeaf is zero
+     */
+    LinearOctree(const BoundingBox& root, unsigned maxLevel = 10, std::size_t maxAtomsPerLeaf = 8);
+
+    /**
+     * @brief Build the complete octree over the whole root box
+     * @param atoms Atoms to insert
+     * @throws std::out_of_range if an atom lies outside the root box
+     */
+    void build(const std::vector<Atom>& atoms);
+
+    /**
+     * @brief Build the part of the octree covering a Morton key range
+     * @param atoms Atoms to insert; all must have keys inside [keyBegin, keyEnd)
+     * @param keyBegin First key of the range (multiple of mortonSpan(maxLevel))
+     * @param keyEnd One past the last key of the range (multiple of mortonSpan(maxLevel))
+     * @throws std::invalid_argument if the range is not aligned to finest-level cells
+     * @throws std::out_of_range if an atom lies outside the root box or the key range
+     */
+    void build(const std::vector<Atom>& atoms, std::uint64_t keyBegin, std::uint64_t keyEnd);
+
+    /**
+     * @brief Build the complete octree over a subset of atoms without copying them
+     * @param atoms All atoms
+     * @param selection Indices of the atoms to insert (e.g. AtomBitset::toIndices())
+     * @note getAtomOrder() then holds indices into atoms, not into selection
+     * @throws std::out_of_range if an index is past the atoms or a selected atom lies outside the root box
+     */
+    void build(const std::vector<Atom>& atoms, const std::vector<std::uint32_t>& selection);
+
+    /**
+     * @brief Replace the tree with previously built contents (e.g. loaded from a cache)
+     * @param keyBegin First key covered
+     * @param keyEnd One past the last key covered
+     * @param leaves Leaves in Morton order
+     * @param atomKeys Atom keys in sorted order
+     * @param atomOrder Input index of each sorted atom
+     * @throws std::invalid_argument if the key range is invalid, atomKeys and atomOrder differ
+     *         in size, or a leaf is deeper than maxLevel or exceeds the atoms
+     */
+    void restore(std::uint64_t keyBegin, std::uint64_t keyEnd, std::vector<OctreeLeaf> leaves,
+                 std::vector<std::uint64_t> atomKeys, std::vector<std::uint32_t> atomOrder);
+
+    /**
+     * @brief Enforce the 2:1 balance constraint between face, edge and vertex neighbours
+     * @return Number of leaves split
+     */
+    std::size_t balance();
+
+    /**
+     * @brief Collect the refinement constraints the current leaves impose on their neighbours
+     * @return Requests for every neighbour position inside the root lattice
+     */
+    std::vector<SplitRequest> collectBalanceRequests() const;
+
+    /**
+     * @brief Split every local leaf whose level is below a request targeting it
+     * @param requests Requests to apply; keys outside this tree's range are ignored
+     * @return Number of leaves split (each split leaf is refined by one level)
+     */
+    std::size_t applySplitRequests(const std::vector<SplitRequest>& requests);
+
+    /**
+     * @brief Find the leaf containing a key
+     * @param key Finest-level Morton key
+     * @return Index into getLeaves(), or npos if the key is outside this tree's range
+     */
+    std::size_t findLeaf(std::uint64_t key) const;
+
+    /**
+     * @brief Get the bounding box of a leaf
+     * @param leaf Leaf of this tree
+     * @return Axis-aligned box covered by the leaf
+     */
+    BoundingBox getLeafBox(const OctreeLeaf& leaf) const { return encoder_.nodeBox(leaf.key, leaf.level); }
+
+    /**
+     * @brief Get the leaves in Morton order
+     * @return Leaves tiling [getKeyBegin(), getKeyEnd())
+     */
+    const std::vector<OctreeLeaf>& getLeaves() const { return leaves_; }
+
+    /**
+     * @brief Get the input indices of the atoms in Morton order
+     * @return Permutation from sorted position to input index
+     */
+    const std::vector<std::uint32_t>& getAtomOrder() const { return atomOrder_; }
+
+    /**
+     * @brief Get the Morton keys of the atoms in sorted order
+     * @return Sorted atom keys
+     */
+    const std::vector<std::uint64_t>& getAtomKeys() const { return atomKeys_; }
+
+    /**
+     * @brief Get the Morton encoder of the root box
+     * @return Encoder mapping coordinates to keys
+     */
+    const MortonEncoder& getEncoder() const { return encoder_; }
+
+    /**
+     * @brief Get the first key covered by this tree
+     * @return First key of the range
+     */
+    std::uint64_t getKeyBegin() const { return keyBegin_; }
+
+    /**
+     * @brief Get one past the last key covered by this tree
+     * @return End of the key range
+     */
+    std::uint64_t getKeyEnd() const { return keyEnd_; }
+
+    /**
+     * @brief Get the maximum refinement level
+     * @return Maximum level
+     */
+    unsigned getMaxLevel() const { return maxLevel_; }
+
+    /**
+     * @brief Get the refinement threshold
+     * @return Maximum atoms per leaf before refinement
+     */
+    std::size_t getMaxAtomsPerLeaf() const { return maxAtomsPerLeaf_; }
+
+    /**
+     * @brief Report heap bytes used versus reserved
+     * @return Footprint of leaves, atom keys and atom order
+     */
+    MemoryUsage memoryUsage() const;
+
+    /**
+     * @brief Collect refinement statistics during build() and balancing
+     * @param statistics Receiver, owned by the caller; nullptr stops collection
+     */
+    void setStatistics(MeshStatistics* statistics) { statistics_ = statistics; }
+
+    /**
+     * @brief Get the attached statistics receiver
+     * @return Receiver, or nullptr if none is attached
+     */
+    MeshStatistics* getStatistics() const { return statistics_; }
+
+private:
+    void build(const std::vector<Atom>& atoms, const std::uint32_t* selection, std::size_t count,
+               std::uint64_t keyBegin, std::uint64_t keyEnd);
+    std::uint64_t buildNode(std::uint64_t anchor, unsigned level, std::size_t first, std::size_t last);
+    void appendChildren(const OctreeLeaf& parent, std::vector<OctreeLeaf>& out) const;
+
+    MortonEncoder encoder_;                 ///< Maps coordinates to Morton keys
+    unsigned maxLevel_;                     ///< Maximum refinement level
+    std::size_t maxAtomsPerLeaf_;           ///< Refinement threshold
+    std::uint64_t keyBegin_{0};             ///< First key covered
+    std::uint64_t keyEnd_{0};               ///< One past the last key covered
+    std::vector<OctreeLeaf> leaves_;        ///< Leaves in Morton order
+    std::vector<std::uint64_t> atomKeys_;   ///< Atom keys in sorted order
+    std::vector<std::uint32_t> atomOrder_;  ///< Input index of each sorted atom
+    MeshStatistics* statistics_{nullptr};   ///< Optional statistics receiver
+};
+
+} // namespace BioMesh
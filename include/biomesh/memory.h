@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace BioMesh {
+
+class Atom;
+
+/**
+ * @brief Heap footprint of a data structure
+ *
+ * usedBytes counts live elements; reservedBytes counts what the structure holds from
+ * the allocator (capacity, buckets, node overhead), so reservedBytes >= usedBytes.
+ * Node-based containers are reported from the standard library's node layout and are
+ * approximate; contiguous containers are exact.
+ */
+struct MemoryUsage {
+    std::size_t usedBytes{0};      ///< Bytes occupied by live data
+    std::size_t reservedBytes{0};  ///< Bytes held from the allocator
+
+    MemoryUsage& operator+=(const MemoryUsage& other) {
+        usedBytes += other.usedBytes;
+        reservedBytes += other.reservedBytes;
+        return *this;
+    }
+
+    friend MemoryUsage operator+(MemoryUsage a, const MemoryUsage& b) { return a += b; }
+};
+
+/**
+ * @brief Footprint of a contiguous vector of trivially laid out elements
+ * @param values Vector
+ * @return size() and capacity() in bytes
+ */
+template <typename T>
+MemoryUsage memoryUsage(const std::vector<T>& values) {
+    return MemoryUsage{values.size() * sizeof(T), values.capacity() * sizeof(T)};
+}
+
+/**
+ * @brief Heap bytes owned by a string beyond its inline (small-string) buffer
+ * @param text String
+ * @return Heap footprint, zero for strings stored inline
+ */
+MemoryUsage memoryUsage(const std::string& text);
+
+/**
+ * @brief Footprint of an atom container, including element strings that spill to the heap
+ * @param atoms Atoms
+ * @return Footprint
+ */
+MemoryUsage memoryUsage(const std::vector<Atom>& atoms);
+
+/**
+ * @brief Predict the peak heap footprint of a build-octree-mesh job before running it
+ * @param atomCount Number of input atoms
+ * @param maxAtomsPerLeaf Octree refinement threshold
+ * @return Upper estimate in bytes: parsed and built atoms, octree keys and leaves after
+ *         balancing, the vertex table and the extracted hexahedral mesh
+ */
+std::size_t estimateJobMemory(std::size_t atomCount, std::size_t maxAtomsPerLeaf = 8);
+
+/**
+ * @brief Polymorphic memory resource that counts bytes and tracks the high-water mark
+ *
+ * Forwards to an upstream resource; counters are atomic so a resource may be shared by
+ * threads. Use with std::pmr containers to measure a job's real allocation profile.
+ */
+class CountingMemoryResource : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Constructor
+     * @param upstream Resource that performs the allocations
+     */
+    explicit CountingMemoryResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream_(upstream) {
+    }
+
+    /**
+     * @brief Get the bytes currently allocated
+     * @return Live bytes
+     */
+    std::size_t getCurrentBytes() const { return current_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the highest value of getCurrentBytes() since construction or resetPeak()
+     * @return Peak bytes
+     */
+    std::size_t getPeakBytes() const { return peak_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of allocations performed
+     * @return Allocation count
+     */
+    std::size_t getAllocationCount() const { return allocations_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Restart peak tracking from the current footprint
+     */
+    void resetPeak() { peak_.store(getCurrentBytes(), std::memory_order_relaxed); }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::pmr::memory_resource* upstream_;        ///< Resource performing the allocations
+    std::atomic<std::size_t> current_{0};        ///< Live bytes
+    std::atomic<std::size_t> peak_{0};           ///< High-water mark of current_
+    std::atomic<std::size_t> allocations_{0};    ///< Allocation count
+};
+
+} // namespace BioMesh
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "Atom.h"
+#include "biomesh/bounding_box.h"
+#include "biomesh/hash.h"
+#include "biomesh/hex_mesh.h"
+#include "biomesh/linear_octree.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace BioMesh {
+
+class TaskScheduler;
+
+/**
+ * @brief Settings that determine the octree and mesh built from a set of atoms
+ */
+struct MeshingParameters {
+    unsigned maxLevel{10};             ///< Maximum octree level
+    std::size_t maxAtomsPerLeaf{8};    ///< Octree refinement threshold
+    bool balance{true};                ///< Enforce 2:1 balance before meshing
+    bool occupiedLeavesOnly{false};    ///< Mesh only leaves that contain atoms
+};
+
+/**
+ * @brief Octree and mesh produced for one cache key
+ */
+struct CachedMesh {
+    LinearOctree tree;  ///< Built (and balanced, if requested) octree
+    HexMesh mesh;       ///< Mesh extracted from tree
+};
+
+/**
+ * @brief Content-addressed on-disk cache of octrees and meshes
+ *
+ * Entries are keyed by a MurmurHash3_x64_128 over the enriched atom columns (coordinates,
+ * radius and mass, in input order), the root box and the meshing parameters, and stored
+ * as one `<key>.bmc` file per entry in the cache directory. Each file carries a checksum;
+ * unreadable or corrupt files are treated as misses and removed.
+ *
+ * The directory is bounded by a byte capacity with least-recently-used eviction. Recency
+ * is kept in the file modification times, so it survives restarts and is shared by
+ * processes using the same directory. All methods are thread-safe.
+ */
+class MeshCache {
+public:
+    /**
+     * @brief Constructor; creates the directory if needed and indexes existing entries
+     * @param directory Cache directory
+     * @param capacityBytes Maximum total size of the cache files
+     * @throws std::invalid_argument if capacityBytes is zero
+     * @throws std::runtime_error if the directory cannot be created
+     */
+    MeshCache(const std::string& directory, std::size_t capacityBytes);
+
+    /**
+     * @brief Compute the cache key of a meshing job
+     * @param atoms Atoms with radius and mass assigned
+     * @param root Octree root box
+     * @param parameters Meshing parameters
+     * @return Content hash
+     */
+    static Hash128 computeKey(const std::vector<Atom>& atoms, const BoundingBox& root,
+                              const MeshingParameters& parameters);
+
+    /**
+     * @brief Look up an entry and mark it most recently used
+     * @param key Cache key
+     * @return Cached octree and mesh, or std::nullopt on a miss
+     */
+    std::optional<CachedMesh> load(const Hash128& key);
+
+    /**
+     * @brief Store an entry, evicting least recently used entries beyond the capacity
+     * @param key Cache key
+     * @param tree Octree to store
+     * @param mesh Mesh to store
+     * @return false if the entry alone exceeds the capacity and was not stored
+     * @throws std::runtime_error if the entry cannot be written
+     */
+    bool store(const Hash128& key, const LinearOctree& tree, const HexMesh& mesh);
+
+    /**
+     * @brief Return the cached result of a job, building and storing it on a miss
+     * @param atoms Atoms with radius and mass assigned
+     * @param root Octree root box
+     * @param parameters Meshing parameters
+     * @param threadCount Extraction threads on a miss (0 uses all hardware threads)
+     * @param scheduler Optional worker pool for extraction (see HexMeshExtractor::setScheduler())
+     * @return Octree and mesh
+     * @throws std::out_of_range if an atom lies outside the root box
+     *
+     * A result that cannot be stored is still returned; the failure is counted in
+     * getStoreFailureCount().
+     */
+    CachedMesh getOrCompute(const std::vector<Atom>& atoms, const BoundingBox& root,
+                            const MeshingParameters& parameters, unsigned threadCount = 0,
+                            TaskScheduler* scheduler = nullptr);
+
+    /**
+     * @brief Remove all entries
+     */
+    void clear();
+
+    /**
+     * @brief Get the cache directory
+     * @return Directory path
+     */
+    const std::string& getDirectory() const { return directory_; }
+
+    /**
+     * @brief Get the capacity
+     * @return Maximum total bytes of the cache files
+     */
+    std::size_t getCapacityBytes() const { return capacityBytes_; }
+
+    /**
+     * @brief Get the total size of the indexed entries
+     * @return Bytes on disk
+     */
+    std::size_t getSizeBytes() const;
+
+    /**
+     * @brief Get the number of indexed entries
+     * @return Entry count
+     */
+    std::size_t getEntryCount() const;
+
+    /**
+     * @brief Get the number of successful lookups
+     * @return Hit count since construction
+     */
+    std::size_t getHitCount() const;
+
+    /**
+     * @brief Get the number of failed lookups
+     * @return Miss count since construction
+     */
+    std::size_t getMissCount() const;
+
+    /**
+     * @brief Get the number of computed results getOrCompute() could not store
+     * @return Store failure count since construction
+     */
+    std::size_t getStoreFailureCount() const;
+
+private:
+    struct Entry {
+        std::size_t bytes;                     ///< File size
+        std::list<std::string>::iterator use;  ///< Position in recency order
+    };
+
+    std::string pathFor(const std::string& name) const;
+    void touch(const std::string& name);
+    void remove(const std::string& name);
+    void evict();
+
+    std::string directory_;                             ///< Cache directory
+    std::size_t capacityBytes_;                         ///< Maximum total file size
+    mutable std::mutex mutex_;                          ///< Guards everything below
+    std::list<std::string> recency_;                    ///< Entry names, most recently used first
+    std::unordered_map<std::string, Entry> entries_;    ///< Entry name (key hex) to index data
+    std::size_t sizeBytes_{0};                          ///< Sum of entry sizes
+    std::size_t hits_{0};                               ///< Successful lookups
+    std::size_t misses_{0};                             ///< Failed lookups
+    std::size_t storeFailures_{0};                      ///< Results getOrCompute() could not store
+};
+
+} // namespace BioMesh
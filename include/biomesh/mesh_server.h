@@ -0,0 +1,218 @@
+#pragma once
+
+#include "AtomBuilder.h"
+#include "biomesh/bounding_box.h"
+#include "biomesh/hex_mesh.h"
+#include "biomesh/mesh_cache.h"
+#include "biomesh/task_graph.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace BioMesh {
+
+/**
+ * @brief Tuning of a MeshServer
+ */
+struct MeshServerOptions {
+    unsigned workerSlots{0};                          ///< Scheduler worker slots (0 = hardware threads)
+    std::size_t largeJobAtoms{100000};                ///< Jobs this large may use every worker slot
+    std::chrono::microseconds batchWindow{2000};      ///< How long to gather small jobs into a batch
+    std::size_t maxBatch{64};                         ///< Maximum jobs per scheduled batch
+    std::size_t maxRequestBytes{std::size_t{256} << 20}; ///< Larger request frames are rejected (~10M atoms)
+    std::string cacheDirectory;                       ///< MeshCache directory; empty disables caching
+    std::size_t cacheBytes{std::size_t{1} << 30};     ///< MeshCache capacity
+};
+
+/**
+ * @brief Counters reported by a MeshServer
+ */
+struct MeshServerStats {
+    std::uint64_t requests{0};   ///< Mesh requests received
+    std::uint64_t errors{0};     ///< Requests answered with an error
+    std::uint64_t batches{0};    ///< Batches run by the scheduler
+    std::uint64_t largeJobs{0};  ///< Jobs run with every worker slot
+    std::uint64_t atoms{0};      ///< Atoms received in mesh requests
+    std::uint64_t cacheHits{0};  ///< Requests answered from the mesh cache
+};
+
+/**
+ * @brief Local meshing daemon serving requests over a Unix domain socket
+ *
+ * Keeps a warm TaskScheduler, AtomBuilder table and optional MeshCache for the lifetime
+ * of the process. Each connection is served by its own thread and may send any number
+ * of requests. Mesh jobs are gathered for up to batchWindow into a TaskGraph: small
+ * jobs run one per worker slot, jobs of at least largeJobAtoms atoms may use every
+ * slot, and the scheduler backfills small jobs around large ones.
+ *
+ * Wire protocol (host byte order; both ends are on the same machine): every message is
+ * a frame of a uint64 payload length followed by the payload. Requests start with
+ * magic "BMRQ", a uint16 version and a uint16 type (mesh, stats, shutdown); mesh
+ * requests carry the meshing parameters, an optional root box and the atoms as
+ * x, y, z doubles plus a length-prefixed element symbol. Responses start with magic
+ * "BMRS", the version and a uint16 status; successful mesh responses carry the vertex
+ * coordinates, hexahedron corner IDs and hexahedron levels, errors a message.
+ * Per-connection receive and send buffers are reused across requests.
+ */
+class MeshServer {
+public:
+    /**
+     * @brief Constructor
+     * @param socketPath Filesystem path of the listening socket
+     * @param options Server tuning
+     * @throws std::invalid_argument if the path does not fit a Unix socket address
+     */
+    explicit MeshServer(const std::string& socketPath, const MeshServerOptions& options = MeshServerOptions());
+
+    /**
+     * @brief Destructor; stops the server
+     */
+    ~MeshServer();
+
+    MeshServer(const MeshServer&) = delete;
+    MeshServer& operator=(const MeshServer&) = delete;
+
+    /**
+     * @brief Bind the socket and start serving in background threads
+     * @throws std::runtime_error if the socket cannot be bound or the server already runs
+     * @note A stale socket file left by a previous process is replaced
+     */
+    void start();
+
+    /**
+     * @brief Stop accepting, finish queued jobs, close connections and remove the socket file
+     */
+    void stop();
+
+    /**
+     * @brief Block until the server stops (through stop() or a shutdown request)
+     */
+    void wait();
+
+    /**
+     * @brief Wait a bounded time for the server to be asked to stop, stopping it if so
+     * @param timeout Maximum time to wait
+     * @return true if the server has stopped
+     * @note Lets a caller interleave waiting with its own checks, such as signal flags
+     */
+    bool waitFor(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Check whether the server is serving
+     * @return true between start() and the server stopping
+     */
+    bool isRunning() const { return running_.load(); }
+
+    /**
+     * @brief Get the request counters
+     * @return Counters since construction
+     */
+    MeshServerStats getStats() const;
+
+    /**
+     * @brief Get the socket path
+     * @return Filesystem path of the listening socket
+     */
+    const std::string& getSocketPath() const { return socketPath_; }
+
+private:
+    struct Job;
+    struct Connection {
+        int fd;                        ///< Connected socket
+        std::thread thread;            ///< Serving thread
+        std::atomic<bool> done{false}; ///< Set when the thread is about to exit
+    };
+
+    void acceptLoop();
+    void serve(Connection& connection);
+    void dispatchLoop();
+    void runBatch(std::vector<std::shared_ptr<Job>>& batch);
+    void runJob(Job& job, unsigned threads);
+    void requestStop();
+
+    std::string socketPath_;                         ///< Listening socket path
+    MeshServerOptions options_;                      ///< Tuning
+    AtomBuilder builder_;                            ///< Warm element table
+    TaskScheduler scheduler_;                        ///< Warm worker threads
+    std::unique_ptr<MeshCache> cache_;               ///< Optional result cache
+
+    int listenFd_{-1};                               ///< Listening socket
+    std::atomic<bool> running_{false};               ///< Serving state
+    std::thread acceptThread_;                       ///< Runs acceptLoop()
+    std::thread dispatchThread_;                     ///< Runs dispatchLoop()
+
+    std::mutex connectionsMutex_;                    ///< Guards connections_
+    std::list<Connection> connections_;              ///< Open connections
+
+    mutable std::mutex queueMutex_;                  ///< Guards the fields below
+    std::condition_variable queueChanged_;           ///< Signals jobs, stop and shutdown
+    std::deque<std::shared_ptr<Job>> queue_;         ///< Jobs waiting for a batch
+    bool stopping_{false};                           ///< No further jobs are accepted
+    bool stopRequested_{false};                      ///< A shutdown request was received
+    MeshServerStats stats_;                          ///< Counters
+};
+
+/**
+ * @brief Client of a MeshServer
+ *
+ * Holds one connection; requests on one client are sequential, so use one client per
+ * thread for concurrent requests.
+ */
+class MeshClient {
+public:
+    /**
+     * @brief Connect to a server
+     * @param socketPath Filesystem path of the server socket
+     * @throws std::runtime_error if the connection fails
+     */
+    explicit MeshClient(const std::string& socketPath);
+
+    /**
+     * @brief Destructor; closes the connection
+     */
+    ~MeshClient();
+
+    MeshClient(const MeshClient&) = delete;
+    MeshClient& operator=(const MeshClient&) = delete;
+
+    /**
+     * @brief Mesh atoms on the server
+     * @param atoms Atoms with coordinates and element; radius and mass are assigned by the server
+     * @param parameters Meshing parameters
+     * @param root Octree root box, or nullptr to use the atoms' bounds plus a 1 Å margin
+     * @return Extracted mesh
+     * @throws std::runtime_error if the server reports an error or the connection fails
+     */
+    HexMesh mesh(const std::vector<Atom>& atoms, const MeshingParameters& parameters = MeshingParameters(),
+                 const BoundingBox* root = nullptr);
+
+    /**
+     * @brief Query the server counters
+     * @return Server counters
+     * @throws std::runtime_error if the connection fails
+     */
+    MeshServerStats getStats();
+
+    /**
+     * @brief Ask the server to stop after finishing queued jobs
+     * @throws std::runtime_error if the connection fails
+     */
+    void requestShutdown();
+
+private:
+    std::vector<std::uint8_t> roundTrip();
+
+    int fd_{-1};                          ///< Connected socket
+    std::vector<std::uint8_t> buffer_;    ///< Reused request and response buffer
+};
+
+} // namespace BioMesh
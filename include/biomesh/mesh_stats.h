@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace BioMesh {
+
+class LinearOctree;
+struct HexMesh;
+
+/**
+ * @brief Counters for one octree level
+ */
+struct LevelStatistics {
+    std::size_t nodes{0};           ///< Nodes visited by build() at this level (internal and leaf)
+    std::size_t leaves{0};          ///< Leaves at this level in the current tree
+    std::size_t occupiedLeaves{0};  ///< Leaves holding at least one atom
+    std::size_t balanceSplits{0};   ///< Leaves at this level refined by 2:1 balancing
+    std::size_t hexahedra{0};       ///< Hexahedra extracted at this level
+    double buildSeconds{0.0};       ///< build() time spent at this level, excluding deeper levels
+};
+
+/**
+ * @brief Refinement and meshing statistics for tuning depth and leaf-size thresholds
+ *
+ * Attach to a LinearOctree (or DistributedOctree) and a HexMeshExtractor with
+ * setStatistics(); counters accumulate across build(), balance() and extract() until
+ * reset(). Collection costs two clock reads per visited node during build() and a pass
+ * over the leaves after each tree change; detached objects cost nothing.
+ *
+ * The leaf occupancy histogram counts leaves by atoms per leaf. Its last bucket collects
+ * leaves holding more than maxAtomsPerLeaf atoms, which only occur at the maximum level.
+ */
+class MeshStatistics {
+public:
+    /**
+     * @brief Clear all counters and timings
+     */
+    void reset();
+
+    /**
+     * @brief Recompute leaf-derived counters (leaves per level, occupancy) from a tree
+     * @param tree Tree whose current leaves are described
+     */
+    void recordLeaves(const LinearOctree& tree);
+
+    /**
+     * @brief Recompute hexahedra per level from an extracted mesh
+     * @param mesh Extracted mesh
+     */
+    void recordMesh(const HexMesh& mesh);
+
+    /**
+     * @brief Write the statistics as a JSON object
+     * @param out Output stream
+     */
+    void writeJson(std::ostream& out) const;
+
+    /**
+     * @brief Write the statistics as a JSON file
+     * @param path Output file path
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void writeJson(const std::string& path) const;
+
+    /**
+     * @brief Get the counters of a level, growing the level table if needed
+     * @param level Octree level
+     * @return Counters of the level
+     */
+    LevelStatistics& level(unsigned level);
+
+    std::vector<LevelStatistics> levels;          ///< Per-level counters, index = level
+    std::vector<std::size_t> leafOccupancy;       ///< Leaves by atom count; last bucket is overflow
+    std::size_t maxAtomsPerLeaf{0};               ///< Refinement threshold of the recorded tree
+    unsigned maxLevel{0};                         ///< Maximum level of the recorded tree
+    std::size_t atoms{0};                         ///< Atoms in the recorded tree
+    std::size_t balancePasses{0};                 ///< Balancing passes that refined at least one leaf
+    std::size_t vertices{0};                      ///< Vertices of the extracted mesh
+    double buildSeconds{0.0};                     ///< Total build() time, key sorting included
+    double balanceSeconds{0.0};                   ///< Total balancing time
+    double meshInsertSeconds{0.0};                ///< Corner insertion into the vertex table
+    double meshCompactSeconds{0.0};               ///< Vertex table compaction
+    double meshPlaceSeconds{0.0};                 ///< Vertex coordinate placement
+    double meshRemapSeconds{0.0};                 ///< Corner slot to vertex ID remapping
+};
+
+} // namespace BioMesh
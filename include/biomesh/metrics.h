@@ -0,0 +1,330 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace BioMesh {
+
+/// Label name/value pairs distinguishing the series of one metric family
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/// Per-thread shards of every counter and histogram; threads beyond this share shards
+constexpr std::size_t kMetricShards = 16;
+
+/**
+ * @brief One cache line of atomic slots, so shards updated by different threads never share a line
+ */
+struct alignas(64) MetricCell {
+    std::atomic<std::uint64_t> slots[8] = {};  ///< Counts (or bit patterns of double sums)
+};
+
+/**
+ * @brief Monotonically increasing count, updated lock-free from any thread
+ */
+class Counter {
+public:
+    Counter() = default;
+    Counter(const Counter&) = delete;
+    Counter& operator=(const Counter&) = delete;
+
+    /**
+     * @brief Add to the count of the calling thread's shard
+     * @param amount Increment
+     */
+    void add(std::uint64_t amount = 1) noexcept;
+
+    /**
+     * @brief Sum the shards
+     * @return Current count
+     */
+    std::uint64_t getValue() const noexcept;
+
+private:
+    MetricCell shards_[kMetricShards];  ///< slots[0] of each cell holds one shard's count
+};
+
+/**
+ * @brief Instantaneous value such as a queue depth or a high-water mark
+ */
+class Gauge {
+public:
+    Gauge() = default;
+    Gauge(const Gauge&) = delete;
+    Gauge& operator=(const Gauge&) = delete;
+
+    /**
+     * @brief Set the value
+     * @param value New value
+     */
+    void set(std::int64_t value) noexcept { value_.store(value, std::memory_order_relaxed); }
+
+    /**
+     * @brief Add to the value
+     * @param amount Increment (negative to decrement)
+     */
+    void add(std::int64_t amount) noexcept { value_.fetch_add(amount, std::memory_order_relaxed); }
+
+    /**
+     * @brief Raise the value to at least the given one (high-water mark)
+     * @param value Candidate maximum
+     */
+    void updateMax(std::int64_t value) noexcept;
+
+    /**
+     * @brief Get the value
+     * @return Current value
+     */
+    std::int64_t getValue() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::int64_t> value_{0};  ///< Current value
+};
+
+/**
+ * @brief Distribution of observed values over fixed buckets, updated lock-free from any thread
+ */
+class Histogram {
+public:
+    /**
+     * @brief Aggregated state of all shards
+     */
+    struct Snapshot {
+        std::vector<std::uint64_t> bucketCounts;  ///< Per bucket (not cumulative), last is +Inf
+        std::uint64_t count{0};                   ///< Total observations
+        double sum{0.0};                          ///< Sum of observed values
+    };
+
+    /**
+     * @brief Constructor
+     * @param upperBounds Increasing bucket upper bounds; +Inf is implicit
+     * @throws std::invalid_argument if the bounds are not strictly increasing
+     */
+    explicit Histogram(std::vector<double> upperBounds);
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    /**
+     * @brief Record a value in the calling thread's shard
+     * @param value Observed value (seconds for latency histograms)
+     */
+    void observe(double value) noexcept;
+
+    /**
+     * @brief Aggregate the shards
+     * @return Bucket counts, total count and sum
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Get the bucket upper bounds
+     * @return Bounds, excluding the implicit +Inf
+     */
+    const std::vector<double>& getUpperBounds() const { return upperBounds_; }
+
+    /**
+     * @brief Make exponentially growing bucket bounds
+     * @param start First upper bound
+     * @param factor Growth factor (> 1)
+     * @param count Number of bounds
+     * @return Bounds start, start*factor, ...
+     */
+    static std::vector<double> exponentialBounds(double start, double factor, std::size_t count);
+
+    /**
+     * @brief Default bounds for stage latencies in seconds (10 µs to about 40 s)
+     * @return Bucket bounds
+     */
+    static std::vector<double> latencyBounds();
+
+private:
+    std::vector<double> upperBounds_;  ///< Bucket bounds
+    std::size_t cellsPerShard_;        ///< Cache lines per shard (buckets + sum)
+    std::vector<MetricCell> cells_;    ///< kMetricShards * cellsPerShard_ lines
+};
+
+/**
+ * @brief Named collection of counters, gauges and histograms with Prometheus text export
+ *
+ * Metric handles are created once (typically into function-local statics) and stay valid
+ * for the life of the registry. Updates never lock: counters and histograms are split into
+ * per-thread shards on separate cache lines and summed only when scraped. Instrumentation
+ * sits at chunk granularity (one observation per pipeline chunk, task or bulk call), so
+ * its cost is a few relaxed atomic adds per chunk.
+ */
+class MetricsRegistry {
+public:
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /**
+     * @brief Get the process-wide registry used by the library's instrumentation
+     * @return Registry instance
+     */
+    static MetricsRegistry& global();
+
+    /**
+     * @brief Get or create a counter series
+     * @param name Metric family name (Prometheus syntax; "_total" suffix by convention)
+     * @param help Family description
+     * @param labels Series labels
+     * @return Counter valid for the life of the registry
+     * @throws std::invalid_argument if the name is invalid or registered with another type
+     */
+    Counter& counter(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    /**
+     * @brief Get or create a gauge series
+     * @param name Metric family name
+     * @param help Family description
+     * @param labels Series labels
+     * @return Gauge valid for the life of the registry
+     * @throws std::invalid_argument if the name is invalid or registered with another type
+     */
+    Gauge& gauge(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    /**
+     * @brief Get or create a histogram series
+     * @param name Metric family name
+     * @param help Family description
+     * @param labels Series labels
+     * @param upperBounds Bucket bounds, used when the series is created
+     * @return Histogram valid for the life of the registry
+     * @throws std::invalid_argument if the name is invalid or registered with another type
+     */
+    Histogram& histogram(const std::string& name, const std::string& help, const MetricLabels& labels = {},
+                         const std::vector<double>& upperBounds = Histogram::latencyBounds());
+
+    /**
+     * @brief Write every metric in the Prometheus text exposition format (version 0.0.4)
+     * @param out Output stream
+     */
+    void writePrometheus(std::ostream& out) const;
+
+    /**
+     * @brief Render every metric in the Prometheus text exposition format
+     * @return Exposition text
+     */
+    std::string scrape() const;
+
+private:
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Family {
+        Type type;
+        std::string help;
+        std::map<std::string, std::unique_ptr<Counter>> counters;      ///< Keyed by rendered labels
+        std::map<std::string, std::unique_ptr<Gauge>> gauges;          ///< Keyed by rendered labels
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;  ///< Keyed by rendered labels
+    };
+
+    Family& family(const std::string& name, const std::string& help, Type type);
+
+    mutable std::mutex mutex_;               ///< Guards registration and scraping
+    std::map<std::string, Family> families_; ///< Families by name
+};
+
+/**
+ * @brief Get the global latency series of a library stage (biomesh_stage_seconds{stage=...})
+ * @param stage Stage label, e.g. "octree_build"
+ * @return Histogram in MetricsRegistry::global()
+ */
+Histogram& stageSeconds(const std::string& stage);
+
+/**
+ * @brief Get the global throughput series of a library stage (biomesh_stage_atoms_total{stage=...})
+ * @param stage Stage label, e.g. "octree_build"
+ * @return Counter in MetricsRegistry::global()
+ */
+Counter& stageAtoms(const std::string& stage);
+
+/**
+ * @brief RAII timer recording the lifetime of a scope into a histogram, in seconds
+ */
+class MetricsTimer {
+public:
+    /**
+     * @brief Start timing
+     * @param histogram Histogram that receives the elapsed time
+     */
+    explicit MetricsTimer(Histogram& histogram) noexcept
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Stop timing and record
+     */
+    ~MetricsTimer() {
+        histogram_.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count());
+    }
+
+    MetricsTimer(const MetricsTimer&) = delete;
+    MetricsTimer& operator=(const MetricsTimer&) = delete;
+
+private:
+    Histogram& histogram_;                             ///< Destination
+    std::chrono::steady_clock::time_point start_;      ///< Start time
+};
+
+/**
+ * @brief Local HTTP endpoint answering scrapes of a MetricsRegistry
+ *
+ * Serves `GET /metrics` (any other path is 404) on a loopback TCP port or a Unix domain
+ * socket, one connection at a time on a background thread.
+ */
+class MetricsEndpoint {
+public:
+    /**
+     * @brief Constructor
+     * @param address "unix:<path>" for a Unix socket, or a TCP port number bound to 127.0.0.1
+     *                ("0" picks a free port)
+     * @param registry Registry to expose
+     * @throws std::invalid_argument if the address cannot be parsed
+     */
+    explicit MetricsEndpoint(const std::string& address, MetricsRegistry& registry = MetricsRegistry::global());
+
+    /**
+     * @brief Destructor; stops the endpoint
+     */
+    ~MetricsEndpoint();
+
+    MetricsEndpoint(const MetricsEndpoint&) = delete;
+    MetricsEndpoint& operator=(const MetricsEndpoint&) = delete;
+
+    /**
+     * @brief Bind and start serving
+     * @throws std::runtime_error if the socket cannot be bound or the endpoint already runs
+     */
+    void start();
+
+    /**
+     * @brief Stop serving and remove a Unix socket file
+     */
+    void stop();
+
+    /**
+     * @brief Get the bound TCP port
+     * @return Port number, or 0 for a Unix socket endpoint
+     */
+    std::uint16_t getPort() const { return port_; }
+
+private:
+    void serveLoop();
+
+    MetricsRegistry& registry_;   ///< Exposed registry
+    std::string socketPath_;      ///< Unix socket path, empty for TCP
+    std::uint16_t port_{0};       ///< TCP port (resolved after start() when 0)
+    int listenFd_{-1};            ///< Listening socket
+    std::thread thread_;          ///< Runs serveLoop()
+};
+
+} // namespace BioMesh
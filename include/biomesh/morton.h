@@ -0,0 +1,94 @@
+#pragma once
+
+#include "biomesh/bounding_box.h"
+#include <array>
+#include <cstdint>
+
+namespace BioMesh {
+
+/// Number of octree levels resolved by a Morton key (21 bits per axis)
+constexpr unsigned kMortonLevels = 21;
+
+/// Number of lattice cells per axis at the finest Morton level
+constexpr std::uint32_t kMortonLatticeSize = std::uint32_t{1} << kMortonLevels;
+
+/// One past the largest Morton key (8^21)
+constexpr std::uint64_t kMortonKeyEnd = std::uint64_t{1} << (3 * kMortonLevels);
+
+/**
+ * @brief Interleave three 21-bit lattice coordinates into a 63-bit Morton key
+ * @param x Lattice X coordinate in [0, 2^21)
+ * @param y Lattice Y coordinate in [0, 2^21)
+ * @param z Lattice Z coordinate in [0, 2^21)
+ * @return Morton key with X as the most significant bit of each triple
+ * @note The bit order matches the octant ordering of BoundingBox::subdivide(),
+ *       so sorting by key visits octants in subdivision order at every level
+ */
+std::uint64_t encodeMorton(std::uint32_t x, std::uint32_t y, std::uint32_t z);
+
+/**
+ * @brief Split a Morton key back into lattice coordinates
+ * @param key Morton key
+ * @return Lattice coordinates {x, y, z}
+ */
+std::array<std::uint32_t, 3> decodeMorton(std::uint64_t key);
+
+/**
+ * @brief Number of finest-level keys covered by a node at the given octree level
+ * @param level Octree level in [0, kMortonLevels]
+ * @return Key span of the node
+ */
+inline std::uint64_t mortonSpan(unsigned level) {
+    return std::uint64_t{1} << (3 * (kMortonLevels - level));
+}
+
+/**
+ * @brief Maps coordinates inside a root bounding box onto the Morton lattice
+ */
+class MortonEncoder {
+public:
+    /**
+     * @brief Constructor
+     * @param root Root bounding box spanned by the lattice
+     * @throws std::invalid_argument if root is empty
+     */
+    explicit MortonEncoder(const BoundingBox& root);
+
+    /**
+     * @brief Quantize a point to lattice coordinates
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param z Z coordinate
+     * @return Lattice coordinates, clamped to [0, 2^21)
+     */
+    std::array<std::uint32_t, 3> toLattice(double x, double y, double z) const;
+
+    /**
+     * @brief Compute the Morton key of a point
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param z Z coordinate
+     * @return Morton key of the lattice cell containing the point
+     */
+    std::uint64_t encode(double x, double y, double z) const;
+
+    /**
+     * @brief Get the bounding box of an octree node
+     * @param key Anchor (smallest) Morton key of the node
+     * @param level Octree level of the node
+     * @return Axis-aligned box covered by the node
+     */
+    BoundingBox nodeBox(std::uint64_t key, unsigned level) const;
+
+    /**
+     * @brief Get the root bounding box
+     * @return Root bounding box
+     */
+    const BoundingBox& getRootBox() const { return root_; }
+
+private:
+    BoundingBox root_;                  ///< Root bounding box
+    std::array<double, 3> scale_{};     ///< Lattice cells per unit length per axis
+};
+
+} // namespace BioMesh
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "Atom.h"
+#include "AtomBuilder.h"
+#include "biomesh/bounding_box.h"
+#include "biomesh/metrics.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace BioMesh {
+
+/**
+ * @brief Bounded multi-producer/multi-consumer FIFO used to connect pipeline stages
+ *
+ * push() blocks while the channel is full, which propagates backpressure from slow
+ * downstream stages to the producer. Once closed, pushes are rejected and pop()
+ * drains the remaining items before reporting end of stream.
+ *
+ * @tparam T Item type moved through the channel
+ */
+template <typename T>
+class BoundedChannel {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Maximum number of queued items
+     * @throws std::invalid_argument if capacity is zero
+     */
+    explicit BoundedChannel(std::size_t capacity) : capacity_(capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("BoundedChannel capacity must be greater than zero");
+        }
+    }
+
+    /**
+     * @brief Push an item, blocking while the channel is full
+     * @param value Item to enqueue
+     * @return true if the item was enqueued, false if the channel was closed
+     */
+    bool push(T value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(value));
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Pop an item, blocking while the channel is empty and open
+     * @return The next item, or std::nullopt once the channel is closed and drained
+     */
+    std::optional<T> pop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return std::nullopt;
+        }
+        T value = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return value;
+    }
+
+    /**
+     * @brief Close the channel and wake all blocked producers and consumers
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notFull_.notify_all();
+        notEmpty_.notify_all();
+    }
+
+    /**
+     * @brief Get the maximum number of queued items
+     * @return Channel capacity
+     */
+    std::size_t getCapacity() const { return capacity_; }
+
+private:
+    std::size_t capacity_;               ///< Maximum number of queued items
+    std::deque<T> items_;                ///< Queued items
+    bool closed_{false};                 ///< True once close() has been called
+    std::mutex mutex_;                   ///< Guards items_ and closed_
+    std::condition_variable notFull_;    ///< Signalled when space becomes available
+    std::condition_variable notEmpty_;   ///< Signalled when an item arrives or on close
+};
+
+/**
+ * @brief Unit of work flowing through an AtomPipeline
+ */
+struct AtomChunk {
+    std::size_t sequence{0};   ///< Position of the chunk in the input stream
+    std::vector<Atom> atoms;   ///< Atoms carried by the chunk
+};
+
+/**
+ * @brief Staged, chunk-streaming pipeline for overlapping parse, build, octree, mesh and write
+ *
+ * Each stage runs on its own thread and is connected to its neighbours by a
+ * BoundedChannel, so a chunk can be enriched by AtomBuilder while the next one is
+ * still being parsed and the previous one is being consumed downstream. Chunks keep
+ * their input order. The channel capacity bounds the number of in-flight chunks per
+ * link, which keeps memory proportional to the chunk size rather than the input size.
+ *
+ * If any stage throws, all channels are closed, the remaining stages wind down and
+ * run() rethrows the first exception.
+ */
+class AtomPipeline {
+public:
+    /// Producer callback: fill the chunk and return true, or return false at end of input
+    using Source = std::function<bool(AtomChunk&)>;
+    /// Transformation callback applied to every chunk in order
+    using Stage = std::function<void(AtomChunk&)>;
+    /// Consumer callback receiving every chunk in order
+    using Sink = std::function<void(AtomChunk&&)>;
+
+    /**
+     * @brief Constructor
+     * @param channelCapacity Number of chunks each inter-stage channel can buffer
+     * @throws std::invalid_argument if channelCapacity is zero
+     */
+    explicit AtomPipeline(std::size_t channelCapacity = 4);
+
+    /**
+     * @brief Set the chunk producer (e.g. a streaming parser)
+     * @param source Producer callback
+     * @return Reference to this pipeline for chaining
+     */
+    AtomPipeline& setSource(Source source);
+
+    /**
+     * @brief Append a transformation stage
+     * @param name Stage name used in diagnostics
+     * @param stage Transformation callback
+     * @return Reference to this pipeline for chaining
+     */
+    AtomPipeline& addStage(const std::string& name, Stage stage);
+
+    /**
+     * @brief Set the chunk consumer (e.g. a writer)
+     * @param sink Consumer callback
+     * @return Reference to this pipeline for chaining
+     */
+    AtomPipeline& setSink(Sink sink);
+
+    /**
+     * @brief Run the pipeline to completion
+     * @throws std::logic_error if no source has been set
+     * @note Rethrows the first exception raised by any stage
+     */
+    void run();
+
+    /**
+     * @brief Get the number of transformation stages
+     * @return Number of stages added with addStage()
+     */
+    std::size_t getStageCount() const { return stages_.size(); }
+
+    /**
+     * @brief Get the number of chunks each inter-stage channel can buffer
+     * @return Channel capacity
+     */
+    std::size_t getChannelCapacity() const { return channelCapacity_; }
+
+    // Stage factories
+
+    /**
+     * @brief Create a source that streams an in-memory atom vector in fixed-size chunks
+     * @param atoms Atoms to stream (must outlive the pipeline run)
+     * @param chunkSize Number of atoms per chunk
+     * @return Source callback
+     * @throws std::invalid_argument if chunkSize is zero
+     */
+    static Source makeChunkedSource(const std::vector<Atom>& atoms, std::size_t chunkSize);
+
+    /**
+     * @brief Create a stage that assigns atomic radius and mass through an AtomBuilder
+     * @param builder Builder used for property lookup (must outlive the pipeline run)
+     * @return Stage callback
+     * @note Throws std::runtime_error from the stage for unknown elements
+     */
+    static Stage makeBuildStage(const AtomBuilder& builder);
+
+    /**
+     * @brief Create a stage that accumulates the bounds of every chunk that passes through
+     * @param bounds Bounding box to expand (must outlive the pipeline run)
+     * @return Stage callback
+     * @note The box is not reset; call reset() beforehand for a fresh computation
+     */
+    static Stage makeBoundsStage(BoundingBox& bounds);
+
+private:
+    struct NamedStage {
+        std::string name;        ///< Stage name used in diagnostics
+        Stage callback;          ///< Transformation callback
+        const char* traceName;   ///< Interned name for trace zones
+        Histogram* chunkSeconds; ///< Per-chunk latency series
+        Counter* chunkAtoms;     ///< Atoms-processed series
+    };
+
+    std::size_t channelCapacity_;       ///< Chunks buffered per inter-stage channel
+    Source source_;                     ///< Chunk producer
+    std::vector<NamedStage> stages_;    ///< Transformation stages in execution order
+    Sink sink_;                         ///< Chunk consumer (optional)
+};
+
+} // namespace BioMesh
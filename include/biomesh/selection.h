@@ -0,0 +1,245 @@
+#pragma once
+
+#include "Atom.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace BioMesh {
+
+/**
+ * @brief Fixed-size set of atom indices stored as 64-bit words
+ *
+ * Bits past size() are always zero, so word-wise operations and counts stay exact.
+ */
+class AtomBitset {
+public:
+    /**
+     * @brief Constructor
+     * @param size Number of atoms covered
+     * @param value Initial value of every bit
+     */
+    explicit AtomBitset(std::size_t size = 0, bool value = false);
+
+    /**
+     * @brief Get the number of atoms covered
+     * @return Bit count
+     */
+    std::size_t size() const { return size_; }
+
+    /**
+     * @brief Count the selected atoms
+     * @return Number of set bits
+     */
+    std::size_t count() const;
+
+    /**
+     * @brief Test an atom
+     * @param index Atom index in [0, size())
+     * @return true if the atom is selected
+     */
+    bool test(std::size_t index) const { return (words_[index >> 6] >> (index & 63)) & 1u; }
+
+    /**
+     * @brief Select or deselect an atom
+     * @param index Atom index in [0, size())
+     * @param value New value
+     */
+    void set(std::size_t index, bool value = true);
+
+    /**
+     * @brief Intersect with another set of the same size
+     * @throws std::invalid_argument if the sizes differ
+     */
+    AtomBitset& operator&=(const AtomBitset& other);
+
+    /**
+     * @brief Unite with another set of the same size
+     * @throws std::invalid_argument if the sizes differ
+     */
+    AtomBitset& operator|=(const AtomBitset& other);
+
+    /**
+     * @brief Complement the set in place
+     * @return Reference to this set
+     */
+    AtomBitset& flip();
+
+    /**
+     * @brief List the selected atoms
+     * @return Ascending atom indices, e.g. for LinearOctree::build(atoms, selection)
+     */
+    std::vector<std::uint32_t> toIndices() const;
+
+    /**
+     * @brief Get the underlying words; bit i of word w is atom 64 * w + i
+     * @return Words
+     */
+    const std::vector<std::uint64_t>& getWords() const { return words_; }
+
+    /**
+     * @brief Get the underlying words for bulk writes; bits past size() must stay zero
+     * @return Words
+     */
+    std::vector<std::uint64_t>& getWords() { return words_; }
+
+    bool operator==(const AtomBitset& other) const { return size_ == other.size_ && words_ == other.words_; }
+    bool operator!=(const AtomBitset& other) const { return !(*this == other); }
+
+private:
+    std::size_t size_;                  ///< Number of atoms covered
+    std::vector<std::uint64_t> words_;  ///< Bits, 64 atoms per word
+};
+
+/**
+ * @brief Column-wise copy of the atom attributes selections are evaluated on
+ *
+ * Built once per atom set and reused by every query, so predicates run as tight loops
+ * over contiguous arrays instead of striding through Atom objects.
+ */
+struct AtomColumns {
+    std::vector<double> x;                      ///< X coordinates
+    std::vector<double> y;                      ///< Y coordinates
+    std::vector<double> z;                      ///< Z coordinates
+    std::vector<double> radius;                 ///< Atomic radii
+    std::vector<double> mass;                   ///< Atomic masses
+    std::vector<std::uint16_t> element;         ///< Index of each atom's symbol in elementSymbols
+    std::vector<std::string> elementSymbols;    ///< Distinct element symbols in first-seen order
+
+    /**
+     * @brief Extract the columns of an atom vector
+     * @param atoms Atoms
+     * @return Columns in atom order
+     * @throws std::invalid_argument if there are more than 65535 distinct elements
+     */
+    static AtomColumns fromAtoms(const std::vector<Atom>& atoms);
+
+    /**
+     * @brief Get the number of atoms
+     * @return Atom count
+     */
+    std::size_t size() const { return x.size(); }
+};
+
+/**
+ * @brief Spatial index answering "is any indexed atom within a distance of this point"
+ *
+ * Uniform grid whose cells are at least the query distance wide, stored as atom indices
+ * sorted by cell key, so a query inspects only the 27 cells around the point.
+ */
+class NeighborIndex {
+public:
+    /**
+     * @brief Index a subset of atoms
+     * @param columns Atom columns (must outlive the index)
+     * @param subset Atoms to index
+     * @param cellSize Grid spacing; queries must use a distance no larger than this
+     * @throws std::invalid_argument if cellSize is not positive or subset has the wrong size
+     */
+    NeighborIndex(const AtomColumns& columns, const AtomBitset& subset, double cellSize);
+
+    /**
+     * @brief Test if an indexed atom lies within a distance of a point
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param z Z coordinate
+     * @param distance Distance, at most the cell size
+     * @return true if an indexed atom centre is within distance (inclusive)
+     */
+    bool anyWithin(double x, double y, double z, double distance) const;
+
+    /**
+     * @brief Get the number of indexed atoms
+     * @return Atom count
+     */
+    std::size_t size() const { return entries_.size(); }
+
+private:
+    std::int64_t cellCoordinate(double value, double origin) const;
+    static std::uint64_t cellKey(std::int64_t i, std::int64_t j, std::int64_t k);
+
+    const AtomColumns& columns_;                                       ///< Indexed coordinates
+    double cellSize_;                                                  ///< Grid spacing
+    double origin_[3] = {0.0, 0.0, 0.0};                               ///< Corner of cell (0, 0, 0)
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> entries_;     ///< (cell key, atom) sorted
+};
+
+/**
+ * @brief Compiled atom selection
+ *
+ * The language combines terms with `and`, `or`, `not` and parentheses:
+ * - `all`, `none`, `hydrogen`, `heavy` (not hydrogen)
+ * - `element C N O` (one or more symbols)
+ * - `index 42`, `index 0 to 99` (inclusive)
+ * - `x|y|z|radius|mass <|<=|>|>=|==|!= value`, e.g. `mass > 12` or `z <= -3.5`
+ * - `within 10 of <term>`: atoms whose centre is within 10 Å of an atom of the term
+ * - any other word names a set supplied at evaluation, e.g. `protein and not hydrogen`
+ *
+ * Compilation produces a postfix plan; evaluation runs each step as a loop over one
+ * column producing 64 atoms per word, and within-terms through a NeighborIndex.
+ */
+class SelectionQuery {
+public:
+    /**
+     * @brief Compile a selection
+     * @param text Selection text
+     * @return Compiled query
+     * @throws std::invalid_argument on a syntax error, naming the offending position
+     */
+    static SelectionQuery compile(const std::string& text);
+
+    /**
+     * @brief Evaluate the selection
+     * @param columns Atom columns
+     * @param namedSets Sets referenced by name in the query
+     * @return Selected atoms
+     * @throws std::invalid_argument if a referenced set is missing or has the wrong size
+     */
+    AtomBitset evaluate(const AtomColumns& columns,
+                        const std::map<std::string, AtomBitset>& namedSets = {}) const;
+
+    /**
+     * @brief Get the source text
+     * @return Text the query was compiled from
+     */
+    const std::string& getText() const { return text_; }
+
+    /**
+     * @brief Describe the compiled plan, one step per line
+     * @return Plan in evaluation order
+     */
+    std::string describe() const;
+
+    /// Operation of one plan step
+    enum class Op : std::uint8_t { All, None, Element, IndexRange, Compare, Named, Not, And, Or, Within };
+    /// Column read by a Compare step
+    enum class Field : std::uint8_t { X, Y, Z, Radius, Mass };
+    /// Comparison of a Compare step
+    enum class Comparison : std::uint8_t { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+    /**
+     * @brief One step of the postfix plan
+     */
+    struct Step {
+        Op op{Op::All};                          ///< Operation
+        Field field{Field::X};                   ///< Column of a Compare step
+        Comparison comparison{Comparison::Less}; ///< Comparison of a Compare step
+        double value{0.0};                       ///< Compare threshold, Within distance or first index
+        double upper{0.0};                       ///< Last index of an IndexRange step
+        std::vector<std::string> names;          ///< Element symbols, or the set name of a Named step
+    };
+
+    /**
+     * @brief Get the compiled plan
+     * @return Steps in evaluation order
+     */
+    const std::vector<Step>& getPlan() const { return plan_; }
+
+private:
+    std::string text_;          ///< Source text
+    std::vector<Step> plan_;    ///< Postfix plan
+};
+
+} // namespace BioMesh
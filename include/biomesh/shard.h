@@ -0,0 +1,155 @@
+#pragma once
+
+#include "Atom.h"
+#include "biomesh/bounding_box.h"
+#include "biomesh/memory.h"
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace BioMesh {
+
+/**
+ * @brief One octant shard of a ShardPlan
+ *
+ * The owned region of a shard is half-open towards the upper bounds (except at the
+ * root's upper faces), so every atom is owned by exactly one shard. The halo region
+ * extends the owned region by the plan's halo width; halo atoms are visible to the
+ * shard's worker but are owned (and emitted) by a neighbouring shard.
+ */
+struct ShardSpec {
+    std::size_t index{0};                  ///< Shard index in subdivision order
+    BoundingBox ownedRegion;               ///< Region whose atoms this shard owns
+    BoundingBox haloRegion;                ///< Owned region expanded by the halo width
+    std::vector<std::size_t> atomIndices;  ///< Owned atoms first, then halo atoms
+    std::size_t ownedCount{0};             ///< Number of owned atoms at the front of atomIndices
+};
+
+/**
+ * @brief Spatial decomposition of a molecular system into octant shards with halos
+ *
+ * The root bounding box of the atoms is subdivided recursively (using the octant
+ * ordering of BoundingBox::subdivide()) into 8^levels shards. Each shard carries a
+ * halo of width max(atomic radius) + probe radius so that a worker sees every atom
+ * whose surface can reach into its owned region. Adjacent owned regions share their
+ * faces bit-for-bit, which keeps lattice-aligned output conforming when stitched.
+ */
+class ShardPlan {
+public:
+    /**
+     * @brief Build a shard plan for a set of atoms
+     * @param atoms Atoms with radii assigned (e.g. from AtomBuilder::buildAtoms)
+     * @param probeRadius Probe radius in Angstroms added to the halo width
+     * @param levels Number of octree subdivision levels (8^levels shards)
+     * @throws std::invalid_argument if probeRadius is negative or levels is outside [1, 7]
+     */
+    ShardPlan(const std::vector<Atom>& atoms, double probeRadius, unsigned levels = 1);
+
+    /**
+     * @brief Get the root bounding box of the atom centres
+     * @return Root bounding box (empty if there are no atoms)
+     */
+    const BoundingBox& getRootBox() const { return rootBox_; }
+
+    /**
+     * @brief Get the halo width (maximum atomic radius plus probe radius)
+     * @return Halo width in Angstroms
+     */
+    double getHaloWidth() const { return haloWidth_; }
+
+    /**
+     * @brief Get the number of subdivision levels
+     * @return Subdivision levels
+     */
+    unsigned getLevels() const { return levels_; }
+
+    /**
+     * @brief Get all shards in subdivision order
+     * @return Vector of 8^levels shards
+     */
+    const std::vector<ShardSpec>& getShards() const { return shards_; }
+
+    /**
+     * @brief Report heap bytes used versus reserved
+     * @return Footprint of the shard list and its atom index lists
+     */
+    MemoryUsage memoryUsage() const;
+
+    /**
+     * @brief Find the shard owning a point
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param z Z coordinate
+     * @return Index of the owning shard
+     * @throws std::out_of_range if the point lies outside the root box
+     */
+    std::size_t getOwningShard(double x, double y, double z) const;
+
+private:
+    BoundingBox rootBox_;              ///< Bounds of all atom centres
+    double haloWidth_{0.0};            ///< Maximum radius plus probe radius
+    unsigned levels_{1};               ///< Subdivision levels
+    std::vector<ShardSpec> shards_;    ///< Shards in subdivision order
+};
+
+/**
+ * @brief Read-only view of one shard's atoms inside the shared memory segment
+ */
+struct ShardView {
+    const ShardSpec* spec{nullptr};   ///< Shard description
+    const double* x{nullptr};         ///< X coordinates (owned atoms first)
+    const double* y{nullptr};         ///< Y coordinates
+    const double* z{nullptr};         ///< Z coordinates
+    const double* radius{nullptr};    ///< Atomic radii
+    std::size_t atomCount{0};         ///< Owned plus halo atoms
+    std::size_t ownedCount{0};        ///< Owned atoms at the front of each array
+};
+
+/**
+ * @brief Local launcher that processes each shard in a separate worker process
+ *
+ * Shard atoms are packed into a POSIX shared memory segment (shm_open/mmap) as
+ * structure-of-arrays columns, then one forked worker per shard reads its slice and
+ * writes up to outputCapacity doubles into its own result slot in the same segment.
+ * No cluster services are involved; concurrency is capped at maxWorkers processes.
+ *
+ * @note Workers are created with fork(); the worker callback must not rely on
+ *       threads started by the parent process.
+ */
+class ShardedLauncher {
+public:
+    /// Worker callback: read the shard view, write results and return the number of doubles written
+    using Worker = std::function<std::size_t(const ShardView& shard, double* output, std::size_t outputCapacity)>;
+
+    /**
+     * @brief Constructor
+     * @param maxWorkers Maximum number of concurrently running worker processes
+     * @param outputCapacity Number of doubles each worker may write
+     * @throws std::invalid_argument if maxWorkers is zero
+     */
+    ShardedLauncher(std::size_t maxWorkers, std::size_t outputCapacity);
+
+    /**
+     * @brief Run the worker over every non-empty shard of a plan
+     * @param plan Shard plan built from atoms
+     * @param atoms Atoms the plan was built from
+     * @param worker Worker callback executed in the child processes
+     * @return Per-shard results in shard order (empty for shards without owned atoms)
+     * @throws std::runtime_error if shared memory cannot be created, a process cannot be
+     *         started, or any worker fails or reports more output than its capacity
+     */
+    std::vector<std::vector<double>> run(const ShardPlan& plan, const std::vector<Atom>& atoms,
+                                         const Worker& worker) const;
+
+    /**
+     * @brief Get the maximum number of concurrent worker processes
+     * @return Worker process limit
+     */
+    std::size_t getMaxWorkers() const { return maxWorkers_; }
+
+private:
+    std::size_t maxWorkers_;      ///< Concurrent worker process limit
+    std::size_t outputCapacity_;  ///< Doubles per worker result slot
+};
+
+} // namespace BioMesh
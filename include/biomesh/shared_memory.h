@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+
+namespace BioMesh {
+
+/**
+ * @brief RAII owner of an anonymous POSIX shared memory mapping
+ *
+ * The segment is created with shm_open, mapped MAP_SHARED and unlinked right away,
+ * so it is shared with processes forked afterwards and released automatically once
+ * every process has unmapped it, whatever the exit path.
+ */
+class SharedMemorySegment {
+public:
+    /**
+     * @brief Create and map a zero-initialized segment
+     * @param bytes Segment size in bytes (rounded up to at least 8 bytes)
+     * @throws std::runtime_error if the segment cannot be created or mapped
+     */
+    explicit SharedMemorySegment(std::size_t bytes);
+
+    /**
+     * @brief Destructor unmaps the segment
+     */
+    ~SharedMemorySegment();
+
+    SharedMemorySegment(const SharedMemorySegment&) = delete;
+    SharedMemorySegment& operator=(const SharedMemorySegment&) = delete;
+
+    /**
+     * @brief Get the start of the mapping
+     * @return Pointer to the mapped memory
+     */
+    void* getData() const { return data_; }
+
+    /**
+     * @brief Get the mapping size
+     * @return Size in bytes
+     */
+    std::size_t getSize() const { return bytes_; }
+
+private:
+    std::size_t bytes_;      ///< Mapping size in bytes
+    void* data_{nullptr};    ///< Start of the mapping
+};
+
+} // namespace BioMesh
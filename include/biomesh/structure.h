@@ -0,0 +1,207 @@
+#pragma once
+
+#include "biomesh/memory.h"
+#include "biomesh/selection.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BioMesh {
+
+/// Up to 8 ASCII characters packed into an integer, first character in the low byte
+using PackedName = std::uint64_t;
+
+/**
+ * @brief Pack a chain ID or residue name
+ * @param name Name of at most 8 characters (trailing spaces are ignored)
+ * @return Packed name; equal names pack to equal integers
+ * @throws std::invalid_argument if the name is longer than 8 characters
+ */
+PackedName packName(std::string_view name);
+
+/**
+ * @brief Unpack a name produced by packName()
+ * @param packed Packed name
+ * @return Name
+ */
+std::string unpackName(PackedName packed);
+
+/**
+ * @brief Half-open range [begin, end) of indices into a container
+ */
+struct IndexRange {
+    std::uint32_t begin{0};  ///< First index
+    std::uint32_t end{0};    ///< One past the last index
+
+    std::size_t size() const { return end - begin; }   ///< Number of indices
+    bool empty() const { return begin == end; }         ///< True if the range has no indices
+};
+
+/**
+ * @brief Identity of an atom within the model / chain / residue hierarchy
+ */
+struct AtomIdentity {
+    std::int32_t model{1};          ///< Model serial number
+    std::string chainId;            ///< Chain identifier, e.g. "A"
+    std::string residueName;        ///< Residue name, e.g. "ALA"
+    std::int32_t residueNumber{0};  ///< Residue sequence number
+    char insertionCode{' '};        ///< Residue insertion code
+};
+
+/**
+ * @brief Model → chain → residue → atom hierarchy over an atom container
+ *
+ * Stored as offset arrays, like CSR: model m owns chains [modelChainOffsets[m],
+ * modelChainOffsets[m + 1]), chain c owns residues [chainResidueOffsets[c], ...) and
+ * residue r owns atoms [residueAtomOffsets[r], ...). Each group is therefore a contiguous
+ * range of the atom container, so per-chain or per-residue work is a loop over
+ * consecutive atoms. Chain IDs and residue names are stored as PackedName integers.
+ *
+ * The hierarchy is built by appending atoms in container order; a new group starts
+ * whenever the identity changes, so atoms of one residue must be consecutive.
+ */
+class StructureHierarchy {
+public:
+    /**
+     * @brief Default constructor creates an empty hierarchy
+     */
+    StructureHierarchy();
+
+    /**
+     * @brief Append the next atom of the container
+     * @param identity Model, chain and residue the atom belongs to
+     * @throws std::invalid_argument if a chain ID or residue name is longer than 8 characters
+     */
+    void addAtom(const AtomIdentity& identity);
+
+    /**
+     * @brief Append the next atom with pre-packed names
+     * @param model Model serial number
+     * @param chainId Packed chain identifier
+     * @param residueName Packed residue name
+     * @param residueNumber Residue sequence number
+     * @param insertionCode Residue insertion code
+     * @throws std::length_error past 2^32 - 1 atoms
+     */
+    void addAtom(std::int32_t model, PackedName chainId, PackedName residueName, std::int32_t residueNumber,
+                 char insertionCode = ' ');
+
+    std::size_t getModelCount() const { return modelNumbers_.size(); }      ///< Number of models
+    std::size_t getChainCount() const { return chainIds_.size(); }          ///< Number of chains
+    std::size_t getResidueCount() const { return residueNames_.size(); }    ///< Number of residues
+    std::size_t getAtomCount() const { return residueAtomOffsets_.back(); } ///< Number of atoms
+
+    /**
+     * @brief Get the chains of a model
+     * @param model Model index in [0, getModelCount())
+     * @return Chain indices
+     */
+    IndexRange getModelChains(std::size_t model) const {
+        return {modelChainOffsets_[model], modelChainOffsets_[model + 1]};
+    }
+
+    /**
+     * @brief Get the residues of a chain
+     * @param chain Chain index in [0, getChainCount())
+     * @return Residue indices
+     */
+    IndexRange getChainResidues(std::size_t chain) const {
+        return {chainResidueOffsets_[chain], chainResidueOffsets_[chain + 1]};
+    }
+
+    /**
+     * @brief Get the atoms of a model
+     * @param model Model index in [0, getModelCount())
+     * @return Atom indices
+     */
+    IndexRange getModelAtoms(std::size_t model) const {
+        return {residueAtomOffsets_[chainResidueOffsets_[modelChainOffsets_[model]]],
+                residueAtomOffsets_[chainResidueOffsets_[modelChainOffsets_[model + 1]]]};
+    }
+
+    /**
+     * @brief Get the atoms of a chain
+     * @param chain Chain index in [0, getChainCount())
+     * @return Atom indices
+     */
+    IndexRange getChainAtoms(std::size_t chain) const {
+        return {residueAtomOffsets_[chainResidueOffsets_[chain]], residueAtomOffsets_[chainResidueOffsets_[chain + 1]]};
+    }
+
+    /**
+     * @brief Get the atoms of a residue
+     * @param residue Residue index in [0, getResidueCount())
+     * @return Atom indices
+     */
+    IndexRange getResidueAtoms(std::size_t residue) const {
+        return {residueAtomOffsets_[residue], residueAtomOffsets_[residue + 1]};
+    }
+
+    std::int32_t getModelNumber(std::size_t model) const { return modelNumbers_[model]; }          ///< Model serial
+    std::string getChainId(std::size_t chain) const { return unpackName(chainIds_[chain]); }      ///< Chain ID
+    std::string getResidueName(std::size_t residue) const { return unpackName(residueNames_[residue]); } ///< Name
+    std::int32_t getResidueNumber(std::size_t residue) const { return residueNumbers_[residue]; }  ///< Sequence number
+    char getInsertionCode(std::size_t residue) const { return insertionCodes_[residue]; }          ///< Insertion code
+
+    /**
+     * @brief Find the residue containing an atom
+     * @param atom Atom index in [0, getAtomCount())
+     * @return Residue index
+     * @throws std::out_of_range if atom is past the hierarchy
+     */
+    std::size_t findResidueOfAtom(std::size_t atom) const;
+
+    /**
+     * @brief Find the chain containing a residue
+     * @param residue Residue index in [0, getResidueCount())
+     * @return Chain index
+     * @throws std::out_of_range if residue is past the hierarchy
+     */
+    std::size_t findChainOfResidue(std::size_t residue) const;
+
+    /**
+     * @brief Select the atoms of every chain with one of the given IDs, in any model
+     * @param chainIds Chain identifiers
+     * @return Bitset over getAtomCount() atoms, usable as a SelectionQuery named set
+     */
+    AtomBitset selectChains(const std::vector<std::string>& chainIds) const;
+
+    /**
+     * @brief Select the atoms of every residue with one of the given names
+     * @param residueNames Residue names, e.g. {"HOH", "WAT"}
+     * @return Bitset over getAtomCount() atoms, usable as a SelectionQuery named set
+     */
+    AtomBitset selectResidueNames(const std::vector<std::string>& residueNames) const;
+
+    /**
+     * @brief Get the atom offset of every chain
+     * @return getChainCount() + 1 ascending offsets; chain c owns atoms [offsets[c], offsets[c + 1])
+     */
+    std::vector<std::uint32_t> getChainAtomOffsets() const;
+
+    const std::vector<std::uint32_t>& getModelChainOffsets() const { return modelChainOffsets_; }      ///< CSR offsets
+    const std::vector<std::uint32_t>& getChainResidueOffsets() const { return chainResidueOffsets_; }  ///< CSR offsets
+    const std::vector<std::uint32_t>& getResidueAtomOffsets() const { return residueAtomOffsets_; }    ///< CSR offsets
+    const std::vector<PackedName>& getChainIds() const { return chainIds_; }                          ///< Packed IDs
+    const std::vector<PackedName>& getResidueNames() const { return residueNames_; }                  ///< Packed names
+
+    /**
+     * @brief Report heap bytes used versus reserved
+     * @return Footprint of the offset and name arrays
+     */
+    MemoryUsage memoryUsage() const;
+
+private:
+    std::vector<std::int32_t> modelNumbers_;           ///< Serial number per model
+    std::vector<std::uint32_t> modelChainOffsets_;     ///< First chain of each model, plus end
+    std::vector<PackedName> chainIds_;                 ///< Packed identifier per chain
+    std::vector<std::uint32_t> chainResidueOffsets_;   ///< First residue of each chain, plus end
+    std::vector<PackedName> residueNames_;             ///< Packed name per residue
+    std::vector<std::int32_t> residueNumbers_;         ///< Sequence number per residue
+    std::vector<char> insertionCodes_;                 ///< Insertion code per residue
+    std::vector<std::uint32_t> residueAtomOffsets_;    ///< First atom of each residue, plus end
+};
+
+} // namespace BioMesh
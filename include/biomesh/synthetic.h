@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Atom.h"
+#include "biomesh/bounding_box.h"
+#include "biomesh/pipeline.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BioMesh {
+
+/**
+ * @brief Spatial distributions produced by SyntheticMoleculeGenerator
+ */
+enum class SyntheticShape {
+    Globular,  ///< Compact protein-like sphere
+    Capsid,    ///< Hollow protein shell, about 30 Angstrom thick
+    Fibre,     ///< Elongated protein cylinder, 20 diameters long
+    WaterBox   ///< Cube of water molecules (O-H 0.9572 Angstrom, H-O-H 104.52 degrees)
+};
+
+/**
+ * @brief Seeded generator of synthetic structures for benchmarks and tests
+ *
+ * Atoms are placed at protein-like density (0.1 atoms per cubic Angstrom) with a
+ * protein element mix (H 49%, C 32%, O 10%, N 8.5%, S 0.5%), or as whole water
+ * molecules for WaterBox. Each atom is derived from a counter-based random stream
+ * keyed by (seed, index), so any index range can be generated independently and the
+ * result does not depend on chunking. That keeps 100M-atom structures streamable in
+ * bounded memory through makeSource().
+ *
+ * Generated atoms carry coordinates and element only, as if parsed from a file; run
+ * them through AtomBuilder to assign radius and mass.
+ */
+class SyntheticMoleculeGenerator {
+public:
+    /**
+     * @brief Constructor
+     * @param shape Spatial distribution
+     * @param atomCount Number of atoms to generate
+     * @param seed Random seed
+     * @throws std::invalid_argument if atomCount is zero
+     */
+    SyntheticMoleculeGenerator(SyntheticShape shape, std::size_t atomCount, std::uint64_t seed = 1);
+
+    /**
+     * @brief Generate the whole structure
+     * @return atomCount atoms
+     */
+    std::vector<Atom> generate() const;
+
+    /**
+     * @brief Generate a range of atom indices
+     * @param first First atom index
+     * @param count Number of atoms; clamped to the end of the structure
+     * @param out Vector receiving the atoms (replaced)
+     * @throws std::out_of_range if first is past the end of the structure
+     */
+    void generateRange(std::size_t first, std::size_t count, std::vector<Atom>& out) const;
+
+    /**
+     * @brief Create an AtomPipeline source that streams the structure in chunks
+     * @param chunkSize Maximum atoms per chunk
+     * @return Source producing consecutive chunks; the generator must outlive it
+     * @throws std::invalid_argument if chunkSize is zero
+     */
+    AtomPipeline::Source makeSource(std::size_t chunkSize) const;
+
+    /**
+     * @brief Get a box enclosing every generated atom centre
+     * @return Analytic extent of the shape
+     */
+    BoundingBox getExtent() const;
+
+    /**
+     * @brief Get the shape
+     * @return Spatial distribution
+     */
+    SyntheticShape getShape() const { return shape_; }
+
+    /**
+     * @brief Get the number of atoms
+     * @return Atom count
+     */
+    std::size_t getAtomCount() const { return atomCount_; }
+
+    /**
+     * @brief Get the seed
+     * @return Random seed
+     */
+    std::uint64_t getSeed() const { return seed_; }
+
+    /**
+     * @brief Parse a shape name ("globular", "capsid", "fibre", "water")
+     * @param name Shape name
+     * @return Shape
+     * @throws std::invalid_argument if the name is unknown
+     */
+    static SyntheticShape parseShape(const std::string& name);
+
+    /**
+     * @brief Get the name of a shape as accepted by parseShape()
+     * @param shape Shape
+     * @return Shape name
+     */
+    static std::string getShapeName(SyntheticShape shape);
+
+private:
+    Atom makeAtom(std::size_t index) const;
+
+    SyntheticShape shape_;     ///< Spatial distribution
+    std::size_t atomCount_;    ///< Number of atoms
+    std::uint64_t seed_;       ///< Random seed
+    double outerRadius_;       ///< Sphere, shell or cylinder radius (Angstrom)
+    double innerRadius_;       ///< Inner shell radius for Capsid (Angstrom)
+    double length_;            ///< Cylinder length for Fibre, cube side for WaterBox (Angstrom)
+};
+
+} // namespace BioMesh
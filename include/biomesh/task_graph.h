@@ -0,0 +1,155 @@
+#pragma once
+
+#include "biomesh/bounding_box.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace BioMesh {
+
+/// Identifier of a task inside a TaskGraph
+using TaskId = std::size_t;
+
+/**
+ * @brief Directed acyclic graph of coarse-grained tasks with cost estimates
+ *
+ * A task is typically one stage of one meshing job (build, octree, balance, mesh,
+ * write). Each task carries a relative cost estimate and the number of worker
+ * slots it can use; a task with parallelism > 1 receives the number of threads it
+ * was granted and is expected to spread its own work over them (for example by
+ * constructing a HexMeshExtractor with that thread count).
+ */
+class TaskGraph {
+public:
+    /// Task body; the argument is the number of threads granted to the task
+    using Work = std::function<void(unsigned threads)>;
+
+    /**
+     * @brief Add a task
+     * @param name Task name used in diagnostics
+     * @param work Task body
+     * @param cost Relative cost estimate (see estimateCost())
+     * @param parallelism Maximum number of worker slots the task can use
+     * @return Identifier of the new task
+     * @throws std::invalid_argument if cost is negative or parallelism is zero
+     */
+    TaskId addTask(const std::string& name, Work work, double cost = 1.0, unsigned parallelism = 1);
+
+    /**
+     * @brief Require one task to finish before another starts
+     * @param before Task that must complete first
+     * @param after Task that depends on it
+     * @throws std::out_of_range if either identifier is unknown
+     */
+    void addDependency(TaskId before, TaskId after);
+
+    /**
+     * @brief Get the number of tasks
+     * @return Task count
+     */
+    std::size_t getTaskCount() const { return tasks_.size(); }
+
+    /**
+     * @brief Get the name of a task
+     * @param task Task identifier
+     * @return Task name
+     * @throws std::out_of_range if the identifier is unknown
+     */
+    const std::string& getTaskName(TaskId task) const { return tasks_.at(task).name; }
+
+    /**
+     * @brief Estimate the relative cost of meshing a structure
+     * @param atomCount Number of atoms
+     * @param root Root bounding box of the structure
+     * @return Cost in arbitrary units: an n log n term for sorting and building plus a
+     *         volume term for the cells of the root box
+     */
+    static double estimateCost(std::size_t atomCount, const BoundingBox& root);
+
+private:
+    friend class TaskScheduler;
+
+    struct Task {
+        std::string name;                 ///< Task name
+        Work work;                        ///< Task body
+        double cost;                      ///< Relative cost estimate
+        unsigned parallelism;             ///< Maximum worker slots
+        std::vector<TaskId> successors;   ///< Tasks depending on this one
+    };
+
+    std::vector<Task> tasks_;  ///< Tasks indexed by TaskId
+};
+
+/**
+ * @brief Critical-path list scheduler with backfilling over a persistent worker pool
+ *
+ * Ready tasks are ordered by their upward rank, i.e. the estimated length of the
+ * longest remaining path through the graph, so the stages of large jobs start as
+ * early as possible. When the highest-priority ready task needs more slots than
+ * are free, it reserves them and smaller ready tasks whose cost does not exceed the
+ * cheapest running task are started in the gap. This lets tiny jobs run alongside
+ * the parallel stages of large ones instead of queueing behind them.
+ *
+ * Worker threads are created once and reused across run() calls.
+ */
+class TaskScheduler {
+public:
+    /**
+     * @brief Constructor
+     * @param workerSlots Number of worker slots (0 uses std::thread::hardware_concurrency())
+     */
+    explicit TaskScheduler(unsigned workerSlots = 0);
+
+    /**
+     * @brief Destructor stops and joins the worker threads
+     */
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /**
+     * @brief Execute every task of a graph, respecting dependencies
+     * @param graph Graph to execute
+     * @throws std::logic_error if the graph contains a cycle
+     * @note Rethrows the first exception raised by a task after running tasks finish;
+     *       tasks that were not started yet are skipped. Not reentrant.
+     */
+    void run(TaskGraph& graph);
+
+    /**
+     * @brief Run body(i) for every i in [0, count) on the calling thread and idle workers
+     * @param count Number of iterations
+     * @param body Iteration body; iterations may run concurrently
+     * @note Meant for tasks granted several slots: the extra iterations are picked up by the
+     *       workers whose slots the task holds, so no threads are created. The calling thread
+     *       takes iterations too and never waits for one that has not started, so the call
+     *       completes even when no worker is idle. Rethrows the first exception raised by an
+     *       iteration after all started iterations finish.
+     */
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& body);
+
+    /**
+     * @brief Get the number of worker slots
+     * @return Worker slots
+     */
+    unsigned getWorkerSlots() const { return workerSlots_; }
+
+private:
+    void workerLoop();
+
+    unsigned workerSlots_;                                 ///< Total worker slots
+    std::vector<std::thread> workers_;                     ///< Persistent worker threads
+    std::mutex mutex_;                                     ///< Guards queue_ and stopping_
+    std::condition_variable queueReady_;                   ///< Signals dispatched work
+    std::deque<std::function<void()>> queue_;              ///< Dispatched task invocations
+    bool stopping_{false};                                 ///< Set on destruction
+};
+
+} // namespace BioMesh
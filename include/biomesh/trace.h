@@ -0,0 +1,196 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace BioMesh {
+
+/**
+ * @brief One completed trace zone
+ */
+struct TraceEvent {
+    const char* name;            ///< Zone name (string literal or Tracer::intern() result)
+    std::uint32_t threadIndex;   ///< Index of the recording thread, in registration order
+    std::uint64_t startNs;       ///< Start time in nanoseconds since the tracer was created
+    std::uint64_t durationNs;    ///< Zone duration in nanoseconds
+};
+
+class TraceBuffer;
+
+/**
+ * @brief Process-wide collector of scoped trace zones
+ *
+ * Each thread records into its own fixed-size ring buffer, so the recording path takes
+ * no lock and never allocates after the thread's first event; when a buffer wraps, the
+ * oldest events are dropped. A buffer is returned to a free list when its thread exits and
+ * handed to the next thread that records, which continues in the same trace lane after the
+ * earlier thread's retained events; short-lived threads therefore cost no more buffers than
+ * were ever recording at once. Recording is off until setEnabled(true); while off, a
+ * TraceScope costs one relaxed atomic load. Building with -DBIOMESH_ENABLE_TRACING=OFF
+ * removes the BIOMESH_TRACE_SCOPE zones entirely.
+ *
+ * collect() and writeChromeTrace() are meant to be called once the traced work has
+ * finished; the output loads in chrome://tracing and Perfetto.
+ */
+class Tracer {
+public:
+    /// Events kept per thread before the oldest are overwritten
+    static constexpr std::size_t kBufferCapacity = std::size_t{1} << 16;
+
+    /**
+     * @brief Get the process-wide tracer
+     * @return Tracer instance
+     */
+    static Tracer& instance();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * @brief Turn recording on or off
+     * @param enabled True to record zones
+     */
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+    /**
+     * @brief Check whether recording is on
+     * @return True if zones are recorded
+     */
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Name the calling thread in exported traces
+     * @param name Thread name
+     */
+    void setThreadName(const std::string& name);
+
+    /**
+     * @brief Get a zone name pointer that stays valid for the life of the process
+     * @param name Dynamic name (e.g. a pipeline stage or task name)
+     * @return Stable pointer usable with TraceScope
+     */
+    const char* intern(const std::string& name);
+
+    /**
+     * @brief Get the current trace timestamp
+     * @return Nanoseconds since the tracer was created
+     */
+    std::uint64_t now() const;
+
+    /**
+     * @brief Record a completed zone for the calling thread
+     * @param name Zone name with static storage duration
+     * @param startNs Start timestamp from now()
+     * @param endNs End timestamp from now()
+     */
+    void record(const char* name, std::uint64_t startNs, std::uint64_t endNs) noexcept;
+
+    /**
+     * @brief Gather the retained events of all threads
+     * @return Events ordered by start time
+     */
+    std::vector<TraceEvent> collect() const;
+
+    /**
+     * @brief Get the number of events lost to ring buffer wrap-around since the last clear()
+     * @return Dropped event count
+     */
+    std::size_t getDroppedCount() const;
+
+    /**
+     * @brief Get the number of per-thread buffers allocated so far
+     * @return Buffer count; bounded by the peak number of concurrently recording threads
+     */
+    std::size_t getBufferCount() const;
+
+    /**
+     * @brief Discard all retained events
+     */
+    void clear();
+
+    /**
+     * @brief Write the retained events in Chrome trace event JSON format
+     * @param out Output stream
+     */
+    void writeChromeTrace(std::ostream& out) const;
+
+    /**
+     * @brief Write the retained events to a Chrome trace JSON file
+     * @param path Output file path
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void writeChromeTrace(const std::string& path) const;
+
+private:
+    struct ThreadSlot;
+
+    Tracer();
+
+    TraceBuffer& localBuffer();
+    void releaseBuffer(TraceBuffer& buffer);
+
+    std::atomic<bool> enabled_{false};                    ///< Recording switch
+    std::int64_t epochNs_;                                ///< steady_clock time of construction
+    mutable std::mutex mutex_;                            ///< Guards the buffer lists and names_
+    std::vector<std::shared_ptr<TraceBuffer>> buffers_;   ///< Per-thread buffers, outliving their threads
+    std::vector<TraceBuffer*> freeBuffers_;               ///< Buffers of exited threads, reused first
+    std::unordered_set<std::string> names_;               ///< Interned zone names
+};
+
+/**
+ * @brief RAII trace zone covering the enclosing scope
+ */
+class TraceScope {
+public:
+    /**
+     * @brief Open a zone if tracing is enabled
+     * @param name Zone name with static storage duration
+     */
+    explicit TraceScope(const char* name) noexcept
+        : name_(Tracer::instance().isEnabled() ? name : nullptr), startNs_(name_ ? Tracer::instance().now() : 0) {
+    }
+
+    /**
+     * @brief Close the zone and record it
+     */
+    ~TraceScope() {
+        if (name_) {
+            Tracer& tracer = Tracer::instance();
+            tracer.record(name_, startNs_, tracer.now());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;        ///< Zone name, or nullptr if not recording
+    std::uint64_t startNs_;   ///< Zone start timestamp
+};
+
+} // namespace BioMesh
+
+#define BIOMESH_TRACE_CONCAT_INNER(a, b) a##b
+#define BIOMESH_TRACE_CONCAT(a, b) BIOMESH_TRACE_CONCAT_INNER(a, b)
+
+/**
+ * @brief Trace the enclosing scope under the given name; BIOMESH_TRACE_THREAD_NAME labels
+ *        the calling thread in exported traces
+ *
+ * Both expand to nothing unless the library is built with BIOMESH_TRACING defined.
+ */
+#ifdef BIOMESH_TRACING
+#define BIOMESH_TRACE_SCOPE(name) \
+    ::BioMesh::TraceScope BIOMESH_TRACE_CONCAT(biomeshTraceScope_, __LINE__)(name)
+#define BIOMESH_TRACE_THREAD_NAME(name) ::BioMesh::Tracer::instance().setThreadName(name)
+#else
+#define BIOMESH_TRACE_SCOPE(name) static_cast<void>(0)
+#define BIOMESH_TRACE_THREAD_NAME(name) static_cast<void>(0)
+#endif
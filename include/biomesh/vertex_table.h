@@ -0,0 +1,121 @@
+#pragma once
+
+#include "biomesh/memory.h"
+#include <atomic>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace BioMesh {
+
+/// Number of vertex positions per axis on the finest octree lattice (2^21 cells + 1)
+constexpr std::uint64_t kVertexLatticeSize = (std::uint64_t{1} << 21) + 1;
+
+/**
+ * @brief Pack lattice vertex coordinates into a 64-bit key
+ * @param x Vertex lattice X coordinate in [0, 2^21]
+ * @param y Vertex lattice Y coordinate in [0, 2^21]
+ * @param z Vertex lattice Z coordinate in [0, 2^21]
+ * @return Mixed-radix key; keys order vertices by x, then y, then z
+ */
+inline std::uint64_t encodeLatticeVertex(std::uint32_t x, std::uint32_t y, std::uint32_t z) {
+    return (static_cast<std::uint64_t>(x) * kVertexLatticeSize + y) * kVertexLatticeSize + z;
+}
+
+/**
+ * @brief Unpack a key produced by encodeLatticeVertex()
+ * @param key Vertex key
+ * @return Vertex lattice coordinates {x, y, z}
+ */
+inline std::array<std::uint32_t, 3> decodeLatticeVertex(std::uint64_t key) {
+    const auto z = static_cast<std::uint32_t>(key % kVertexLatticeSize);
+    key /= kVertexLatticeSize;
+    const auto y = static_cast<std::uint32_t>(key % kVertexLatticeSize);
+    return {static_cast<std::uint32_t>(key / kVertexLatticeSize), y, z};
+}
+
+/**
+ * @brief Lock-free open-addressing set of lattice vertex keys with dense ID assignment
+ *
+ * Threads insert keys concurrently with a single compare-and-swap per new key and
+ * linear probing; a slot index identifies a key for the lifetime of the table, so
+ * callers can record slots while inserting and translate them to dense vertex IDs
+ * after compact(). The capacity is fixed at construction (see estimateVertexCount()),
+ * which avoids any resizing or locking on the insertion path.
+ */
+class ConcurrentVertexTable {
+public:
+    /// Marker stored in unused slots; never a valid vertex key
+    static constexpr std::uint64_t kEmptyKey = std::numeric_limits<std::uint64_t>::max();
+
+    /**
+     * @brief Constructor
+     * @param expectedVertices Expected number of distinct keys; the table keeps at least
+     *        twice as many slots so probe sequences stay short
+     * @throws std::length_error if the required capacity exceeds 2^32 slots
+     */
+    explicit ConcurrentVertexTable(std::size_t expectedVertices);
+
+    /**
+     * @brief Estimate the number of distinct vertices of a hexahedral octree mesh
+     * @param leafCount Number of octree leaves
+     * @return Expected distinct vertex count
+     * @note Neighbouring leaves share corners, so the count stays far below 8 per leaf
+     *       even with hanging nodes; insert() reports an overflow if the estimate is beaten
+     */
+    static std::size_t estimateVertexCount(std::size_t leafCount);
+
+    /**
+     * @brief Insert a key if absent (thread-safe, lock-free)
+     * @param key Vertex key (must not equal kEmptyKey)
+     * @return Slot index holding the key
+     * @throws std::length_error if the table is full
+     */
+    std::uint32_t insert(std::uint64_t key);
+
+    /**
+     * @brief Assign dense IDs in ascending key order
+     * @return Number of distinct keys
+     * @note Not thread-safe; call after all insertions have completed. Ordering by key
+     *       makes IDs independent of thread scheduling.
+     */
+    std::size_t compact();
+
+    /**
+     * @brief Get the dense ID of a slot
+     * @param slot Slot index returned by insert()
+     * @return Dense vertex ID assigned by compact()
+     */
+    std::uint32_t getId(std::uint32_t slot) const { return ids_[slot]; }
+
+    /**
+     * @brief Get the keys in dense ID order
+     * @return Sorted keys (valid after compact())
+     */
+    const std::vector<std::uint64_t>& getKeys() const { return sortedKeys_; }
+
+    /**
+     * @brief Get the number of slots
+     * @return Table capacity (a power of two)
+     */
+    std::size_t getCapacity() const { return capacity_; }
+
+    /**
+     * @brief Report heap bytes used versus reserved
+     * @return Footprint of the slot array, dense IDs and sorted keys
+     */
+    MemoryUsage memoryUsage() const;
+
+private:
+    std::size_t capacity_;                           ///< Number of slots (power of two)
+    std::size_t mask_;                               ///< capacity_ - 1
+    unsigned shift_;                                 ///< 64 - log2(capacity_), selects the hash's top bits
+    std::unique_ptr<std::atomic<std::uint64_t>[]> keys_;  ///< Slot keys, kEmptyKey if unused
+    std::vector<std::uint32_t> ids_;                 ///< Dense ID per slot after compact()
+    std::vector<std::uint64_t> sortedKeys_;          ///< Keys in dense ID order
+};
+
+} // namespace BioMesh
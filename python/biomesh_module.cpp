@@ -0,0 +1,301 @@
+/**
+ * @file biomesh_module.cpp
+ * @brief Python bindings (module `biomesh`) exchanging bulk data with NumPy through the buffer protocol
+ *
+ * Outputs are zero-copy: atom coordinates, octree leaf fields, the atom order and mesh arrays
+ * are NumPy views into the C++ containers, strided where the C++ layout is an array of
+ * structs, and keep their owning Python object alive. Views of an octree are read-only; while
+ * any of them is alive, build() and balance() raise RuntimeError instead of reallocating the
+ * memory under them. Delete the views (or keep copy()s) before rebuilding.
+ *
+ * Inputs are read in place from any strided buffer: bounds are computed directly from a
+ * coordinate array, and AtomArray.from_arrays() fills the atom container in one C++ pass
+ * with the GIL released, never calling back into Python per atom.
+ */
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "biomesh/biomesh.h"
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace py = pybind11;
+using namespace BioMesh;
+
+namespace {
+
+/**
+ * @brief Python-owned atom container
+ */
+struct AtomArray {
+    std::vector<Atom> atoms;  ///< Atoms in input order
+};
+
+/**
+ * @brief Python-owned octree that tracks the readers of its storage
+ *
+ * All counters are only touched with the GIL held.
+ */
+struct Octree {
+    LinearOctree tree;          ///< Wrapped octree
+    std::size_t readers{0};     ///< Live NumPy views plus running extractions
+    bool writing{false};        ///< build() or balance() is running with the GIL released
+
+    void checkWritable(const char* operation) const {
+        if (writing) {
+            throw std::runtime_error(std::string(operation) + " called while the octree is being rebuilt");
+        }
+        if (readers != 0) {
+            throw std::runtime_error(std::string(operation) + " would invalidate " + std::to_string(readers) +
+                                     " live view(s) of this octree; delete them or keep copies first");
+        }
+    }
+
+    void checkReadable() const {
+        if (writing) {
+            throw std::runtime_error("octree is being rebuilt");
+        }
+    }
+};
+
+/**
+ * @brief Marks an octree as being written for the lifetime of a build() or balance() call
+ */
+class OctreeWrite {
+public:
+    OctreeWrite(Octree& octree, const char* operation) : octree_(octree) {
+        octree_.checkWritable(operation);
+        octree_.writing = true;
+    }
+    ~OctreeWrite() { octree_.writing = false; }
+
+    OctreeWrite(const OctreeWrite&) = delete;
+    OctreeWrite& operator=(const OctreeWrite&) = delete;
+
+private:
+    Octree& octree_;
+};
+
+/**
+ * @brief Base object of an octree view: keeps the octree alive and counted as read until released
+ */
+py::capsule octreeViewOwner(const py::object& self) {
+    Octree& octree = self.cast<Octree&>();
+    octree.checkReadable();
+    ++octree.readers;
+    return py::capsule(new py::object(self), [](void* pointer) {
+        auto* owner = static_cast<py::object*>(pointer);
+        --owner->cast<Octree&>().readers;
+        delete owner;
+    });
+}
+
+/**
+ * @brief Wrap C++ memory in a NumPy array that keeps owner alive
+ */
+template <typename T>
+py::array_t<T> view(const py::object& owner, const T* data, std::vector<py::ssize_t> shape,
+                     std::vector<py::ssize_t> strides, bool writeable) {
+    py::array_t<T> array(std::move(shape), std::move(strides), data, owner);
+    if (!writeable) {
+        array.attr("flags").attr("writeable") = false;
+    }
+    return array;
+}
+
+/**
+ * @brief View one field of every element of a vector of structs as a 1-D strided array
+ */
+template <typename T, typename Struct>
+py::array_t<T> fieldView(const py::object& owner, const std::vector<Struct>& items, const T* firstField,
+                         bool writeable) {
+    return view<T>(owner, items.empty() ? nullptr : firstField, {static_cast<py::ssize_t>(items.size())},
+                   {static_cast<py::ssize_t>(sizeof(Struct))}, writeable);
+}
+
+void checkCoordinates(const py::array_t<double>& coordinates) {
+    if (coordinates.ndim() != 2 || coordinates.shape(1) != 3) {
+        throw std::invalid_argument("coordinates must have shape (N, 3)");
+    }
+}
+
+/**
+ * @brief View a strided (N, 3) float64 array in place
+ */
+CoordinateView coordinateView(const py::array_t<double>& coordinates) {
+    checkCoordinates(coordinates);
+    // Column d of a strided (N, 3) array starts d * strides(1) bytes after the first element
+    const char* first = static_cast<const char*>(coordinates.data());
+    const auto column = [&](py::ssize_t d) {
+        return reinterpret_cast<const double*>(first + d * coordinates.strides(1));
+    };
+    return CoordinateView(column(0), column(1), column(2), static_cast<std::size_t>(coordinates.shape(0)),
+                          coordinates.strides(0));
+}
+
+BoundingBox boundsFromCoordinates(const py::array_t<double>& coordinates) {
+    const CoordinateView points = coordinateView(coordinates);
+    BoundingBox bounds;
+    py::gil_scoped_release release;
+    bounds.calculateFromPoints(points);
+    return bounds;
+}
+
+AtomArray atomsFromArrays(const py::array_t<double>& coordinates,
+                          const py::array_t<std::int32_t, py::array::forcecast>& elementIds,
+                          const std::vector<std::string>& symbols, bool assignProperties) {
+    static const AtomBuilder builder;
+    const CoordinateView points = coordinateView(coordinates);
+    if (elementIds.ndim() != 1 || elementIds.shape(0) != coordinates.shape(0)) {
+        throw std::invalid_argument("element_ids must have shape (N,) matching coordinates");
+    }
+    const StridedView<std::int32_t> ids(elementIds.data(), points.size(), elementIds.strides(0));
+
+    AtomArray result;
+    py::gil_scoped_release release;
+    if (assignProperties) {
+        // Resolves each symbol once; the same code path as AtomBuilder::buildAtoms in C++
+        result.atoms = builder.buildAtoms(points, ids, symbols);
+        return result;
+    }
+    result.atoms.reserve(points.size());
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const std::int32_t id = ids[i];
+        if (id < 0 || static_cast<std::size_t>(id) >= symbols.size()) {
+            throw std::out_of_range("element id " + std::to_string(id) + " at index " + std::to_string(i) +
+                                    " has no symbol");
+        }
+        result.atoms.emplace_back(points.x(i), points.y(i), points.z(i), symbols[static_cast<std::size_t>(id)]);
+    }
+    return result;
+}
+
+} // namespace
+
+PYBIND11_MODULE(biomesh, m) {
+    m.doc() = "BioMesh octree meshing of biomolecules with zero-copy NumPy views";
+
+    py::class_<BoundingBox>(m, "BoundingBox")
+        .def(py::init<>())
+        .def(py::init<double, double, double, double, double, double>(), py::arg("min_x"), py::arg("min_y"),
+             py::arg("min_z"), py::arg("max_x"), py::arg("max_y"), py::arg("max_z"))
+        .def_property_readonly("min", [](const BoundingBox& box) {
+            return py::make_tuple(box.getMinX(), box.getMinY(), box.getMinZ());
+        })
+        .def_property_readonly("max", [](const BoundingBox& box) {
+            return py::make_tuple(box.getMaxX(), box.getMaxY(), box.getMaxZ());
+        })
+        .def_property_readonly("volume", &BoundingBox::getVolume)
+        .def("is_empty", &BoundingBox::isEmpty)
+        .def("expand", &BoundingBox::expand, py::arg("margin"))
+        .def_static("from_coordinates", &boundsFromCoordinates, py::arg("coordinates"),
+                    "Bounds of an (N, 3) float64 array, read in place");
+
+    py::class_<AtomArray>(m, "AtomArray")
+        .def(py::init<>())
+        .def_static("from_arrays", &atomsFromArrays, py::arg("coordinates"), py::arg("element_ids"),
+                    py::arg("symbols"), py::arg("assign_properties") = true,
+                    "Build atoms from (N, 3) coordinates and per-atom indices into symbols")
+        .def("__len__", [](const AtomArray& array) { return array.atoms.size(); })
+        .def_property_readonly("coordinates", [](py::object self) {
+            const auto& atoms = self.cast<const AtomArray&>().atoms;
+            const double* first = atoms.empty() ? nullptr : atoms.front().getCoordinates().data();
+            return view<double>(self, first, {static_cast<py::ssize_t>(atoms.size()), 3},
+                                {static_cast<py::ssize_t>(sizeof(Atom)), sizeof(double)}, true);
+        }, "Writeable (N, 3) strided view of the atom coordinates")
+        .def_property_readonly("radii", [](const AtomArray& array) {
+            py::array_t<double> radii(static_cast<py::ssize_t>(array.atoms.size()));
+            auto out = radii.mutable_unchecked<1>();
+            for (std::size_t i = 0; i < array.atoms.size(); ++i) {
+                out(static_cast<py::ssize_t>(i)) = array.atoms[i].getAtomicRadius();
+            }
+            return radii;
+        }, "Copy of the atomic radii")
+        .def_property_readonly("masses", [](const AtomArray& array) {
+            py::array_t<double> masses(static_cast<py::ssize_t>(array.atoms.size()));
+            auto out = masses.mutable_unchecked<1>();
+            for (std::size_t i = 0; i < array.atoms.size(); ++i) {
+                out(static_cast<py::ssize_t>(i)) = array.atoms[i].getAtomicMass();
+            }
+            return masses;
+        }, "Copy of the atomic masses")
+        .def("bounds", [](const AtomArray& array) {
+            BoundingBox bounds;
+            bounds.calculateFromAtoms(array.atoms);
+            return bounds;
+        });
+
+    py::class_<Octree>(m, "LinearOctree")
+        .def(py::init([](const BoundingBox& root, unsigned maxLevel, std::size_t maxAtomsPerLeaf) {
+            return Octree{LinearOctree(root, maxLevel, maxAtomsPerLeaf)};
+        }), py::arg("root"), py::arg("max_level") = 10, py::arg("max_atoms_per_leaf") = 8)
+        .def("build", [](Octree& octree, const AtomArray& array) {
+            OctreeWrite write(octree, "build()");
+            py::gil_scoped_release release;
+            octree.tree.build(array.atoms);
+        }, py::arg("atoms"), "Build the octree; raises RuntimeError while views of it are alive")
+        .def("balance", [](Octree& octree) {
+            OctreeWrite write(octree, "balance()");
+            py::gil_scoped_release release;
+            return octree.tree.balance();
+        }, "Enforce 2:1 balance; returns the number of splits. Raises RuntimeError while views are alive")
+        .def("__len__", [](const Octree& octree) {
+            octree.checkReadable();
+            return octree.tree.getLeaves().size();
+        })
+        .def_property_readonly("leaf_keys", [](py::object self) {
+            const auto& leaves = self.cast<const Octree&>().tree.getLeaves();
+            return fieldView(octreeViewOwner(self), leaves, leaves.empty() ? nullptr : &leaves.front().key, false);
+        })
+        .def_property_readonly("leaf_levels", [](py::object self) {
+            const auto& leaves = self.cast<const Octree&>().tree.getLeaves();
+            return fieldView(octreeViewOwner(self), leaves, leaves.empty() ? nullptr : &leaves.front().level, false);
+        })
+        .def_property_readonly("leaf_first_atoms", [](py::object self) {
+            const auto& leaves = self.cast<const Octree&>().tree.getLeaves();
+            return fieldView(octreeViewOwner(self), leaves, leaves.empty() ? nullptr : &leaves.front().firstAtom,
+                             false);
+        })
+        .def_property_readonly("leaf_atom_counts", [](py::object self) {
+            const auto& leaves = self.cast<const Octree&>().tree.getLeaves();
+            return fieldView(octreeViewOwner(self), leaves, leaves.empty() ? nullptr : &leaves.front().atomCount,
+                             false);
+        })
+        .def_property_readonly("atom_order", [](py::object self) {
+            const auto& order = self.cast<const Octree&>().tree.getAtomOrder();
+            return view<std::uint32_t>(octreeViewOwner(self), order.data(), {static_cast<py::ssize_t>(order.size())},
+                                       {sizeof(std::uint32_t)}, false);
+        }, "Input index of each atom in leaf (Morton) order");
+
+    py::class_<HexMesh>(m, "HexMesh")
+        .def_property_readonly("vertices", [](py::object self) {
+            auto& mesh = self.cast<HexMesh&>();
+            return view<double>(self, mesh.vertices.empty() ? nullptr : mesh.vertices.front().data(),
+                                {static_cast<py::ssize_t>(mesh.vertices.size()), 3},
+                                {3 * sizeof(double), sizeof(double)}, true);
+        }, "(V, 3) float64 view of the vertex coordinates")
+        .def_property_readonly("hexahedra", [](py::object self) {
+            auto& mesh = self.cast<HexMesh&>();
+            return view<std::uint32_t>(self, mesh.hexahedra.empty() ? nullptr : mesh.hexahedra.front().data(),
+                                       {static_cast<py::ssize_t>(mesh.hexahedra.size()), 8},
+                                       {8 * sizeof(std::uint32_t), sizeof(std::uint32_t)}, true);
+        }, "(H, 8) uint32 view of the corner vertex IDs")
+        .def_property_readonly("levels", [](py::object self) {
+            auto& mesh = self.cast<HexMesh&>();
+            return view<std::uint8_t>(self, mesh.levels.data(), {static_cast<py::ssize_t>(mesh.levels.size())},
+                                      {sizeof(std::uint8_t)}, true);
+        }, "(H,) uint8 view of the hexahedron octree levels");
+
+    m.def("extract", [](py::object tree, bool occupiedLeavesOnly, unsigned threads) {
+        // Counted as a reader, so a concurrent build() from another Python thread raises
+        const py::capsule reading = octreeViewOwner(tree);
+        const LinearOctree& octree = tree.cast<const Octree&>().tree;
+        py::gil_scoped_release release;
+        return HexMeshExtractor(threads).extract(octree, occupiedLeavesOnly);
+    }, py::arg("tree"), py::arg("occupied_leaves_only") = false, py::arg("threads") = 0,
+          "Extract the hexahedral mesh of an octree");
+}
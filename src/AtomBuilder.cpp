@@ -1,13 +1,96 @@
 #include "AtomBuilder.h"
+#include "biomesh/trace.h"
+#include <algorithm>
 #include <stdexcept>
 
 namespace BioMesh {
 
+// Readers only touch these atomics; a mutex fallback would make them block
+static_assert(std::atomic<const AtomicSpecTable*>::is_always_lock_free, "table pointer must be lock-free");
+static_assert(std::atomic<bool>::is_always_lock_free, "reader slot flag must be lock-free");
+
+/**
+ * @brief Hazard pointer of one reader; slots are reused, and freed with the builder
+ */
+struct AtomBuilder::ReaderSlot {
+    std::atomic<const AtomicSpecTable*> table{nullptr};   ///< Table the reader is using
+    std::atomic<bool> active{false};                      ///< Claimed by a reader
+    ReaderSlot* next = nullptr;                           ///< Immutable once the slot is listed
+};
+
+AtomBuilder::SpecTablePin::~SpecTablePin() {
+    if (slot_ != nullptr) {
+        slot_->table.store(nullptr, std::memory_order_release);
+        slot_->active.store(false, std::memory_order_release);
+    }
+}
+
 AtomBuilder::AtomBuilder() {
     initializeAtomicSpecs();
 }
 
+AtomBuilder::AtomBuilder(const AtomBuilder& other) {
+    const SpecTablePin table = other.getSpecTable();
+    current_.store(new AtomicSpecTable(table->getSpecs(), table->getVersion()), std::memory_order_release);
+}
+
+AtomBuilder::~AtomBuilder() {
+    delete current_.load(std::memory_order_relaxed);
+    for (const AtomicSpecTable* table : retired_) {
+        delete table;
+    }
+    for (ReaderSlot* slot = readers_.load(std::memory_order_relaxed); slot != nullptr;) {
+        ReaderSlot* next = slot->next;
+        delete slot;
+        slot = next;
+    }
+}
+
+AtomBuilder::SpecTablePin AtomBuilder::getSpecTable() const {
+    ReaderSlot* slot = acquireSlot();
+    const AtomicSpecTable* table = current_.load(std::memory_order_acquire);
+    // Announce the table, then check it is still current: a writer that superseded it
+    // in between may not have seen the announcement before reclaiming
+    for (;;) {
+        slot->table.store(table, std::memory_order_seq_cst);
+        const AtomicSpecTable* current = current_.load(std::memory_order_seq_cst);
+        if (current == table) {
+            return SpecTablePin(slot, table);
+        }
+        table = current;
+    }
+}
+
+AtomBuilder::ReaderSlot* AtomBuilder::acquireSlot() const {
+    for (ReaderSlot* slot = readers_.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+        bool expected = false;
+        if (!slot->active.load(std::memory_order_relaxed) &&
+            slot->active.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return slot;
+        }
+    }
+    auto* slot = new ReaderSlot;
+    slot->active.store(true, std::memory_order_relaxed);
+    ReaderSlot* head = readers_.load(std::memory_order_relaxed);
+    do {
+        slot->next = head;
+    } while (!readers_.compare_exchange_weak(head, slot, std::memory_order_release, std::memory_order_relaxed));
+    return slot;
+}
+
+AtomBuilder& AtomBuilder::operator=(const AtomBuilder& other) {
+    if (this != &other) {
+        std::unordered_map<std::string, AtomicSpec> specs = other.getSpecTable()->getSpecs();
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        publish(std::move(specs));
+    }
+    return *this;
+}
+
 std::vector<Atom> AtomBuilder::buildAtoms(const std::vector<Atom>& parsedAtoms) const {
+    BIOMESH_TRACE_SCOPE("AtomBuilder::buildAtoms");
+    const auto table = getSpecTable();
+    const AtomicSpecTable& specs = *table;
     std::vector<Atom> enhancedAtoms;
     enhancedAtoms.reserve(parsedAtoms.size());
 
@@ -15,15 +98,15 @@ std::vector<Atom> AtomBuilder::buildAtoms(const std::vector<Atom>& parsedAtoms)
         const std::string& element = parsedAtom.getChemicalElement();
         
         // Check if element exists in specification table
-        auto it = atomicSpecs_.find(element);
-        if (it == atomicSpecs_.end()) {
+        const AtomicSpec* spec = specs.find(element);
+        if (spec == nullptr) {
             throw std::runtime_error("Element '" + element + "' not found in atomic specification table");
         }
 
         // Create enhanced atom with all properties
         Atom enhancedAtom = parsedAtom;  // Copy coordinates and element
-        enhancedAtom.setAtomicRadius(it->second.radius);
-        enhancedAtom.setAtomicMass(it->second.mass);
+        enhancedAtom.setAtomicRadius(spec->radius);
+        enhancedAtom.setAtomicMass(spec->mass);
         
         enhancedAtoms.push_back(enhancedAtom);
     }
@@ -31,59 +114,189 @@ std::vector<Atom> AtomBuilder::buildAtoms(const std::vector<Atom>& parsedAtoms)
     return enhancedAtoms;
 }
 
+std::vector<Atom> AtomBuilder::buildAtoms(const CoordinateView& coordinates,
+                                          const StridedView<std::int32_t>& elementIds,
+                                          const std::vector<std::string>& symbols, std::int32_t idBase) const {
+    BIOMESH_TRACE_SCOPE("AtomBuilder::buildAtoms");
+    if (elementIds.size() != coordinates.size()) {
+        throw std::invalid_argument("Element IDs and coordinates must have the same size");
+    }
+
+    // Resolve every symbol once; unknown symbols only fail if an atom uses them
+    const auto table = getSpecTable();
+    const AtomicSpecTable& specs = *table;
+    std::vector<const AtomicSpec*> resolved(symbols.size());
+    for (std::size_t s = 0; s < symbols.size(); ++s) {
+        resolved[s] = specs.find(symbols[s]);
+    }
+
+    std::vector<Atom> atoms(coordinates.size());
+    for (std::size_t i = 0; i < coordinates.size(); ++i) {
+        const std::int64_t id = static_cast<std::int64_t>(elementIds[i]) - idBase;
+        if (id < 0 || id >= static_cast<std::int64_t>(symbols.size())) {
+            throw std::out_of_range("Atom " + std::to_string(i) + " has element ID " +
+                                    std::to_string(elementIds[i]) + " with no symbol");
+        }
+        const AtomicSpec* spec = resolved[static_cast<std::size_t>(id)];
+        if (spec == nullptr) {
+            throw std::runtime_error("Element '" + symbols[static_cast<std::size_t>(id)] + "' of atom " +
+                                     std::to_string(i) + " not found in atomic specification table");
+        }
+        Atom& atom = atoms[i];
+        atom.setCoordinates(coordinates.x(i), coordinates.y(i), coordinates.z(i));
+        atom.setChemicalElement(spec->elementSymbol);
+        atom.setAtomicRadius(spec->radius);
+        atom.setAtomicMass(spec->mass);
+    }
+    return atoms;
+}
+
+void AtomBuilder::assignProperties(std::vector<Atom>& atoms) const {
+    BIOMESH_TRACE_SCOPE("AtomBuilder::assignProperties");
+    const auto table = getSpecTable();
+    const AtomicSpecTable& specs = *table;
+    for (auto& atom : atoms) {
+        const AtomicSpec* spec = specs.find(atom.getChemicalElement());
+        if (spec == nullptr) {
+            throw std::runtime_error("Element '" + atom.getChemicalElement() +
+                                     "' not found in atomic specification table");
+        }
+        atom.setAtomicRadius(spec->radius);
+        atom.setAtomicMass(spec->mass);
+    }
+}
+
 void AtomBuilder::addAtomicSpec(const std::string& element, double radius, double mass) {
-    atomicSpecs_[element] = AtomicSpec(element, radius, mass);
+    updateAtomicSpecs({AtomicSpec(element, radius, mass)});
+}
+
+void AtomBuilder::updateAtomicSpecs(const std::vector<AtomicSpec>& specs, bool replaceAll) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    std::unordered_map<std::string, AtomicSpec> next;
+    if (!replaceAll) {
+        next = getSpecTable()->getSpecs();
+    }
+    for (const auto& spec : specs) {
+        next[spec.elementSymbol] = spec;
+    }
+    publish(std::move(next));
+}
+
+void AtomBuilder::publish(std::unordered_map<std::string, AtomicSpec> specs) {
+    const AtomicSpecTable* previous = current_.load(std::memory_order_relaxed);
+    const std::uint64_t version = previous != nullptr ? previous->getVersion() + 1 : 1;
+    const AtomicSpecTable* next = new AtomicSpecTable(std::move(specs), version);
+    // Pairs with the loads in getSpecTable(): the table is complete before it is visible, and
+    // a reader either announces previous before this store or sees next on its re-check
+    current_.store(next, std::memory_order_seq_cst);
+    if (previous != nullptr) {
+        retired_.push_back(previous);
+        reclaim();
+    }
+}
+
+void AtomBuilder::reclaim() {
+    std::vector<const AtomicSpecTable*> pinned;
+    for (ReaderSlot* slot = readers_.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+        if (const AtomicSpecTable* table = slot->table.load(std::memory_order_seq_cst)) {
+            pinned.push_back(table);
+        }
+    }
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < retired_.size(); ++i) {
+        if (std::find(pinned.begin(), pinned.end(), retired_[i]) != pinned.end()) {
+            retired_[kept++] = retired_[i];
+        } else {
+            delete retired_[i];
+        }
+    }
+    retired_.resize(kept);
+}
+
+std::size_t AtomBuilder::getRetiredTableCount() const {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    return retired_.size();
 }
 
 bool AtomBuilder::hasElement(const std::string& element) const {
-    return atomicSpecs_.find(element) != atomicSpecs_.end();
+    return getSpecTable()->find(element) != nullptr;
 }
 
-const AtomicSpec& AtomBuilder::getAtomicSpec(const std::string& element) const {
-    auto it = atomicSpecs_.find(element);
-    if (it == atomicSpecs_.end()) {
+AtomicSpec AtomBuilder::getAtomicSpec(const std::string& element) const {
+    const auto table = getSpecTable();
+    const AtomicSpec* spec = table->find(element);
+    if (spec == nullptr) {
         throw std::runtime_error("Element '" + element + "' not found in atomic specification table");
     }
-    return it->second;
+    return *spec;
 }
 
 void AtomBuilder::initializeAtomicSpecs() {
     // Common biological elements with accurate atomic properties
     // Values from NIST and standard chemistry references
+    std::unordered_map<std::string, AtomicSpec> specs;
+    auto add = [&specs](const std::string& element, double radius, double mass) {
+        specs[element] = AtomicSpec(element, radius, mass);
+    };
     
     // Hydrogen
-    addAtomicSpec("H", 1.20, 1.008);
+    add("H", 1.20, 1.008);
     
     // Carbon
-    addAtomicSpec("C", 1.70, 12.011);
+    add("C", 1.70, 12.011);
     
     // Nitrogen  
-    addAtomicSpec("N", 1.55, 14.007);
+    add("N", 1.55, 14.007);
     
     // Oxygen
-    addAtomicSpec("O", 1.52, 15.999);
+    add("O", 1.52, 15.999);
     
     // Phosphorus
-    addAtomicSpec("P", 1.80, 30.974);
+    add("P", 1.80, 30.974);
     
     // Sulfur
-    addAtomicSpec("S", 1.80, 32.06);
+    add("S", 1.80, 32.06);
     
     // Additional common elements
-    addAtomicSpec("Na", 2.27, 22.990);  // Sodium
-    addAtomicSpec("Mg", 1.73, 24.305);  // Magnesium
-    addAtomicSpec("Cl", 1.75, 35.45);   // Chlorine
-    addAtomicSpec("K", 2.75, 39.098);   // Potassium
-    addAtomicSpec("Ca", 2.31, 40.078);  // Calcium
-    addAtomicSpec("Fe", 2.04, 55.845);  // Iron
-    addAtomicSpec("Zn", 2.01, 65.38);   // Zinc
-    addAtomicSpec("Cu", 1.96, 63.546);  // Copper
-    addAtomicSpec("Mn", 2.05, 54.938);  // Manganese
-    addAtomicSpec("Co", 1.92, 58.933);  // Cobalt
-    addAtomicSpec("Ni", 1.84, 58.693);  // Nickel
-    addAtomicSpec("Mo", 2.17, 95.95);   // Molybdenum
-    addAtomicSpec("Se", 1.90, 78.971);  // Selenium
-    addAtomicSpec("I", 1.98, 126.90);   // Iodine
+    add("Na", 2.27, 22.990);  // Sodium
+    add("Mg", 1.73, 24.305);  // Magnesium
+    add("Cl", 1.75, 35.45);   // Chlorine
+    add("K", 2.75, 39.098);   // Potassium
+    add("Ca", 2.31, 40.078);  // Calcium
+    add("Fe", 2.04, 55.845);  // Iron
+    add("Zn", 2.01, 65.38);   // Zinc
+    add("Cu", 1.96, 63.546);  // Copper
+    add("Mn", 2.05, 54.938);  // Manganese
+    add("Co", 1.92, 58.933);  // Cobalt
+    add("Ni", 1.84, 58.693);  // Nickel
+    add("Mo", 2.17, 95.95);   // Molybdenum
+    add("Se", 1.90, 78.971);  // Selenium
+    add("I", 1.98, 126.90);   // Iodine
+
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    publish(std::move(specs));
+}
+
+MemoryUsage AtomicSpecTable::memoryUsage() const {
+    using Node = std::unordered_map<std::string, AtomicSpec>::value_type;
+    // Hash nodes hold the value, a next pointer and the cached hash of the string key
+    const std::size_t nodeBytes = sizeof(Node) + sizeof(void*) + sizeof(std::size_t);
+    MemoryUsage usage{sizeof(*this) + specs_.size() * sizeof(Node),
+                      sizeof(*this) + specs_.size() * nodeBytes + specs_.bucket_count() * sizeof(void*)};
+    for (const auto& entry : specs_) {
+        usage += BioMesh::memoryUsage(entry.first);
+        usage += BioMesh::memoryUsage(entry.second.elementSymbol);
+    }
+    return usage;
+}
+
+MemoryUsage AtomBuilder::memoryUsage() const {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    MemoryUsage usage = current_.load(std::memory_order_relaxed)->memoryUsage();
+    for (const AtomicSpecTable* table : retired_) {
+        usage += table->memoryUsage();
+    }
+    return usage;
 }
 
 } // namespace BioMesh
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "biomesh/biomesh_c.h"
+#include "AtomBuilder.h"
+#include "biomesh/hex_mesh.h"
+#include "biomesh/linear_octree.h"
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct biomesh_mesh {
+    BioMesh::HexMesh mesh;  ///< Extracted mesh
+};
+
+namespace {
+
+using namespace BioMesh;
+
+thread_local std::string tLastError;
+
+/**
+ * @brief Failure carrying a C status
+ */
+class StatusError : public std::runtime_error {
+public:
+    StatusError(biomesh_status status, const std::string& message) : std::runtime_error(message), status_(status) {}
+    biomesh_status getStatus() const { return status_; }
+
+private:
+    biomesh_status status_;
+};
+
+// Run body, translating exceptions to a status and the thread's error message
+template <typename Body>
+biomesh_status guarded(Body&& body) noexcept {
+    try {
+        body();
+        tLastError.clear();
+        return BIOMESH_OK;
+    } catch (const StatusError& error) {
+        tLastError = error.what();
+        return error.getStatus();
+    } catch (const std::invalid_argument& error) {
+        tLastError = error.what();
+        return BIOMESH_ERROR_INVALID_ARGUMENT;
+    } catch (const std::out_of_range& error) {
+        tLastError = error.what();
+        return BIOMESH_ERROR_OUT_OF_RANGE;
+    } catch (const std::bad_alloc&) {
+        tLastError = "Out of memory";
+        return BIOMESH_ERROR_OUT_OF_MEMORY;
+    } catch (const std::exception& error) {
+        tLastError = error.what();
+        return BIOMESH_ERROR_INTERNAL;
+    } catch (...) {
+        tLastError = "Unknown error";
+        return BIOMESH_ERROR_INTERNAL;
+    }
+}
+
+void require(bool condition, const char* message) {
+    if (!condition) {
+        throw StatusError(BIOMESH_ERROR_INVALID_ARGUMENT, message);
+    }
+}
+
+CoordinateView coordinatesOf(const biomesh_atoms* atoms) {
+    require(atoms != nullptr, "atoms is NULL");
+    return CoordinateView(atoms->x, atoms->y, atoms->z, atoms->count, atoms->coordinate_stride);
+}
+
+/**
+ * @brief Build atoms with radius and mass assigned, reading caller memory in place
+ */
+std::vector<Atom> readAtoms(const biomesh_atoms* atoms) {
+    const CoordinateView coordinates = coordinatesOf(atoms);
+    const StridedView<std::int32_t> elementIds(atoms->element_ids, atoms->count, atoms->element_id_stride);
+    require(atoms->element_symbol_count == 0 || atoms->element_symbols, "element_symbols is NULL");
+    std::vector<std::string> symbols;
+    symbols.reserve(atoms->element_symbol_count);
+    for (std::size_t i = 0; i < atoms->element_symbol_count; ++i) {
+        require(atoms->element_symbols[i] != nullptr, "element symbol is NULL");
+        symbols.emplace_back(atoms->element_symbols[i]);
+    }
+
+    try {
+        return AtomBuilder().buildAtoms(coordinates, elementIds, symbols, atoms->element_id_base);
+    } catch (const std::out_of_range& error) {
+        throw StatusError(BIOMESH_ERROR_UNKNOWN_ELEMENT, error.what());
+    } catch (const std::runtime_error& error) {
+        throw StatusError(BIOMESH_ERROR_UNKNOWN_ELEMENT, error.what());
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+int biomesh_abi_version(void) {
+    return BIOMESH_C_ABI_VERSION;
+}
+
+const char* biomesh_last_error(void) {
+    return tLastError.c_str();
+}
+
+void biomesh_params_init(biomesh_params* params) {
+    if (params == nullptr) {
+        return;
+    }
+    std::memset(params, 0, sizeof(*params));
+    params->max_level = 10;
+    params->max_atoms_per_leaf = 8;
+    params->balance = 1;
+}
+
+biomesh_status biomesh_bounds(const biomesh_atoms* atoms, double bounds[6]) {
+    return guarded([&]() {
+        const CoordinateView points = coordinatesOf(atoms);
+        require(bounds != nullptr, "bounds is NULL");
+        BoundingBox box;
+        box.calculateFromPoints(points);
+        const double values[6] = {box.getMinX(), box.getMinY(), box.getMinZ(),
+                                  box.getMaxX(), box.getMaxY(), box.getMaxZ()};
+        std::memcpy(bounds, values, sizeof(values));
+    });
+}
+
+biomesh_status biomesh_mesh_create(const biomesh_atoms* atoms, const biomesh_params* params, biomesh_mesh** mesh) {
+    if (mesh != nullptr) {
+        *mesh = nullptr;
+    }
+    return guarded([&]() {
+        require(mesh != nullptr, "mesh is NULL");
+        biomesh_params defaults;
+        biomesh_params_init(&defaults);
+        const biomesh_params& p = params ? *params : defaults;
+        require(p.max_atoms_per_leaf > 0, "max_atoms_per_leaf must be positive");
+
+        const std::vector<Atom> input = readAtoms(atoms);
+        BoundingBox root;
+        if (p.has_root) {
+            root = BoundingBox(p.root[0], p.root[1], p.root[2], p.root[3], p.root[4], p.root[5]);
+        } else {
+            root.calculateFromAtoms(input);
+            root.expand(1.0);
+        }
+
+        LinearOctree tree(root, p.max_level, p.max_atoms_per_leaf);
+        tree.build(input);
+        if (p.balance) {
+            tree.balance();
+        }
+        auto result = std::make_unique<biomesh_mesh>();
+        result->mesh = HexMeshExtractor(p.threads).extract(tree, p.occupied_leaves_only != 0);
+        *mesh = result.release();
+    });
+}
+
+biomesh_status biomesh_mesh_get_sizes(const biomesh_mesh* mesh, size_t* vertex_count, size_t* hex_count) {
+    return guarded([&]() {
+        require(mesh != nullptr, "mesh is NULL");
+        if (vertex_count != nullptr) {
+            *vertex_count = mesh->mesh.getVertexCount();
+        }
+        if (hex_count != nullptr) {
+            *hex_count = mesh->mesh.getHexCount();
+        }
+    });
+}
+
+biomesh_status biomesh_mesh_copy(const biomesh_mesh* mesh, double* vertices, size_t vertex_capacity,
+                                 int32_t* hexahedra, size_t hex_capacity, int32_t index_base, uint8_t* levels) {
+    return guarded([&]() {
+        require(mesh != nullptr, "mesh is NULL");
+        const HexMesh& source = mesh->mesh;
+        if ((vertices != nullptr && vertex_capacity < source.getVertexCount()) ||
+            ((hexahedra != nullptr || levels != nullptr) && hex_capacity < source.getHexCount())) {
+            throw StatusError(BIOMESH_ERROR_BUFFER_TOO_SMALL, "Output buffer smaller than the mesh; query sizes first");
+        }
+        if (hexahedra != nullptr && source.getVertexCount() > 0 &&
+            static_cast<std::int64_t>(source.getVertexCount() - 1) + index_base >
+                std::numeric_limits<std::int32_t>::max()) {
+            throw StatusError(BIOMESH_ERROR_OUT_OF_RANGE, "Vertex IDs do not fit in int32");
+        }
+
+        if (vertices != nullptr && !source.vertices.empty()) {
+            std::memcpy(vertices, source.vertices.data(), source.vertices.size() * sizeof(source.vertices[0]));
+        }
+        if (hexahedra != nullptr) {
+            for (std::size_t h = 0; h < source.hexahedra.size(); ++h) {
+                for (std::size_t c = 0; c < 8; ++c) {
+                    hexahedra[8 * h + c] = static_cast<std::int32_t>(source.hexahedra[h][c]) + index_base;
+                }
+            }
+        }
+        if (levels != nullptr && !source.levels.empty()) {
+            std::memcpy(levels, source.levels.data(), source.levels.size());
+        }
+    });
+}
+
+void biomesh_mesh_free(biomesh_mesh* mesh) {
+    delete mesh;
+}
+
+} // extern "C"
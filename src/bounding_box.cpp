@@ -1,4 +1,5 @@
 #include "biomesh/bounding_box.h"
+#include "biomesh/trace.h"
 #include <stdexcept>
 #include <cmath>
 #include <algorithm>
@@ -36,6 +37,7 @@ void BoundingBox::addPoint(double x, double y, double z) {
 }
 
 void BoundingBox::calculateFromAtoms(const std::vector<Atom>& atoms) {
+    BIOMESH_TRACE_SCOPE("BoundingBox::calculateFromAtoms");
     reset();
     
     for (const auto& atom : atoms) {
@@ -43,6 +45,25 @@ void BoundingBox::calculateFromAtoms(const std::vector<Atom>& atoms) {
     }
 }
 
+void BoundingBox::calculateFromAtoms(const std::vector<Atom>& atoms, const std::vector<std::uint32_t>& selection) {
+    BIOMESH_TRACE_SCOPE("BoundingBox::calculateFromAtoms");
+    reset();
+
+    for (std::uint32_t i : selection) {
+        const Atom& atom = atoms.at(i);
+        addPoint(atom.getX(), atom.getY(), atom.getZ());
+    }
+}
+
+void BoundingBox::calculateFromPoints(const CoordinateView& points) {
+    BIOMESH_TRACE_SCOPE("BoundingBox::calculateFromPoints");
+    reset();
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        addPoint(points.x(i), points.y(i), points.z(i));
+    }
+}
+
 double BoundingBox::getWidth() const {
     if (isEmpty()) {
         return 0.0;
@@ -171,6 +192,16 @@ std::array<BoundingBox, 8> BoundingBox::subdivide() const {
     return octants;
 }
 
+int BoundingBox::getOctantIndex(double x, double y, double z) const {
+    if (isEmpty()) {
+        return 0;
+    }
+    // Same bit layout as subdivide(): X is the high bit, Z the low bit
+    return (x >= (minX_ + maxX_) * 0.5 ? 4 : 0) |
+           (y >= (minY_ + maxY_) * 0.5 ? 2 : 0) |
+           (z >= (minZ_ + maxZ_) * 0.5 ? 1 : 0);
+}
+
 void BoundingBox::initializeEmpty() {
     // Initialize to an invalid state where min > max to indicate empty
     minX_ = minY_ = minZ_ = std::numeric_limits<double>::max();
@@ -0,0 +1,268 @@
+#include "biomesh/communicator.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace BioMesh {
+
+std::vector<Communicator::Buffer> Communicator::allGather(const Buffer& buffer) {
+    return allToAll(std::vector<Buffer>(static_cast<std::size_t>(getSize()), buffer));
+}
+
+std::uint64_t Communicator::allReduceSum(std::uint64_t value) {
+    Buffer buffer(sizeof(value));
+    std::memcpy(buffer.data(), &value, sizeof(value));
+
+    std::uint64_t sum = 0;
+    for (const auto& received : allGather(buffer)) {
+        std::uint64_t contribution = 0;
+        std::memcpy(&contribution, received.data(), sizeof(contribution));
+        sum += contribution;
+    }
+    return sum;
+}
+
+struct SharedMemoryCommunicator::ControlBlock {
+    pthread_barrier_t barrier;      ///< Process-shared barrier across all ranks
+    std::atomic<int> overflow;      ///< Set when a message did not fit its mailbox
+};
+
+namespace {
+
+constexpr std::size_t kLengthWord = sizeof(std::uint64_t);
+
+std::size_t alignedMailbox(std::size_t mailboxBytes) {
+    return (mailboxBytes + 7) / 8 * 8;
+}
+
+std::size_t controlBytes() {
+    return (sizeof(pthread_barrier_t) + sizeof(std::atomic<int>) + 63) / 64 * 64;
+}
+
+} // namespace
+
+SharedMemoryCommunicator::SharedMemoryCommunicator(int rank, int size, std::size_t mailboxBytes, void* base)
+    : rank_(rank), size_(size), mailboxBytes_(mailboxBytes),
+      control_(static_cast<ControlBlock*>(base)),
+      mailboxes_(static_cast<std::uint8_t*>(base) + controlBytes()) {
+}
+
+std::uint8_t* SharedMemoryCommunicator::mailbox(int source, int destination) const {
+    std::size_t slot = static_cast<std::size_t>(source) * static_cast<std::size_t>(size_) +
+                       static_cast<std::size_t>(destination);
+    return mailboxes_ + slot * (kLengthWord + mailboxBytes_);
+}
+
+std::vector<Communicator::Buffer> SharedMemoryCommunicator::allToAll(const std::vector<Buffer>& sendBuffers) {
+    if (sendBuffers.size() != static_cast<std::size_t>(size_)) {
+        throw std::invalid_argument("allToAll requires one send buffer per rank");
+    }
+
+    // Wait until every rank has finished reading the previous exchange
+    barrier();
+
+    for (int destination = 0; destination < size_; ++destination) {
+        const Buffer& message = sendBuffers[static_cast<std::size_t>(destination)];
+        std::uint8_t* slot = mailbox(rank_, destination);
+        std::uint64_t length = 0;
+        if (message.size() > mailboxBytes_) {
+            control_->overflow.store(1);
+        } else {
+            length = message.size();
+            if (length > 0) {
+                std::memcpy(slot + kLengthWord, message.data(), message.size());
+            }
+        }
+        std::memcpy(slot, &length, sizeof(length));
+    }
+
+    barrier();
+
+    // Every rank observes the flag after the same barrier, so all of them throw together
+    if (control_->overflow.load() != 0) {
+        throw std::runtime_error("allToAll message exceeds the shared memory mailbox capacity of " +
+                                 std::to_string(mailboxBytes_) + " bytes");
+    }
+
+    std::vector<Buffer> received(static_cast<std::size_t>(size_));
+    for (int source = 0; source < size_; ++source) {
+        const std::uint8_t* slot = mailbox(source, rank_);
+        std::uint64_t length = 0;
+        std::memcpy(&length, slot, sizeof(length));
+        received[static_cast<std::size_t>(source)].assign(slot + kLengthWord, slot + kLengthWord + length);
+    }
+    return received;
+}
+
+void SharedMemoryCommunicator::barrier() {
+    pthread_barrier_wait(&control_->barrier);
+}
+
+std::vector<Communicator::Buffer> SharedMemoryCommunicator::launch(int ranks, std::size_t mailboxBytes,
+                                                                   const RankBody& body) {
+    if (ranks <= 0) {
+        throw std::invalid_argument("SharedMemoryCommunicator requires at least one rank");
+    }
+
+    const std::size_t mailbox = alignedMailbox(mailboxBytes);
+    const std::size_t slotBytes = kLengthWord + mailbox;
+    const std::size_t rankCount = static_cast<std::size_t>(ranks);
+    const std::size_t mailboxRegion = rankCount * rankCount * slotBytes;
+    SharedMemorySegment segment(controlBytes() + mailboxRegion + rankCount * slotBytes);
+
+    auto* base = static_cast<std::uint8_t*>(segment.getData());
+    auto* control = new (base) ControlBlock;
+    control->overflow.store(0);
+
+    pthread_barrierattr_t attributes;
+    pthread_barrierattr_init(&attributes);
+    pthread_barrierattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(&control->barrier, &attributes, static_cast<unsigned>(ranks));
+    pthread_barrierattr_destroy(&attributes);
+
+    std::uint8_t* results = base + controlBytes() + mailboxRegion;
+
+    std::vector<pid_t> pids;
+    bool forkFailed = false;
+    for (int rank = 0; rank < ranks; ++rank) {
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            forkFailed = true;
+            break;
+        }
+        if (pid == 0) {
+            int exitCode = 0;
+            try {
+                SharedMemoryCommunicator communicator(rank, ranks, mailbox, base);
+                Buffer result = body(communicator);
+                if (result.size() > mailbox) {
+                    exitCode = 2;
+                } else {
+                    std::uint8_t* slot = results + static_cast<std::size_t>(rank) * slotBytes;
+                    std::uint64_t length = result.size();
+                    std::memcpy(slot, &length, sizeof(length));
+                    if (length > 0) {
+                        std::memcpy(slot + kLengthWord, result.data(), result.size());
+                    }
+                }
+            } catch (...) {
+                exitCode = 1;
+            }
+            ::_exit(exitCode);
+        }
+        pids.push_back(pid);
+    }
+
+    // Poll rather than block in rank order: a failed rank must not leave us waiting on
+    // peers that are stuck in a barrier it will never reach
+    std::vector<bool> finished(pids.size(), false);
+    std::size_t remaining = pids.size();
+    bool failed = forkFailed;
+    while (remaining > 0) {
+        bool progressed = false;
+        for (std::size_t i = 0; i < pids.size(); ++i) {
+            if (finished[i]) {
+                continue;
+            }
+            int status = 0;
+            pid_t result = ::waitpid(pids[i], &status, WNOHANG);
+            if (result == 0) {
+                continue;
+            }
+            finished[i] = true;
+            --remaining;
+            progressed = true;
+            if (result < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                failed = true;
+            }
+        }
+        if (failed) {
+            for (std::size_t i = 0; i < pids.size(); ++i) {
+                if (!finished[i]) {
+                    ::kill(pids[i], SIGKILL);
+                }
+            }
+        }
+        if (!progressed && remaining > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Killed ranks can leave waiters recorded in the barrier, and destroying it then
+    // blocks; the segment is discarded anyway, so only tear it down after a clean run
+    if (!failed) {
+        pthread_barrier_destroy(&control->barrier);
+        control->~ControlBlock();
+    }
+
+    if (forkFailed) {
+        throw std::runtime_error("Failed to start shared memory rank process");
+    }
+    if (failed) {
+        throw std::runtime_error("A shared memory rank process failed");
+    }
+
+    std::vector<Buffer> output(rankCount);
+    for (std::size_t rank = 0; rank < rankCount; ++rank) {
+        const std::uint8_t* slot = results + rank * slotBytes;
+        std::uint64_t length = 0;
+        std::memcpy(&length, slot, sizeof(length));
+        output[rank].assign(slot + kLengthWord, slot + kLengthWord + length);
+    }
+    return output;
+}
+
+#ifdef BIOMESH_HAVE_MPI
+MpiCommunicator::MpiCommunicator(MPI_Comm comm) : comm_(comm), rank_(0), size_(1) {
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &size_);
+}
+
+std::vector<Communicator::Buffer> MpiCommunicator::allToAll(const std::vector<Buffer>& sendBuffers) {
+    if (sendBuffers.size() != static_cast<std::size_t>(size_)) {
+        throw std::invalid_argument("allToAll requires one send buffer per rank");
+    }
+
+    const std::size_t ranks = static_cast<std::size_t>(size_);
+    std::vector<int> sendCounts(ranks), sendOffsets(ranks), receiveCounts(ranks), receiveOffsets(ranks);
+    Buffer sendData;
+    for (std::size_t rank = 0; rank < ranks; ++rank) {
+        sendCounts[rank] = static_cast<int>(sendBuffers[rank].size());
+        sendOffsets[rank] = static_cast<int>(sendData.size());
+        sendData.insert(sendData.end(), sendBuffers[rank].begin(), sendBuffers[rank].end());
+    }
+
+    MPI_Alltoall(sendCounts.data(), 1, MPI_INT, receiveCounts.data(), 1, MPI_INT, comm_);
+
+    int receiveTotal = 0;
+    for (std::size_t rank = 0; rank < ranks; ++rank) {
+        receiveOffsets[rank] = receiveTotal;
+        receiveTotal += receiveCounts[rank];
+    }
+    Buffer receiveData(static_cast<std::size_t>(receiveTotal));
+
+    MPI_Alltoallv(sendData.data(), sendCounts.data(), sendOffsets.data(), MPI_BYTE,
+                  receiveData.data(), receiveCounts.data(), receiveOffsets.data(), MPI_BYTE, comm_);
+
+    std::vector<Buffer> received(ranks);
+    for (std::size_t rank = 0; rank < ranks; ++rank) {
+        auto begin = receiveData.begin() + receiveOffsets[rank];
+        received[rank].assign(begin, begin + receiveCounts[rank]);
+    }
+    return received;
+}
+
+void MpiCommunicator::barrier() {
+    MPI_Barrier(comm_);
+}
+#endif
+
+} // namespace BioMesh
@@ -0,0 +1,222 @@
+#include "biomesh/distributed_octree.h"
+#include "biomesh/mesh_stats.h"
+#include "biomesh/trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace BioMesh {
+
+namespace {
+
+constexpr std::size_t kSamplesPerRank = 64;
+
+template <typename T>
+void appendValue(Communicator::Buffer& buffer, const T& value) {
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+T readValue(const std::uint8_t*& cursor) {
+    T value;
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return value;
+}
+
+void appendAtom(Communicator::Buffer& buffer, const Atom& atom) {
+    appendValue(buffer, atom.getX());
+    appendValue(buffer, atom.getY());
+    appendValue(buffer, atom.getZ());
+    appendValue(buffer, atom.getAtomicRadius());
+    appendValue(buffer, atom.getAtomicMass());
+    const std::string& element = atom.getChemicalElement();
+    appendValue(buffer, static_cast<std::uint32_t>(element.size()));
+    buffer.insert(buffer.end(), element.begin(), element.end());
+}
+
+Atom readAtom(const std::uint8_t*& cursor) {
+    double x = readValue<double>(cursor);
+    double y = readValue<double>(cursor);
+    double z = readValue<double>(cursor);
+    double radius = readValue<double>(cursor);
+    double mass = readValue<double>(cursor);
+    auto length = readValue<std::uint32_t>(cursor);
+    std::string element(reinterpret_cast<const char*>(cursor), length);
+    cursor += length;
+
+    Atom atom(x, y, z, element);
+    atom.setAtomicRadius(radius);
+    atom.setAtomicMass(mass);
+    return atom;
+}
+
+} // namespace
+
+DistributedOctree::DistributedOctree(Communicator& communicator, const BoundingBox& root,
+                                     unsigned maxLevel, std::size_t maxAtomsPerLeaf)
+    : communicator_(communicator), tree_(root, maxLevel, maxAtomsPerLeaf) {
+}
+
+void DistributedOctree::build(const std::vector<Atom>& localAtoms) {
+    BIOMESH_TRACE_SCOPE("DistributedOctree::build");
+    const MortonEncoder& encoder = tree_.getEncoder();
+    std::vector<std::uint64_t> keys;
+    keys.reserve(localAtoms.size());
+    for (std::size_t i = 0; i < localAtoms.size(); ++i) {
+        const Atom& atom = localAtoms[i];
+        if (!encoder.getRootBox().contains(atom)) {
+            throw std::out_of_range("Atom " + std::to_string(i) + " lies outside the octree root box");
+        }
+        keys.push_back(encoder.encode(atom.getX(), atom.getY(), atom.getZ()));
+    }
+
+    chooseSplitters(keys);
+
+    std::vector<Communicator::Buffer> outgoing(static_cast<std::size_t>(communicator_.getSize()));
+    for (std::size_t i = 0; i < localAtoms.size(); ++i) {
+        appendAtom(outgoing[static_cast<std::size_t>(getOwner(keys[i]))], localAtoms[i]);
+    }
+
+    localAtoms_.clear();
+    {
+        BIOMESH_TRACE_SCOPE("DistributedOctree::exchangeAtoms");
+        for (const auto& buffer : communicator_.allToAll(outgoing)) {
+            const std::uint8_t* cursor = buffer.data();
+            const std::uint8_t* end = cursor + buffer.size();
+            while (cursor < end) {
+                localAtoms_.push_back(readAtom(cursor));
+            }
+        }
+    }
+
+    const std::size_t rank = static_cast<std::size_t>(communicator_.getRank());
+    tree_.build(localAtoms_, splitters_[rank], splitters_[rank + 1]);
+}
+
+std::size_t DistributedOctree::balance() {
+    BIOMESH_TRACE_SCOPE("DistributedOctree::balance");
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t ranks = static_cast<std::size_t>(communicator_.getSize());
+    const int rank = communicator_.getRank();
+    std::size_t totalSplits = 0;
+
+    while (true) {
+        std::vector<SplitRequest> local;
+        std::vector<Communicator::Buffer> outgoing(ranks);
+        for (const auto& request : tree_.collectBalanceRequests()) {
+            int owner = getOwner(request.key);
+            if (owner == rank) {
+                local.push_back(request);
+            } else {
+                appendValue(outgoing[static_cast<std::size_t>(owner)], request.key);
+                appendValue(outgoing[static_cast<std::size_t>(owner)], request.minLevel);
+            }
+        }
+
+        for (const auto& buffer : communicator_.allToAll(outgoing)) {
+            const std::uint8_t* cursor = buffer.data();
+            const std::uint8_t* end = cursor + buffer.size();
+            while (cursor < end) {
+                SplitRequest request;
+                request.key = readValue<std::uint64_t>(cursor);
+                request.minLevel = readValue<std::uint8_t>(cursor);
+                local.push_back(request);
+            }
+        }
+
+        std::uint64_t splits = communicator_.allReduceSum(tree_.applySplitRequests(local));
+        if (splits == 0) {
+            break;
+        }
+        totalSplits += static_cast<std::size_t>(splits);
+    }
+
+    if (MeshStatistics* statistics = tree_.getStatistics()) {
+        statistics->balanceSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return totalSplits;
+}
+
+std::uint64_t DistributedOctree::getGlobalLeafCount() {
+    return communicator_.allReduceSum(tree_.getLeaves().size());
+}
+
+BoundingBox DistributedOctree::reduceBounds(Communicator& communicator, const std::vector<Atom>& localAtoms) {
+    BoundingBox local;
+    local.calculateFromAtoms(localAtoms);
+
+    Communicator::Buffer buffer;
+    appendValue(buffer, static_cast<std::uint8_t>(local.isEmpty() ? 0 : 1));
+    appendValue(buffer, local.getMinX());
+    appendValue(buffer, local.getMinY());
+    appendValue(buffer, local.getMinZ());
+    appendValue(buffer, local.getMaxX());
+    appendValue(buffer, local.getMaxY());
+    appendValue(buffer, local.getMaxZ());
+
+    BoundingBox global;
+    for (const auto& received : communicator.allGather(buffer)) {
+        const std::uint8_t* cursor = received.data();
+        if (readValue<std::uint8_t>(cursor) == 0) {
+            continue;
+        }
+        double minX = readValue<double>(cursor);
+        double minY = readValue<double>(cursor);
+        double minZ = readValue<double>(cursor);
+        double maxX = readValue<double>(cursor);
+        double maxY = readValue<double>(cursor);
+        double maxZ = readValue<double>(cursor);
+        global.addPoint(minX, minY, minZ);
+        global.addPoint(maxX, maxY, maxZ);
+    }
+    return global;
+}
+
+int DistributedOctree::getOwner(std::uint64_t key) const {
+    auto it = std::upper_bound(splitters_.begin(), splitters_.end(), key);
+    int owner = static_cast<int>(it - splitters_.begin()) - 1;
+    return std::min(std::max(owner, 0), communicator_.getSize() - 1);
+}
+
+void DistributedOctree::chooseSplitters(std::vector<std::uint64_t> localKeys) {
+    const std::size_t ranks = static_cast<std::size_t>(communicator_.getSize());
+    std::sort(localKeys.begin(), localKeys.end());
+
+    // Regular sampling with a global stride so every rank contributes in proportion to its atoms
+    const std::uint64_t globalCount = communicator_.allReduceSum(localKeys.size());
+    const std::size_t stride = std::max<std::size_t>(1, static_cast<std::size_t>(globalCount / (kSamplesPerRank * ranks)));
+
+    Communicator::Buffer samples;
+    for (std::size_t i = stride / 2; i < localKeys.size(); i += stride) {
+        appendValue(samples, localKeys[i]);
+    }
+
+    std::vector<std::uint64_t> allSamples;
+    for (const auto& buffer : communicator_.allGather(samples)) {
+        const std::uint8_t* cursor = buffer.data();
+        const std::uint8_t* end = cursor + buffer.size();
+        while (cursor < end) {
+            allSamples.push_back(readValue<std::uint64_t>(cursor));
+        }
+    }
+    std::sort(allSamples.begin(), allSamples.end());
+
+    // Splitters are aligned to finest-level cells so no leaf straddles two ranks
+    const std::uint64_t cellSpan = mortonSpan(tree_.getMaxLevel());
+    splitters_.assign(ranks + 1, kMortonKeyEnd);
+    splitters_[0] = 0;
+    for (std::size_t r = 1; r < ranks && !allSamples.empty(); ++r) {
+        std::uint64_t sample = allSamples[r * allSamples.size() / ranks];
+        splitters_[r] = std::max(splitters_[r - 1], sample / cellSpan * cellSpan);
+    }
+}
+
+MemoryUsage DistributedOctree::memoryUsage() const {
+    return tree_.memoryUsage() + BioMesh::memoryUsage(localAtoms_) + BioMesh::memoryUsage(splitters_);
+}
+
+} // namespace BioMesh
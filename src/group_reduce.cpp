@@ -0,0 +1,261 @@
+#include "biomesh/group_reduce.h"
+#include "biomesh/metrics.h"
+#include "biomesh/trace.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace BioMesh {
+
+namespace {
+
+constexpr std::size_t kLanes = 4;
+
+/**
+ * @brief Running sums of one group, or of the part of it inside one chunk
+ */
+struct Accumulator {
+    double low[3] = {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(),
+                     std::numeric_limits<double>::infinity()};
+    double high[3] = {-std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+                      -std::numeric_limits<double>::infinity()};
+    double mass = 0.0;
+    double weighted[3] = {0.0, 0.0, 0.0};   ///< Sum of mass * coordinate
+    double sum[3] = {0.0, 0.0, 0.0};        ///< Sum of coordinates, for massless groups
+    std::uint32_t count = 0;
+
+    void merge(const Accumulator& other) {
+        for (int d = 0; d < 3; ++d) {
+            low[d] = std::min(low[d], other.low[d]);
+            high[d] = std::max(high[d], other.high[d]);
+            weighted[d] += other.weighted[d];
+            sum[d] += other.sum[d];
+        }
+        mass += other.mass;
+        count += other.count;
+    }
+};
+
+struct ColumnSource {
+    const double* x;
+    const double* y;
+    const double* z;
+    const double* mass;
+
+    double getX(std::size_t i) const { return x[i]; }
+    double getY(std::size_t i) const { return y[i]; }
+    double getZ(std::size_t i) const { return z[i]; }
+    double getMass(std::size_t i) const { return mass[i]; }
+};
+
+struct AtomSource {
+    const Atom* atoms;
+
+    double getX(std::size_t i) const { return atoms[i].getX(); }
+    double getY(std::size_t i) const { return atoms[i].getY(); }
+    double getZ(std::size_t i) const { return atoms[i].getZ(); }
+    double getMass(std::size_t i) const { return atoms[i].getAtomicMass(); }
+};
+
+template <typename Source>
+void add(Accumulator& sums, const Source& source, std::size_t i) {
+    const double p[3] = {source.getX(i), source.getY(i), source.getZ(i)};
+    const double m = source.getMass(i);
+    for (int d = 0; d < 3; ++d) {
+        sums.low[d] = p[d] < sums.low[d] ? p[d] : sums.low[d];
+        sums.high[d] = p[d] > sums.high[d] ? p[d] : sums.high[d];
+        sums.weighted[d] += m * p[d];
+        sums.sum[d] += p[d];
+    }
+    sums.mass += m;
+}
+
+/**
+ * @brief Reduce atoms [begin, end), with kLanes independent accumulators for long ranges
+ *
+ * Lane l takes atoms begin + l, begin + l + kLanes, ...; lanes are combined in a fixed
+ * order, so the result depends only on the range, never on the caller's threading.
+ */
+template <typename Source>
+Accumulator accumulate(const Source& source, std::size_t begin, std::size_t end) {
+    // Residue-sized ranges are too short for lanes to pay off
+    if (end - begin < 4 * kLanes) {
+        Accumulator sums;
+        for (std::size_t i = begin; i < end; ++i) {
+            add(sums, source, i);
+        }
+        sums.count = static_cast<std::uint32_t>(end - begin);
+        return sums;
+    }
+
+    Accumulator lanes[kLanes];
+    std::size_t i = begin;
+    for (; i + kLanes <= end; i += kLanes) {
+        for (std::size_t l = 0; l < kLanes; ++l) {
+            add(lanes[l], source, i + l);
+        }
+    }
+    for (std::size_t l = 0; i < end; ++i, ++l) {
+        add(lanes[l], source, i);
+    }
+
+    Accumulator result = lanes[0];
+    for (std::size_t l = 1; l < kLanes; ++l) {
+        result.merge(lanes[l]);
+    }
+    result.count = static_cast<std::uint32_t>(end - begin);
+    return result;
+}
+
+void store(GroupReduction& result, std::size_t group, const Accumulator& sums) {
+    result.atomCounts[group] = sums.count;
+    result.masses[group] = sums.mass;
+    if (sums.count == 0) {
+        return;
+    }
+    if (sums.low[0] <= sums.high[0] && sums.low[1] <= sums.high[1] && sums.low[2] <= sums.high[2]) {
+        result.bounds[group] =
+            BoundingBox(sums.low[0], sums.low[1], sums.low[2], sums.high[0], sums.high[1], sums.high[2]);
+    }
+    const bool massless = sums.mass == 0.0;
+    for (int d = 0; d < 3; ++d) {
+        result.centersOfMass[group][d] = massless ? sums.sum[d] / sums.count : sums.weighted[d] / sums.mass;
+    }
+}
+
+/**
+ * @brief Groups of a chunk that extend past it; at most the first and the last
+ */
+struct ChunkPartials {
+    std::size_t groups[2];
+    Accumulator sums[2];
+    int count = 0;
+};
+
+template <typename Source>
+GroupReduction reduceGroups(const Source& source, std::size_t atomCount, const std::vector<std::uint32_t>& offsets,
+                            unsigned threadCount, std::size_t chunkAtoms) {
+    BIOMESH_TRACE_SCOPE("GroupReducer::reduce");
+    static Histogram& reduceSeconds = stageSeconds("group_reduce");
+    static Counter& reduceAtoms = stageAtoms("group_reduce");
+    MetricsTimer metricsTimer(reduceSeconds);
+
+    if (offsets.empty()) {
+        throw std::invalid_argument("Group offsets need at least one entry");
+    }
+    for (std::size_t g = 1; g < offsets.size(); ++g) {
+        if (offsets[g] < offsets[g - 1]) {
+            throw std::invalid_argument("Group offsets must be non-decreasing (offset " + std::to_string(g) + ")");
+        }
+    }
+    if (offsets.back() > atomCount) {
+        throw std::invalid_argument("Group offsets end at atom " + std::to_string(offsets.back()) + " but there are " +
+                                    std::to_string(atomCount) + " atoms");
+    }
+
+    const std::size_t groupCount = offsets.size() - 1;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    GroupReduction result;
+    result.bounds.resize(groupCount);
+    result.masses.assign(groupCount, 0.0);
+    result.centersOfMass.assign(groupCount, {nan, nan, nan});
+    result.atomCounts.assign(groupCount, 0);
+
+    const std::size_t first = offsets.front();
+    const std::size_t last = offsets.back();
+    reduceAtoms.add(last - first);
+    const std::size_t chunkCount = (last - first + chunkAtoms - 1) / chunkAtoms;
+    std::vector<ChunkPartials> partials(chunkCount);
+
+    // Groups wholly inside a chunk are stored by the thread that reduces the chunk;
+    // no other chunk touches them
+    auto reduceChunk = [&](std::size_t chunk) {
+        const std::size_t chunkBegin = first + chunk * chunkAtoms;
+        const std::size_t chunkEnd = std::min(last, chunkBegin + chunkAtoms);
+        std::size_t group = static_cast<std::size_t>(
+            std::upper_bound(offsets.begin(), offsets.end(), chunkBegin) - offsets.begin()) - 1;
+        for (; group < groupCount && offsets[group] < chunkEnd; ++group) {
+            const std::size_t begin = std::max<std::size_t>(offsets[group], chunkBegin);
+            const std::size_t end = std::min<std::size_t>(offsets[group + 1], chunkEnd);
+            if (begin == end) {
+                continue;
+            }
+            const Accumulator sums = accumulate(source, begin, end);
+            if (begin == offsets[group] && end == offsets[group + 1]) {
+                store(result, group, sums);
+            } else {
+                ChunkPartials& chunkPartials = partials[chunk];
+                chunkPartials.groups[chunkPartials.count] = group;
+                chunkPartials.sums[chunkPartials.count] = sums;
+                ++chunkPartials.count;
+            }
+        }
+    };
+
+    const std::size_t workers = std::max<std::size_t>(1, std::min<std::size_t>(threadCount, chunkCount));
+    if (workers == 1) {
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            reduceChunk(chunk);
+        }
+    } else {
+        std::atomic<std::size_t> nextChunk{0};
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        for (std::size_t t = 0; t < workers; ++t) {
+            threads.emplace_back([&]() {
+                for (std::size_t chunk; (chunk = nextChunk.fetch_add(1, std::memory_order_relaxed)) < chunkCount;) {
+                    reduceChunk(chunk);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // Partials of one group sit in consecutive chunks; merging in chunk order keeps sums deterministic
+    std::size_t pendingGroup = groupCount;
+    Accumulator pending;
+    for (const ChunkPartials& chunkPartials : partials) {
+        for (int p = 0; p < chunkPartials.count; ++p) {
+            if (chunkPartials.groups[p] != pendingGroup) {
+                if (pendingGroup != groupCount) {
+                    store(result, pendingGroup, pending);
+                }
+                pendingGroup = chunkPartials.groups[p];
+                pending = chunkPartials.sums[p];
+            } else {
+                pending.merge(chunkPartials.sums[p]);
+            }
+        }
+    }
+    if (pendingGroup != groupCount) {
+        store(result, pendingGroup, pending);
+    }
+    return result;
+}
+
+} // namespace
+
+GroupReducer::GroupReducer(unsigned threadCount, std::size_t chunkAtoms)
+    : threadCount_(threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency())),
+      chunkAtoms_(chunkAtoms) {
+    if (chunkAtoms == 0) {
+        throw std::invalid_argument("Group reducer chunk size must be greater than zero");
+    }
+}
+
+GroupReduction GroupReducer::reduce(const AtomColumns& columns, const std::vector<std::uint32_t>& offsets) const {
+    const ColumnSource source{columns.x.data(), columns.y.data(), columns.z.data(), columns.mass.data()};
+    return reduceGroups(source, columns.size(), offsets, threadCount_, chunkAtoms_);
+}
+
+GroupReduction GroupReducer::reduce(const std::vector<Atom>& atoms, const std::vector<std::uint32_t>& offsets) const {
+    const AtomSource source{atoms.data()};
+    return reduceGroups(source, atoms.size(), offsets, threadCount_, chunkAtoms_);
+}
+
+} // namespace BioMesh
@@ -0,0 +1,129 @@
+#include "biomesh/hash.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace BioMesh {
+
+namespace {
+
+constexpr std::uint64_t kC1 = 0x87c37b91114253d5ULL;
+constexpr std::uint64_t kC2 = 0x4cf5ad432745937fULL;
+
+inline std::uint64_t rotl(std::uint64_t value, int shift) {
+    return (value << shift) | (value >> (64 - shift));
+}
+
+inline std::uint64_t fmix(std::uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+// Blocks are read as little-endian words, as in the reference implementation on x86-64
+inline std::uint64_t loadWord(const std::uint8_t* bytes) {
+    std::uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+} // namespace
+
+std::string Hash128::toHex() const {
+    char text[33];
+    std::snprintf(text, sizeof(text), "%016llx%016llx", static_cast<unsigned long long>(low),
+                  static_cast<unsigned long long>(high));
+    return text;
+}
+
+void MurmurHash3::processBlock(const std::uint8_t* block) {
+    std::uint64_t k1 = loadWord(block);
+    std::uint64_t k2 = loadWord(block + 8);
+
+    k1 *= kC1;
+    k1 = rotl(k1, 31);
+    k1 *= kC2;
+    h1_ ^= k1;
+    h1_ = rotl(h1_, 27);
+    h1_ += h2_;
+    h1_ = h1_ * 5 + 0x52dce729;
+
+    k2 *= kC2;
+    k2 = rotl(k2, 33);
+    k2 *= kC1;
+    h2_ ^= k2;
+    h2_ = rotl(h2_, 31);
+    h2_ += h1_;
+    h2_ = h2_ * 5 + 0x38495ab5;
+}
+
+void MurmurHash3::update(const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    length_ += size;
+
+    if (tailSize_ > 0) {
+        const std::size_t take = std::min(size, sizeof(tail_) - tailSize_);
+        std::memcpy(tail_ + tailSize_, bytes, take);
+        tailSize_ += take;
+        bytes += take;
+        size -= take;
+        if (tailSize_ < sizeof(tail_)) {
+            return;
+        }
+        processBlock(tail_);
+        tailSize_ = 0;
+    }
+
+    for (; size >= 16; bytes += 16, size -= 16) {
+        processBlock(bytes);
+    }
+    std::memcpy(tail_, bytes, size);
+    tailSize_ = size;
+}
+
+Hash128 MurmurHash3::finish() const {
+    std::uint64_t h1 = h1_;
+    std::uint64_t h2 = h2_;
+    std::uint64_t k1 = 0;
+    std::uint64_t k2 = 0;
+
+    for (std::size_t i = tailSize_; i > 8; --i) {
+        k2 ^= static_cast<std::uint64_t>(tail_[i - 1]) << (8 * (i - 9));
+    }
+    if (tailSize_ > 8) {
+        k2 *= kC2;
+        k2 = rotl(k2, 33);
+        k2 *= kC1;
+        h2 ^= k2;
+    }
+    for (std::size_t i = std::min<std::size_t>(tailSize_, 8); i > 0; --i) {
+        k1 ^= static_cast<std::uint64_t>(tail_[i - 1]) << (8 * (i - 1));
+    }
+    if (tailSize_ > 0) {
+        k1 *= kC1;
+        k1 = rotl(k1, 31);
+        k1 *= kC2;
+        h1 ^= k1;
+    }
+
+    h1 ^= length_;
+    h2 ^= length_;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix(h1);
+    h2 = fmix(h2);
+    h1 += h2;
+    h2 += h1;
+    return Hash128{h1, h2};
+}
+
+Hash128 MurmurHash3::hash(const void* data, std::size_t size, std::uint64_t seed) {
+    MurmurHash3 hasher(seed);
+    hasher.update(data, size);
+    return hasher.finish();
+}
+
+} // namespace BioMesh
@@ -0,0 +1,188 @@
+#include "biomesh/hex_mesh.h"
+#include "biomesh/mesh_stats.h"
+#include "biomesh/metrics.h"
+#include "biomesh/task_graph.h"
+#include "biomesh/trace.h"
+#include "biomesh/vertex_table.h"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace BioMesh {
+
+namespace {
+
+// Corner offsets in VTK_HEXAHEDRON order
+constexpr std::uint32_t kCornerOffsets[8][3] = {
+    {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+    {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1},
+};
+
+/**
+ * @brief Run body(begin, end) over contiguous blocks of [0, count) on up to threadCount threads
+ *
+ * With a scheduler the blocks run on its persistent workers; otherwise a thread is
+ * started per block.
+ * @note Rethrows the first exception raised by any block after all threads have joined
+ */
+template <typename Body>
+void parallelBlocks(unsigned threadCount, TaskScheduler* scheduler, std::size_t count, const Body& body) {
+    const std::size_t blocks = std::max<std::size_t>(1, std::min<std::size_t>(threadCount, count));
+    if (blocks == 1) {
+        body(std::size_t{0}, count);
+        return;
+    }
+    if (scheduler) {
+        scheduler->parallelFor(blocks, [&](std::size_t block) {
+            body(count * block / blocks, count * (block + 1) / blocks);
+        });
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(blocks);
+    std::vector<std::thread> threads;
+    threads.reserve(blocks);
+    for (std::size_t block = 0; block < blocks; ++block) {
+        const std::size_t begin = count * block / blocks;
+        const std::size_t end = count * (block + 1) / blocks;
+        threads.emplace_back([&, block, begin, end]() {
+            try {
+                body(begin, end);
+            } catch (...) {
+                errors[block] = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+/**
+ * @brief Charges the time since construction (or the previous lap) to a statistics field
+ * @note Does nothing when no statistics receiver is attached
+ */
+class PhaseTimer {
+public:
+    explicit PhaseTimer(MeshStatistics* statistics) : statistics_(statistics) {
+        if (statistics_) {
+            last_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    void lap(double MeshStatistics::*field) {
+        if (!statistics_) {
+            return;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        statistics_->*field += std::chrono::duration<double>(now - last_).count();
+        last_ = now;
+    }
+
+private:
+    MeshStatistics* statistics_;
+    std::chrono::steady_clock::time_point last_;
+};
+
+} // namespace
+
+HexMeshExtractor::HexMeshExtractor(unsigned threadCount)
+    : threadCount_(threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency())) {
+}
+
+HexMesh HexMeshExtractor::extract(const LinearOctree& tree, bool occupiedLeavesOnly) const {
+    BIOMESH_TRACE_SCOPE("HexMeshExtractor::extract");
+    static Histogram& extractSeconds = stageSeconds("extract");
+    MetricsTimer metricsTimer(extractSeconds);
+    PhaseTimer timer(statistics_);
+    const auto& leaves = tree.getLeaves();
+    std::vector<std::size_t> cells;
+    cells.reserve(leaves.size());
+    for (std::size_t i = 0; i < leaves.size(); ++i) {
+        if (!occupiedLeavesOnly || leaves[i].atomCount > 0) {
+            cells.push_back(i);
+        }
+    }
+
+    HexMesh mesh;
+    mesh.hexahedra.resize(cells.size());
+    mesh.levels.resize(cells.size());
+
+    auto insertCorners = [&](ConcurrentVertexTable& table) {
+        parallelBlocks(threadCount_, scheduler_, cells.size(), [&](std::size_t begin, std::size_t end) {
+            BIOMESH_TRACE_SCOPE("HexMeshExtractor::insertCorners");
+            for (std::size_t i = begin; i < end; ++i) {
+                const OctreeLeaf& leaf = leaves[cells[i]];
+                const auto anchor = decodeMorton(leaf.key);
+                const std::uint32_t size = std::uint32_t{1} << (kMortonLevels - leaf.level);
+                for (int corner = 0; corner < 8; ++corner) {
+                    mesh.hexahedra[i][corner] = table.insert(encodeLatticeVertex(
+                        anchor[0] + kCornerOffsets[corner][0] * size,
+                        anchor[1] + kCornerOffsets[corner][1] * size,
+                        anchor[2] + kCornerOffsets[corner][2] * size));
+                }
+                mesh.levels[i] = leaf.level;
+            }
+        });
+    };
+
+    // The leaf-count estimate covers real meshes; fall back to the no-sharing bound if beaten
+    auto table = std::make_unique<ConcurrentVertexTable>(ConcurrentVertexTable::estimateVertexCount(cells.size()));
+    try {
+        insertCorners(*table);
+    } catch (const std::length_error&) {
+        table = std::make_unique<ConcurrentVertexTable>(8 * cells.size());
+        insertCorners(*table);
+    }
+    timer.lap(&MeshStatistics::meshInsertSeconds);
+
+    std::size_t vertexCount;
+    {
+        BIOMESH_TRACE_SCOPE("ConcurrentVertexTable::compact");
+        vertexCount = table->compact();
+    }
+    timer.lap(&MeshStatistics::meshCompactSeconds);
+    mesh.vertices.resize(vertexCount);
+
+    const BoundingBox& root = tree.getEncoder().getRootBox();
+    const double origin[3] = {root.getMinX(), root.getMinY(), root.getMinZ()};
+    const double extent[3] = {root.getWidth(), root.getHeight(), root.getDepth()};
+    const double lattice = static_cast<double>(kMortonLatticeSize);
+    const auto& keys = table->getKeys();
+
+    parallelBlocks(threadCount_, scheduler_, vertexCount, [&](std::size_t begin, std::size_t end) {
+        BIOMESH_TRACE_SCOPE("HexMeshExtractor::placeVertices");
+        for (std::size_t id = begin; id < end; ++id) {
+            const auto vertex = decodeLatticeVertex(keys[id]);
+            for (int axis = 0; axis < 3; ++axis) {
+                mesh.vertices[id][axis] = origin[axis] + extent[axis] * (static_cast<double>(vertex[axis]) / lattice);
+            }
+        }
+    });
+    timer.lap(&MeshStatistics::meshPlaceSeconds);
+
+    parallelBlocks(threadCount_, scheduler_, cells.size(), [&](std::size_t begin, std::size_t end) {
+        BIOMESH_TRACE_SCOPE("HexMeshExtractor::remapCorners");
+        for (std::size_t i = begin; i < end; ++i) {
+            for (auto& corner : mesh.hexahedra[i]) {
+                corner = table->getId(corner);
+            }
+        }
+    });
+    timer.lap(&MeshStatistics::meshRemapSeconds);
+
+    if (statistics_) {
+        statistics_->recordMesh(mesh);
+    }
+    return mesh;
+}
+
+} // namespace BioMesh
@@ -0,0 +1,325 @@
+#include "biomesh/linear_octree.h"
+#include "biomesh/mesh_stats.h"
+#include "biomesh/metrics.h"
+#include "biomesh/trace.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace BioMesh {
+
+namespace {
+
+std::uint64_t nowNs() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+LinearOctree::LinearOctree(const BoundingBox& root, unsigned maxLevel, std::size_t maxAtomsPerLeaf)
+    : encoder_(root), maxLevel_(maxLevel), maxAtomsPerLeaf_(maxAtomsPerLeaf) {
+    if (maxLevel == 0 || maxLevel > kMortonLevels) {
+        throw std::invalid_argument("Octree max level must be between 1 and " + std::to_string(kMortonLevels));
+    }
+    if (maxAtomsPerLeaf == 0) {
+        throw std::invalid_argument("Octree max atoms per leaf must be greater than zero");
+    }
+}
+
+void LinearOctree::build(const std::vector<Atom>& atoms) {
+    build(atoms, 0, kMortonKeyEnd);
+}
+
+void LinearOctree::build(const std::vector<Atom>& atoms, std::uint64_t keyBegin, std::uint64_t keyEnd) {
+    build(atoms, nullptr, atoms.size(), keyBegin, keyEnd);
+}
+
+void LinearOctree::build(const std::vector<Atom>& atoms, const std::vector<std::uint32_t>& selection) {
+    build(atoms, selection.data(), selection.size(), 0, kMortonKeyEnd);
+}
+
+void LinearOctree::build(const std::vector<Atom>& atoms, const std::uint32_t* selection, std::size_t count,
+                         std::uint64_t keyBegin, std::uint64_t keyEnd) {
+    BIOMESH_TRACE_SCOPE("LinearOctree::build");
+    static Histogram& buildSeconds = stageSeconds("octree_build");
+    static Counter& buildAtoms = stageAtoms("octree_build");
+    MetricsTimer metricsTimer(buildSeconds);
+    buildAtoms.add(count);
+    const std::uint64_t cellSpan = mortonSpan(maxLevel_);
+    if (keyBegin > keyEnd || keyEnd > kMortonKeyEnd || keyBegin % cellSpan != 0 || keyEnd % cellSpan != 0) {
+        throw std::invalid_argument("Octree key range must be ordered and aligned to finest-level cells");
+    }
+    if (atoms.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument("Octree supports at most 2^32 - 1 atoms per tree");
+    }
+
+    keyBegin_ = keyBegin;
+    keyEnd_ = keyEnd;
+    const std::uint64_t start = statistics_ ? nowNs() : 0;
+
+    // Without a selection every atom is inserted; with one, atom order refers to the full vector
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> keyed;
+    keyed.reserve(count);
+    const BoundingBox& root = encoder_.getRootBox();
+    for (std::size_t n = 0; n < count; ++n) {
+        const std::size_t i = selection ? selection[n] : n;
+        if (i >= atoms.size()) {
+            throw std::out_of_range("Selected atom " + std::to_string(i) + " is past the " +
+                                    std::to_string(atoms.size()) + " atoms");
+        }
+        const Atom& atom = atoms[i];
+        if (!root.contains(atom)) {
+            throw std::out_of_range("Atom " + std::to_string(i) + " lies outside the octree root box");
+        }
+        std::uint64_t key = encoder_.encode(atom.getX(), atom.getY(), atom.getZ());
+        if (key < keyBegin || key >= keyEnd) {
+            throw std::out_of_range("Atom " + std::to_string(i) + " lies outside the octree key range");
+        }
+        keyed.emplace_back(key, static_cast<std::uint32_t>(i));
+    }
+    std::sort(keyed.begin(), keyed.end());
+
+    atomKeys_.resize(keyed.size());
+    atomOrder_.resize(keyed.size());
+    for (std::size_t i = 0; i < keyed.size(); ++i) {
+        atomKeys_[i] = keyed[i].first;
+        atomOrder_[i] = keyed[i].second;
+    }
+
+    leaves_.clear();
+    buildNode(0, 0, 0, atomKeys_.size());
+
+    if (statistics_) {
+        statistics_->buildSeconds += static_cast<double>(nowNs() - start) * 1e-9;
+        statistics_->recordLeaves(*this);
+    }
+}
+
+std::uint64_t LinearOctree::buildNode(std::uint64_t anchor, unsigned level, std::size_t first, std::size_t last) {
+    const std::uint64_t span = mortonSpan(level);
+    const std::uint64_t end = anchor + span;
+    if (end <= keyBegin_ || anchor >= keyEnd_) {
+        return 0;
+    }
+
+    // With statistics attached, returns the nanoseconds spent in this subtree so each
+    // level can be charged its exclusive time
+    const std::uint64_t start = statistics_ ? nowNs() : 0;
+    std::uint64_t childNs = 0;
+    const bool inside = anchor >= keyBegin_ && end <= keyEnd_;
+    const std::size_t count = last - first;
+    if (inside && (count <= maxAtomsPerLeaf_ || level == maxLevel_)) {
+        OctreeLeaf leaf;
+        leaf.key = anchor;
+        leaf.level = static_cast<std::uint8_t>(level);
+        leaf.firstAtom = static_cast<std::uint32_t>(first);
+        leaf.atomCount = static_cast<std::uint32_t>(count);
+        leaves_.push_back(leaf);
+    } else {
+        // Nodes straddling the range boundary are refined until they fall inside or outside it
+        const std::uint64_t childSpan = span >> 3;
+        std::size_t position = first;
+        for (std::uint64_t octant = 0; octant < 8; ++octant) {
+            const std::uint64_t childAnchor = anchor + octant * childSpan;
+            auto childLast = std::lower_bound(atomKeys_.begin() + static_cast<std::ptrdiff_t>(position),
+                                              atomKeys_.begin() + static_cast<std::ptrdiff_t>(last),
+                                              childAnchor + childSpan);
+            std::size_t childEnd = static_cast<std::size_t>(childLast - atomKeys_.begin());
+            childNs += buildNode(childAnchor, level + 1, position, childEnd);
+            position = childEnd;
+        }
+    }
+
+    if (!statistics_) {
+        return 0;
+    }
+    const std::uint64_t elapsed = nowNs() - start;
+    LevelStatistics& counters = statistics_->level(level);
+    ++counters.nodes;
+    counters.buildSeconds += static_cast<double>(elapsed - std::min(elapsed, childNs)) * 1e-9;
+    return elapsed;
+}
+
+void LinearOctree::restore(std::uint64_t keyBegin, std::uint64_t keyEnd, std::vector<OctreeLeaf> leaves,
+                           std::vector<std::uint64_t> atomKeys, std::vector<std::uint32_t> atomOrder) {
+    if (keyBegin > keyEnd || keyEnd > kMortonKeyEnd) {
+        throw std::invalid_argument("Octree key range must be ordered and inside the Morton key space");
+    }
+    if (atomKeys.size() != atomOrder.size()) {
+        throw std::invalid_argument("Octree atom keys and atom order must have the same size");
+    }
+    for (const auto& leaf : leaves) {
+        if (leaf.level > maxLevel_ ||
+            static_cast<std::size_t>(leaf.firstAtom) + leaf.atomCount > atomKeys.size()) {
+            throw std::invalid_argument("Octree leaf is inconsistent with the restored atoms");
+        }
+    }
+
+    keyBegin_ = keyBegin;
+    keyEnd_ = keyEnd;
+    leaves_ = std::move(leaves);
+    atomKeys_ = std::move(atomKeys);
+    atomOrder_ = std::move(atomOrder);
+    if (statistics_) {
+        statistics_->recordLeaves(*this);
+    }
+}
+
+void LinearOctree::appendChildren(const OctreeLeaf& parent, std::vector<OctreeLeaf>& out) const {
+    const std::uint64_t childSpan = mortonSpan(parent.level + 1u);
+    auto begin = atomKeys_.begin() + parent.firstAtom;
+    auto end = begin + parent.atomCount;
+
+    auto position = begin;
+    for (std::uint64_t octant = 0; octant < 8; ++octant) {
+        OctreeLeaf child;
+        child.key = parent.key + octant * childSpan;
+        child.level = static_cast<std::uint8_t>(parent.level + 1);
+        auto childEnd = std::lower_bound(position, end, child.key + childSpan);
+        child.firstAtom = static_cast<std::uint32_t>(position - atomKeys_.begin());
+        child.atomCount = static_cast<std::uint32_t>(childEnd - position);
+        out.push_back(child);
+        position = childEnd;
+    }
+}
+
+std::size_t LinearOctree::balance() {
+    BIOMESH_TRACE_SCOPE("LinearOctree::balance");
+    static Histogram& balanceSeconds = stageSeconds("octree_balance");
+    MetricsTimer metricsTimer(balanceSeconds);
+    const std::uint64_t start = statistics_ ? nowNs() : 0;
+    std::size_t totalSplits = 0;
+    while (true) {
+        std::size_t splits = applySplitRequests(collectBalanceRequests());
+        if (splits == 0) {
+            break;
+        }
+        totalSplits += splits;
+    }
+    if (statistics_) {
+        statistics_->balanceSeconds += static_cast<double>(nowNs() - start) * 1e-9;
+    }
+    return totalSplits;
+}
+
+std::vector<SplitRequest> LinearOctree::collectBalanceRequests() const {
+    std::vector<SplitRequest> requests;
+
+    for (const auto& leaf : leaves_) {
+        // Leaves at level 0 or 1 cannot constrain a neighbour
+        if (leaf.level < 2) {
+            continue;
+        }
+
+        const auto anchor = decodeMorton(leaf.key);
+        const std::int64_t size = std::int64_t{1} << (kMortonLevels - leaf.level);
+        std::int64_t parentAnchor[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            parentAnchor[axis] = static_cast<std::int64_t>(anchor[axis]) & ~(2 * size - 1);
+        }
+
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dz = -1; dz <= 1; ++dz) {
+                    if (dx == 0 && dy == 0 && dz == 0) {
+                        continue;
+                    }
+
+                    const int offsets[3] = {dx, dy, dz};
+                    std::int64_t neighbour[3];
+                    bool inLattice = true;
+                    bool insideParent = true;
+                    for (int axis = 0; axis < 3; ++axis) {
+                        std::int64_t base = static_cast<std::int64_t>(anchor[axis]);
+                        neighbour[axis] = offsets[axis] < 0 ? base - 1 : (offsets[axis] > 0 ? base + size : base);
+                        inLattice = inLattice && neighbour[axis] >= 0 &&
+                                    neighbour[axis] < static_cast<std::int64_t>(kMortonLatticeSize);
+                        insideParent = insideParent && neighbour[axis] >= parentAnchor[axis] &&
+                                       neighbour[axis] < parentAnchor[axis] + 2 * size;
+                    }
+
+                    // Siblings are never coarser than the leaf itself
+                    if (!inLattice || insideParent) {
+                        continue;
+                    }
+
+                    SplitRequest request;
+                    request.key = encodeMorton(static_cast<std::uint32_t>(neighbour[0]),
+                                               static_cast<std::uint32_t>(neighbour[1]),
+                                               static_cast<std::uint32_t>(neighbour[2]));
+                    request.minLevel = static_cast<std::uint8_t>(leaf.level - 1);
+                    requests.push_back(request);
+                }
+            }
+        }
+    }
+
+    return requests;
+}
+
+std::size_t LinearOctree::applySplitRequests(const std::vector<SplitRequest>& requests) {
+    std::vector<bool> split(leaves_.size(), false);
+    std::size_t splitCount = 0;
+
+    for (const auto& request : requests) {
+        std::size_t index = findLeaf(request.key);
+        if (index == npos || split[index] || leaves_[index].level >= request.minLevel) {
+            continue;
+        }
+        split[index] = true;
+        ++splitCount;
+    }
+
+    if (splitCount == 0) {
+        return 0;
+    }
+    if (statistics_) {
+        ++statistics_->balancePasses;
+        for (std::size_t i = 0; i < leaves_.size(); ++i) {
+            if (split[i]) {
+                ++statistics_->level(leaves_[i].level).balanceSplits;
+            }
+        }
+    }
+
+    std::vector<OctreeLeaf> refined;
+    refined.reserve(leaves_.size() + 7 * splitCount);
+    for (std::size_t i = 0; i < leaves_.size(); ++i) {
+        if (split[i]) {
+            appendChildren(leaves_[i], refined);
+        } else {
+            refined.push_back(leaves_[i]);
+        }
+    }
+    leaves_ = std::move(refined);
+    if (statistics_) {
+        statistics_->recordLeaves(*this);
+    }
+    return splitCount;
+}
+
+std::size_t LinearOctree::findLeaf(std::uint64_t key) const {
+    if (key < keyBegin_ || key >= keyEnd_ || leaves_.empty()) {
+        return npos;
+    }
+
+    auto it = std::upper_bound(leaves_.begin(), leaves_.end(), key,
+                               [](std::uint64_t value, const OctreeLeaf& leaf) { return value < leaf.key; });
+    if (it == leaves_.begin()) {
+        return npos;
+    }
+    --it;
+    if (key - it->key >= mortonSpan(it->level)) {
+        return npos;
+    }
+    return static_cast<std::size_t>(it - leaves_.begin());
+}
+
+MemoryUsage LinearOctree::memoryUsage() const {
+    return BioMesh::memoryUsage(leaves_) + BioMesh::memoryUsage(atomKeys_) + BioMesh::memoryUsage(atomOrder_);
+}
+
+} // namespace BioMesh
@@ -0,0 +1,59 @@
+#include "biomesh/memory.h"
+#include "Atom.h"
+#include "biomesh/linear_octree.h"
+#include "biomesh/vertex_table.h"
+#include <array>
+#include <cstdint>
+
+namespace BioMesh {
+
+MemoryUsage memoryUsage(const std::string& text) {
+    // A string whose data lives inside the object itself uses the small-string buffer
+    const char* data = text.data();
+    const char* object = reinterpret_cast<const char*>(&text);
+    if (data >= object && data < object + sizeof(text)) {
+        return MemoryUsage{};
+    }
+    return MemoryUsage{text.size() + 1, text.capacity() + 1};
+}
+
+MemoryUsage memoryUsage(const std::vector<Atom>& atoms) {
+    MemoryUsage usage{atoms.size() * sizeof(Atom), atoms.capacity() * sizeof(Atom)};
+    for (const auto& atom : atoms) {
+        usage += memoryUsage(atom.getChemicalElement());
+    }
+    return usage;
+}
+
+std::size_t estimateJobMemory(std::size_t atomCount, std::size_t maxAtomsPerLeaf) {
+    const double atoms = static_cast<double>(atomCount);
+    // Leaves hold about half the threshold on average; 2:1 balancing roughly doubles them
+    const double leaves = 2.0 * atoms / (0.5 * static_cast<double>(maxAtomsPerLeaf == 0 ? 1 : maxAtomsPerLeaf)) + 8.0;
+    const double vertices = static_cast<double>(ConcurrentVertexTable::estimateVertexCount(static_cast<std::size_t>(leaves)));
+
+    double bytes = 0.0;
+    bytes += 2.0 * atoms * sizeof(Atom);                                           // parsed + built atoms
+    bytes += atoms * (sizeof(std::uint64_t) + sizeof(std::uint32_t));             // octree keys and order
+    bytes += 2.0 * leaves * sizeof(OctreeLeaf);                                    // leaves, growth headroom
+    bytes += 4.0 * vertices * sizeof(std::uint64_t) + 2.0 * vertices * sizeof(std::uint32_t);  // vertex table
+    bytes += leaves * (sizeof(std::array<std::uint32_t, 8>) + 1.0);              // hexahedra and levels
+    bytes += vertices * (sizeof(std::array<double, 3>) + sizeof(std::uint64_t));  // coordinates, sorted keys
+    return static_cast<std::size_t>(bytes);
+}
+
+void* CountingMemoryResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    void* pointer = upstream_->allocate(bytes, alignment);
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t current = current_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    std::size_t peak = peak_.load(std::memory_order_relaxed);
+    while (current > peak && !peak_.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+    return pointer;
+}
+
+void CountingMemoryResource::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) {
+    upstream_->deallocate(pointer, bytes, alignment);
+    current_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+} // namespace BioMesh
@@ -0,0 +1,420 @@
+#include "biomesh/mesh_cache.h"
+#include "biomesh/metrics.h"
+#include "biomesh/trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+namespace BioMesh {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kMagic[4] = {'B', 'M', 'C', '1'};
+constexpr std::uint32_t kFormatVersion = 1;
+constexpr const char* kExtension = ".bmc";
+
+/// Distinguishes temporaries of concurrent stores within one process
+std::atomic<std::uint64_t> temporaryCounter{0};
+
+void appendBytes(std::vector<std::uint8_t>& out, const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+template <typename T>
+void append(std::vector<std::uint8_t>& out, const T& value) {
+    appendBytes(out, &value, sizeof(T));
+}
+
+/**
+ * @brief Bounds-checked reader over a loaded cache file
+ */
+class Reader {
+public:
+    Reader(const std::uint8_t* data, std::size_t size) : cursor_(data), end_(data + size) {}
+
+    void read(void* out, std::size_t size) {
+        if (static_cast<std::size_t>(end_ - cursor_) < size) {
+            throw std::runtime_error("truncated cache entry");
+        }
+        std::memcpy(out, cursor_, size);
+        cursor_ += size;
+    }
+
+    template <typename T>
+    T read() {
+        T value;
+        read(&value, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void readVector(std::vector<T>& out, std::uint64_t count) {
+        if (count > static_cast<std::uint64_t>(end_ - cursor_) / sizeof(T)) {
+            throw std::runtime_error("truncated cache entry");
+        }
+        out.resize(static_cast<std::size_t>(count));
+        read(out.data(), out.size() * sizeof(T));
+    }
+
+    bool atEnd() const { return cursor_ == end_; }
+
+private:
+    const std::uint8_t* cursor_;
+    const std::uint8_t* end_;
+};
+
+void appendBox(std::vector<std::uint8_t>& out, const BoundingBox& box) {
+    const double bounds[6] = {box.getMinX(), box.getMinY(), box.getMinZ(), box.getMaxX(), box.getMaxY(), box.getMaxZ()};
+    appendBytes(out, bounds, sizeof(bounds));
+}
+
+/**
+ * @brief Serialize an entry: header, octree, mesh, then a checksum of everything before it
+ */
+std::vector<std::uint8_t> serialize(const Hash128& key, const LinearOctree& tree, const HexMesh& mesh) {
+    std::vector<std::uint8_t> out;
+    const auto& leaves = tree.getLeaves();
+    out.reserve(128 + leaves.size() * 17 + tree.getAtomKeys().size() * 12 + mesh.getVertexCount() * 24 +
+                mesh.getHexCount() * 33);
+
+    appendBytes(out, kMagic, sizeof(kMagic));
+    append(out, kFormatVersion);
+    append(out, key);
+    appendBox(out, tree.getEncoder().getRootBox());
+    append(out, static_cast<std::uint32_t>(tree.getMaxLevel()));
+    append(out, static_cast<std::uint64_t>(tree.getMaxAtomsPerLeaf()));
+    append(out, tree.getKeyBegin());
+    append(out, tree.getKeyEnd());
+    append(out, static_cast<std::uint64_t>(leaves.size()));
+    append(out, static_cast<std::uint64_t>(tree.getAtomKeys().size()));
+    append(out, static_cast<std::uint64_t>(mesh.getVertexCount()));
+    append(out, static_cast<std::uint64_t>(mesh.getHexCount()));
+
+    // Leaves field by field so struct padding never reaches the file
+    for (const auto& leaf : leaves) {
+        append(out, leaf.key);
+        append(out, leaf.firstAtom);
+        append(out, leaf.atomCount);
+        append(out, leaf.level);
+    }
+    appendBytes(out, tree.getAtomKeys().data(), tree.getAtomKeys().size() * sizeof(std::uint64_t));
+    appendBytes(out, tree.getAtomOrder().data(), tree.getAtomOrder().size() * sizeof(std::uint32_t));
+    appendBytes(out, mesh.vertices.data(), mesh.vertices.size() * sizeof(mesh.vertices[0]));
+    appendBytes(out, mesh.hexahedra.data(), mesh.hexahedra.size() * sizeof(mesh.hexahedra[0]));
+    appendBytes(out, mesh.levels.data(), mesh.levels.size());
+
+    append(out, MurmurHash3::hash(out.data(), out.size()));
+    return out;
+}
+
+CachedMesh deserialize(const Hash128& key, const std::vector<std::uint8_t>& data) {
+    if (data.size() < sizeof(Hash128) ||
+        MurmurHash3::hash(data.data(), data.size() - sizeof(Hash128)) !=
+            Reader(data.data() + data.size() - sizeof(Hash128), sizeof(Hash128)).read<Hash128>()) {
+        throw std::runtime_error("cache entry checksum mismatch");
+    }
+
+    Reader reader(data.data(), data.size() - sizeof(Hash128));
+    char magic[4];
+    reader.read(magic, sizeof(magic));
+    if (std::memcmp(magic, kMagic, sizeof(magic)) != 0 || reader.read<std::uint32_t>() != kFormatVersion ||
+        reader.read<Hash128>() != key) {
+        throw std::runtime_error("cache entry header mismatch");
+    }
+
+    double bounds[6];
+    reader.read(bounds, sizeof(bounds));
+    const auto maxLevel = reader.read<std::uint32_t>();
+    const auto maxAtomsPerLeaf = reader.read<std::uint64_t>();
+    const auto keyBegin = reader.read<std::uint64_t>();
+    const auto keyEnd = reader.read<std::uint64_t>();
+    const auto leafCount = reader.read<std::uint64_t>();
+    const auto atomCount = reader.read<std::uint64_t>();
+    const auto vertexCount = reader.read<std::uint64_t>();
+    const auto hexCount = reader.read<std::uint64_t>();
+
+    if (leafCount > data.size() / 17) {
+        throw std::runtime_error("truncated cache entry");
+    }
+    std::vector<OctreeLeaf> leaves(static_cast<std::size_t>(leafCount));
+    for (auto& leaf : leaves) {
+        leaf.key = reader.read<std::uint64_t>();
+        leaf.firstAtom = reader.read<std::uint32_t>();
+        leaf.atomCount = reader.read<std::uint32_t>();
+        leaf.level = reader.read<std::uint8_t>();
+    }
+    std::vector<std::uint64_t> atomKeys;
+    std::vector<std::uint32_t> atomOrder;
+    reader.readVector(atomKeys, atomCount);
+    reader.readVector(atomOrder, atomCount);
+
+    CachedMesh result{LinearOctree(BoundingBox(bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]),
+                                   maxLevel, static_cast<std::size_t>(maxAtomsPerLeaf)),
+                      HexMesh()};
+    result.tree.restore(keyBegin, keyEnd, std::move(leaves), std::move(atomKeys), std::move(atomOrder));
+    reader.readVector(result.mesh.vertices, vertexCount);
+    reader.readVector(result.mesh.hexahedra, hexCount);
+    reader.readVector(result.mesh.levels, hexCount);
+    if (!reader.atEnd()) {
+        throw std::runtime_error("trailing data in cache entry");
+    }
+    return result;
+}
+
+} // namespace
+
+MeshCache::MeshCache(const std::string& directory, std::size_t capacityBytes)
+    : directory_(directory), capacityBytes_(capacityBytes) {
+    if (capacityBytes == 0) {
+        throw std::invalid_argument("Mesh cache capacity must be greater than zero");
+    }
+    std::error_code error;
+    fs::create_directories(directory_, error);
+    if (error || !fs::is_directory(directory_)) {
+        throw std::runtime_error("Cannot create mesh cache directory: " + directory_);
+    }
+
+    // Rebuild the recency order from modification times, oldest first
+    std::vector<std::pair<fs::file_time_type, fs::directory_entry>> found;
+    for (const auto& file : fs::directory_iterator(directory_)) {
+        if (file.is_regular_file() && file.path().extension() == kExtension) {
+            found.emplace_back(file.last_write_time(), file);
+        }
+    }
+    std::sort(found.begin(), found.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (const auto& item : found) {
+        const std::string name = item.second.path().stem().string();
+        recency_.push_front(name);
+        const auto bytes = static_cast<std::size_t>(item.second.file_size());
+        entries_[name] = Entry{bytes, recency_.begin()};
+        sizeBytes_ += bytes;
+    }
+    evict();
+}
+
+Hash128 MeshCache::computeKey(const std::vector<Atom>& atoms, const BoundingBox& root,
+                              const MeshingParameters& parameters) {
+    BIOMESH_TRACE_SCOPE("MeshCache::computeKey");
+    MurmurHash3 hasher(kFormatVersion);
+    std::vector<std::uint8_t> header;
+    appendBox(header, root);
+    append(header, static_cast<std::uint32_t>(parameters.maxLevel));
+    append(header, static_cast<std::uint64_t>(parameters.maxAtomsPerLeaf));
+    append(header, static_cast<std::uint8_t>(parameters.balance));
+    append(header, static_cast<std::uint8_t>(parameters.occupiedLeavesOnly));
+    append(header, static_cast<std::uint64_t>(atoms.size()));
+    hasher.update(header.data(), header.size());
+
+    // Batch the columns so the hasher sees whole blocks
+    constexpr std::size_t kBatch = 64;
+    double columns[kBatch * 5];
+    for (std::size_t first = 0; first < atoms.size(); first += kBatch) {
+        const std::size_t count = std::min(kBatch, atoms.size() - first);
+        for (std::size_t i = 0; i < count; ++i) {
+            const Atom& atom = atoms[first + i];
+            double* row = columns + 5 * i;
+            row[0] = atom.getX();
+            row[1] = atom.getY();
+            row[2] = atom.getZ();
+            row[3] = atom.getAtomicRadius();
+            row[4] = atom.getAtomicMass();
+        }
+        hasher.update(columns, count * 5 * sizeof(double));
+    }
+    return hasher.finish();
+}
+
+std::optional<CachedMesh> MeshCache::load(const Hash128& key) {
+    BIOMESH_TRACE_SCOPE("MeshCache::load");
+    static Counter& hitCount = MetricsRegistry::global().counter(
+        "biomesh_mesh_cache_lookups_total", "Mesh cache lookups by result", {{"result", "hit"}});
+    static Counter& missCount = MetricsRegistry::global().counter(
+        "biomesh_mesh_cache_lookups_total", "Mesh cache lookups by result", {{"result", "miss"}});
+    const std::string name = key.toHex();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.count(name) == 0) {
+            ++misses_;
+            missCount.add();
+            return std::nullopt;
+        }
+    }
+
+    // Read, checksum and decode without the lock, so lookups do not queue behind disk I/O.
+    // Stores replace files by rename, so an open file is never seen half-written
+    std::optional<CachedMesh> result;
+    std::ifstream in(pathFor(name), std::ios::binary);
+    std::vector<std::uint8_t> data;
+    if (in) {
+        in.seekg(0, std::ios::end);
+        data.resize(static_cast<std::size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+    if (in) {
+        try {
+            result = deserialize(key, data);
+        } catch (const std::exception&) {
+        }
+    }
+
+    // The entry may have been evicted, removed or re-stored meanwhile
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!result) {
+        // Removed by another process sharing the directory, or corrupt
+        remove(name);
+        ++misses_;
+        missCount.add();
+        return std::nullopt;
+    }
+    if (entries_.count(name) != 0) {
+        touch(name);
+    }
+    ++hits_;
+    hitCount.add();
+    return result;
+}
+
+bool MeshCache::store(const Hash128& key, const LinearOctree& tree, const HexMesh& mesh) {
+    BIOMESH_TRACE_SCOPE("MeshCache::store");
+    const std::vector<std::uint8_t> data = serialize(key, tree, mesh);
+    if (data.size() > capacityBytes_) {
+        return false;
+    }
+
+    const std::string name = key.toHex();
+    // Write to a private temporary and rename, so readers never see a partial entry; the name is
+    // unique per call, since threads of one process may store the same key at the same time
+    const std::string temporary = pathFor(name) + ".tmp" + std::to_string(::getpid()) + "." +
+                                  std::to_string(temporaryCounter.fetch_add(1, std::memory_order_relaxed));
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!out) {
+            std::error_code ignored;
+            fs::remove(temporary, ignored);
+            throw std::runtime_error("Failed to write mesh cache entry: " + temporary);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code error;
+    fs::rename(temporary, pathFor(name), error);
+    if (error) {
+        fs::remove(temporary, error);
+        throw std::runtime_error("Failed to store mesh cache entry: " + pathFor(name));
+    }
+    auto it = entries_.find(name);
+    if (it != entries_.end()) {
+        sizeBytes_ -= it->second.bytes;
+        recency_.erase(it->second.use);
+    }
+    recency_.push_front(name);
+    entries_[name] = Entry{data.size(), recency_.begin()};
+    sizeBytes_ += data.size();
+    evict();
+    return true;
+}
+
+CachedMesh MeshCache::getOrCompute(const std::vector<Atom>& atoms, const BoundingBox& root,
+                                   const MeshingParameters& parameters, unsigned threadCount,
+                                   TaskScheduler* scheduler) {
+    const Hash128 key = computeKey(atoms, root, parameters);
+    if (auto cached = load(key)) {
+        return std::move(*cached);
+    }
+
+    CachedMesh result{LinearOctree(root, parameters.maxLevel, parameters.maxAtomsPerLeaf), HexMesh()};
+    result.tree.build(atoms);
+    if (parameters.balance) {
+        result.tree.balance();
+    }
+    HexMeshExtractor extractor(threadCount);
+    extractor.setScheduler(scheduler);
+    result.mesh = extractor.extract(result.tree, parameters.occupiedLeavesOnly);
+    // Storing is best effort: the caller still gets the mesh if the directory is unwritable
+    try {
+        store(key, result.tree, result.mesh);
+    } catch (const std::exception&) {
+        static Counter& failureCount = MetricsRegistry::global().counter(
+            "biomesh_mesh_cache_store_failures_total", "Mesh cache entries that could not be written");
+        failureCount.add();
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++storeFailures_;
+    }
+    return result;
+}
+
+void MeshCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!recency_.empty()) {
+        const std::string oldest = recency_.back();
+        remove(oldest);
+    }
+}
+
+std::size_t MeshCache::getSizeBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sizeBytes_;
+}
+
+std::size_t MeshCache::getEntryCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+std::size_t MeshCache::getHitCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+std::size_t MeshCache::getMissCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+std::size_t MeshCache::getStoreFailureCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return storeFailures_;
+}
+
+std::string MeshCache::pathFor(const std::string& name) const {
+    return (fs::path(directory_) / (name + kExtension)).string();
+}
+
+void MeshCache::touch(const std::string& name) {
+    auto& entry = entries_.at(name);
+    recency_.splice(recency_.begin(), recency_, entry.use);
+    std::error_code ignored;
+    fs::last_write_time(pathFor(name), fs::file_time_type::clock::now(), ignored);
+}
+
+void MeshCache::remove(const std::string& name) {
+    auto it = entries_.find(name);
+    if (it == entries_.end()) {
+        return;
+    }
+    std::error_code ignored;
+    fs::remove(pathFor(name), ignored);
+    sizeBytes_ -= it->second.bytes;
+    recency_.erase(it->second.use);
+    entries_.erase(it);
+}
+
+void MeshCache::evict() {
+    while (sizeBytes_ > capacityBytes_ && !recency_.empty()) {
+        const std::string oldest = recency_.back();
+        remove(oldest);
+    }
+}
+
+} // namespace BioMesh
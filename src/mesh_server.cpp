@@ -0,0 +1,641 @@
+#include "biomesh/mesh_server.h"
+#include "biomesh/metrics.h"
+#include "biomesh/trace.h"
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace BioMesh {
+
+namespace {
+
+constexpr std::uint32_t kRequestMagic = 0x51524d42;   // "BMRQ"
+constexpr std::uint32_t kResponseMagic = 0x53524d42;  // "BMRS"
+constexpr std::uint16_t kProtocolVersion = 1;
+
+enum RequestType : std::uint16_t { kMeshRequest = 1, kStatsRequest = 2, kShutdownRequest = 3 };
+enum ResponseStatus : std::uint16_t { kOk = 0, kError = 1 };
+
+// Mesh request flags
+constexpr std::uint32_t kBalance = 1;
+constexpr std::uint32_t kOccupiedOnly = 2;
+constexpr std::uint32_t kExplicitRoot = 4;
+
+sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path must be 1 to " + std::to_string(sizeof(address.sun_path) - 1) +
+                                    " characters: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+bool sendAll(int fd, const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    while (size > 0) {
+        ssize_t sent = ::send(fd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        bytes += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+    return true;
+}
+
+bool receiveAll(int fd, void* data, std::size_t size) {
+    auto* bytes = static_cast<std::uint8_t*>(data);
+    while (size > 0) {
+        ssize_t received = ::recv(fd, bytes, size, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        size -= static_cast<std::size_t>(received);
+    }
+    return true;
+}
+
+bool sendFrame(int fd, const std::vector<std::uint8_t>& payload) {
+    const std::uint64_t size = payload.size();
+    return sendAll(fd, &size, sizeof(size)) && sendAll(fd, payload.data(), payload.size());
+}
+
+/**
+ * @brief Receive one frame into a reused buffer
+ *
+ * The buffer grows with the bytes that actually arrive, at most doubling, so a length
+ * header alone cannot make the server commit memory.
+ * @return false on a closed connection
+ * @throws std::length_error if the frame exceeds maxBytes
+ */
+bool receiveFrame(int fd, std::vector<std::uint8_t>& payload, std::size_t maxBytes) {
+    constexpr std::size_t kFirstChunk = std::size_t{1} << 20;
+    std::uint64_t size = 0;
+    if (!receiveAll(fd, &size, sizeof(size))) {
+        return false;
+    }
+    if (size > maxBytes) {
+        throw std::length_error("Request of " + std::to_string(size) + " bytes exceeds the server limit");
+    }
+    payload.clear();
+    while (payload.size() < size) {
+        const std::size_t received = payload.size();
+        const std::size_t chunk = std::min<std::size_t>(static_cast<std::size_t>(size) - received,
+                                                        std::max(kFirstChunk, received));
+        payload.resize(received + chunk);
+        if (!receiveAll(fd, payload.data() + received, chunk)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+class Writer {
+public:
+    explicit Writer(std::vector<std::uint8_t>& out) : out_(out) { out_.clear(); }
+
+    void bytes(const void* data, std::size_t size) {
+        if (size == 0) {
+            return;
+        }
+        const std::size_t offset = out_.size();
+        out_.resize(offset + size);
+        std::memcpy(out_.data() + offset, data, size);
+    }
+
+    template <typename T>
+    void value(const T& v) {
+        bytes(&v, sizeof(T));
+    }
+
+private:
+    std::vector<std::uint8_t>& out_;
+};
+
+class Reader {
+public:
+    explicit Reader(const std::vector<std::uint8_t>& in) : cursor_(in.data()), end_(in.data() + in.size()) {}
+
+    void bytes(void* out, std::size_t size) {
+        if (static_cast<std::size_t>(end_ - cursor_) < size) {
+            throw std::runtime_error("Truncated message");
+        }
+        std::memcpy(out, cursor_, size);
+        cursor_ += size;
+    }
+
+    template <typename T>
+    T value() {
+        T v;
+        bytes(&v, sizeof(T));
+        return v;
+    }
+
+    template <typename T>
+    void vector(std::vector<T>& out, std::uint64_t count) {
+        if (count > static_cast<std::uint64_t>(end_ - cursor_) / sizeof(T)) {
+            throw std::runtime_error("Truncated message");
+        }
+        out.resize(static_cast<std::size_t>(count));
+        bytes(out.data(), out.size() * sizeof(T));
+    }
+
+private:
+    const std::uint8_t* cursor_;
+    const std::uint8_t* end_;
+};
+
+void writeHeader(Writer& writer, std::uint32_t magic, std::uint16_t code) {
+    writer.value(magic);
+    writer.value(kProtocolVersion);
+    writer.value(code);
+}
+
+std::uint16_t readHeader(Reader& reader, std::uint32_t magic) {
+    if (reader.value<std::uint32_t>() != magic || reader.value<std::uint16_t>() != kProtocolVersion) {
+        throw std::runtime_error("Unsupported message format");
+    }
+    return reader.value<std::uint16_t>();
+}
+
+void writeError(std::vector<std::uint8_t>& out, const std::string& message) {
+    Writer writer(out);
+    writeHeader(writer, kResponseMagic, kError);
+    writer.value(static_cast<std::uint32_t>(message.size()));
+    writer.bytes(message.data(), message.size());
+}
+
+void writeStats(Writer& writer, const MeshServerStats& stats) {
+    writer.value(stats.requests);
+    writer.value(stats.errors);
+    writer.value(stats.batches);
+    writer.value(stats.largeJobs);
+    writer.value(stats.atoms);
+    writer.value(stats.cacheHits);
+}
+
+/**
+ * @brief Server series in the global metrics registry, shared by all servers in the process
+ */
+struct ServerMetrics {
+    MetricsRegistry& registry = MetricsRegistry::global();
+    Counter& requests = registry.counter("biomesh_server_requests_total", "Mesh requests received");
+    Counter& errors = registry.counter("biomesh_server_errors_total", "Requests answered with an error");
+    Histogram& requestSeconds =
+        registry.histogram("biomesh_server_request_seconds", "Mesh request latency from receipt to reply in seconds");
+    Gauge& queueDepth = registry.gauge("biomesh_server_queue_depth", "Mesh jobs waiting for a batch");
+    Histogram& batchJobs = registry.histogram("biomesh_server_batch_jobs", "Jobs per scheduled batch", {},
+                                              Histogram::exponentialBounds(1.0, 2.0, 8));
+    Gauge& connections = registry.gauge("biomesh_server_connections", "Open client connections");
+    Gauge& arenaHighWater = registry.gauge("biomesh_server_arena_high_water_bytes",
+                                           "Largest per-connection request and response buffers in bytes");
+};
+
+ServerMetrics& serverMetrics() {
+    static ServerMetrics metrics;
+    return metrics;
+}
+
+} // namespace
+
+/**
+ * @brief One mesh request travelling from a connection thread to the scheduler
+ */
+struct MeshServer::Job {
+    std::vector<Atom> atoms;            ///< Decoded atoms with radius and mass assigned
+    MeshingParameters parameters;       ///< Requested parameters
+    bool explicitRoot{false};           ///< root was supplied by the client
+    BoundingBox root;                   ///< Octree root box
+    std::promise<HexMesh> result;       ///< Fulfilled by runJob()
+};
+
+MeshServer::MeshServer(const std::string& socketPath, const MeshServerOptions& options)
+    : socketPath_(socketPath), options_(options), scheduler_(options.workerSlots) {
+    socketAddress(socketPath_);
+    serverMetrics();  // register the series so scrapes show them before the first request
+    if (!options_.cacheDirectory.empty()) {
+        cache_ = std::make_unique<MeshCache>(options_.cacheDirectory, options_.cacheBytes);
+    }
+}
+
+MeshServer::~MeshServer() {
+    stop();
+}
+
+void MeshServer::start() {
+    if (running_.load() || acceptThread_.joinable()) {
+        throw std::runtime_error("Mesh server is already running");
+    }
+
+    const sockaddr_un address = socketAddress(socketPath_);
+    struct stat existing;
+    if (::lstat(socketPath_.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) {
+        ::unlink(socketPath_.c_str());
+    }
+
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) {
+        throw systemError("Cannot create socket");
+    }
+    if (::bind(listenFd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd_, SOMAXCONN) != 0) {
+        auto error = systemError("Cannot listen on " + socketPath_);
+        ::close(listenFd_);
+        listenFd_ = -1;
+        throw error;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        stopping_ = false;
+        stopRequested_ = false;
+    }
+    running_ = true;
+    dispatchThread_ = std::thread(&MeshServer::dispatchLoop, this);
+    acceptThread_ = std::thread(&MeshServer::acceptLoop, this);
+}
+
+void MeshServer::stop() {
+    if (!acceptThread_.joinable()) {
+        return;
+    }
+
+    // Wake accept() and stop taking new connections
+    ::shutdown(listenFd_, SHUT_RDWR);
+    acceptThread_.join();
+    ::close(listenFd_);
+    listenFd_ = -1;
+    ::unlink(socketPath_.c_str());
+
+    // Let queued jobs finish, then close the connections
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        stopping_ = true;
+    }
+    queueChanged_.notify_all();
+    dispatchThread_.join();
+
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        for (auto& connection : connections_) {
+            ::shutdown(connection.fd, SHUT_RDWR);
+        }
+    }
+    for (auto& connection : connections_) {
+        connection.thread.join();
+        ::close(connection.fd);
+    }
+    connections_.clear();
+
+    running_ = false;
+    queueChanged_.notify_all();
+}
+
+void MeshServer::wait() {
+    while (!waitFor(std::chrono::seconds(1))) {
+    }
+}
+
+bool MeshServer::waitFor(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    if (!queueChanged_.wait_for(lock, timeout, [this]() { return stopRequested_ || !running_.load(); })) {
+        return false;
+    }
+    lock.unlock();
+    stop();
+    return true;
+}
+
+void MeshServer::requestStop() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        stopRequested_ = true;
+    }
+    queueChanged_.notify_all();
+}
+
+MeshServerStats MeshServer::getStats() const {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    MeshServerStats stats = stats_;
+    stats.cacheHits = cache_ ? cache_->getHitCount() : 0;
+    return stats;
+}
+
+void MeshServer::acceptLoop() {
+    BIOMESH_TRACE_THREAD_NAME("biomesh-server accept");
+    while (true) {
+        int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return;  // listening socket shut down
+        }
+
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        // Reap connections whose clients have gone away
+        for (auto it = connections_.begin(); it != connections_.end();) {
+            if (it->done.load()) {
+                it->thread.join();
+                ::close(it->fd);
+                it = connections_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        connections_.emplace_back();
+        Connection& connection = connections_.back();
+        connection.fd = fd;
+        serverMetrics().connections.add(1);
+        connection.thread = std::thread(&MeshServer::serve, this, std::ref(connection));
+    }
+}
+
+void MeshServer::serve(Connection& connection) {
+    BIOMESH_TRACE_THREAD_NAME("biomesh-server connection");
+    ServerMetrics& metrics = serverMetrics();
+    std::vector<std::uint8_t> request;
+    std::vector<std::uint8_t> response;
+
+    while (true) {
+        try {
+            if (!receiveFrame(connection.fd, request, options_.maxRequestBytes)) {
+                break;
+            }
+        } catch (const std::exception& error) {
+            // Oversized, or too large to buffer: the rest of the frame cannot be skipped
+            // reliably, so answer and hang up
+            writeError(response, error.what());
+            sendFrame(connection.fd, response);
+            break;
+        }
+
+        try {
+            Reader reader(request);
+            const std::uint16_t type = readHeader(reader, kRequestMagic);
+            if (type == kStatsRequest) {
+                Writer writer(response);
+                writeHeader(writer, kResponseMagic, kOk);
+                writeStats(writer, getStats());
+            } else if (type == kShutdownRequest) {
+                Writer writer(response);
+                writeHeader(writer, kResponseMagic, kOk);
+                sendFrame(connection.fd, response);
+                requestStop();
+                continue;
+            } else if (type == kMeshRequest) {
+                MetricsTimer requestTimer(metrics.requestSeconds);
+                auto job = std::make_shared<Job>();
+                job->parameters.maxLevel = reader.value<std::uint32_t>();
+                const auto flags = reader.value<std::uint32_t>();
+                job->parameters.maxAtomsPerLeaf = static_cast<std::size_t>(reader.value<std::uint64_t>());
+                job->parameters.balance = (flags & kBalance) != 0;
+                job->parameters.occupiedLeavesOnly = (flags & kOccupiedOnly) != 0;
+                job->explicitRoot = (flags & kExplicitRoot) != 0;
+                double bounds[6];
+                reader.bytes(bounds, sizeof(bounds));
+                if (job->explicitRoot) {
+                    job->root = BoundingBox(bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]);
+                }
+
+                const auto count = reader.value<std::uint64_t>();
+                if (count > request.size() / 25) {
+                    throw std::runtime_error("Truncated message");
+                }
+                job->atoms.reserve(static_cast<std::size_t>(count));
+                std::string element;
+                for (std::uint64_t i = 0; i < count; ++i) {
+                    const double x = reader.value<double>();
+                    const double y = reader.value<double>();
+                    const double z = reader.value<double>();
+                    element.resize(reader.value<std::uint8_t>());
+                    reader.bytes(&element[0], element.size());
+                    job->atoms.emplace_back(x, y, z, element);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(queueMutex_);
+                    ++stats_.requests;
+                    stats_.atoms += count;
+                }
+                metrics.requests.add();
+
+                // Enrich on the connection thread so the scheduler sees the real root volume
+                builder_.assignProperties(job->atoms);
+                if (!job->explicitRoot) {
+                    job->root.calculateFromAtoms(job->atoms);
+                    job->root.expand(1.0);
+                }
+
+                auto future = job->result.get_future();
+                {
+                    std::lock_guard<std::mutex> lock(queueMutex_);
+                    if (stopping_) {
+                        throw std::runtime_error("Mesh server is shutting down");
+                    }
+                    queue_.push_back(job);
+                }
+                metrics.queueDepth.add(1);
+                queueChanged_.notify_all();
+
+                const HexMesh mesh = future.get();
+                Writer writer(response);
+                writeHeader(writer, kResponseMagic, kOk);
+                writer.value(static_cast<std::uint64_t>(mesh.getVertexCount()));
+                writer.value(static_cast<std::uint64_t>(mesh.getHexCount()));
+                writer.bytes(mesh.vertices.data(), mesh.vertices.size() * sizeof(mesh.vertices[0]));
+                writer.bytes(mesh.hexahedra.data(), mesh.hexahedra.size() * sizeof(mesh.hexahedra[0]));
+                writer.bytes(mesh.levels.data(), mesh.levels.size());
+            } else {
+                throw std::runtime_error("Unknown request type " + std::to_string(type));
+            }
+        } catch (const std::exception& error) {
+            {
+                std::lock_guard<std::mutex> lock(queueMutex_);
+                ++stats_.errors;
+            }
+            metrics.errors.add();
+            writeError(response, error.what());
+        }
+
+        metrics.arenaHighWater.updateMax(static_cast<std::int64_t>(request.capacity() + response.capacity()));
+        if (!sendFrame(connection.fd, response)) {
+            break;
+        }
+    }
+    metrics.connections.add(-1);
+    connection.done = true;
+}
+
+void MeshServer::dispatchLoop() {
+    BIOMESH_TRACE_THREAD_NAME("biomesh-server dispatch");
+    std::vector<std::shared_ptr<Job>> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueChanged_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;  // stopping and drained
+            }
+            // Give concurrent clients a moment to add their jobs to the same batch
+            const auto deadline = std::chrono::steady_clock::now() + options_.batchWindow;
+            queueChanged_.wait_until(lock, deadline,
+                                     [this]() { return stopping_ || queue_.size() >= options_.maxBatch; });
+            while (!queue_.empty() && batch.size() < std::max<std::size_t>(1, options_.maxBatch)) {
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+            ++stats_.batches;
+        }
+        serverMetrics().queueDepth.add(-static_cast<std::int64_t>(batch.size()));
+        serverMetrics().batchJobs.observe(static_cast<double>(batch.size()));
+        runBatch(batch);
+        batch.clear();
+    }
+}
+
+void MeshServer::runBatch(std::vector<std::shared_ptr<Job>>& batch) {
+    BIOMESH_TRACE_SCOPE("MeshServer::runBatch");
+    TaskGraph graph;
+    for (auto& job : batch) {
+        const bool large = job->atoms.size() >= options_.largeJobAtoms;
+        if (large) {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            ++stats_.largeJobs;
+        }
+        const double cost = TaskGraph::estimateCost(job->atoms.size(), job->root);
+        graph.addTask("mesh", [this, job](unsigned threads) { runJob(*job, threads); }, cost,
+                      large ? scheduler_.getWorkerSlots() : 1);
+    }
+    scheduler_.run(graph);
+}
+
+void MeshServer::runJob(Job& job, unsigned threads) {
+    try {
+        // Extraction blocks run on the scheduler workers whose slots this job holds
+        if (cache_) {
+            job.result.set_value(
+                std::move(cache_->getOrCompute(job.atoms, job.root, job.parameters, threads, &scheduler_).mesh));
+            return;
+        }
+        LinearOctree tree(job.root, job.parameters.maxLevel, job.parameters.maxAtomsPerLeaf);
+        tree.build(job.atoms);
+        if (job.parameters.balance) {
+            tree.balance();
+        }
+        HexMeshExtractor extractor(threads);
+        extractor.setScheduler(&scheduler_);
+        job.result.set_value(extractor.extract(tree, job.parameters.occupiedLeavesOnly));
+    } catch (...) {
+        job.result.set_exception(std::current_exception());
+    }
+}
+
+MeshClient::MeshClient(const std::string& socketPath) {
+    const sockaddr_un address = socketAddress(socketPath);
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+        throw systemError("Cannot create socket");
+    }
+    if (::connect(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        auto error = systemError("Cannot connect to " + socketPath);
+        ::close(fd_);
+        throw error;
+    }
+}
+
+MeshClient::~MeshClient() {
+    ::close(fd_);
+}
+
+std::vector<std::uint8_t> MeshClient::roundTrip() {
+    std::vector<std::uint8_t> response;
+    if (!sendFrame(fd_, buffer_) || !receiveFrame(fd_, response, std::numeric_limits<std::size_t>::max())) {
+        throw std::runtime_error("Connection to mesh server lost");
+    }
+    return response;
+}
+
+HexMesh MeshClient::mesh(const std::vector<Atom>& atoms, const MeshingParameters& parameters, const BoundingBox* root) {
+    Writer writer(buffer_);
+    writeHeader(writer, kRequestMagic, kMeshRequest);
+    writer.value(static_cast<std::uint32_t>(parameters.maxLevel));
+    writer.value((parameters.balance ? kBalance : 0u) | (parameters.occupiedLeavesOnly ? kOccupiedOnly : 0u) |
+                 (root ? kExplicitRoot : 0u));
+    writer.value(static_cast<std::uint64_t>(parameters.maxAtomsPerLeaf));
+    const BoundingBox box = root ? *root : BoundingBox();
+    const double bounds[6] = {box.getMinX(), box.getMinY(), box.getMinZ(), box.getMaxX(), box.getMaxY(), box.getMaxZ()};
+    writer.bytes(bounds, sizeof(bounds));
+    writer.value(static_cast<std::uint64_t>(atoms.size()));
+    for (const auto& atom : atoms) {
+        const std::string& element = atom.getChemicalElement();
+        if (element.size() > 255) {
+            throw std::invalid_argument("Element symbol too long: " + element);
+        }
+        writer.value(atom.getX());
+        writer.value(atom.getY());
+        writer.value(atom.getZ());
+        writer.value(static_cast<std::uint8_t>(element.size()));
+        writer.bytes(element.data(), element.size());
+    }
+
+    const std::vector<std::uint8_t> response = roundTrip();
+    Reader reader(response);
+    if (readHeader(reader, kResponseMagic) != kOk) {
+        std::string message(reader.value<std::uint32_t>(), '\0');
+        reader.bytes(&message[0], message.size());
+        throw std::runtime_error("Mesh server error: " + message);
+    }
+    HexMesh mesh;
+    const auto vertexCount = reader.value<std::uint64_t>();
+    const auto hexCount = reader.value<std::uint64_t>();
+    reader.vector(mesh.vertices, vertexCount);
+    reader.vector(mesh.hexahedra, hexCount);
+    reader.vector(mesh.levels, hexCount);
+    return mesh;
+}
+
+MeshServerStats MeshClient::getStats() {
+    Writer writer(buffer_);
+    writeHeader(writer, kRequestMagic, kStatsRequest);
+    const std::vector<std::uint8_t> response = roundTrip();
+    Reader reader(response);
+    if (readHeader(reader, kResponseMagic) != kOk) {
+        throw std::runtime_error("Mesh server rejected the stats request");
+    }
+    MeshServerStats stats;
+    stats.requests = reader.value<std::uint64_t>();
+    stats.errors = reader.value<std::uint64_t>();
+    stats.batches = reader.value<std::uint64_t>();
+    stats.largeJobs = reader.value<std::uint64_t>();
+    stats.atoms = reader.value<std::uint64_t>();
+    stats.cacheHits = reader.value<std::uint64_t>();
+    return stats;
+}
+
+void MeshClient::requestShutdown() {
+    Writer writer(buffer_);
+    writeHeader(writer, kRequestMagic, kShutdownRequest);
+    roundTrip();
+}
+
+} // namespace BioMesh
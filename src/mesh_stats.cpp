@@ -0,0 +1,107 @@
+#include "biomesh/mesh_stats.h"
+#include "biomesh/hex_mesh.h"
+#include "biomesh/linear_octree.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace BioMesh {
+
+void MeshStatistics::reset() {
+    *this = MeshStatistics();
+}
+
+LevelStatistics& MeshStatistics::level(unsigned level) {
+    if (levels.size() <= level) {
+        levels.resize(level + 1);
+    }
+    return levels[level];
+}
+
+void MeshStatistics::recordLeaves(const LinearOctree& tree) {
+    maxAtomsPerLeaf = tree.getMaxAtomsPerLeaf();
+    maxLevel = tree.getMaxLevel();
+    atoms = tree.getAtomKeys().size();
+    for (auto& counters : levels) {
+        counters.leaves = 0;
+        counters.occupiedLeaves = 0;
+    }
+    leafOccupancy.assign(maxAtomsPerLeaf + 2, 0);
+    for (const auto& leaf : tree.getLeaves()) {
+        LevelStatistics& counters = level(leaf.level);
+        ++counters.leaves;
+        if (leaf.atomCount > 0) {
+            ++counters.occupiedLeaves;
+        }
+        ++leafOccupancy[std::min<std::size_t>(leaf.atomCount, maxAtomsPerLeaf + 1)];
+    }
+}
+
+void MeshStatistics::recordMesh(const HexMesh& mesh) {
+    for (auto& counters : levels) {
+        counters.hexahedra = 0;
+    }
+    for (std::uint8_t hexLevel : mesh.levels) {
+        ++level(hexLevel).hexahedra;
+    }
+    vertices = mesh.getVertexCount();
+}
+
+void MeshStatistics::writeJson(std::ostream& out) const {
+    char seconds[32];
+    auto formatSeconds = [&](double value) {
+        std::snprintf(seconds, sizeof(seconds), "%.9f", value);
+        return seconds;
+    };
+
+    std::size_t leaves = 0;
+    std::size_t hexahedra = 0;
+    std::size_t balanceSplits = 0;
+    for (const auto& counters : levels) {
+        leaves += counters.leaves;
+        hexahedra += counters.hexahedra;
+        balanceSplits += counters.balanceSplits;
+    }
+
+    out << "{\n  \"atoms\": " << atoms << ",\n  \"maxLevel\": " << maxLevel
+        << ",\n  \"maxAtomsPerLeaf\": " << maxAtomsPerLeaf << ",\n  \"leaves\": " << leaves
+        << ",\n  \"hexahedra\": " << hexahedra << ",\n  \"vertices\": " << vertices
+        << ",\n  \"balancePasses\": " << balancePasses << ",\n  \"balanceSplits\": " << balanceSplits;
+    out << ",\n  \"seconds\": {\"build\": " << formatSeconds(buildSeconds);
+    out << ", \"balance\": " << formatSeconds(balanceSeconds);
+    out << ", \"meshInsert\": " << formatSeconds(meshInsertSeconds);
+    out << ", \"meshCompact\": " << formatSeconds(meshCompactSeconds);
+    out << ", \"meshPlace\": " << formatSeconds(meshPlaceSeconds);
+    out << ", \"meshRemap\": " << formatSeconds(meshRemapSeconds) << "}";
+
+    out << ",\n  \"levels\": [";
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        const LevelStatistics& counters = levels[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"level\": " << i << ", \"nodes\": " << counters.nodes
+            << ", \"leaves\": " << counters.leaves << ", \"occupiedLeaves\": " << counters.occupiedLeaves
+            << ", \"balanceSplits\": " << counters.balanceSplits << ", \"hexahedra\": " << counters.hexahedra
+            << ", \"buildSeconds\": " << formatSeconds(counters.buildSeconds) << "}";
+    }
+    out << (levels.empty() ? "]" : "\n  ]");
+
+    // Bucket i counts leaves with i atoms; the last bucket is "more than maxAtomsPerLeaf"
+    out << ",\n  \"leafOccupancy\": [";
+    for (std::size_t i = 0; i < leafOccupancy.size(); ++i) {
+        out << (i == 0 ? "" : ", ") << leafOccupancy[i];
+    }
+    out << "]\n}\n";
+}
+
+void MeshStatistics::writeJson(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot open statistics file: " + path);
+    }
+    writeJson(out);
+    if (!out) {
+        throw std::runtime_error("Failed to write statistics file: " + path);
+    }
+}
+
+} // namespace BioMesh
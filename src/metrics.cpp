@@ -0,0 +1,413 @@
+#include "biomesh/metrics.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <netinet/in.h>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace BioMesh {
+
+namespace {
+
+// Threads are assigned shards round-robin on first use
+std::size_t localShard() noexcept {
+    static std::atomic<std::size_t> nextShard{0};
+    thread_local const std::size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+    return shard;
+}
+
+std::uint64_t toBits(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double fromBits(std::uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool isValidName(const std::string& name) {
+    if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) {
+        return false;
+    }
+    return std::all_of(name.begin(), name.end(), [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == ':';
+    });
+}
+
+std::string renderLabels(const MetricLabels& labels) {
+    std::string out;
+    for (const auto& label : labels) {
+        if (!isValidName(label.first) || label.first.find(':') != std::string::npos) {
+            throw std::invalid_argument("Invalid metric label name: " + label.first);
+        }
+        out += out.empty() ? "" : ",";
+        out += label.first + "=\"";
+        for (char c : label.second) {
+            if (c == '\\' || c == '"') {
+                out += '\\';
+                out += c;
+            } else if (c == '\n') {
+                out += "\\n";
+            } else {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+    return out;
+}
+
+// Series name with labels, plus an optional extra label (the histogram "le")
+std::string seriesName(const std::string& name, const std::string& labels, const std::string& extra = "") {
+    if (labels.empty() && extra.empty()) {
+        return name;
+    }
+    return name + "{" + labels + (labels.empty() || extra.empty() ? "" : ",") + extra + "}";
+}
+
+std::string formatNumber(double value) {
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    std::ostringstream out;
+    out.precision(17);
+    out << value;
+    return out.str();
+}
+
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+void Counter::add(std::uint64_t amount) noexcept {
+    shards_[localShard()].slots[0].fetch_add(amount, std::memory_order_relaxed);
+}
+
+std::uint64_t Counter::getValue() const noexcept {
+    std::uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.slots[0].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Gauge::updateMax(std::int64_t value) noexcept {
+    std::int64_t current = value_.load(std::memory_order_relaxed);
+    while (current < value && !value_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+Histogram::Histogram(std::vector<double> upperBounds) : upperBounds_(std::move(upperBounds)) {
+    for (std::size_t i = 1; i < upperBounds_.size(); ++i) {
+        if (!(upperBounds_[i - 1] < upperBounds_[i])) {
+            throw std::invalid_argument("Histogram bounds must be strictly increasing");
+        }
+    }
+    // Slots: one per bucket including +Inf, then the sum
+    const std::size_t slots = upperBounds_.size() + 2;
+    cellsPerShard_ = (slots + 7) / 8;
+    cells_ = std::vector<MetricCell>(kMetricShards * cellsPerShard_);
+}
+
+void Histogram::observe(double value) noexcept {
+    const std::size_t bucket = static_cast<std::size_t>(
+        std::lower_bound(upperBounds_.begin(), upperBounds_.end(), value) - upperBounds_.begin());
+    MetricCell* shard = &cells_[localShard() * cellsPerShard_];
+    shard[bucket / 8].slots[bucket % 8].fetch_add(1, std::memory_order_relaxed);
+
+    const std::size_t sumSlot = upperBounds_.size() + 1;
+    std::atomic<std::uint64_t>& sum = shard[sumSlot / 8].slots[sumSlot % 8];
+    std::uint64_t bits = sum.load(std::memory_order_relaxed);
+    while (!sum.compare_exchange_weak(bits, toBits(fromBits(bits) + value), std::memory_order_relaxed)) {
+    }
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot result;
+    result.bucketCounts.assign(upperBounds_.size() + 1, 0);
+    const std::size_t sumSlot = upperBounds_.size() + 1;
+    for (std::size_t s = 0; s < kMetricShards; ++s) {
+        const MetricCell* shard = &cells_[s * cellsPerShard_];
+        for (std::size_t b = 0; b < result.bucketCounts.size(); ++b) {
+            result.bucketCounts[b] += shard[b / 8].slots[b % 8].load(std::memory_order_relaxed);
+        }
+        result.sum += fromBits(shard[sumSlot / 8].slots[sumSlot % 8].load(std::memory_order_relaxed));
+    }
+    for (std::uint64_t count : result.bucketCounts) {
+        result.count += count;
+    }
+    return result;
+}
+
+std::vector<double> Histogram::exponentialBounds(double start, double factor, std::size_t count) {
+    if (start <= 0.0 || factor <= 1.0) {
+        throw std::invalid_argument("Exponential bounds need start > 0 and factor > 1");
+    }
+    std::vector<double> bounds;
+    bounds.reserve(count);
+    for (double bound = start; bounds.size() < count; bound *= factor) {
+        bounds.push_back(bound);
+    }
+    return bounds;
+}
+
+std::vector<double> Histogram::latencyBounds() {
+    return exponentialBounds(1e-5, 4.0, 12);
+}
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, const std::string& help, Type type) {
+    if (!isValidName(name)) {
+        throw std::invalid_argument("Invalid metric name: " + name);
+    }
+    auto it = families_.find(name);
+    if (it == families_.end()) {
+        it = families_.emplace(name, Family{type, help, {}, {}, {}}).first;
+    } else if (it->second.type != type) {
+        throw std::invalid_argument("Metric " + name + " is already registered with another type");
+    }
+    return it->second;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    const std::string key = renderLabels(labels);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = family(name, help, Type::Counter).counters[key];
+    if (!slot) {
+        slot = std::make_unique<Counter>();
+    }
+    return *slot;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    const std::string key = renderLabels(labels);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = family(name, help, Type::Gauge).gauges[key];
+    if (!slot) {
+        slot = std::make_unique<Gauge>();
+    }
+    return *slot;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const MetricLabels& labels,
+                                      const std::vector<double>& upperBounds) {
+    const std::string key = renderLabels(labels);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = family(name, help, Type::Histogram).histograms[key];
+    if (!slot) {
+        slot = std::make_unique<Histogram>(upperBounds);
+    }
+    return *slot;
+}
+
+void MetricsRegistry::writePrometheus(std::ostream& out) const {
+    static const char* const kTypeNames[] = {"counter", "gauge", "histogram"};
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : families_) {
+        const std::string& name = entry.first;
+        const Family& family = entry.second;
+        std::string help = family.help;
+        for (std::size_t pos = 0; (pos = help.find_first_of("\\\n", pos)) != std::string::npos; pos += 2) {
+            help.replace(pos, 1, help[pos] == '\\' ? "\\\\" : "\\n");
+        }
+        out << "# HELP " << name << ' ' << help << '\n';
+        out << "# TYPE " << name << ' ' << kTypeNames[static_cast<int>(family.type)] << '\n';
+
+        for (const auto& series : family.counters) {
+            out << seriesName(name, series.first) << ' ' << series.second->getValue() << '\n';
+        }
+        for (const auto& series : family.gauges) {
+            out << seriesName(name, series.first) << ' ' << series.second->getValue() << '\n';
+        }
+        for (const auto& series : family.histograms) {
+            const Histogram::Snapshot snapshot = series.second->snapshot();
+            const auto& bounds = series.second->getUpperBounds();
+            std::uint64_t cumulative = 0;
+            for (std::size_t b = 0; b < snapshot.bucketCounts.size(); ++b) {
+                cumulative += snapshot.bucketCounts[b];
+                const double bound = b < bounds.size() ? bounds[b] : INFINITY;
+                out << seriesName(name + "_bucket", series.first, "le=\"" + formatNumber(bound) + "\"") << ' '
+                    << cumulative << '\n';
+            }
+            out << seriesName(name + "_sum", series.first) << ' ' << formatNumber(snapshot.sum) << '\n';
+            out << seriesName(name + "_count", series.first) << ' ' << snapshot.count << '\n';
+        }
+    }
+}
+
+Histogram& stageSeconds(const std::string& stage) {
+    return MetricsRegistry::global().histogram("biomesh_stage_seconds", "Duration of bulk operations in seconds",
+                                               {{"stage", stage}});
+}
+
+Counter& stageAtoms(const std::string& stage) {
+    return MetricsRegistry::global().counter("biomesh_stage_atoms_total", "Atoms processed by bulk operations",
+                                             {{"stage", stage}});
+}
+
+std::string MetricsRegistry::scrape() const {
+    std::ostringstream out;
+    writePrometheus(out);
+    return out.str();
+}
+
+MetricsEndpoint::MetricsEndpoint(const std::string& address, MetricsRegistry& registry) : registry_(registry) {
+    if (address.compare(0, 5, "unix:") == 0) {
+        socketPath_ = address.substr(5);
+        if (socketPath_.empty() || socketPath_.size() >= sizeof(sockaddr_un{}.sun_path)) {
+            throw std::invalid_argument("Invalid metrics socket path: " + socketPath_);
+        }
+    } else {
+        std::size_t parsed = 0;
+        unsigned long port = 0;
+        try {
+            port = std::stoul(address, &parsed);
+        } catch (const std::exception&) {
+            parsed = 0;
+        }
+        if (parsed == 0 || parsed != address.size() || port > 65535) {
+            throw std::invalid_argument("Metrics address must be a port number or unix:<path>: " + address);
+        }
+        port_ = static_cast<std::uint16_t>(port);
+    }
+}
+
+MetricsEndpoint::~MetricsEndpoint() {
+    stop();
+}
+
+void MetricsEndpoint::start() {
+    if (thread_.joinable()) {
+        throw std::runtime_error("Metrics endpoint is already running");
+    }
+
+    if (!socketPath_.empty()) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, socketPath_.c_str(), socketPath_.size() + 1);
+        // Replace a stale socket, but never delete anything else at the path
+        struct stat existing;
+        if (::lstat(socketPath_.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) {
+            ::unlink(socketPath_.c_str());
+        }
+        listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listenFd_ < 0 || ::bind(listenFd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            auto error = systemError("Cannot bind metrics socket " + socketPath_);
+            ::close(listenFd_);
+            listenFd_ = -1;
+            throw error;
+        }
+    } else {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port_);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        listenFd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const int reuse = 1;
+        if (listenFd_ >= 0) {
+            ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        }
+        if (listenFd_ < 0 || ::bind(listenFd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            auto error = systemError("Cannot bind metrics port " + std::to_string(port_));
+            ::close(listenFd_);
+            listenFd_ = -1;
+            throw error;
+        }
+        socklen_t length = sizeof(address);
+        ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&address), &length);
+        port_ = ntohs(address.sin_port);
+    }
+
+    if (::listen(listenFd_, 16) != 0) {
+        auto error = systemError("Cannot listen for metrics scrapes");
+        ::close(listenFd_);
+        listenFd_ = -1;
+        throw error;
+    }
+    thread_ = std::thread(&MetricsEndpoint::serveLoop, this);
+}
+
+void MetricsEndpoint::stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    ::shutdown(listenFd_, SHUT_RDWR);
+    thread_.join();
+    ::close(listenFd_);
+    listenFd_ = -1;
+    if (!socketPath_.empty()) {
+        ::unlink(socketPath_.c_str());
+    }
+}
+
+void MetricsEndpoint::serveLoop() {
+    while (true) {
+        const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return;  // listening socket shut down
+        }
+
+        // Read the request head; scrapers send a small GET without a body
+        timeval timeout{2, 0};
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        std::string request;
+        char buffer[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+            const ssize_t received = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (received <= 0) {
+                break;
+            }
+            request.append(buffer, static_cast<std::size_t>(received));
+        }
+
+        const std::string line = request.substr(0, request.find("\r\n"));
+        const bool isScrape = line.compare(0, 13, "GET /metrics ") == 0 || line == "GET /metrics" ||
+                              line.compare(0, 13, "GET /metrics?") == 0;
+        const std::string body = isScrape ? registry_.scrape() : "Not found\n";
+        std::string response = std::string("HTTP/1.1 ") + (isScrape ? "200 OK" : "404 Not Found") +
+                               "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8"
+                               "\r\nContent-Length: " + std::to_string(body.size()) +
+                               "\r\nConnection: close\r\n\r\n" + body;
+
+        const char* data = response.data();
+        std::size_t remaining = response.size();
+        while (remaining > 0) {
+            const ssize_t sent = ::send(fd, data, remaining, MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent <= 0) {
+                break;
+            }
+            data += sent;
+            remaining -= static_cast<std::size_t>(sent);
+        }
+        ::close(fd);
+    }
+}
+
+} // namespace BioMesh
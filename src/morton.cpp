@@ -0,0 +1,93 @@
+#include "biomesh/morton.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace BioMesh {
+
+namespace {
+
+// Spread the low 21 bits of v so that there are two zero bits between each
+std::uint64_t spreadBits(std::uint32_t v) {
+    std::uint64_t x = v & 0x1fffff;
+    x = (x | (x << 32)) & 0x1f00000000ffffULL;
+    x = (x | (x << 16)) & 0x1f0000ff0000ffULL;
+    x = (x | (x << 8)) & 0x100f00f00f00f00fULL;
+    x = (x | (x << 4)) & 0x10c30c30c30c30c3ULL;
+    x = (x | (x << 2)) & 0x1249249249249249ULL;
+    return x;
+}
+
+std::uint32_t compactBits(std::uint64_t x) {
+    x &= 0x1249249249249249ULL;
+    x = (x | (x >> 2)) & 0x10c30c30c30c30c3ULL;
+    x = (x | (x >> 4)) & 0x100f00f00f00f00fULL;
+    x = (x | (x >> 8)) & 0x1f0000ff0000ffULL;
+    x = (x | (x >> 16)) & 0x1f00000000ffffULL;
+    x = (x | (x >> 32)) & 0x1fffffULL;
+    return static_cast<std::uint32_t>(x);
+}
+
+std::uint32_t quantize(double value, double minValue, double scale) {
+    double cell = std::floor((value - minValue) * scale);
+    if (!(cell > 0.0)) {
+        return 0;
+    }
+    if (cell >= static_cast<double>(kMortonLatticeSize - 1)) {
+        return kMortonLatticeSize - 1;
+    }
+    return static_cast<std::uint32_t>(cell);
+}
+
+} // namespace
+
+std::uint64_t encodeMorton(std::uint32_t x, std::uint32_t y, std::uint32_t z) {
+    return (spreadBits(x) << 2) | (spreadBits(y) << 1) | spreadBits(z);
+}
+
+std::array<std::uint32_t, 3> decodeMorton(std::uint64_t key) {
+    return {compactBits(key >> 2), compactBits(key >> 1), compactBits(key)};
+}
+
+MortonEncoder::MortonEncoder(const BoundingBox& root) : root_(root) {
+    if (root.isEmpty()) {
+        throw std::invalid_argument("MortonEncoder requires a non-empty root bounding box");
+    }
+
+    const double extents[3] = {root.getWidth(), root.getHeight(), root.getDepth()};
+    for (int axis = 0; axis < 3; ++axis) {
+        scale_[axis] = extents[axis] > 0.0 ? static_cast<double>(kMortonLatticeSize) / extents[axis] : 0.0;
+    }
+}
+
+std::array<std::uint32_t, 3> MortonEncoder::toLattice(double x, double y, double z) const {
+    return {quantize(x, root_.getMinX(), scale_[0]),
+            quantize(y, root_.getMinY(), scale_[1]),
+            quantize(z, root_.getMinZ(), scale_[2])};
+}
+
+std::uint64_t MortonEncoder::encode(double x, double y, double z) const {
+    auto lattice = toLattice(x, y, z);
+    return encodeMorton(lattice[0], lattice[1], lattice[2]);
+}
+
+BoundingBox MortonEncoder::nodeBox(std::uint64_t key, unsigned level) const {
+    auto anchor = decodeMorton(key);
+    const double cells = static_cast<double>(std::uint32_t{1} << (kMortonLevels - level));
+    const double lattice = static_cast<double>(kMortonLatticeSize);
+
+    auto lower = [&](int axis, double minValue, double extent) {
+        return minValue + extent * (static_cast<double>(anchor[axis]) / lattice);
+    };
+    auto upper = [&](int axis, double minValue, double extent) {
+        return minValue + extent * ((static_cast<double>(anchor[axis]) + cells) / lattice);
+    };
+
+    return BoundingBox(lower(0, root_.getMinX(), root_.getWidth()),
+                       lower(1, root_.getMinY(), root_.getHeight()),
+                       lower(2, root_.getMinZ(), root_.getDepth()),
+                       upper(0, root_.getMinX(), root_.getWidth()),
+                       upper(1, root_.getMinY(), root_.getHeight()),
+                       upper(2, root_.getMinZ(), root_.getDepth()));
+}
+
+} // namespace BioMesh
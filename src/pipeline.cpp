@@ -0,0 +1,171 @@
+#include "biomesh/pipeline.h"
+#include "biomesh/metrics.h"
+#include "biomesh/trace.h"
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace BioMesh {
+
+AtomPipeline::AtomPipeline(std::size_t channelCapacity)
+    : channelCapacity_(channelCapacity) {
+    if (channelCapacity == 0) {
+        throw std::invalid_argument("AtomPipeline channel capacity must be greater than zero");
+    }
+}
+
+AtomPipeline& AtomPipeline::setSource(Source source) {
+    source_ = std::move(source);
+    return *this;
+}
+
+AtomPipeline& AtomPipeline::addStage(const std::string& name, Stage stage) {
+    MetricsRegistry& metrics = MetricsRegistry::global();
+    stages_.push_back(NamedStage{
+        name, std::move(stage), Tracer::instance().intern(name),
+        &metrics.histogram("biomesh_pipeline_chunk_seconds", "Pipeline stage time per chunk in seconds",
+                           {{"stage", name}}),
+        &metrics.counter("biomesh_pipeline_atoms_total", "Atoms processed by pipeline stages", {{"stage", name}})});
+    return *this;
+}
+
+AtomPipeline& AtomPipeline::setSink(Sink sink) {
+    sink_ = std::move(sink);
+    return *this;
+}
+
+void AtomPipeline::run() {
+    if (!source_) {
+        throw std::logic_error("AtomPipeline requires a source before run()");
+    }
+
+    // Channel i feeds stage i; the last channel feeds the sink
+    std::vector<std::unique_ptr<BoundedChannel<AtomChunk>>> channels;
+    channels.reserve(stages_.size() + 1);
+    for (std::size_t i = 0; i <= stages_.size(); ++i) {
+        channels.push_back(std::make_unique<BoundedChannel<AtomChunk>>(channelCapacity_));
+    }
+
+    std::mutex errorMutex;
+    std::exception_ptr firstError;
+
+    // On failure, closing every channel unblocks all stages so they can exit
+    auto fail = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!firstError) {
+                firstError = std::current_exception();
+            }
+        }
+        for (auto& channel : channels) {
+            channel->close();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(stages_.size() + 2);
+
+    threads.emplace_back([&]() {
+        BIOMESH_TRACE_THREAD_NAME("pipeline source");
+        try {
+            std::size_t sequence = 0;
+            while (true) {
+                AtomChunk chunk;
+                chunk.sequence = sequence++;
+                bool produced;
+                {
+                    BIOMESH_TRACE_SCOPE("AtomPipeline::source");
+                    produced = source_(chunk);
+                }
+                if (!produced || !channels.front()->push(std::move(chunk))) {
+                    break;
+                }
+            }
+        } catch (...) {
+            fail();
+        }
+        channels.front()->close();
+    });
+
+    for (std::size_t i = 0; i < stages_.size(); ++i) {
+        threads.emplace_back([&, i]() {
+            BoundedChannel<AtomChunk>& input = *channels[i];
+            BoundedChannel<AtomChunk>& output = *channels[i + 1];
+            BIOMESH_TRACE_THREAD_NAME("pipeline " + stages_[i].name);
+            try {
+                while (auto chunk = input.pop()) {
+                    {
+                        BIOMESH_TRACE_SCOPE(stages_[i].traceName);
+                        MetricsTimer metricsTimer(*stages_[i].chunkSeconds);
+                        stages_[i].callback(*chunk);
+                    }
+                    stages_[i].chunkAtoms->add(chunk->atoms.size());
+                    if (!output.push(std::move(*chunk))) {
+                        break;
+                    }
+                }
+            } catch (...) {
+                fail();
+            }
+            output.close();
+        });
+    }
+
+    threads.emplace_back([&]() {
+        BIOMESH_TRACE_THREAD_NAME("pipeline sink");
+        try {
+            while (auto chunk = channels.back()->pop()) {
+                if (sink_) {
+                    BIOMESH_TRACE_SCOPE("AtomPipeline::sink");
+                    sink_(std::move(*chunk));
+                }
+            }
+        } catch (...) {
+            fail();
+        }
+    });
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+AtomPipeline::Source AtomPipeline::makeChunkedSource(const std::vector<Atom>& atoms, std::size_t chunkSize) {
+    if (chunkSize == 0) {
+        throw std::invalid_argument("Chunk size must be greater than zero");
+    }
+
+    auto offset = std::make_shared<std::size_t>(0);
+    return [&atoms, chunkSize, offset](AtomChunk& chunk) {
+        if (*offset >= atoms.size()) {
+            return false;
+        }
+        std::size_t end = std::min(atoms.size(), *offset + chunkSize);
+        chunk.atoms.assign(atoms.begin() + static_cast<std::ptrdiff_t>(*offset),
+                           atoms.begin() + static_cast<std::ptrdiff_t>(end));
+        *offset = end;
+        return true;
+    };
+}
+
+AtomPipeline::Stage AtomPipeline::makeBuildStage(const AtomBuilder& builder) {
+    return [&builder](AtomChunk& chunk) {
+        chunk.atoms = builder.buildAtoms(chunk.atoms);
+    };
+}
+
+AtomPipeline::Stage AtomPipeline::makeBoundsStage(BoundingBox& bounds) {
+    return [&bounds](AtomChunk& chunk) {
+        for (const auto& atom : chunk.atoms) {
+            bounds.addPoint(atom.getX(), atom.getY(), atom.getZ());
+        }
+    };
+}
+
+} // namespace BioMesh
@@ -0,0 +1,629 @@
+#include "biomesh/selection.h"
+#include "biomesh/trace.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace BioMesh {
+
+// AtomBitset
+
+AtomBitset::AtomBitset(std::size_t size, bool value)
+    : size_(size), words_((size + 63) / 64, value ? ~std::uint64_t{0} : 0) {
+    if (value && (size & 63) != 0) {
+        words_.back() = (std::uint64_t{1} << (size & 63)) - 1;
+    }
+}
+
+std::size_t AtomBitset::count() const {
+    std::size_t total = 0;
+    for (std::uint64_t word : words_) {
+        total += static_cast<std::size_t>(__builtin_popcountll(word));
+    }
+    return total;
+}
+
+void AtomBitset::set(std::size_t index, bool value) {
+    const std::uint64_t bit = std::uint64_t{1} << (index & 63);
+    if (value) {
+        words_[index >> 6] |= bit;
+    } else {
+        words_[index >> 6] &= ~bit;
+    }
+}
+
+AtomBitset& AtomBitset::operator&=(const AtomBitset& other) {
+    if (other.size_ != size_) {
+        throw std::invalid_argument("Atom bitsets must have the same size");
+    }
+    for (std::size_t w = 0; w < words_.size(); ++w) {
+        words_[w] &= other.words_[w];
+    }
+    return *this;
+}
+
+AtomBitset& AtomBitset::operator|=(const AtomBitset& other) {
+    if (other.size_ != size_) {
+        throw std::invalid_argument("Atom bitsets must have the same size");
+    }
+    for (std::size_t w = 0; w < words_.size(); ++w) {
+        words_[w] |= other.words_[w];
+    }
+    return *this;
+}
+
+AtomBitset& AtomBitset::flip() {
+    for (auto& word : words_) {
+        word = ~word;
+    }
+    if ((size_ & 63) != 0) {
+        words_.back() &= (std::uint64_t{1} << (size_ & 63)) - 1;
+    }
+    return *this;
+}
+
+std::vector<std::uint32_t> AtomBitset::toIndices() const {
+    std::vector<std::uint32_t> indices;
+    indices.reserve(count());
+    for (std::size_t w = 0; w < words_.size(); ++w) {
+        std::uint64_t word = words_[w];
+        while (word != 0) {
+            indices.push_back(static_cast<std::uint32_t>(64 * w + static_cast<std::size_t>(__builtin_ctzll(word))));
+            word &= word - 1;
+        }
+    }
+    return indices;
+}
+
+// AtomColumns
+
+AtomColumns AtomColumns::fromAtoms(const std::vector<Atom>& atoms) {
+    BIOMESH_TRACE_SCOPE("AtomColumns::fromAtoms");
+    AtomColumns columns;
+    columns.x.resize(atoms.size());
+    columns.y.resize(atoms.size());
+    columns.z.resize(atoms.size());
+    columns.radius.resize(atoms.size());
+    columns.mass.resize(atoms.size());
+    columns.element.resize(atoms.size());
+
+    std::unordered_map<std::string, std::uint16_t> elementIds;
+    for (std::size_t i = 0; i < atoms.size(); ++i) {
+        const Atom& atom = atoms[i];
+        columns.x[i] = atom.getX();
+        columns.y[i] = atom.getY();
+        columns.z[i] = atom.getZ();
+        columns.radius[i] = atom.getAtomicRadius();
+        columns.mass[i] = atom.getAtomicMass();
+        auto found = elementIds.find(atom.getChemicalElement());
+        if (found == elementIds.end()) {
+            if (columns.elementSymbols.size() > std::numeric_limits<std::uint16_t>::max()) {
+                throw std::invalid_argument("Atom columns support at most 65535 distinct elements");
+            }
+            found = elementIds.emplace(atom.getChemicalElement(),
+                                       static_cast<std::uint16_t>(columns.elementSymbols.size())).first;
+            columns.elementSymbols.push_back(atom.getChemicalElement());
+        }
+        columns.element[i] = found->second;
+    }
+    return columns;
+}
+
+// NeighborIndex
+
+NeighborIndex::NeighborIndex(const AtomColumns& columns, const AtomBitset& subset, double cellSize)
+    : columns_(columns), cellSize_(cellSize) {
+    if (!(cellSize > 0.0)) {
+        throw std::invalid_argument("Neighbor index cell size must be positive");
+    }
+    if (subset.size() != columns.size()) {
+        throw std::invalid_argument("Neighbor index subset must cover every atom");
+    }
+    const std::vector<std::uint32_t> indices = subset.toIndices();
+    if (!indices.empty()) {
+        origin_[0] = origin_[1] = origin_[2] = std::numeric_limits<double>::max();
+        for (std::uint32_t i : indices) {
+            origin_[0] = std::min(origin_[0], columns.x[i]);
+            origin_[1] = std::min(origin_[1], columns.y[i]);
+            origin_[2] = std::min(origin_[2], columns.z[i]);
+        }
+    }
+    entries_.reserve(indices.size());
+    for (std::uint32_t i : indices) {
+        entries_.emplace_back(cellKey(cellCoordinate(columns.x[i], origin_[0]),
+                                      cellCoordinate(columns.y[i], origin_[1]),
+                                      cellCoordinate(columns.z[i], origin_[2])),
+                              i);
+    }
+    std::sort(entries_.begin(), entries_.end());
+}
+
+std::int64_t NeighborIndex::cellCoordinate(double value, double origin) const {
+    // Clamped so far-away query points cannot overflow; they have no neighbours anyway
+    const double cell = std::floor((value - origin) / cellSize_);
+    return static_cast<std::int64_t>(std::max(-1e15, std::min(1e15, cell)));
+}
+
+std::uint64_t NeighborIndex::cellKey(std::int64_t i, std::int64_t j, std::int64_t k) {
+    // Coordinates wrap modulo 2^21; colliding cells only add candidates that fail the distance test
+    constexpr std::uint64_t mask = (std::uint64_t{1} << 21) - 1;
+    return ((static_cast<std::uint64_t>(i) & mask) << 42) | ((static_cast<std::uint64_t>(j) & mask) << 21) |
+           (static_cast<std::uint64_t>(k) & mask);
+}
+
+bool NeighborIndex::anyWithin(double x, double y, double z, double distance) const {
+    const double limit = distance * distance;
+    const std::int64_t ci = cellCoordinate(x, origin_[0]);
+    const std::int64_t cj = cellCoordinate(y, origin_[1]);
+    const std::int64_t ck = cellCoordinate(z, origin_[2]);
+    for (std::int64_t di = -1; di <= 1; ++di) {
+        for (std::int64_t dj = -1; dj <= 1; ++dj) {
+            for (std::int64_t dk = -1; dk <= 1; ++dk) {
+                const std::uint64_t key = cellKey(ci + di, cj + dj, ck + dk);
+                auto it = std::lower_bound(entries_.begin(), entries_.end(), std::make_pair(key, std::uint32_t{0}));
+                for (; it != entries_.end() && it->first == key; ++it) {
+                    const double dx = columns_.x[it->second] - x;
+                    const double dy = columns_.y[it->second] - y;
+                    const double dz = columns_.z[it->second] - z;
+                    if (dx * dx + dy * dy + dz * dz <= limit) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// SelectionQuery
+
+namespace {
+
+using Op = SelectionQuery::Op;
+using Field = SelectionQuery::Field;
+using Comparison = SelectionQuery::Comparison;
+using Step = SelectionQuery::Step;
+
+struct Token {
+    enum class Kind { Word, Number, Operator, Open, Close, End } kind;
+    std::string text;
+    std::size_t position;
+};
+
+std::vector<Token> tokenize(const std::string& text) {
+    std::vector<Token> tokens;
+    std::size_t i = 0;
+    while (i < text.size()) {
+        const char c = text[i];
+        const std::size_t start = i;
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+        } else if (c == '(' || c == ')') {
+            tokens.push_back({c == '(' ? Token::Kind::Open : Token::Kind::Close, std::string(1, c), start});
+            ++i;
+        } else if (c == '<' || c == '>' || c == '=' || c == '!') {
+            ++i;
+            if (i < text.size() && text[i] == '=') {
+                ++i;
+            }
+            tokens.push_back({Token::Kind::Operator, text.substr(start, i - start), start});
+        } else if (std::isdigit(static_cast<unsigned char>(c)) || c == '.' || c == '-' || c == '+') {
+            const char* begin = text.c_str() + start;
+            char* end = nullptr;
+            std::strtod(begin, &end);
+            if (end == begin) {
+                throw std::invalid_argument("Selection syntax error at position " + std::to_string(start) +
+                                            ": invalid number");
+            }
+            i = start + static_cast<std::size_t>(end - begin);
+            tokens.push_back({Token::Kind::Number, text.substr(start, i - start), start});
+        } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            while (i < text.size() && (std::isalnum(static_cast<unsigned char>(text[i])) || text[i] == '_')) {
+                ++i;
+            }
+            tokens.push_back({Token::Kind::Word, text.substr(start, i - start), start});
+        } else {
+            throw std::invalid_argument("Selection syntax error at position " + std::to_string(start) +
+                                        ": unexpected '" + std::string(1, c) + "'");
+        }
+    }
+    tokens.push_back({Token::Kind::End, "", text.size()});
+    return tokens;
+}
+
+bool isKeyword(const std::string& word) {
+    static const char* const keywords[] = {"and", "or", "not", "within", "of", "to", "all", "none", "hydrogen",
+                                           "heavy", "element", "index", "x", "y", "z", "radius", "mass"};
+    return std::find(std::begin(keywords), std::end(keywords), word) != std::end(keywords);
+}
+
+/**
+ * @brief Recursive-descent parser emitting the postfix plan
+ */
+class Parser {
+public:
+    explicit Parser(const std::string& text) : tokens_(tokenize(text)) {}
+
+    std::vector<Step> parse() {
+        parseOr();
+        if (peek().kind != Token::Kind::End) {
+            fail("unexpected '" + peek().text + "'");
+        }
+        return std::move(plan_);
+    }
+
+private:
+    const Token& peek() const { return tokens_[position_]; }
+    const Token& next() { return tokens_[position_++]; }
+
+    bool acceptWord(const char* word) {
+        if (peek().kind == Token::Kind::Word && peek().text == word) {
+            ++position_;
+            return true;
+        }
+        return false;
+    }
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::invalid_argument("Selection syntax error at position " + std::to_string(peek().position) +
+                                    ": " + message);
+    }
+
+    double number() {
+        if (peek().kind != Token::Kind::Number) {
+            fail("expected a number");
+        }
+        return std::strtod(next().text.c_str(), nullptr);
+    }
+
+    double index() {
+        const double value = number();
+        if (value < 0.0 || value != std::floor(value)) {
+            fail("expected a non-negative integer index");
+        }
+        return value;
+    }
+
+    void emit(Op op) {
+        Step step;
+        step.op = op;
+        plan_.push_back(step);
+    }
+
+    void parseOr() {
+        parseAnd();
+        while (acceptWord("or")) {
+            parseAnd();
+            emit(Op::Or);
+        }
+    }
+
+    void parseAnd() {
+        parseUnary();
+        while (acceptWord("and")) {
+            parseUnary();
+            emit(Op::And);
+        }
+    }
+
+    void parseUnary() {
+        if (acceptWord("not")) {
+            parseUnary();
+            emit(Op::Not);
+        } else if (acceptWord("within")) {
+            const double distance = number();
+            if (distance < 0.0) {
+                fail("within distance must not be negative");
+            }
+            if (!acceptWord("of")) {
+                fail("expected 'of'");
+            }
+            parseUnary();
+            Step step;
+            step.op = Op::Within;
+            step.value = distance;
+            plan_.push_back(step);
+        } else {
+            parsePrimary();
+        }
+    }
+
+    void parsePrimary() {
+        const Token& token = peek();
+        if (token.kind == Token::Kind::Open) {
+            ++position_;
+            parseOr();
+            if (peek().kind != Token::Kind::Close) {
+                fail("expected ')'");
+            }
+            ++position_;
+            return;
+        }
+        if (token.kind != Token::Kind::Word) {
+            fail(token.kind == Token::Kind::End ? "unexpected end of selection" : "unexpected '" + token.text + "'");
+        }
+
+        Step step;
+        const std::string word = next().text;
+        if (word == "all" || word == "none") {
+            step.op = word == "all" ? Op::All : Op::None;
+        } else if (word == "hydrogen" || word == "heavy") {
+            step.op = Op::Element;
+            step.names = {"H"};
+            plan_.push_back(step);
+            if (word == "heavy") {
+                emit(Op::Not);
+            }
+            return;
+        } else if (word == "element") {
+            step.op = Op::Element;
+            while (peek().kind == Token::Kind::Word && !isKeyword(peek().text)) {
+                step.names.push_back(next().text);
+            }
+            if (step.names.empty()) {
+                fail("expected an element symbol");
+            }
+        } else if (word == "index") {
+            step.op = Op::IndexRange;
+            step.value = index();
+            step.upper = acceptWord("to") ? index() : step.value;
+            if (step.upper < step.value) {
+                fail("index range must be ascending");
+            }
+        } else if (word == "x" || word == "y" || word == "z" || word == "radius" || word == "mass") {
+            step.op = Op::Compare;
+            step.field = word == "x"        ? Field::X
+                         : word == "y"      ? Field::Y
+                         : word == "z"      ? Field::Z
+                         : word == "radius" ? Field::Radius
+                                            : Field::Mass;
+            if (peek().kind != Token::Kind::Operator) {
+                fail("expected a comparison");
+            }
+            const std::string comparison = next().text;
+            if (comparison == "<") {
+                step.comparison = Comparison::Less;
+            } else if (comparison == "<=") {
+                step.comparison = Comparison::LessEqual;
+            } else if (comparison == ">") {
+                step.comparison = Comparison::Greater;
+            } else if (comparison == ">=") {
+                step.comparison = Comparison::GreaterEqual;
+            } else if (comparison == "==") {
+                step.comparison = Comparison::Equal;
+            } else if (comparison == "!=") {
+                step.comparison = Comparison::NotEqual;
+            } else {
+                --position_;
+                fail("unknown comparison '" + comparison + "'");
+            }
+            step.value = number();
+        } else if (isKeyword(word)) {
+            --position_;
+            fail("unexpected '" + word + "'");
+        } else {
+            step.op = Op::Named;
+            step.names = {word};
+        }
+        plan_.push_back(step);
+    }
+
+    std::vector<Token> tokens_;
+    std::size_t position_ = 0;
+    std::vector<Step> plan_;
+};
+
+/**
+ * @brief Evaluate a predicate for every atom, 64 atoms per output word
+ */
+template <typename Predicate>
+AtomBitset fill(std::size_t count, Predicate predicate) {
+    AtomBitset result(count);
+    std::vector<std::uint64_t>& words = result.getWords();
+    for (std::size_t w = 0; w < words.size(); ++w) {
+        const std::size_t begin = 64 * w;
+        const std::size_t end = std::min(count, begin + 64);
+        std::uint64_t bits = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            bits |= static_cast<std::uint64_t>(predicate(i)) << (i - begin);
+        }
+        words[w] = bits;
+    }
+    return result;
+}
+
+const std::vector<double>& column(const AtomColumns& columns, Field field) {
+    switch (field) {
+    case Field::X: return columns.x;
+    case Field::Y: return columns.y;
+    case Field::Z: return columns.z;
+    case Field::Radius: return columns.radius;
+    case Field::Mass: return columns.mass;
+    }
+    return columns.x;
+}
+
+AtomBitset compare(const std::vector<double>& values, Comparison comparison, double threshold) {
+    // One loop per comparison keeps the branch out of the inner loop
+    const double* v = values.data();
+    switch (comparison) {
+    case Comparison::Less: return fill(values.size(), [=](std::size_t i) { return v[i] < threshold; });
+    case Comparison::LessEqual: return fill(values.size(), [=](std::size_t i) { return v[i] <= threshold; });
+    case Comparison::Greater: return fill(values.size(), [=](std::size_t i) { return v[i] > threshold; });
+    case Comparison::GreaterEqual: return fill(values.size(), [=](std::size_t i) { return v[i] >= threshold; });
+    case Comparison::Equal: return fill(values.size(), [=](std::size_t i) { return v[i] == threshold; });
+    case Comparison::NotEqual: return fill(values.size(), [=](std::size_t i) { return v[i] != threshold; });
+    }
+    return AtomBitset(values.size());
+}
+
+AtomBitset matchElements(const AtomColumns& columns, const std::vector<std::string>& symbols) {
+    std::vector<std::uint8_t> wanted(columns.elementSymbols.size(), 0);
+    for (std::size_t e = 0; e < wanted.size(); ++e) {
+        wanted[e] = std::find(symbols.begin(), symbols.end(), columns.elementSymbols[e]) != symbols.end();
+    }
+    const std::uint16_t* element = columns.element.data();
+    const std::uint8_t* table = wanted.data();
+    return fill(columns.size(), [=](std::size_t i) { return table[element[i]] != 0; });
+}
+
+AtomBitset within(const AtomColumns& columns, const AtomBitset& targets, double distance) {
+    const std::size_t count = columns.size();
+    if (targets.count() == 0) {
+        return AtomBitset(count);
+    }
+    const NeighborIndex index(columns, targets, distance > 0.0 ? distance : 1.0);
+
+    // Atoms outside the targets' box grown by the distance cannot qualify
+    double low[3] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+                     std::numeric_limits<double>::max()};
+    double high[3] = {std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(),
+                      std::numeric_limits<double>::lowest()};
+    for (std::uint32_t i : targets.toIndices()) {
+        low[0] = std::min(low[0], columns.x[i]);
+        low[1] = std::min(low[1], columns.y[i]);
+        low[2] = std::min(low[2], columns.z[i]);
+        high[0] = std::max(high[0], columns.x[i]);
+        high[1] = std::max(high[1], columns.y[i]);
+        high[2] = std::max(high[2], columns.z[i]);
+    }
+    return fill(count, [&](std::size_t i) {
+        const double x = columns.x[i];
+        const double y = columns.y[i];
+        const double z = columns.z[i];
+        if (targets.test(i)) {
+            return true;
+        }
+        if (x < low[0] - distance || x > high[0] + distance || y < low[1] - distance || y > high[1] + distance ||
+            z < low[2] - distance || z > high[2] + distance) {
+            return false;
+        }
+        return index.anyWithin(x, y, z, distance);
+    });
+}
+
+const char* comparisonText(Comparison comparison) {
+    switch (comparison) {
+    case Comparison::Less: return "<";
+    case Comparison::LessEqual: return "<=";
+    case Comparison::Greater: return ">";
+    case Comparison::GreaterEqual: return ">=";
+    case Comparison::Equal: return "==";
+    case Comparison::NotEqual: return "!=";
+    }
+    return "?";
+}
+
+const char* fieldText(Field field) {
+    switch (field) {
+    case Field::X: return "x";
+    case Field::Y: return "y";
+    case Field::Z: return "z";
+    case Field::Radius: return "radius";
+    case Field::Mass: return "mass";
+    }
+    return "?";
+}
+
+} // namespace
+
+SelectionQuery SelectionQuery::compile(const std::string& text) {
+    SelectionQuery query;
+    query.text_ = text;
+    query.plan_ = Parser(text).parse();
+    return query;
+}
+
+AtomBitset SelectionQuery::evaluate(const AtomColumns& columns,
+                                    const std::map<std::string, AtomBitset>& namedSets) const {
+    BIOMESH_TRACE_SCOPE("SelectionQuery::evaluate");
+    const std::size_t count = columns.size();
+    std::vector<AtomBitset> stack;
+    for (const Step& step : plan_) {
+        switch (step.op) {
+        case Op::All:
+        case Op::None:
+            stack.emplace_back(count, step.op == Op::All);
+            break;
+        case Op::Element:
+            stack.push_back(matchElements(columns, step.names));
+            break;
+        case Op::IndexRange: {
+            const double first = step.value;
+            const double last = step.upper;
+            stack.push_back(fill(count, [=](std::size_t i) {
+                return static_cast<double>(i) >= first && static_cast<double>(i) <= last;
+            }));
+            break;
+        }
+        case Op::Compare:
+            stack.push_back(compare(column(columns, step.field), step.comparison, step.value));
+            break;
+        case Op::Named: {
+            auto found = namedSets.find(step.names.front());
+            if (found == namedSets.end()) {
+                throw std::invalid_argument("Selection refers to undefined set '" + step.names.front() + "'");
+            }
+            if (found->second.size() != count) {
+                throw std::invalid_argument("Selection set '" + step.names.front() + "' has " +
+                                            std::to_string(found->second.size()) + " atoms, expected " +
+                                            std::to_string(count));
+            }
+            stack.push_back(found->second);
+            break;
+        }
+        case Op::Not:
+            stack.back().flip();
+            break;
+        case Op::And:
+        case Op::Or: {
+            AtomBitset right = std::move(stack.back());
+            stack.pop_back();
+            if (step.op == Op::And) {
+                stack.back() &= right;
+            } else {
+                stack.back() |= right;
+            }
+            break;
+        }
+        case Op::Within:
+            stack.back() = within(columns, stack.back(), step.value);
+            break;
+        }
+    }
+    return stack.empty() ? AtomBitset(count) : std::move(stack.back());
+}
+
+std::string SelectionQuery::describe() const {
+    std::ostringstream out;
+    for (const Step& step : plan_) {
+        switch (step.op) {
+        case Op::All: out << "all"; break;
+        case Op::None: out << "none"; break;
+        case Op::Element:
+            out << "element";
+            for (const auto& name : step.names) {
+                out << ' ' << name;
+            }
+            break;
+        case Op::IndexRange: out << "index " << step.value << " to " << step.upper; break;
+        case Op::Compare:
+            out << "compare " << fieldText(step.field) << ' ' << comparisonText(step.comparison) << ' ' << step.value;
+            break;
+        case Op::Named: out << "set " << step.names.front(); break;
+        case Op::Not: out << "not"; break;
+        case Op::And: out << "and"; break;
+        case Op::Or: out << "or"; break;
+        case Op::Within: out << "within " << step.value; break;
+        }
+        out << '\n';
+    }
+    return out.str();
+}
+
+} // namespace BioMesh
@@ -0,0 +1,250 @@
+#include "biomesh/shard.h"
+#include "biomesh/shared_memory.h"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace BioMesh {
+
+namespace {
+
+constexpr unsigned kMaxShardLevels = 7;
+constexpr std::uint64_t kPendingCount = std::numeric_limits<std::uint64_t>::max();
+
+/**
+ * @brief Append the indices of all leaf shards whose halo region contains a point
+ */
+void collectHaloShards(const BoundingBox& box, unsigned level, unsigned levels, std::size_t firstIndex,
+                       double halo, double x, double y, double z, std::vector<std::size_t>& out) {
+    if (level == levels) {
+        out.push_back(firstIndex);
+        return;
+    }
+
+    std::size_t stride = std::size_t{1} << (3 * (levels - level - 1));
+    auto children = box.subdivide();
+    for (std::size_t octant = 0; octant < children.size(); ++octant) {
+        BoundingBox expanded = children[octant];
+        expanded.expand(halo);
+        if (expanded.contains(x, y, z)) {
+            collectHaloShards(children[octant], level + 1, levels, firstIndex + octant * stride,
+                              halo, x, y, z, out);
+        }
+    }
+}
+
+void collectLeafRegions(const BoundingBox& box, unsigned level, unsigned levels, std::vector<ShardSpec>& shards) {
+    if (level == levels) {
+        ShardSpec spec;
+        spec.index = shards.size();
+        spec.ownedRegion = box;
+        shards.push_back(std::move(spec));
+        return;
+    }
+    for (const auto& child : box.subdivide()) {
+        collectLeafRegions(child, level + 1, levels, shards);
+    }
+}
+
+} // namespace
+
+ShardPlan::ShardPlan(const std::vector<Atom>& atoms, double probeRadius, unsigned levels)
+    : levels_(levels) {
+    if (probeRadius < 0.0) {
+        throw std::invalid_argument("Probe radius must be non-negative");
+    }
+    if (levels == 0 || levels > kMaxShardLevels) {
+        throw std::invalid_argument("Shard levels must be between 1 and " + std::to_string(kMaxShardLevels));
+    }
+
+    rootBox_.calculateFromAtoms(atoms);
+
+    double maxRadius = 0.0;
+    for (const auto& atom : atoms) {
+        maxRadius = std::max(maxRadius, atom.getAtomicRadius());
+    }
+    haloWidth_ = maxRadius + probeRadius;
+
+    shards_.reserve(std::size_t{1} << (3 * levels));
+    collectLeafRegions(rootBox_, 0, levels_, shards_);
+    for (auto& shard : shards_) {
+        shard.haloRegion = shard.ownedRegion;
+        shard.haloRegion.expand(haloWidth_);
+    }
+
+    // Owned atoms first so each worker sees them as a contiguous prefix
+    for (std::size_t i = 0; i < atoms.size(); ++i) {
+        const Atom& atom = atoms[i];
+        shards_[getOwningShard(atom.getX(), atom.getY(), atom.getZ())].atomIndices.push_back(i);
+    }
+    for (auto& shard : shards_) {
+        shard.ownedCount = shard.atomIndices.size();
+    }
+
+    std::vector<std::size_t> haloShards;
+    for (std::size_t i = 0; i < atoms.size(); ++i) {
+        const Atom& atom = atoms[i];
+        std::size_t owner = getOwningShard(atom.getX(), atom.getY(), atom.getZ());
+        haloShards.clear();
+        collectHaloShards(rootBox_, 0, levels_, 0, haloWidth_, atom.getX(), atom.getY(), atom.getZ(), haloShards);
+        for (std::size_t shard : haloShards) {
+            if (shard != owner) {
+                shards_[shard].atomIndices.push_back(i);
+            }
+        }
+    }
+}
+
+std::size_t ShardPlan::getOwningShard(double x, double y, double z) const {
+    if (!rootBox_.contains(x, y, z)) {
+        throw std::out_of_range("Point lies outside the shard plan root box");
+    }
+
+    // Descend with the same midpoints subdivide() uses; points on a midplane go to the upper octant
+    BoundingBox box = rootBox_;
+    std::size_t index = 0;
+    for (unsigned level = 0; level < levels_; ++level) {
+        double centerX, centerY, centerZ;
+        box.getCenter(centerX, centerY, centerZ);
+        std::size_t octant = (x >= centerX ? 4 : 0) + (y >= centerY ? 2 : 0) + (z >= centerZ ? 1 : 0);
+        index = index * 8 + octant;
+        box = box.subdivide()[octant];
+    }
+    return index;
+}
+
+ShardedLauncher::ShardedLauncher(std::size_t maxWorkers, std::size_t outputCapacity)
+    : maxWorkers_(maxWorkers), outputCapacity_(outputCapacity) {
+    if (maxWorkers == 0) {
+        throw std::invalid_argument("ShardedLauncher requires at least one worker");
+    }
+}
+
+std::vector<std::vector<double>> ShardedLauncher::run(const ShardPlan& plan, const std::vector<Atom>& atoms,
+                                                      const Worker& worker) const {
+    const auto& shards = plan.getShards();
+    const std::size_t shardCount = shards.size();
+
+    // Segment layout: [result slots][result counts][x column][y column][z column][radius column]
+    std::vector<std::size_t> columnOffsets(shardCount + 1, 0);
+    for (std::size_t s = 0; s < shardCount; ++s) {
+        columnOffsets[s + 1] = columnOffsets[s] + shards[s].atomIndices.size();
+    }
+    const std::size_t totalAtoms = columnOffsets.back();
+    const std::size_t resultDoubles = shardCount * outputCapacity_;
+    const std::size_t bytes = resultDoubles * sizeof(double) + shardCount * sizeof(std::uint64_t) +
+                              4 * totalAtoms * sizeof(double);
+
+    SharedMemorySegment segment(bytes);
+    double* results = static_cast<double*>(segment.getData());
+    auto* counts = reinterpret_cast<std::uint64_t*>(results + resultDoubles);
+    double* columns = reinterpret_cast<double*>(counts + shardCount);
+    double* xs = columns;
+    double* ys = xs + totalAtoms;
+    double* zs = ys + totalAtoms;
+    double* radii = zs + totalAtoms;
+
+    for (std::size_t s = 0; s < shardCount; ++s) {
+        counts[s] = kPendingCount;
+        std::size_t offset = columnOffsets[s];
+        for (std::size_t atomIndex : shards[s].atomIndices) {
+            const Atom& atom = atoms.at(atomIndex);
+            xs[offset] = atom.getX();
+            ys[offset] = atom.getY();
+            zs[offset] = atom.getZ();
+            radii[offset] = atom.getAtomicRadius();
+            ++offset;
+        }
+    }
+
+    std::deque<std::pair<pid_t, std::size_t>> running;
+    std::vector<std::size_t> failedShards;
+
+    auto reapOldest = [&]() {
+        auto [pid, shardIndex] = running.front();
+        running.pop_front();
+        int status = 0;
+        if (::waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0 ||
+            counts[shardIndex] == kPendingCount) {
+            failedShards.push_back(shardIndex);
+        }
+    };
+
+    bool forkFailed = false;
+    for (std::size_t s = 0; s < shardCount && !forkFailed; ++s) {
+        if (shards[s].ownedCount == 0) {
+            continue;
+        }
+        if (running.size() >= maxWorkers_) {
+            reapOldest();
+        }
+
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            forkFailed = true;
+            break;
+        }
+        if (pid == 0) {
+            int exitCode = 0;
+            try {
+                std::size_t offset = columnOffsets[s];
+                ShardView view;
+                view.spec = &shards[s];
+                view.x = xs + offset;
+                view.y = ys + offset;
+                view.z = zs + offset;
+                view.radius = radii + offset;
+                view.atomCount = shards[s].atomIndices.size();
+                view.ownedCount = shards[s].ownedCount;
+
+                std::size_t written = worker(view, results + s * outputCapacity_, outputCapacity_);
+                if (written > outputCapacity_) {
+                    exitCode = 2;
+                } else {
+                    counts[s] = written;
+                }
+            } catch (...) {
+                exitCode = 1;
+            }
+            ::_exit(exitCode);
+        }
+        running.emplace_back(pid, s);
+    }
+
+    while (!running.empty()) {
+        reapOldest();
+    }
+
+    if (forkFailed) {
+        throw std::runtime_error("Failed to start shard worker process");
+    }
+    if (!failedShards.empty()) {
+        std::sort(failedShards.begin(), failedShards.end());
+        throw std::runtime_error("Shard worker failed for shard " + std::to_string(failedShards.front()));
+    }
+
+    std::vector<std::vector<double>> output(shardCount);
+    for (std::size_t s = 0; s < shardCount; ++s) {
+        if (shards[s].ownedCount == 0) {
+            continue;
+        }
+        const double* slot = results + s * outputCapacity_;
+        output[s].assign(slot, slot + counts[s]);
+    }
+    return output;
+}
+
+MemoryUsage ShardPlan::memoryUsage() const {
+    MemoryUsage usage = BioMesh::memoryUsage(shards_);
+    for (const auto& shard : shards_) {
+        usage += BioMesh::memoryUsage(shard.atomIndices);
+    }
+    return usage;
+}
+
+} // namespace BioMesh
@@ -0,0 +1,43 @@
+#include "biomesh/shared_memory.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace BioMesh {
+
+SharedMemorySegment::SharedMemorySegment(std::size_t bytes)
+    : bytes_(std::max<std::size_t>(bytes, sizeof(std::uint64_t))) {
+    static std::atomic<unsigned> counter{0};
+    std::string name = "/biomesh_" + std::to_string(::getpid()) + "_" + std::to_string(counter++);
+
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create shared memory segment '" + name + "'");
+    }
+    // The mapping outlives the name; unlinking now guarantees cleanup on any exit path
+    ::shm_unlink(name.c_str());
+
+    if (::ftruncate(fd, static_cast<off_t>(bytes_)) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to size shared memory segment '" + name + "'");
+    }
+    data_ = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        throw std::runtime_error("Failed to map shared memory segment '" + name + "'");
+    }
+}
+
+SharedMemorySegment::~SharedMemorySegment() {
+    if (data_) {
+        ::munmap(data_, bytes_);
+    }
+}
+
+} // namespace BioMesh
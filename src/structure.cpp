@@ -0,0 +1,133 @@
+#include "biomesh/structure.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace BioMesh {
+
+PackedName packName(std::string_view name) {
+    while (!name.empty() && name.back() == ' ') {
+        name.remove_suffix(1);
+    }
+    if (name.size() > sizeof(PackedName)) {
+        throw std::invalid_argument("Name '" + std::string(name) + "' is longer than 8 characters");
+    }
+    PackedName packed = 0;
+    for (std::size_t i = 0; i < name.size(); ++i) {
+        packed |= static_cast<PackedName>(static_cast<unsigned char>(name[i])) << (8 * i);
+    }
+    return packed;
+}
+
+std::string unpackName(PackedName packed) {
+    std::string name;
+    for (; packed != 0; packed >>= 8) {
+        name.push_back(static_cast<char>(packed & 0xFF));
+    }
+    return name;
+}
+
+StructureHierarchy::StructureHierarchy()
+    : modelChainOffsets_{0}, chainResidueOffsets_{0}, residueAtomOffsets_{0} {}
+
+void StructureHierarchy::addAtom(const AtomIdentity& identity) {
+    addAtom(identity.model, packName(identity.chainId), packName(identity.residueName), identity.residueNumber,
+            identity.insertionCode);
+}
+
+void StructureHierarchy::addAtom(std::int32_t model, PackedName chainId, PackedName residueName,
+                                 std::int32_t residueNumber, char insertionCode) {
+    if (residueAtomOffsets_.back() == std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("Structure hierarchy supports at most 2^32 - 1 atoms");
+    }
+
+    // A group that changes starts a new child group at the current end of each level below
+    const bool newModel = modelNumbers_.empty() || modelNumbers_.back() != model;
+    if (newModel) {
+        modelNumbers_.push_back(model);
+        modelChainOffsets_.push_back(modelChainOffsets_.back());
+    }
+    const bool newChain = newModel || chainIds_.back() != chainId;
+    if (newChain) {
+        chainIds_.push_back(chainId);
+        chainResidueOffsets_.push_back(chainResidueOffsets_.back());
+        ++modelChainOffsets_.back();
+    }
+    const bool newResidue = newChain || residueNames_.back() != residueName ||
+                            residueNumbers_.back() != residueNumber || insertionCodes_.back() != insertionCode;
+    if (newResidue) {
+        residueNames_.push_back(residueName);
+        residueNumbers_.push_back(residueNumber);
+        insertionCodes_.push_back(insertionCode);
+        residueAtomOffsets_.push_back(residueAtomOffsets_.back());
+        ++chainResidueOffsets_.back();
+    }
+    ++residueAtomOffsets_.back();
+}
+
+std::size_t StructureHierarchy::findResidueOfAtom(std::size_t atom) const {
+    if (atom >= getAtomCount()) {
+        throw std::out_of_range("Atom " + std::to_string(atom) + " is past the structure hierarchy");
+    }
+    // Residues are never empty, so the last offset not above atom is unique
+    auto it = std::upper_bound(residueAtomOffsets_.begin(), residueAtomOffsets_.end(), atom);
+    return static_cast<std::size_t>(it - residueAtomOffsets_.begin()) - 1;
+}
+
+std::size_t StructureHierarchy::findChainOfResidue(std::size_t residue) const {
+    if (residue >= getResidueCount()) {
+        throw std::out_of_range("Residue " + std::to_string(residue) + " is past the structure hierarchy");
+    }
+    auto it = std::upper_bound(chainResidueOffsets_.begin(), chainResidueOffsets_.end(), residue);
+    return static_cast<std::size_t>(it - chainResidueOffsets_.begin()) - 1;
+}
+
+AtomBitset StructureHierarchy::selectChains(const std::vector<std::string>& chainIds) const {
+    std::vector<PackedName> wanted;
+    for (const auto& id : chainIds) {
+        wanted.push_back(packName(id));
+    }
+    AtomBitset selected(getAtomCount());
+    for (std::size_t c = 0; c < getChainCount(); ++c) {
+        if (std::find(wanted.begin(), wanted.end(), chainIds_[c]) != wanted.end()) {
+            const IndexRange atoms = getChainAtoms(c);
+            for (std::uint32_t a = atoms.begin; a < atoms.end; ++a) {
+                selected.set(a);
+            }
+        }
+    }
+    return selected;
+}
+
+AtomBitset StructureHierarchy::selectResidueNames(const std::vector<std::string>& residueNames) const {
+    std::vector<PackedName> wanted;
+    for (const auto& name : residueNames) {
+        wanted.push_back(packName(name));
+    }
+    AtomBitset selected(getAtomCount());
+    for (std::size_t r = 0; r < getResidueCount(); ++r) {
+        if (std::find(wanted.begin(), wanted.end(), residueNames_[r]) != wanted.end()) {
+            for (std::uint32_t a = residueAtomOffsets_[r]; a < residueAtomOffsets_[r + 1]; ++a) {
+                selected.set(a);
+            }
+        }
+    }
+    return selected;
+}
+
+std::vector<std::uint32_t> StructureHierarchy::getChainAtomOffsets() const {
+    std::vector<std::uint32_t> offsets(chainResidueOffsets_.size());
+    for (std::size_t c = 0; c < offsets.size(); ++c) {
+        offsets[c] = residueAtomOffsets_[chainResidueOffsets_[c]];
+    }
+    return offsets;
+}
+
+MemoryUsage StructureHierarchy::memoryUsage() const {
+    return BioMesh::memoryUsage(modelNumbers_) + BioMesh::memoryUsage(modelChainOffsets_) +
+           BioMesh::memoryUsage(chainIds_) + BioMesh::memoryUsage(chainResidueOffsets_) +
+           BioMesh::memoryUsage(residueNames_) + BioMesh::memoryUsage(residueNumbers_) +
+           BioMesh::memoryUsage(insertionCodes_) + BioMesh::memoryUsage(residueAtomOffsets_);
+}
+
+} // namespace BioMesh
@@ -0,0 +1,264 @@
+#include "biomesh/synthetic.h"
+#include "biomesh/trace.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+namespace BioMesh {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kAtomDensity = 0.1;        // atoms per cubic Angstrom (proteins and water alike)
+constexpr double kShellThickness = 30.0;    // capsid protein shell (Angstrom)
+constexpr double kFibreAspect = 20.0;       // fibre length in diameters
+constexpr double kWaterBond = 0.9572;       // O-H distance (Angstrom)
+constexpr double kWaterHalfAngle = 52.26 * kPi / 180.0;  // half of the H-O-H angle (radians)
+
+// Cumulative protein composition including hydrogens
+struct ElementShare {
+    double cumulative;
+    const char* element;
+};
+constexpr ElementShare kProteinMix[] = {
+    {0.490, "H"}, {0.810, "C"}, {0.910, "O"}, {0.995, "N"}, {1.000, "S"},
+};
+
+/**
+ * @brief Counter-based random stream (SplitMix64) keyed by seed and index
+ */
+class IndexedRandom {
+public:
+    IndexedRandom(std::uint64_t seed, std::uint64_t index)
+        : state_(seed ^ (index * 0xD1B54A32D192ED03ULL)) {
+    }
+
+    std::uint64_t next() {
+        std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /// Uniform double in [0, 1)
+    double uniform() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+private:
+    std::uint64_t state_;
+};
+
+const char* proteinElement(double u) {
+    for (const auto& share : kProteinMix) {
+        if (u < share.cumulative) {
+            return share.element;
+        }
+    }
+    return kProteinMix[4].element;
+}
+
+void unitVector(IndexedRandom& rng, double out[3]) {
+    const double z = 2.0 * rng.uniform() - 1.0;
+    const double phi = 2.0 * kPi * rng.uniform();
+    const double s = std::sqrt(std::max(0.0, 1.0 - z * z));
+    out[0] = s * std::cos(phi);
+    out[1] = s * std::sin(phi);
+    out[2] = z;
+}
+
+} // namespace
+
+SyntheticMoleculeGenerator::SyntheticMoleculeGenerator(SyntheticShape shape, std::size_t atomCount,
+                                                       std::uint64_t seed)
+    : shape_(shape), atomCount_(atomCount), seed_(seed), outerRadius_(0.0), innerRadius_(0.0), length_(0.0) {
+    if (atomCount == 0) {
+        throw std::invalid_argument("Synthetic structure needs at least one atom");
+    }
+
+    const double volume = static_cast<double>(atomCount) / kAtomDensity;
+    switch (shape) {
+    case SyntheticShape::Globular:
+        outerRadius_ = std::cbrt(3.0 * volume / (4.0 * kPi));
+        break;
+    case SyntheticShape::Capsid: {
+        // Shell of fixed thickness; small structures keep 30% of the radius as shell instead
+        auto inner = [](double outer) { return std::max(outer - kShellThickness, 0.7 * outer); };
+        auto shellVolume = [&inner](double outer) {
+            const double r = inner(outer);
+            return 4.0 / 3.0 * kPi * (outer * outer * outer - r * r * r);
+        };
+        double low = 0.0;
+        double high = kShellThickness;
+        while (shellVolume(high) < volume) {
+            low = high;
+            high *= 2.0;
+        }
+        for (int i = 0; i < 64; ++i) {
+            const double mid = 0.5 * (low + high);
+            (shellVolume(mid) < volume ? low : high) = mid;
+        }
+        outerRadius_ = high;
+        innerRadius_ = inner(high);
+        break;
+    }
+    case SyntheticShape::Fibre:
+        outerRadius_ = std::cbrt(volume / (2.0 * kFibreAspect * kPi));
+        length_ = 2.0 * kFibreAspect * outerRadius_;
+        break;
+    case SyntheticShape::WaterBox:
+        length_ = std::cbrt(volume);
+        break;
+    }
+}
+
+Atom SyntheticMoleculeGenerator::makeAtom(std::size_t index) const {
+    if (shape_ == SyntheticShape::WaterBox) {
+        // Every atom of a molecule replays the molecule's stream: O, then two H
+        IndexedRandom rng(seed_, index / 3);
+        double oxygen[3] = {length_ * rng.uniform(), length_ * rng.uniform(), length_ * rng.uniform()};
+        const int part = static_cast<int>(index % 3);
+        if (part == 0) {
+            return Atom(oxygen[0], oxygen[1], oxygen[2], "O");
+        }
+
+        double bisector[3];
+        double axis[3];
+        unitVector(rng, bisector);
+        unitVector(rng, axis);
+        // Perpendicular component of axis gives the molecular plane
+        const double dot = axis[0] * bisector[0] + axis[1] * bisector[1] + axis[2] * bisector[2];
+        double perpendicular[3] = {axis[0] - dot * bisector[0], axis[1] - dot * bisector[1], axis[2] - dot * bisector[2]};
+        double norm = std::sqrt(perpendicular[0] * perpendicular[0] + perpendicular[1] * perpendicular[1] +
+                                perpendicular[2] * perpendicular[2]);
+        if (norm < 1e-9) {
+            perpendicular[0] = -bisector[1];
+            perpendicular[1] = bisector[0];
+            perpendicular[2] = 0.0;
+            norm = std::sqrt(perpendicular[0] * perpendicular[0] + perpendicular[1] * perpendicular[1]);
+            if (norm < 1e-9) {
+                perpendicular[0] = 1.0;
+                norm = 1.0;
+            }
+        }
+        const double sign = part == 1 ? 1.0 : -1.0;
+        const double along = kWaterBond * std::cos(kWaterHalfAngle);
+        const double across = sign * kWaterBond * std::sin(kWaterHalfAngle) / norm;
+        return Atom(oxygen[0] + along * bisector[0] + across * perpendicular[0],
+                    oxygen[1] + along * bisector[1] + across * perpendicular[1],
+                    oxygen[2] + along * bisector[2] + across * perpendicular[2], "H");
+    }
+
+    IndexedRandom rng(seed_, index);
+    const char* element = proteinElement(rng.uniform());
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+    switch (shape_) {
+    case SyntheticShape::Globular:
+    case SyntheticShape::Capsid: {
+        // Radius with density proportional to r^2 between the inner and outer radius
+        const double inner3 = innerRadius_ * innerRadius_ * innerRadius_;
+        const double outer3 = outerRadius_ * outerRadius_ * outerRadius_;
+        const double r = std::cbrt(inner3 + rng.uniform() * (outer3 - inner3));
+        double direction[3];
+        unitVector(rng, direction);
+        x = r * direction[0];
+        y = r * direction[1];
+        z = r * direction[2];
+        break;
+    }
+    case SyntheticShape::Fibre: {
+        const double r = outerRadius_ * std::sqrt(rng.uniform());
+        const double phi = 2.0 * kPi * rng.uniform();
+        x = r * std::cos(phi);
+        y = r * std::sin(phi);
+        z = length_ * rng.uniform();
+        break;
+    }
+    case SyntheticShape::WaterBox:
+        break;
+    }
+    return Atom(x, y, z, element);
+}
+
+std::vector<Atom> SyntheticMoleculeGenerator::generate() const {
+    std::vector<Atom> atoms;
+    generateRange(0, atomCount_, atoms);
+    return atoms;
+}
+
+void SyntheticMoleculeGenerator::generateRange(std::size_t first, std::size_t count, std::vector<Atom>& out) const {
+    BIOMESH_TRACE_SCOPE("SyntheticMoleculeGenerator::generateRange");
+    if (first > atomCount_) {
+        throw std::out_of_range("Synthetic atom range starts past the end of the structure");
+    }
+    const std::size_t end = first + std::min(count, atomCount_ - first);
+    out.clear();
+    out.reserve(end - first);
+    for (std::size_t i = first; i < end; ++i) {
+        out.push_back(makeAtom(i));
+    }
+}
+
+AtomPipeline::Source SyntheticMoleculeGenerator::makeSource(std::size_t chunkSize) const {
+    if (chunkSize == 0) {
+        throw std::invalid_argument("Chunk size must be greater than zero");
+    }
+
+    auto offset = std::make_shared<std::size_t>(0);
+    return [this, chunkSize, offset](AtomChunk& chunk) {
+        if (*offset >= atomCount_) {
+            return false;
+        }
+        generateRange(*offset, chunkSize, chunk.atoms);
+        *offset += chunk.atoms.size();
+        return true;
+    };
+}
+
+BoundingBox SyntheticMoleculeGenerator::getExtent() const {
+    switch (shape_) {
+    case SyntheticShape::Globular:
+    case SyntheticShape::Capsid:
+        return BoundingBox(-outerRadius_, -outerRadius_, -outerRadius_, outerRadius_, outerRadius_, outerRadius_);
+    case SyntheticShape::Fibre:
+        return BoundingBox(-outerRadius_, -outerRadius_, 0.0, outerRadius_, outerRadius_, length_);
+    case SyntheticShape::WaterBox:
+        // Hydrogens may stick out of the oxygen cube by one bond length
+        return BoundingBox(-kWaterBond, -kWaterBond, -kWaterBond,
+                           length_ + kWaterBond, length_ + kWaterBond, length_ + kWaterBond);
+    }
+    return BoundingBox();
+}
+
+SyntheticShape SyntheticMoleculeGenerator::parseShape(const std::string& name) {
+    if (name == "globular") {
+        return SyntheticShape::Globular;
+    }
+    if (name == "capsid") {
+        return SyntheticShape::Capsid;
+    }
+    if (name == "fibre") {
+        return SyntheticShape::Fibre;
+    }
+    if (name == "water") {
+        return SyntheticShape::WaterBox;
+    }
+    throw std::invalid_argument("Unknown synthetic shape: " + name);
+}
+
+std::string SyntheticMoleculeGenerator::getShapeName(SyntheticShape shape) {
+    switch (shape) {
+    case SyntheticShape::Globular:
+        return "globular";
+    case SyntheticShape::Capsid:
+        return "capsid";
+    case SyntheticShape::Fibre:
+        return "fibre";
+    case SyntheticShape::WaterBox:
+        return "water";
+    }
+    return "unknown";
+}
+
+} // namespace BioMesh
@@ -0,0 +1,276 @@
+#include "biomesh/task_graph.h"
+#include "biomesh/metrics.h"
+#include "biomesh/trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace BioMesh {
+
+namespace {
+
+// Volume term weight: roughly one finest-level cell per cubic Angstrom, much cheaper than an atom
+constexpr double kCostPerCubicAngstrom = 0.05;
+
+} // namespace
+
+TaskId TaskGraph::addTask(const std::string& name, Work work, double cost, unsigned parallelism) {
+    if (!(cost >= 0.0)) {
+        throw std::invalid_argument("Task cost must be non-negative: " + name);
+    }
+    if (parallelism == 0) {
+        throw std::invalid_argument("Task parallelism must be at least 1: " + name);
+    }
+    tasks_.push_back(Task{name, std::move(work), cost, parallelism, {}});
+    return tasks_.size() - 1;
+}
+
+void TaskGraph::addDependency(TaskId before, TaskId after) {
+    if (before >= tasks_.size() || after >= tasks_.size()) {
+        throw std::out_of_range("Unknown task in dependency");
+    }
+    tasks_[before].successors.push_back(after);
+}
+
+double TaskGraph::estimateCost(std::size_t atomCount, const BoundingBox& root) {
+    const double atoms = static_cast<double>(atomCount);
+    const double volume = root.isEmpty() ? 0.0 : root.getVolume();
+    return atoms * std::log2(atoms + 2.0) + kCostPerCubicAngstrom * volume;
+}
+
+TaskScheduler::TaskScheduler(unsigned workerSlots)
+    : workerSlots_(workerSlots != 0 ? workerSlots : std::max(1u, std::thread::hardware_concurrency())) {
+    workers_.reserve(workerSlots_);
+    for (unsigned i = 0; i < workerSlots_; ++i) {
+        workers_.emplace_back([this, i]() {
+            BIOMESH_TRACE_THREAD_NAME("scheduler worker " + std::to_string(i));
+            workerLoop();
+        });
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    queueReady_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void TaskScheduler::workerLoop() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            queueReady_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        job();
+    }
+}
+
+void TaskScheduler::parallelFor(std::size_t count, const std::function<void(std::size_t)>& body) {
+    if (count <= 1) {
+        if (count == 1) {
+            body(0);
+        }
+        return;
+    }
+
+    // Helpers may be dequeued after the call returns; they only touch body after claiming an
+    // iteration, and the caller waits for every claimed iteration
+    struct Loop {
+        const std::function<void(std::size_t)>* body;
+        std::size_t count;
+        std::atomic<std::size_t> next{0};
+        std::mutex mutex;
+        std::condition_variable done;
+        std::size_t finished{0};
+        std::exception_ptr error;
+
+        void runClaimed() {
+            for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+                std::exception_ptr failure;
+                try {
+                    (*body)(i);
+                } catch (...) {
+                    failure = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                if (failure && !error) {
+                    error = failure;
+                }
+                if (++finished == count) {
+                    done.notify_all();
+                }
+            }
+        }
+    };
+    auto loop = std::make_shared<Loop>();
+    loop->body = &body;
+    loop->count = count;
+
+    const std::size_t helpers = std::min<std::size_t>(count - 1, workers_.size());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::size_t h = 0; h < helpers; ++h) {
+            queue_.push_front([loop]() { loop->runClaimed(); });
+        }
+    }
+    queueReady_.notify_all();
+
+    loop->runClaimed();
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->done.wait(lock, [&]() { return loop->finished == count; });
+    if (loop->error) {
+        std::rethrow_exception(loop->error);
+    }
+}
+
+void TaskScheduler::run(TaskGraph& graph) {
+    auto& tasks = graph.tasks_;
+    const std::size_t count = tasks.size();
+
+    // Topological order (Kahn) doubles as the cycle check
+    std::vector<std::size_t> pending(count, 0);
+    for (const auto& task : tasks) {
+        for (TaskId next : task.successors) {
+            ++pending[next];
+        }
+    }
+    std::vector<TaskId> order;
+    order.reserve(count);
+    {
+        std::vector<std::size_t> indegree = pending;
+        for (TaskId id = 0; id < count; ++id) {
+            if (indegree[id] == 0) {
+                order.push_back(id);
+            }
+        }
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            for (TaskId next : tasks[order[i]].successors) {
+                if (--indegree[next] == 0) {
+                    order.push_back(next);
+                }
+            }
+        }
+    }
+    if (order.size() != count) {
+        throw std::logic_error("TaskGraph contains a cycle");
+    }
+
+    // Upward rank: a parallel task's duration shrinks with the slots it can use
+    std::vector<unsigned> slots(count);
+    std::vector<double> rank(count, 0.0);
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        const auto& task = tasks[*it];
+        slots[*it] = std::min(task.parallelism, workerSlots_);
+        double tail = 0.0;
+        for (TaskId next : task.successors) {
+            tail = std::max(tail, rank[next]);
+        }
+        rank[*it] = task.cost / slots[*it] + tail;
+    }
+    auto higherPriority = [&](TaskId a, TaskId b) {
+        return rank[a] != rank[b] ? rank[a] > rank[b] : a < b;
+    };
+
+    std::mutex stateMutex;
+    std::condition_variable finished;
+    std::vector<TaskId> ready;
+    std::vector<TaskId> running;
+    unsigned freeSlots = workerSlots_;
+    std::size_t completed = 0;
+    std::exception_ptr error;
+
+    for (TaskId id = 0; id < count; ++id) {
+        if (pending[id] == 0) {
+            ready.push_back(id);
+        }
+    }
+
+    auto start = [&](TaskId id) {
+        freeSlots -= slots[id];
+        running.push_back(id);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back([&, id]() {
+                std::exception_ptr failure;
+                try {
+                    BIOMESH_TRACE_SCOPE("TaskScheduler::task");
+                    static Histogram& taskSeconds = MetricsRegistry::global().histogram(
+                        "biomesh_scheduler_task_seconds", "TaskScheduler task duration in seconds");
+                    MetricsTimer metricsTimer(taskSeconds);
+                    tasks[id].work(slots[id]);
+                } catch (...) {
+                    failure = std::current_exception();
+                }
+                std::lock_guard<std::mutex> stateLock(stateMutex);
+                if (failure && !error) {
+                    error = failure;
+                }
+                freeSlots += slots[id];
+                running.erase(std::find(running.begin(), running.end(), id));
+                ++completed;
+                for (TaskId next : tasks[id].successors) {
+                    if (--pending[next] == 0) {
+                        ready.push_back(next);
+                    }
+                }
+                finished.notify_one();
+            });
+        }
+        queueReady_.notify_one();
+    };
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    for (;;) {
+        if (!error) {
+            std::sort(ready.begin(), ready.end(), higherPriority);
+            std::vector<TaskId> deferred;
+            bool reserved = false;
+            double backfillBudget = 0.0;
+            for (TaskId id : ready) {
+                if (!reserved && slots[id] <= freeSlots) {
+                    start(id);
+                } else if (!reserved) {
+                    // Hold slots for this task; only work expected to finish first may jump ahead
+                    reserved = true;
+                    backfillBudget = std::numeric_limits<double>::max();
+                    for (TaskId active : running) {
+                        backfillBudget = std::min(backfillBudget, tasks[active].cost);
+                    }
+                    deferred.push_back(id);
+                } else if (slots[id] <= freeSlots && tasks[id].cost <= backfillBudget) {
+                    start(id);
+                } else {
+                    deferred.push_back(id);
+                }
+            }
+            ready.swap(deferred);
+        }
+
+        if (running.empty() && (error || completed == count)) {
+            break;
+        }
+        finished.wait(lock);
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace BioMesh
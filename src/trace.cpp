@@ -0,0 +1,241 @@
+#include "biomesh/trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+namespace BioMesh {
+
+/**
+ * @brief Single-producer ring buffer of trace events owned by one thread
+ */
+class TraceBuffer {
+public:
+    TraceBuffer(std::uint32_t threadIndex, std::string name)
+        : threadIndex_(threadIndex), name_(std::move(name)), events_(Tracer::kBufferCapacity) {
+    }
+
+    void record(const char* name, std::uint64_t startNs, std::uint64_t durationNs) noexcept {
+        const std::uint64_t head = head_.load(std::memory_order_relaxed);
+        events_[head & (Tracer::kBufferCapacity - 1)] = TraceEvent{name, threadIndex_, startNs, durationNs};
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    void appendTo(std::vector<TraceEvent>& out) const {
+        const std::uint64_t head = head_.load(std::memory_order_acquire);
+        const std::uint64_t first = std::max(tail_.load(std::memory_order_relaxed),
+                                             head > Tracer::kBufferCapacity ? head - Tracer::kBufferCapacity : 0);
+        for (std::uint64_t i = first; i < head; ++i) {
+            out.push_back(events_[i & (Tracer::kBufferCapacity - 1)]);
+        }
+    }
+
+    std::size_t getDroppedCount() const {
+        const std::uint64_t retained = head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+        return retained > Tracer::kBufferCapacity ? static_cast<std::size_t>(retained - Tracer::kBufferCapacity) : 0;
+    }
+
+    void clear() { tail_.store(head_.load(std::memory_order_acquire), std::memory_order_relaxed); }
+
+    std::uint32_t getThreadIndex() const { return threadIndex_; }
+    const std::string& getName() const { return name_; }
+    void setName(const std::string& name) { name_ = name; }
+
+private:
+    std::uint32_t threadIndex_;           ///< Thread index in registration order
+    std::string name_;                    ///< Thread name (guarded by the tracer mutex)
+    std::vector<TraceEvent> events_;      ///< Ring storage (power-of-two size)
+    std::atomic<std::uint64_t> head_{0};  ///< Total events written
+    std::atomic<std::uint64_t> tail_{0};  ///< Events discarded by clear()
+};
+
+/**
+ * @brief Hands the calling thread's buffer back to the tracer when the thread exits
+ */
+struct Tracer::ThreadSlot {
+    TraceBuffer* buffer = nullptr;
+
+    ~ThreadSlot();
+};
+
+namespace {
+
+// Trivially destructible, so both stay usable from thread_local destructors that run later
+thread_local TraceBuffer* tLocalBuffer = nullptr;
+thread_local bool tSlotDestroyed = false;
+
+void writeJsonString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        switch (c) {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                out << escaped;
+            } else {
+                out << c;
+            }
+        }
+    }
+    out << '"';
+}
+
+std::int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+Tracer& Tracer::instance() {
+    // Never destroyed, so threads still running during static destruction can record safely
+    static Tracer* tracer = new Tracer();
+    return *tracer;
+}
+
+Tracer::Tracer() : epochNs_(steadyNowNs()) {
+}
+
+Tracer::ThreadSlot::~ThreadSlot() {
+    tSlotDestroyed = true;
+    tLocalBuffer = nullptr;
+    if (buffer) {
+        Tracer::instance().releaseBuffer(*buffer);
+    }
+}
+
+TraceBuffer& Tracer::localBuffer() {
+    if (!tLocalBuffer) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!freeBuffers_.empty()) {
+                tLocalBuffer = freeBuffers_.back();
+                freeBuffers_.pop_back();
+                tLocalBuffer->setName("thread " + std::to_string(tLocalBuffer->getThreadIndex()));
+            } else {
+                const auto index = static_cast<std::uint32_t>(buffers_.size());
+                buffers_.push_back(std::make_shared<TraceBuffer>(index, "thread " + std::to_string(index)));
+                tLocalBuffer = buffers_.back().get();
+            }
+        }
+        // Recording from a later thread_local destructor keeps the buffer; it is not reused
+        if (!tSlotDestroyed) {
+            thread_local ThreadSlot slot;
+            slot.buffer = tLocalBuffer;
+        }
+    }
+    return *tLocalBuffer;
+}
+
+void Tracer::releaseBuffer(TraceBuffer& buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    freeBuffers_.push_back(&buffer);
+}
+
+void Tracer::setThreadName(const std::string& name) {
+    TraceBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer.setName(name);
+}
+
+const char* Tracer::intern(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return names_.insert(name).first->c_str();
+}
+
+std::uint64_t Tracer::now() const {
+    return static_cast<std::uint64_t>(steadyNowNs() - epochNs_);
+}
+
+void Tracer::record(const char* name, std::uint64_t startNs, std::uint64_t endNs) noexcept {
+    try {
+        localBuffer().record(name, startNs, endNs - startNs);
+    } catch (...) {
+        // Registration failed to allocate; losing a zone is preferable to failing the traced work
+    }
+}
+
+std::vector<TraceEvent> Tracer::collect() const {
+    std::vector<TraceEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& buffer : buffers_) {
+            buffer->appendTo(events);
+        }
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](const TraceEvent& a, const TraceEvent& b) { return a.startNs < b.startNs; });
+    return events;
+}
+
+std::size_t Tracer::getDroppedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t dropped = 0;
+    for (const auto& buffer : buffers_) {
+        dropped += buffer->getDroppedCount();
+    }
+    return dropped;
+}
+
+std::size_t Tracer::getBufferCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return buffers_.size();
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& buffer : buffers_) {
+        buffer->clear();
+    }
+}
+
+void Tracer::writeChromeTrace(std::ostream& out) const {
+    const auto events = collect();
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& buffer : buffers_) {
+            out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                << buffer->getThreadIndex() << ",\"args\":{\"name\":";
+            writeJsonString(out, buffer->getName());
+            out << "}}";
+            first = false;
+        }
+    }
+
+    // Chrome trace timestamps are microseconds; keep nanosecond resolution as fractions
+    char timing[64];
+    for (const auto& event : events) {
+        out << (first ? "\n" : ",\n") << "{\"name\":";
+        writeJsonString(out, event.name);
+        std::snprintf(timing, sizeof(timing), ",\"ts\":%.3f,\"dur\":%.3f", event.startNs / 1000.0,
+                      event.durationNs / 1000.0);
+        out << ",\"cat\":\"biomesh\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadIndex << timing << "}";
+        first = false;
+    }
+    out << "\n]}\n";
+}
+
+void Tracer::writeChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot open trace file: " + path);
+    }
+    writeChromeTrace(out);
+    if (!out) {
+        throw std::runtime_error("Failed to write trace file: " + path);
+    }
+}
+
+} // namespace BioMesh
@@ -0,0 +1,79 @@
+#include "biomesh/vertex_table.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace BioMesh {
+
+ConcurrentVertexTable::ConcurrentVertexTable(std::size_t expectedVertices) {
+    std::size_t capacity = 16;
+    unsigned bits = 4;
+    while (capacity < 2 * expectedVertices) {
+        capacity <<= 1;
+        ++bits;
+    }
+    if (capacity > (std::size_t{1} << 32)) {
+        throw std::length_error("ConcurrentVertexTable capacity exceeds 2^32 slots");
+    }
+
+    capacity_ = capacity;
+    mask_ = capacity - 1;
+    shift_ = 64 - bits;
+    keys_.reset(new std::atomic<std::uint64_t>[capacity]);
+    for (std::size_t i = 0; i < capacity; ++i) {
+        keys_[i].store(kEmptyKey, std::memory_order_relaxed);
+    }
+}
+
+std::size_t ConcurrentVertexTable::estimateVertexCount(std::size_t leafCount) {
+    return 3 * leafCount + 8;
+}
+
+std::uint32_t ConcurrentVertexTable::insert(std::uint64_t key) {
+    // Fibonacci hashing on the top bits spreads lattice-adjacent keys across the table
+    std::uint64_t mixed = (key ^ (key >> 29)) * 0x9E3779B97F4A7C15ULL;
+    std::size_t slot = static_cast<std::size_t>(mixed >> shift_);
+    for (std::size_t probe = 0; probe < capacity_; ++probe) {
+        std::uint64_t current = keys_[slot].load(std::memory_order_relaxed);
+        if (current == key) {
+            return static_cast<std::uint32_t>(slot);
+        }
+        if (current == kEmptyKey) {
+            if (keys_[slot].compare_exchange_strong(current, key, std::memory_order_relaxed)) {
+                return static_cast<std::uint32_t>(slot);
+            }
+            // Lost the race; `current` now holds the winner's key
+            if (current == key) {
+                return static_cast<std::uint32_t>(slot);
+            }
+        }
+        slot = (slot + 1) & mask_;
+    }
+    throw std::length_error("ConcurrentVertexTable is full");
+}
+
+std::size_t ConcurrentVertexTable::compact() {
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> occupied;
+    for (std::size_t slot = 0; slot < capacity_; ++slot) {
+        std::uint64_t key = keys_[slot].load(std::memory_order_relaxed);
+        if (key != kEmptyKey) {
+            occupied.emplace_back(key, static_cast<std::uint32_t>(slot));
+        }
+    }
+    std::sort(occupied.begin(), occupied.end());
+
+    ids_.assign(capacity_, 0);
+    sortedKeys_.resize(occupied.size());
+    for (std::size_t id = 0; id < occupied.size(); ++id) {
+        sortedKeys_[id] = occupied[id].first;
+        ids_[occupied[id].second] = static_cast<std::uint32_t>(id);
+    }
+    return occupied.size();
+}
+
+MemoryUsage ConcurrentVertexTable::memoryUsage() const {
+    const std::size_t slotBytes = capacity_ * sizeof(std::atomic<std::uint64_t>);
+    return MemoryUsage{slotBytes, slotBytes} + BioMesh::memoryUsage(ids_) + BioMesh::memoryUsage(sortedKeys_);
+}
+
+} // namespace BioMesh
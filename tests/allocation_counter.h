@@ -0,0 +1,91 @@
+#pragma once
+
+/**
+ * @file allocation_counter.h
+ * @brief Test utility counting global operator new calls made by the current thread
+ *
+ * Replaces the global allocation functions, so include it from exactly one translation
+ * unit of a test executable. Counts are per thread: allocations by GoogleTest or other
+ * threads do not leak into a scope opened on the test thread.
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace BioMesh {
+namespace test {
+
+/**
+ * @brief Number of operator new calls made so far by the calling thread
+ */
+inline std::size_t& threadAllocationCount() {
+    static thread_local std::size_t count = 0;
+    return count;
+}
+
+/**
+ * @brief Counts heap allocations made by the calling thread while in scope
+ *
+ * Typical use: run the code once to warm up (fill caches, grow buffers), then
+ * @code
+ * AllocationCounter counter;
+ * hotPath();
+ * EXPECT_EQ(counter.getCount(), 0u);
+ * @endcode
+ */
+class AllocationCounter {
+public:
+    AllocationCounter() : start_(threadAllocationCount()) {}
+
+    /**
+     * @brief Get the number of allocations since construction
+     * @return Allocation count
+     */
+    std::size_t getCount() const { return threadAllocationCount() - start_; }
+
+private:
+    std::size_t start_;  ///< Thread count at construction
+};
+
+} // namespace test
+} // namespace BioMesh
+
+namespace biomesh_test_detail {
+
+inline void* countedAllocate(std::size_t size, std::size_t alignment) {
+    ++BioMesh::test::threadAllocationCount();
+    if (size == 0) {
+        size = 1;
+    }
+    void* pointer = nullptr;
+    if (alignment > alignof(std::max_align_t)) {
+        // aligned_alloc requires the size to be a multiple of the alignment
+        pointer = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    } else {
+        pointer = std::malloc(size);
+    }
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+} // namespace biomesh_test_detail
+
+void* operator new(std::size_t size) { return biomesh_test_detail::countedAllocate(size, 0); }
+void* operator new[](std::size_t size) { return biomesh_test_detail::countedAllocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return biomesh_test_detail::countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return biomesh_test_detail::countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
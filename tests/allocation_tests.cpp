@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "biomesh/biomesh.h"
+#include "allocation_counter.h"
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace BioMesh;
+using BioMesh::test::AllocationCounter;
+
+namespace {
+
+std::vector<Atom> makeAtoms(std::size_t count) {
+    SyntheticMoleculeGenerator generator(SyntheticShape::Globular, count, 11);
+    return AtomBuilder().buildAtoms(generator.generate());
+}
+
+} // namespace
+
+TEST(AllocationCounterTest, CountsAllocationsInScope) {
+    AllocationCounter counter;
+    EXPECT_EQ(counter.getCount(), 0u);
+    auto value = std::make_unique<int>(1);
+    std::vector<double> values(16);
+    EXPECT_EQ(counter.getCount(), 2u);
+
+    AllocationCounter nested;
+    values.push_back(1.0);
+    EXPECT_EQ(nested.getCount(), 1u);
+    EXPECT_EQ(counter.getCount(), 3u);
+}
+
+TEST(AllocationCounterTest, IgnoresOtherThreads) {
+    AllocationCounter counter;
+    std::thread worker([]() { std::vector<int> values(100); });
+    const std::size_t afterSpawn = counter.getCount();  // the thread state itself is allocated here
+    worker.join();
+    EXPECT_EQ(counter.getCount(), afterSpawn);
+}
+
+TEST(ZeroAllocationTest, BoundsComputation) {
+    const auto atoms = makeAtoms(2000);
+    BoundingBox box;
+    box.calculateFromAtoms(atoms);
+
+    AllocationCounter counter;
+    box.calculateFromAtoms(atoms);
+    box.addPoint(1000.0, -1000.0, 0.0);
+    box.expand(2.0);
+    double cx, cy, cz;
+    box.getCenter(cx, cy, cz);
+    EXPECT_GT(box.getVolume(), 0.0);
+    EXPECT_EQ(counter.getCount(), 0u);
+}
+
+TEST(ZeroAllocationTest, Classification) {
+    const auto atoms = makeAtoms(2000);
+    BoundingBox box;
+    box.calculateFromAtoms(atoms);
+    const auto octants = box.subdivide();
+    MortonEncoder encoder(box);
+
+    AllocationCounter counter;
+    std::uint64_t keyChecksum = 0;
+    for (const auto& atom : atoms) {
+        const int octant = box.getOctantIndex(atom.getX(), atom.getY(), atom.getZ());
+        ASSERT_TRUE(octants[octant].contains(atom));
+        keyChecksum ^= encoder.encode(atom.getX(), atom.getY(), atom.getZ());
+    }
+    EXPECT_NE(keyChecksum, 0u);
+    EXPECT_EQ(counter.getCount(), 0u);
+}
+
+TEST(ZeroAllocationTest, OctantIndexMatchesSubdivideOrder) {
+    BoundingBox box(0, 0, 0, 2, 2, 2);
+    const auto octants = box.subdivide();
+    for (int i = 0; i < 8; ++i) {
+        double cx, cy, cz;
+        octants[i].getCenter(cx, cy, cz);
+        EXPECT_EQ(box.getOctantIndex(cx, cy, cz), i);
+    }
+    EXPECT_EQ(box.getOctantIndex(1.0, 1.0, 1.0), 7);
+    EXPECT_EQ(BoundingBox().getOctantIndex(1.0, 1.0, 1.0), 0);
+}
+
+TEST(ZeroAllocationTest, Queries) {
+    const auto atoms = makeAtoms(5000);
+    BoundingBox box;
+    box.calculateFromAtoms(atoms);
+    LinearOctree tree(box);
+    tree.build(atoms);
+    tree.balance();
+    const BoundingBox probe(box.getMinX(), box.getMinY(), box.getMinZ(), 0.0, 0.0, 0.0);
+
+    AllocationCounter counter;
+    std::size_t found = 0;
+    std::size_t intersecting = 0;
+    for (const auto& atom : atoms) {
+        const std::size_t leaf = tree.findLeaf(tree.getEncoder().encode(atom.getX(), atom.getY(), atom.getZ()));
+        ASSERT_NE(leaf, LinearOctree::npos);
+        if (tree.getLeafBox(tree.getLeaves()[leaf]).contains(atom)) {
+            ++found;
+        }
+        if (probe.contains(atom)) {
+            ++intersecting;
+        }
+    }
+    for (const auto& leaf : tree.getLeaves()) {
+        intersecting += tree.getLeafBox(leaf).intersects(probe) ? 1 : 0;
+    }
+    EXPECT_EQ(found, atoms.size());
+    EXPECT_GT(intersecting, 0u);
+    EXPECT_EQ(counter.getCount(), 0u);
+}
+
+TEST(ZeroAllocationTest, InPlacePropertyAssignment) {
+    SyntheticMoleculeGenerator generator(SyntheticShape::WaterBox, 3000, 5);
+    auto atoms = generator.generate();
+    AtomBuilder builder;
+    const auto built = builder.buildAtoms(atoms);
+    builder.assignProperties(atoms);
+
+    AllocationCounter counter;
+    builder.assignProperties(atoms);
+    EXPECT_EQ(counter.getCount(), 0u);
+
+    ASSERT_EQ(atoms.size(), built.size());
+    for (std::size_t i = 0; i < atoms.size(); ++i) {
+        EXPECT_EQ(atoms[i].getAtomicRadius(), built[i].getAtomicRadius());
+        EXPECT_EQ(atoms[i].getAtomicMass(), built[i].getAtomicMass());
+    }
+
+    AllocationCounter copying;
+    builder.buildAtoms(atoms);
+    EXPECT_GT(copying.getCount(), 0u);  // buildAtoms returns a new vector
+}
+
+TEST(ZeroAllocationTest, InPlaceAssignmentRejectsUnknownElements) {
+    std::vector<Atom> atoms = {Atom(0, 0, 0, "C"), Atom(1, 1, 1, "Xx")};
+    EXPECT_THROW(AtomBuilder().assignProperties(atoms), std::runtime_error);
+    EXPECT_DOUBLE_EQ(atoms[0].getAtomicRadius(), 1.70);
+}
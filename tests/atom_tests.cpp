@@ -5,6 +5,8 @@
 #include <vector>
 #include <stdexcept>
 #include <cmath>
+#include <atomic>
+#include <thread>
 
 using namespace BioMesh;
 
@@ -223,6 +225,122 @@ TEST_F(AtomBuilderTest, IntegrationTestWithMixedElements) {
     EXPECT_EQ(enhancedAtoms[5].getAtomicMass(), 32.06);   // S
 }
 
+// Hot reload of the specification table
+TEST_F(AtomBuilderTest, UpdatesPublishNewVersions) {
+    const std::uint64_t initial = builder->getVersion();
+    const auto before = builder->getSpecTable();
+    const AtomicSpec oldCarbon = builder->getAtomicSpec("C");
+
+    builder->updateAtomicSpecs({AtomicSpec("C", 1.75, 12.011), AtomicSpec("Br", 1.85, 79.904)});
+    EXPECT_EQ(builder->getVersion(), initial + 1);
+    EXPECT_EQ(builder->getAtomicSpec("C").radius, 1.75);
+    EXPECT_TRUE(builder->hasElement("Br"));
+    EXPECT_TRUE(builder->hasElement("H"));
+
+    // Superseded tables stay intact for readers that pinned them
+    EXPECT_EQ(before->getVersion(), initial);
+    EXPECT_EQ(before->find("C")->radius, 1.70);
+    EXPECT_EQ(before->find("Br"), nullptr);
+    EXPECT_EQ(oldCarbon.radius, 1.70);
+
+    builder->updateAtomicSpecs({AtomicSpec("C", 1.80, 12.0)}, true);
+    EXPECT_EQ(builder->getVersion(), initial + 2);
+    EXPECT_EQ(builder->getSpecTable()->size(), 1u);
+    EXPECT_FALSE(builder->hasElement("H"));
+}
+
+TEST_F(AtomBuilderTest, SupersededTablesAreFreed) {
+    const MemoryUsage initial = builder->memoryUsage();
+
+    // Many single-element reloads keep only the current table and the pinned one
+    std::vector<AtomBuilder::SpecTablePin> pins;
+    for (int i = 0; i < 500; ++i) {
+        builder->addAtomicSpec("C", 1.70 + i * 1e-3, 12.011);
+        if (i == 100) {
+            pins.push_back(builder->getSpecTable());
+        }
+    }
+    EXPECT_EQ(builder->getRetiredTableCount(), 1u);
+    EXPECT_GT(builder->memoryUsage().usedBytes, initial.usedBytes);
+
+    // A pinned table outlives its supersession, unchanged
+    EXPECT_DOUBLE_EQ(pins.front()->find("C")->radius, 1.70 + 100 * 1e-3);
+    EXPECT_EQ(pins.front()->getVersion(), builder->getVersion() - 399);
+
+    // Released pins are reclaimed by the next update
+    pins.clear();
+    builder->addAtomicSpec("C", 1.70, 12.011);
+    EXPECT_EQ(builder->getRetiredTableCount(), 0u);
+    EXPECT_EQ(builder->memoryUsage().usedBytes, initial.usedBytes);
+}
+
+TEST_F(AtomBuilderTest, ReadersAreLockFree) {
+    std::atomic<const AtomicSpecTable*> table{nullptr};
+    std::atomic<bool> flag{false};
+    EXPECT_TRUE(table.is_lock_free());
+    EXPECT_TRUE(flag.is_lock_free());
+
+    // Overlapping pins use separate reader slots and see the same table
+    const auto first = builder->getSpecTable();
+    const auto second = builder->getSpecTable();
+    EXPECT_EQ(first.get(), second.get());
+}
+
+TEST_F(AtomBuilderTest, CopiesAreIndependent) {
+    AtomBuilder copy(*builder);
+    copy.addAtomicSpec("Br", 1.85, 79.904);
+    EXPECT_TRUE(copy.hasElement("Br"));
+    EXPECT_FALSE(builder->hasElement("Br"));
+
+    *builder = copy;
+    EXPECT_TRUE(builder->hasElement("Br"));
+}
+
+TEST_F(AtomBuilderTest, ReadersSeeCompleteTablesDuringReload) {
+    // Every published table assigns one radius to all elements; a reader must never mix two
+    std::vector<std::string> elements = {"H", "C", "N", "O", "P", "S"};
+    auto uniformTable = [&elements](double radius) {
+        std::vector<AtomicSpec> specs;
+        for (const auto& element : elements) {
+            specs.emplace_back(element, radius, 1.0);
+        }
+        return specs;
+    };
+    builder->updateAtomicSpecs(uniformTable(1.0), true);
+
+    std::vector<Atom> parsed;
+    for (int i = 0; i < 600; ++i) {
+        parsed.emplace_back(i, 0.0, 0.0, elements[i % elements.size()]);
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<int> mixed{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            while (!done.load()) {
+                const auto atoms = builder->buildAtoms(parsed);
+                for (const auto& atom : atoms) {
+                    if (atom.getAtomicRadius() != atoms.front().getAtomicRadius()) {
+                        ++mixed;
+                        break;
+                    }
+                }
+            }
+        });
+    }
+    for (int version = 2; version <= 200; ++version) {
+        builder->updateAtomicSpecs(uniformTable(version), true);
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(mixed.load(), 0);
+    EXPECT_EQ(builder->getAtomicSpec("C").radius, 200.0);
+}
+
 // Test fixtures for BoundingBox class
 class BoundingBoxTest : public ::testing::Test {
 protected:
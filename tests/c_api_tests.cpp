@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include "biomesh/biomesh.h"
+#include "biomesh/biomesh_c.h"
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+const char* const kSymbols[] = {"C", "N", "O", "H", "S"};
+
+struct Particle {
+    double position[3];
+    double velocity[3];
+    std::int32_t element;
+};
+
+std::vector<Particle> makeParticles(std::size_t count) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coordinate(-15.0, 15.0);
+    std::uniform_int_distribution<int> element(0, 4);
+    std::vector<Particle> particles(count);
+    for (auto& particle : particles) {
+        for (double& value : particle.position) {
+            value = coordinate(rng);
+        }
+        particle.element = element(rng);
+    }
+    return particles;
+}
+
+biomesh_atoms describeParticles(const std::vector<Particle>& particles) {
+    biomesh_atoms atoms{};
+    atoms.count = particles.size();
+    atoms.x = &particles[0].position[0];
+    atoms.y = &particles[0].position[1];
+    atoms.z = &particles[0].position[2];
+    atoms.coordinate_stride = sizeof(Particle);
+    atoms.element_ids = &particles[0].element;
+    atoms.element_id_stride = sizeof(Particle);
+    atoms.element_symbols = kSymbols;
+    atoms.element_symbol_count = 5;
+    return atoms;
+}
+
+biomesh_params testParams() {
+    biomesh_params params;
+    biomesh_params_init(&params);
+    params.max_level = 6;
+    params.threads = 1;
+    return params;
+}
+
+HexMesh referenceMesh(const std::vector<Particle>& particles) {
+    std::vector<Atom> atoms;
+    for (const auto& particle : particles) {
+        atoms.emplace_back(particle.position[0], particle.position[1], particle.position[2],
+                           kSymbols[particle.element]);
+    }
+    AtomBuilder().assignProperties(atoms);
+    BoundingBox root;
+    root.calculateFromAtoms(atoms);
+    root.expand(1.0);
+    LinearOctree tree(root, 6);
+    tree.build(atoms);
+    tree.balance();
+    return HexMeshExtractor(1).extract(tree);
+}
+
+struct CopiedMesh {
+    std::vector<double> vertices;
+    std::vector<std::int32_t> hexahedra;
+    std::vector<std::uint8_t> levels;
+};
+
+CopiedMesh createAndCopy(const biomesh_atoms& atoms, std::int32_t indexBase) {
+    const biomesh_params params = testParams();
+    biomesh_mesh* mesh = nullptr;
+    EXPECT_EQ(biomesh_mesh_create(&atoms, &params, &mesh), BIOMESH_OK) << biomesh_last_error();
+    std::size_t vertexCount = 0;
+    std::size_t hexCount = 0;
+    EXPECT_EQ(biomesh_mesh_get_sizes(mesh, &vertexCount, &hexCount), BIOMESH_OK);
+    CopiedMesh copied{std::vector<double>(3 * vertexCount), std::vector<std::int32_t>(8 * hexCount),
+                      std::vector<std::uint8_t>(hexCount)};
+    EXPECT_EQ(biomesh_mesh_copy(mesh, copied.vertices.data(), vertexCount, copied.hexahedra.data(), hexCount,
+                                indexBase, copied.levels.data()),
+              BIOMESH_OK);
+    biomesh_mesh_free(mesh);
+    return copied;
+}
+
+void expectMatches(const CopiedMesh& copied, const HexMesh& reference, std::int32_t indexBase) {
+    ASSERT_EQ(copied.vertices.size(), 3 * reference.getVertexCount());
+    ASSERT_EQ(copied.hexahedra.size(), 8 * reference.getHexCount());
+    EXPECT_EQ(std::memcmp(copied.vertices.data(), reference.vertices.data(), copied.vertices.size() * sizeof(double)),
+              0);
+    for (std::size_t h = 0; h < reference.getHexCount(); ++h) {
+        for (std::size_t c = 0; c < 8; ++c) {
+            ASSERT_EQ(copied.hexahedra[8 * h + c], static_cast<std::int32_t>(reference.hexahedra[h][c]) + indexBase);
+        }
+    }
+    EXPECT_EQ(copied.levels, reference.levels);
+}
+
+} // namespace
+
+TEST(CApiTest, ReportsAbiVersionAndDefaults) {
+    EXPECT_EQ(biomesh_abi_version(), BIOMESH_C_ABI_VERSION);
+    biomesh_params params;
+    biomesh_params_init(&params);
+    EXPECT_EQ(params.max_level, 10u);
+    EXPECT_EQ(params.max_atoms_per_leaf, 8u);
+    EXPECT_NE(params.balance, 0);
+    EXPECT_EQ(params.has_root, 0);
+}
+
+TEST(CApiTest, ArrayOfStructsMatchesCppPipeline) {
+    const auto particles = makeParticles(800);
+    const HexMesh reference = referenceMesh(particles);
+    ASSERT_GT(reference.getHexCount(), 0u);
+    expectMatches(createAndCopy(describeParticles(particles), 0), reference, 0);
+}
+
+TEST(CApiTest, SeparateArraysMatchArrayOfStructs) {
+    const auto particles = makeParticles(800);
+    std::vector<double> x, y, z;
+    std::vector<std::int32_t> ids;
+    for (const auto& particle : particles) {
+        x.push_back(particle.position[0]);
+        y.push_back(particle.position[1]);
+        z.push_back(particle.position[2]);
+        ids.push_back(particle.element);
+    }
+    biomesh_atoms atoms = describeParticles(particles);
+    atoms.x = x.data();
+    atoms.y = y.data();
+    atoms.z = z.data();
+    atoms.coordinate_stride = sizeof(double);
+    atoms.element_ids = ids.data();
+    atoms.element_id_stride = sizeof(std::int32_t);
+    expectMatches(createAndCopy(atoms, 0), referenceMesh(particles), 0);
+}
+
+TEST(CApiTest, FortranColumnMajorWithOneBasedIds) {
+    // coordinates(N, 3) in column-major order, 1-based element IDs and 1-based vertex IDs
+    const auto particles = makeParticles(500);
+    const std::size_t n = particles.size();
+    std::vector<double> coordinates(3 * n);
+    std::vector<std::int32_t> ids(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t d = 0; d < 3; ++d) {
+            coordinates[d * n + i] = particles[i].position[d];
+        }
+        ids[i] = particles[i].element + 1;
+    }
+    biomesh_atoms atoms = describeParticles(particles);
+    atoms.x = &coordinates[0];
+    atoms.y = &coordinates[n];
+    atoms.z = &coordinates[2 * n];
+    atoms.coordinate_stride = sizeof(double);
+    atoms.element_ids = ids.data();
+    atoms.element_id_stride = sizeof(std::int32_t);
+    atoms.element_id_base = 1;
+    expectMatches(createAndCopy(atoms, 1), referenceMesh(particles), 1);
+}
+
+TEST(CApiTest, CopyRejectsSmallBuffersWithoutWriting) {
+    const auto particles = makeParticles(200);
+    const biomesh_atoms atoms = describeParticles(particles);
+    biomesh_mesh* mesh = nullptr;
+    ASSERT_EQ(biomesh_mesh_create(&atoms, nullptr, &mesh), BIOMESH_OK);
+    std::size_t vertexCount = 0;
+    std::size_t hexCount = 0;
+    ASSERT_EQ(biomesh_mesh_get_sizes(mesh, &vertexCount, &hexCount), BIOMESH_OK);
+    ASSERT_GT(hexCount, 1u);
+
+    std::vector<double> vertices(3 * vertexCount, -1.0);
+    std::vector<std::int32_t> hexahedra(8 * hexCount, -1);
+    EXPECT_EQ(biomesh_mesh_copy(mesh, vertices.data(), vertexCount, hexahedra.data(), hexCount - 1, 0, nullptr),
+              BIOMESH_ERROR_BUFFER_TOO_SMALL);
+    EXPECT_NE(std::string(biomesh_last_error()), "");
+    EXPECT_EQ(vertices.front(), -1.0);
+    EXPECT_EQ(hexahedra.front(), -1);
+
+    // Skipped outputs need no capacity
+    EXPECT_EQ(biomesh_mesh_copy(mesh, vertices.data(), vertexCount, nullptr, 0, 0, nullptr), BIOMESH_OK);
+    EXPECT_STREQ(biomesh_last_error(), "");
+    EXPECT_NE(vertices.front(), -1.0);
+    biomesh_mesh_free(mesh);
+}
+
+TEST(CApiTest, ReportsErrorsAsStatusCodes) {
+    auto particles = makeParticles(50);
+    biomesh_atoms atoms = describeParticles(particles);
+    biomesh_mesh* mesh = nullptr;
+
+    particles[10].element = 7;
+    EXPECT_EQ(biomesh_mesh_create(&atoms, nullptr, &mesh), BIOMESH_ERROR_UNKNOWN_ELEMENT);
+    EXPECT_EQ(mesh, nullptr);
+    EXPECT_NE(std::string(biomesh_last_error()).find("Atom 10"), std::string::npos);
+    particles[10].element = 0;
+
+    const char* const unknown[] = {"C", "N", "O", "H", "Xx"};
+    atoms.element_symbols = unknown;
+    particles[0].element = 4;
+    EXPECT_EQ(biomesh_mesh_create(&atoms, nullptr, &mesh), BIOMESH_ERROR_UNKNOWN_ELEMENT);
+    atoms.element_symbols = kSymbols;
+
+    biomesh_params params = testParams();
+    params.has_root = 1;
+    const double tiny[6] = {0.0, 0.0, 0.0, 1.0, 1.0, 1.0};
+    std::memcpy(params.root, tiny, sizeof(tiny));
+    EXPECT_EQ(biomesh_mesh_create(&atoms, &params, &mesh), BIOMESH_ERROR_OUT_OF_RANGE);
+    const double inverted[6] = {1.0, 0.0, 0.0, 0.0, 1.0, 1.0};
+    std::memcpy(params.root, inverted, sizeof(inverted));
+    EXPECT_EQ(biomesh_mesh_create(&atoms, &params, &mesh), BIOMESH_ERROR_INVALID_ARGUMENT);
+
+    EXPECT_EQ(biomesh_mesh_create(nullptr, nullptr, &mesh), BIOMESH_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(biomesh_mesh_create(&atoms, nullptr, nullptr), BIOMESH_ERROR_INVALID_ARGUMENT);
+    atoms.coordinate_stride = 0;
+    EXPECT_EQ(biomesh_mesh_create(&atoms, nullptr, &mesh), BIOMESH_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(biomesh_mesh_get_sizes(nullptr, nullptr, nullptr), BIOMESH_ERROR_INVALID_ARGUMENT);
+    biomesh_mesh_free(nullptr);
+}
+
+TEST(CApiTest, ComputesBoundsInPlace) {
+    const auto particles = makeParticles(300);
+    biomesh_atoms atoms = describeParticles(particles);
+    atoms.element_ids = nullptr;
+    double bounds[6];
+    ASSERT_EQ(biomesh_bounds(&atoms, bounds), BIOMESH_OK);
+
+    BoundingBox expected;
+    for (const auto& particle : particles) {
+        expected.addPoint(particle.position[0], particle.position[1], particle.position[2]);
+    }
+    EXPECT_EQ(bounds[0], expected.getMinX());
+    EXPECT_EQ(bounds[2], expected.getMinZ());
+    EXPECT_EQ(bounds[4], expected.getMaxY());
+    EXPECT_EQ(biomesh_bounds(&atoms, nullptr), BIOMESH_ERROR_INVALID_ARGUMENT);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "biomesh/distributed_octree.h"
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+struct LeafRecord {
+    std::uint64_t key;
+    std::uint32_t atomCount;
+    std::uint8_t level;
+};
+
+Communicator::Buffer packLeaves(const LinearOctree& tree) {
+    Communicator::Buffer buffer(tree.getLeaves().size() * sizeof(LeafRecord));
+    std::size_t offset = 0;
+    for (const auto& leaf : tree.getLeaves()) {
+        LeafRecord record{leaf.key, leaf.atomCount, leaf.level};
+        std::memcpy(buffer.data() + offset, &record, sizeof(record));
+        offset += sizeof(record);
+    }
+    return buffer;
+}
+
+std::vector<LeafRecord> unpackLeaves(const std::vector<Communicator::Buffer>& buffers) {
+    std::vector<LeafRecord> leaves;
+    for (const auto& buffer : buffers) {
+        for (std::size_t offset = 0; offset < buffer.size(); offset += sizeof(LeafRecord)) {
+            LeafRecord record;
+            std::memcpy(&record, buffer.data() + offset, sizeof(record));
+            leaves.push_back(record);
+        }
+    }
+    return leaves;
+}
+
+} // namespace
+
+TEST(SharedMemoryCommunicatorTest, AllToAllAndReductions) {
+    auto results = SharedMemoryCommunicator::launch(4, 256, [](Communicator& comm) {
+        std::vector<Communicator::Buffer> send(static_cast<std::size_t>(comm.getSize()));
+        for (int destination = 0; destination < comm.getSize(); ++destination) {
+            send[static_cast<std::size_t>(destination)].assign(static_cast<std::size_t>(destination + 1),
+                                                               static_cast<std::uint8_t>(comm.getRank()));
+        }
+        auto received = comm.allToAll(send);
+
+        Communicator::Buffer summary;
+        for (int source = 0; source < comm.getSize(); ++source) {
+            const auto& message = received[static_cast<std::size_t>(source)];
+            bool ok = message.size() == static_cast<std::size_t>(comm.getRank() + 1) &&
+                      std::all_of(message.begin(), message.end(),
+                                  [source](std::uint8_t b) { return b == source; });
+            summary.push_back(ok ? 1 : 0);
+        }
+        summary.push_back(static_cast<std::uint8_t>(comm.allReduceSum(static_cast<std::uint64_t>(comm.getRank()))));
+        return summary;
+    });
+
+    ASSERT_EQ(results.size(), 4u);
+    for (const auto& summary : results) {
+        ASSERT_EQ(summary.size(), 5u);
+        EXPECT_EQ(summary[0] + summary[1] + summary[2] + summary[3], 4);
+        EXPECT_EQ(summary[4], 6);
+    }
+}
+
+TEST(SharedMemoryCommunicatorTest, FailuresAreReported) {
+    EXPECT_THROW(SharedMemoryCommunicator::launch(0, 16, [](Communicator&) { return Communicator::Buffer{}; }),
+                 std::invalid_argument);
+
+    // A failing rank must not deadlock peers waiting in a barrier
+    EXPECT_THROW(SharedMemoryCommunicator::launch(3, 16, [](Communicator& comm) {
+        if (comm.getRank() == 1) {
+            throw std::runtime_error("rank failure");
+        }
+        comm.barrier();
+        return Communicator::Buffer{};
+    }), std::runtime_error);
+
+    // Oversized messages fail on every rank
+    EXPECT_THROW(SharedMemoryCommunicator::launch(2, 8, [](Communicator& comm) {
+        comm.allToAll(std::vector<Communicator::Buffer>(2, Communicator::Buffer(64)));
+        return Communicator::Buffer{};
+    }), std::runtime_error);
+}
+
+TEST(DistributedOctreeTest, PartitionedBuildMatchesGlobalInvariants) {
+    std::mt19937 rng(7);
+    std::normal_distribution<double> cluster(0.0, 2.0);
+    std::vector<Atom> atoms;
+    for (int i = 0; i < 600; ++i) {
+        atoms.emplace_back(cluster(rng), cluster(rng), cluster(rng), "C");
+    }
+    const int ranks = 3;
+
+    auto results = SharedMemoryCommunicator::launch(ranks, 1 << 20, [&](Communicator& comm) {
+        // Start from a round-robin distribution unrelated to space
+        std::vector<Atom> mine;
+        for (std::size_t i = static_cast<std::size_t>(comm.getRank()); i < atoms.size(); i += ranks) {
+            mine.push_back(atoms[i]);
+        }
+
+        BoundingBox root = DistributedOctree::reduceBounds(comm, mine);
+        DistributedOctree octree(comm, root, 9, 2);
+        octree.build(mine);
+        octree.balance();
+
+        for (const auto& atom : octree.getLocalAtoms()) {
+            std::uint64_t key = octree.getLocalTree().getEncoder().encode(atom.getX(), atom.getY(), atom.getZ());
+            if (key < octree.getKeyBegin() || key >= octree.getKeyEnd()) {
+                throw std::runtime_error("atom not owned by its rank");
+            }
+        }
+        if (octree.getGlobalLeafCount() == 0) {
+            throw std::runtime_error("empty tree");
+        }
+        return packLeaves(octree.getLocalTree());
+    });
+
+    auto leaves = unpackLeaves(results);
+    ASSERT_FALSE(leaves.empty());
+
+    // Rank slices concatenate into one complete tiling holding every atom
+    std::uint64_t expectedKey = 0;
+    std::size_t atomTotal = 0;
+    for (const auto& leaf : leaves) {
+        EXPECT_EQ(leaf.key, expectedKey);
+        expectedKey += mortonSpan(leaf.level);
+        atomTotal += leaf.atomCount;
+    }
+    EXPECT_EQ(expectedKey, kMortonKeyEnd);
+    EXPECT_EQ(atomTotal, atoms.size());
+
+    // Balance holds across rank boundaries
+    auto findLevel = [&](std::uint64_t key) {
+        auto it = std::upper_bound(leaves.begin(), leaves.end(), key,
+                                   [](std::uint64_t k, const LeafRecord& leaf) { return k < leaf.key; });
+        return (it - 1)->level;
+    };
+    for (const auto& leaf : leaves) {
+        auto anchor = decodeMorton(leaf.key);
+        std::uint32_t size = std::uint32_t{1} << (kMortonLevels - leaf.level);
+        if (anchor[0] + size < kMortonLatticeSize) {
+            EXPECT_GE(findLevel(encodeMorton(anchor[0] + size, anchor[1], anchor[2])) + 1, leaf.level);
+        }
+        if (anchor[1] > 0) {
+            EXPECT_GE(findLevel(encodeMorton(anchor[0], anchor[1] - 1, anchor[2])) + 1, leaf.level);
+        }
+    }
+}
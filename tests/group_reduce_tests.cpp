@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "biomesh/biomesh.h"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+std::vector<Atom> makeAtoms(std::size_t count) {
+    SyntheticMoleculeGenerator generator(SyntheticShape::Globular, count, 5);
+    return AtomBuilder().buildAtoms(generator.generate());
+}
+
+// One huge group, runs of tiny groups and a few empty ones
+std::vector<std::uint32_t> skewedOffsets(std::uint32_t atomCount) {
+    std::vector<std::uint32_t> offsets = {0, 0, atomCount / 2};
+    for (std::uint32_t offset = atomCount / 2; offset < atomCount;) {
+        offset = std::min(atomCount, offset + 1 + offset % 13);
+        offsets.push_back(offset);
+    }
+    offsets.push_back(atomCount);
+    return offsets;
+}
+
+void expectSame(const GroupReduction& a, const GroupReduction& b) {
+    ASSERT_EQ(a.size(), b.size());
+    for (std::size_t g = 0; g < a.size(); ++g) {
+        EXPECT_EQ(a.bounds[g].getMinX(), b.bounds[g].getMinX());
+        EXPECT_EQ(a.bounds[g].getMaxY(), b.bounds[g].getMaxY());
+        EXPECT_EQ(a.bounds[g].getMaxZ(), b.bounds[g].getMaxZ());
+        EXPECT_EQ(a.masses[g], b.masses[g]);
+        EXPECT_EQ(a.atomCounts[g], b.atomCounts[g]);
+        for (int d = 0; d < 3; ++d) {
+            if (std::isnan(a.centersOfMass[g][d])) {
+                EXPECT_TRUE(std::isnan(b.centersOfMass[g][d]));
+            } else {
+                EXPECT_EQ(a.centersOfMass[g][d], b.centersOfMass[g][d]);
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(GroupReduceTest, MatchesPerGroupReference) {
+    const auto atoms = makeAtoms(5000);
+    const auto offsets = skewedOffsets(5000);
+    const GroupReduction result = GroupReducer(4, 256).reduce(atoms, offsets);
+    ASSERT_EQ(result.size(), offsets.size() - 1);
+
+    for (std::size_t g = 0; g + 1 < offsets.size(); ++g) {
+        const std::vector<Atom> group(atoms.begin() + offsets[g], atoms.begin() + offsets[g + 1]);
+        BoundingBox expected;
+        expected.calculateFromAtoms(group);
+        double mass = 0.0;
+        double weighted[3] = {0.0, 0.0, 0.0};
+        for (const auto& atom : group) {
+            mass += atom.getAtomicMass();
+            for (int d = 0; d < 3; ++d) {
+                weighted[d] += atom.getAtomicMass() * atom.getCoordinates()[d];
+            }
+        }
+
+        ASSERT_EQ(result.atomCounts[g], group.size());
+        EXPECT_EQ(result.bounds[g].isEmpty(), group.empty());
+        if (group.empty()) {
+            EXPECT_EQ(result.masses[g], 0.0);
+            EXPECT_TRUE(std::isnan(result.centersOfMass[g][0]));
+            continue;
+        }
+        EXPECT_EQ(result.bounds[g].getMinX(), expected.getMinX());
+        EXPECT_EQ(result.bounds[g].getMinY(), expected.getMinY());
+        EXPECT_EQ(result.bounds[g].getMinZ(), expected.getMinZ());
+        EXPECT_EQ(result.bounds[g].getMaxX(), expected.getMaxX());
+        EXPECT_EQ(result.bounds[g].getMaxY(), expected.getMaxY());
+        EXPECT_EQ(result.bounds[g].getMaxZ(), expected.getMaxZ());
+        EXPECT_NEAR(result.masses[g], mass, 1e-9 * mass);
+        for (int d = 0; d < 3; ++d) {
+            EXPECT_NEAR(result.centersOfMass[g][d], weighted[d] / mass, 1e-9);
+        }
+    }
+}
+
+TEST(GroupReduceTest, ResultsIndependentOfThreadCount) {
+    const auto atoms = makeAtoms(20000);
+    const auto offsets = skewedOffsets(20000);
+    const GroupReduction serial = GroupReducer(1, 512).reduce(atoms, offsets);
+    expectSame(serial, GroupReducer(3, 512).reduce(atoms, offsets));
+    expectSame(serial, GroupReducer(8, 512).reduce(atoms, offsets));
+    // The columnar path performs the same arithmetic
+    expectSame(serial, GroupReducer(4, 512).reduce(AtomColumns::fromAtoms(atoms), offsets));
+}
+
+TEST(GroupReduceTest, GroupsSpanningManyChunks) {
+    const auto atoms = makeAtoms(1000);
+    // Offsets need not start at zero; the single group spans 100 chunks
+    const std::vector<std::uint32_t> offsets = {100, 900};
+    const GroupReduction chunked = GroupReducer(4, 8).reduce(atoms, offsets);
+    const GroupReduction whole = GroupReducer(1, 1000).reduce(atoms, offsets);
+    ASSERT_EQ(chunked.size(), 1u);
+    EXPECT_EQ(chunked.atomCounts[0], 800u);
+    EXPECT_EQ(chunked.bounds[0].getMinX(), whole.bounds[0].getMinX());
+    EXPECT_EQ(chunked.bounds[0].getMaxZ(), whole.bounds[0].getMaxZ());
+    EXPECT_NEAR(chunked.masses[0], whole.masses[0], 1e-9 * whole.masses[0]);
+    EXPECT_NEAR(chunked.centersOfMass[0][1], whole.centersOfMass[0][1], 1e-9);
+}
+
+TEST(GroupReduceTest, MasslessGroupsUseCentroid) {
+    std::vector<Atom> atoms = {Atom(0.0, 0.0, 0.0, "X"), Atom(2.0, 4.0, 6.0, "X")};
+    const GroupReduction result = GroupReducer(1).reduce(atoms, {0, 2});
+    EXPECT_EQ(result.masses[0], 0.0);
+    EXPECT_EQ(result.centersOfMass[0], (std::array<double, 3>{1.0, 2.0, 3.0}));
+}
+
+TEST(GroupReduceTest, RejectsInvalidOffsets) {
+    const auto atoms = makeAtoms(100);
+    const GroupReducer reducer(2);
+    EXPECT_THROW(reducer.reduce(atoms, {}), std::invalid_argument);
+    EXPECT_THROW(reducer.reduce(atoms, {0, 50, 40, 100}), std::invalid_argument);
+    EXPECT_THROW(reducer.reduce(atoms, {0, 101}), std::invalid_argument);
+    EXPECT_THROW(GroupReducer(1, 0), std::invalid_argument);
+    EXPECT_EQ(reducer.reduce(atoms, {0}).size(), 0u);
+}
+
+TEST(GroupReduceTest, ReducesHierarchyGroups) {
+    const auto atoms = makeAtoms(3000);
+    StructureHierarchy hierarchy;
+    for (std::size_t i = 0; i < atoms.size(); ++i) {
+        hierarchy.addAtom(1, packName(i < 2000 ? "A" : "B"), packName("RES"), static_cast<std::int32_t>(i / 10));
+    }
+    const GroupReducer reducer(2, 1024);
+    const GroupReduction chains = reducer.reduce(atoms, hierarchy.getChainAtomOffsets());
+    const GroupReduction residues = reducer.reduce(atoms, hierarchy.getResidueAtomOffsets());
+    ASSERT_EQ(chains.size(), 2u);
+    ASSERT_EQ(residues.size(), 300u);
+    EXPECT_EQ(chains.atomCounts[0], 2000u);
+
+    // Every residue box lies inside its chain box
+    for (std::size_t r = 0; r < residues.size(); ++r) {
+        EXPECT_TRUE(chains.bounds[hierarchy.findChainOfResidue(r)].contains(residues.bounds[r]));
+    }
+}
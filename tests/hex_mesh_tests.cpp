@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "biomesh/hex_mesh.h"
+#include "biomesh/task_graph.h"
+#include "biomesh/vertex_table.h"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace BioMesh;
+
+TEST(ConcurrentVertexTableTest, LatticeKeyRoundTrip) {
+    const std::uint32_t max = std::uint32_t{1} << 21;
+    auto decoded = decodeLatticeVertex(encodeLatticeVertex(max, 0, max));
+    EXPECT_EQ(decoded[0], max);
+    EXPECT_EQ(decoded[1], 0u);
+    EXPECT_EQ(decoded[2], max);
+    EXPECT_NE(encodeLatticeVertex(max, max, max), ConcurrentVertexTable::kEmptyKey);
+    EXPECT_LT(encodeLatticeVertex(0, 1, 0), encodeLatticeVertex(1, 0, 0));
+}
+
+TEST(ConcurrentVertexTableTest, ConcurrentInsertDeduplicates) {
+    const std::size_t distinct = 5000;
+    ConcurrentVertexTable table(distinct);
+    EXPECT_GE(table.getCapacity(), 2 * distinct);
+
+    // Every thread inserts the same keys in a different order (multipliers coprime to 5000)
+    const unsigned threads = 8;
+    const std::size_t multipliers[threads] = {1, 3, 7, 9, 11, 13, 17, 19};
+    std::vector<std::vector<std::uint32_t>> slots(threads, std::vector<std::uint32_t>(distinct));
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (std::size_t i = 0; i < distinct; ++i) {
+                std::size_t k = (i * multipliers[t] + t) % distinct;
+                slots[t][k] = table.insert(encodeLatticeVertex(static_cast<std::uint32_t>(k), 3, 7));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    EXPECT_EQ(table.compact(), distinct);
+    for (std::size_t k = 0; k < distinct; ++k) {
+        for (unsigned t = 1; t < threads; ++t) {
+            EXPECT_EQ(slots[t][k], slots[0][k]);
+        }
+        // Dense IDs follow key order
+        EXPECT_EQ(table.getId(slots[0][k]), k);
+    }
+    EXPECT_TRUE(std::is_sorted(table.getKeys().begin(), table.getKeys().end()));
+}
+
+TEST(ConcurrentVertexTableTest, FullTableThrows) {
+    ConcurrentVertexTable table(1);
+    for (std::uint32_t i = 0; i < table.getCapacity(); ++i) {
+        table.insert(encodeLatticeVertex(i, 0, 0));
+    }
+    EXPECT_THROW(table.insert(encodeLatticeVertex(0, 0, 1)), std::length_error);
+}
+
+class HexMeshExtractorTest : public ::testing::Test {
+protected:
+    // One atom per cell of a 4x4x4 grid forces a uniform level-2 octree
+    void SetUp() override {
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                for (int k = 0; k < 4; ++k) {
+                    atoms.emplace_back(i + 0.5, j + 0.5, k + 0.5, "C");
+                }
+            }
+        }
+    }
+
+    std::vector<Atom> atoms;
+    BoundingBox root{0.0, 0.0, 0.0, 4.0, 4.0, 4.0};
+};
+
+TEST_F(HexMeshExtractorTest, UniformGridSharesVertices) {
+    LinearOctree tree(root, 6, 1);
+    tree.build(atoms);
+    ASSERT_EQ(tree.getLeaves().size(), 64u);
+
+    HexMesh mesh = HexMeshExtractor(4).extract(tree);
+    EXPECT_EQ(mesh.getHexCount(), 64u);
+    EXPECT_EQ(mesh.getVertexCount(), 125u);
+
+    // The first leaf is the unit cube at the origin in VTK corner order
+    const auto& hex = mesh.hexahedra.front();
+    const double expected[8][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+                                   {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}};
+    for (int corner = 0; corner < 8; ++corner) {
+        for (int axis = 0; axis < 3; ++axis) {
+            EXPECT_DOUBLE_EQ(mesh.vertices[hex[corner]][axis], expected[corner][axis]);
+        }
+    }
+    EXPECT_EQ(mesh.levels.front(), 2);
+}
+
+TEST_F(HexMeshExtractorTest, ResultIndependentOfThreadCount) {
+    std::mt19937 rng(3);
+    std::normal_distribution<double> cluster(2.0, 0.6);
+    for (int i = 0; i < 300; ++i) {
+        atoms.emplace_back(std::clamp(cluster(rng), 0.0, 4.0), std::clamp(cluster(rng), 0.0, 4.0),
+                           std::clamp(cluster(rng), 0.0, 4.0), "O");
+    }
+    LinearOctree tree(root, 8, 2);
+    tree.build(atoms);
+    tree.balance();
+
+    HexMesh serial = HexMeshExtractor(1).extract(tree);
+    HexMesh parallel = HexMeshExtractor(8).extract(tree);
+    EXPECT_EQ(serial.vertices, parallel.vertices);
+    EXPECT_EQ(serial.hexahedra, parallel.hexahedra);
+
+    // Blocks on a scheduler's workers, as inside a wide scheduler task
+    TaskScheduler scheduler(4);
+    TaskGraph graph;
+    HexMesh pooled;
+    graph.addTask("mesh", [&](unsigned threads) {
+        HexMeshExtractor extractor(threads);
+        extractor.setScheduler(&scheduler);
+        pooled = extractor.extract(tree);
+    }, 1.0, 4);
+    scheduler.run(graph);
+    EXPECT_EQ(serial.vertices, pooled.vertices);
+    EXPECT_EQ(serial.hexahedra, pooled.hexahedra);
+
+    // Every corner is a distinct vertex of its hexahedron
+    for (const auto& hex : serial.hexahedra) {
+        EXPECT_EQ(std::set<std::uint32_t>(hex.begin(), hex.end()).size(), 8u);
+    }
+}
+
+TEST_F(HexMeshExtractorTest, OccupiedLeavesOnly) {
+    std::vector<Atom> corner = {Atom(0.1, 0.1, 0.1, "C"), Atom(0.6, 0.1, 0.1, "C")};
+    LinearOctree tree(root, 4, 1);
+    tree.build(corner);
+
+    HexMesh full = HexMeshExtractor(2).extract(tree);
+    HexMesh occupied = HexMeshExtractor(2).extract(tree, true);
+    EXPECT_EQ(full.getHexCount(), tree.getLeaves().size());
+    EXPECT_EQ(occupied.getHexCount(), 2u);
+    EXPECT_LT(occupied.getVertexCount(), full.getVertexCount());
+}
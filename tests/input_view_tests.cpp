@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "biomesh/biomesh.h"
+#include <deque>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+// Trajectory-style record with coordinates embedded among other fields
+struct FrameAtom {
+    char name[4];
+    double xyz[3];
+    float occupancy;
+    std::int32_t element;
+};
+
+const std::vector<std::string> kSymbols = {"C", "N", "O", "H", "S"};
+
+std::vector<FrameAtom> makeFrame() {
+    std::vector<FrameAtom> frame;
+    for (int i = 0; i < 20; ++i) {
+        FrameAtom atom{};
+        atom.xyz[0] = 0.5 * i - 3.0;
+        atom.xyz[1] = (i % 7) * 1.25;
+        atom.xyz[2] = -0.75 * (i % 5);
+        atom.element = i % 5;
+        frame.push_back(atom);
+    }
+    return frame;
+}
+
+std::vector<Atom> referenceAtoms(const std::vector<FrameAtom>& frame) {
+    std::vector<Atom> atoms;
+    for (const auto& item : frame) {
+        atoms.emplace_back(item.xyz[0], item.xyz[1], item.xyz[2], kSymbols[static_cast<std::size_t>(item.element)]);
+    }
+    return AtomBuilder().buildAtoms(atoms);
+}
+
+void expectSameAtoms(const std::vector<Atom>& actual, const std::vector<Atom>& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0; i < actual.size(); ++i) {
+        EXPECT_EQ(actual[i].getCoordinates(), expected[i].getCoordinates());
+        EXPECT_EQ(actual[i].getChemicalElement(), expected[i].getChemicalElement());
+        EXPECT_EQ(actual[i].getAtomicRadius(), expected[i].getAtomicRadius());
+        EXPECT_EQ(actual[i].getAtomicMass(), expected[i].getAtomicMass());
+    }
+}
+
+} // namespace
+
+TEST(InputViewTest, CoordinateViewLayouts) {
+    const std::vector<double> interleaved = {1, 2, 3, 4, 5, 6};
+    const std::vector<double> columnMajor = {1, 4, 2, 5, 3, 6};
+    const std::vector<double> x = {1, 4}, y = {2, 5}, z = {3, 6};
+
+    for (const CoordinateView& view : {CoordinateView::interleaved(interleaved.data(), 2),
+                                       CoordinateView::columnMajor(columnMajor.data(), 2),
+                                       CoordinateView::separate(x.data(), y.data(), z.data(), 2)}) {
+        ASSERT_EQ(view.size(), 2u);
+        EXPECT_EQ(view[0], (std::array<double, 3>{1, 2, 3}));
+        EXPECT_EQ(view[1], (std::array<double, 3>{4, 5, 6}));
+    }
+
+    EXPECT_TRUE(CoordinateView().empty());
+    EXPECT_TRUE(CoordinateView::interleaved(nullptr, 0).empty());
+    EXPECT_THROW(CoordinateView::interleaved(nullptr, 2), std::invalid_argument);
+    EXPECT_THROW(CoordinateView(x.data(), y.data(), z.data(), 2, 0), std::invalid_argument);
+}
+
+TEST(InputViewTest, BoundsFromViewsMatchAtoms) {
+    const auto frame = makeFrame();
+    BoundingBox expected;
+    expected.calculateFromAtoms(referenceAtoms(frame));
+
+    BoundingBox fromView;
+    fromView.calculateFromPoints(
+        CoordinateView(&frame[0].xyz[0], &frame[0].xyz[1], &frame[0].xyz[2], frame.size(), sizeof(FrameAtom)));
+
+    BoundingBox fromRange;
+    const std::list<FrameAtom> linked(frame.begin(), frame.end());
+    fromRange.calculateFromRange(linked.begin(), linked.end(), [](const FrameAtom& item) { return item.xyz; });
+
+    for (const BoundingBox* box : {&fromView, &fromRange}) {
+        EXPECT_EQ(box->getMinX(), expected.getMinX());
+        EXPECT_EQ(box->getMinY(), expected.getMinY());
+        EXPECT_EQ(box->getMinZ(), expected.getMinZ());
+        EXPECT_EQ(box->getMaxX(), expected.getMaxX());
+        EXPECT_EQ(box->getMaxY(), expected.getMaxY());
+        EXPECT_EQ(box->getMaxZ(), expected.getMaxZ());
+    }
+
+    // Recalculating resets previous bounds
+    fromView.calculateFromPoints(CoordinateView());
+    EXPECT_TRUE(fromView.isEmpty());
+}
+
+TEST(InputViewTest, BuildAtomsFromStridedViews) {
+    const auto frame = makeFrame();
+    const CoordinateView coordinates(&frame[0].xyz[0], &frame[0].xyz[1], &frame[0].xyz[2], frame.size(),
+                                     sizeof(FrameAtom));
+    const StridedView<std::int32_t> ids(&frame[0].element, frame.size(), sizeof(FrameAtom));
+    const AtomBuilder builder;
+    expectSameAtoms(builder.buildAtoms(coordinates, ids, kSymbols), referenceAtoms(frame));
+
+    // One-based IDs in a plain array
+    std::vector<std::int32_t> oneBased;
+    for (const auto& item : frame) {
+        oneBased.push_back(item.element + 1);
+    }
+    expectSameAtoms(builder.buildAtoms(coordinates, StridedView<std::int32_t>(oneBased.data(), oneBased.size()),
+                                       kSymbols, 1),
+                    referenceAtoms(frame));
+}
+
+TEST(InputViewTest, BuildAtomsFromStridedViewsRejectsBadInput) {
+    auto frame = makeFrame();
+    const CoordinateView coordinates(&frame[0].xyz[0], &frame[0].xyz[1], &frame[0].xyz[2], frame.size(),
+                                     sizeof(FrameAtom));
+    const StridedView<std::int32_t> ids(&frame[0].element, frame.size(), sizeof(FrameAtom));
+    const AtomBuilder builder;
+
+    EXPECT_THROW(builder.buildAtoms(coordinates, StridedView<std::int32_t>(&frame[0].element, 3, sizeof(FrameAtom)),
+                                    kSymbols),
+                 std::invalid_argument);
+    frame[4].element = 9;
+    EXPECT_THROW(builder.buildAtoms(coordinates, ids, kSymbols), std::out_of_range);
+    frame[4].element = 0;
+
+    // An unknown symbol only fails when an atom uses it
+    std::vector<std::string> symbols = kSymbols;
+    symbols.push_back("Xx");
+    EXPECT_NO_THROW(builder.buildAtoms(coordinates, ids, symbols));
+    frame[4].element = 5;
+    EXPECT_THROW(builder.buildAtoms(coordinates, ids, symbols), std::runtime_error);
+}
+
+TEST(InputViewTest, BuildAtomsFromProjectedRange) {
+    const auto frame = makeFrame();
+    const std::deque<FrameAtom> queue(frame.begin(), frame.end());
+    const auto atoms = AtomBuilder().buildAtoms(queue.begin(), queue.end(), [](const FrameAtom& item) {
+        return AtomRecord{item.xyz[0], item.xyz[1], item.xyz[2], kSymbols[static_cast<std::size_t>(item.element)]};
+    });
+    expectSameAtoms(atoms, referenceAtoms(frame));
+
+    const std::vector<const char*> unknown = {"C", "Xx"};
+    EXPECT_THROW(AtomBuilder().buildAtoms(unknown.begin(), unknown.end(),
+                                          [](const char* symbol) { return AtomRecord{0.0, 0.0, 0.0, symbol}; }),
+                 std::runtime_error);
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include "biomesh/linear_octree.h"
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+// Every leaf's neighbours must be at most one level coarser
+bool isTwoToOneBalanced(const LinearOctree& tree) {
+    for (const auto& leaf : tree.getLeaves()) {
+        auto anchor = decodeMorton(leaf.key);
+        std::int64_t size = std::int64_t{1} << (kMortonLevels - leaf.level);
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dz = -1; dz <= 1; ++dz) {
+                    std::int64_t n[3];
+                    const int d[3] = {dx, dy, dz};
+                    bool valid = true;
+                    for (int axis = 0; axis < 3; ++axis) {
+                        std::int64_t base = anchor[axis];
+                        n[axis] = d[axis] < 0 ? base - 1 : (d[axis] > 0 ? base + size : base);
+                        valid = valid && n[axis] >= 0 && n[axis] < std::int64_t{kMortonLatticeSize};
+                    }
+                    if (!valid) {
+                        continue;
+                    }
+                    std::size_t index = tree.findLeaf(encodeMorton(static_cast<std::uint32_t>(n[0]),
+                                                                   static_cast<std::uint32_t>(n[1]),
+                                                                   static_cast<std::uint32_t>(n[2])));
+                    if (index != LinearOctree::npos && tree.getLeaves()[index].level + 1 < leaf.level) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(MortonTest, EncodeDecodeRoundTrip) {
+    EXPECT_EQ(encodeMorton(0, 0, 0), 0u);
+    EXPECT_EQ(encodeMorton(1, 0, 0), 4u);
+    EXPECT_EQ(encodeMorton(0, 1, 0), 2u);
+    EXPECT_EQ(encodeMorton(0, 0, 1), 1u);
+    EXPECT_EQ(encodeMorton(kMortonLatticeSize - 1, kMortonLatticeSize - 1, kMortonLatticeSize - 1),
+              kMortonKeyEnd - 1);
+
+    std::uint32_t x = 123456, y = 2000000, z = 7;
+    auto decoded = decodeMorton(encodeMorton(x, y, z));
+    EXPECT_EQ(decoded[0], x);
+    EXPECT_EQ(decoded[1], y);
+    EXPECT_EQ(decoded[2], z);
+}
+
+TEST(MortonTest, TopLevelKeysFollowSubdivideOrder) {
+    BoundingBox root(-1.0, -1.0, -1.0, 1.0, 1.0, 1.0);
+    MortonEncoder encoder(root);
+    auto octants = root.subdivide();
+    for (std::size_t octant = 0; octant < octants.size(); ++octant) {
+        double cx, cy, cz;
+        octants[octant].getCenter(cx, cy, cz);
+        EXPECT_EQ(encoder.encode(cx, cy, cz) / mortonSpan(1), octant);
+
+        BoundingBox box = encoder.nodeBox(octant * mortonSpan(1), 1);
+        EXPECT_DOUBLE_EQ(box.getMinX(), octants[octant].getMinX());
+        EXPECT_DOUBLE_EQ(box.getMaxY(), octants[octant].getMaxY());
+        EXPECT_DOUBLE_EQ(box.getMaxZ(), octants[octant].getMaxZ());
+    }
+    EXPECT_THROW(MortonEncoder{BoundingBox{}}, std::invalid_argument);
+}
+
+class LinearOctreeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::mt19937 rng(42);
+        std::normal_distribution<double> cluster(0.0, 1.5);
+        std::uniform_real_distribution<double> spread(-10.0, 10.0);
+        for (int i = 0; i < 400; ++i) {
+            atoms.emplace_back(cluster(rng), cluster(rng), cluster(rng), "C");
+        }
+        for (int i = 0; i < 100; ++i) {
+            atoms.emplace_back(spread(rng), spread(rng), spread(rng), "O");
+        }
+        root.calculateFromAtoms(atoms);
+    }
+
+    std::vector<Atom> atoms;
+    BoundingBox root;
+};
+
+TEST_F(LinearOctreeTest, InvalidParametersThrow) {
+    EXPECT_THROW(LinearOctree(root, 0), std::invalid_argument);
+    EXPECT_THROW(LinearOctree(root, 22), std::invalid_argument);
+    EXPECT_THROW(LinearOctree(root, 8, 0), std::invalid_argument);
+
+    LinearOctree tree(root, 4);
+    EXPECT_THROW(tree.build(atoms, 1, kMortonKeyEnd), std::invalid_argument);
+    atoms.emplace_back(100.0, 0.0, 0.0, "C");
+    EXPECT_THROW(tree.build(atoms), std::out_of_range);
+}
+
+TEST_F(LinearOctreeTest, LeavesTileRootAndHoldTheirAtoms) {
+    LinearOctree tree(root, 8, 4);
+    tree.build(atoms);
+
+    std::uint64_t expectedKey = 0;
+    std::size_t atomTotal = 0;
+    for (const auto& leaf : tree.getLeaves()) {
+        EXPECT_EQ(leaf.key, expectedKey);
+        expectedKey += mortonSpan(leaf.level);
+        EXPECT_TRUE(leaf.atomCount <= 4 || leaf.level == 8);
+        EXPECT_EQ(leaf.firstAtom, atomTotal);
+        atomTotal += leaf.atomCount;
+
+        BoundingBox box = tree.getLeafBox(leaf);
+        box.expand(1e-9);
+        for (std::uint32_t i = leaf.firstAtom; i < leaf.firstAtom + leaf.atomCount; ++i) {
+            EXPECT_TRUE(box.contains(atoms[tree.getAtomOrder()[i]]));
+        }
+    }
+    EXPECT_EQ(expectedKey, kMortonKeyEnd);
+    EXPECT_EQ(atomTotal, atoms.size());
+}
+
+TEST_F(LinearOctreeTest, FindLeafLocatesContainingLeaf) {
+    LinearOctree tree(root, 8, 4);
+    tree.build(atoms);
+    for (std::size_t i = 0; i < tree.getAtomKeys().size(); ++i) {
+        std::size_t index = tree.findLeaf(tree.getAtomKeys()[i]);
+        ASSERT_NE(index, LinearOctree::npos);
+        const OctreeLeaf& leaf = tree.getLeaves()[index];
+        EXPECT_GE(i, leaf.firstAtom);
+        EXPECT_LT(i, leaf.firstAtom + leaf.atomCount);
+    }
+}
+
+TEST_F(LinearOctreeTest, BalanceEnforcesTwoToOne) {
+    LinearOctree tree(root, 10, 1);
+    tree.build(atoms);
+    std::size_t before = tree.getLeaves().size();
+
+    std::size_t splits = tree.balance();
+    EXPECT_GT(splits, 0u);
+    EXPECT_EQ(tree.getLeaves().size(), before + 7 * splits);
+    EXPECT_TRUE(isTwoToOneBalanced(tree));
+
+    // Balancing is idempotent and preserves atom ranges
+    EXPECT_EQ(tree.balance(), 0u);
+    std::size_t atomTotal = 0;
+    for (const auto& leaf : tree.getLeaves()) {
+        EXPECT_EQ(leaf.firstAtom, atomTotal);
+        atomTotal += leaf.atomCount;
+    }
+    EXPECT_EQ(atomTotal, atoms.size());
+}
+
+TEST_F(LinearOctreeTest, RangeBuildCoversOnlyRange) {
+    LinearOctree full(root, 6, 4);
+    full.build(atoms);
+
+    const std::uint64_t split = 3 * mortonSpan(1) + 5 * mortonSpan(6);
+    std::vector<Atom> lower, upper;
+    MortonEncoder encoder(root);
+    for (const auto& atom : atoms) {
+        (encoder.encode(atom.getX(), atom.getY(), atom.getZ()) < split ? lower : upper).push_back(atom);
+    }
+
+    LinearOctree first(root, 6, 4);
+    first.build(lower, 0, split);
+    LinearOctree second(root, 6, 4);
+    second.build(upper, split, kMortonKeyEnd);
+
+    EXPECT_EQ(first.getLeaves().front().key, 0u);
+    EXPECT_EQ(second.getLeaves().front().key, split);
+    const OctreeLeaf& last = first.getLeaves().back();
+    EXPECT_EQ(last.key + mortonSpan(last.level), split);
+    EXPECT_EQ(first.findLeaf(split), LinearOctree::npos);
+    EXPECT_THROW(first.build(upper, 0, split), std::out_of_range);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "biomesh/biomesh.h"
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace BioMesh;
+
+TEST(MemoryUsageTest, VectorReportsSizeAndCapacity) {
+    std::vector<double> values(10);
+    values.reserve(32);
+    MemoryUsage usage = memoryUsage(values);
+    EXPECT_EQ(usage.usedBytes, 10 * sizeof(double));
+    EXPECT_EQ(usage.reservedBytes, 32 * sizeof(double));
+}
+
+TEST(MemoryUsageTest, ShortStringsStayInline) {
+    EXPECT_EQ(memoryUsage(std::string("C")).reservedBytes, 0u);
+    std::string longName(100, 'x');
+    MemoryUsage usage = memoryUsage(longName);
+    EXPECT_EQ(usage.usedBytes, 101u);
+    EXPECT_GE(usage.reservedBytes, 101u);
+}
+
+TEST(MemoryUsageTest, AtomContainerCountsSpilledElementStrings) {
+    std::vector<Atom> atoms = {Atom(0, 0, 0, "C"), Atom(1, 1, 1, "O")};
+    MemoryUsage shortNames = memoryUsage(atoms);
+    EXPECT_EQ(shortNames.usedBytes, 2 * sizeof(Atom));
+
+    atoms.emplace_back(2, 2, 2, std::string(64, 'Q'));
+    MemoryUsage withLongName = memoryUsage(atoms);
+    EXPECT_EQ(withLongName.usedBytes, 3 * sizeof(Atom) + 65);
+    EXPECT_GE(withLongName.reservedBytes, withLongName.usedBytes);
+}
+
+TEST(MemoryUsageTest, StructuresReportReservedAtLeastUsed) {
+    SyntheticMoleculeGenerator generator(SyntheticShape::Globular, 5000, 4);
+    AtomBuilder builder;
+    auto atoms = builder.buildAtoms(generator.generate());
+
+    MemoryUsage table = builder.memoryUsage();
+    EXPECT_GT(table.usedBytes, 0u);
+    EXPECT_GE(table.reservedBytes, table.usedBytes);
+
+    LinearOctree tree(generator.getExtent());
+    tree.build(atoms);
+    tree.balance();
+    MemoryUsage octree = tree.memoryUsage();
+    EXPECT_EQ(octree.usedBytes, tree.getLeaves().size() * sizeof(OctreeLeaf) +
+                                    atoms.size() * (sizeof(std::uint64_t) + sizeof(std::uint32_t)));
+    EXPECT_GE(octree.reservedBytes, octree.usedBytes);
+
+    HexMesh mesh = HexMeshExtractor(2).extract(tree);
+    MemoryUsage meshUsage = mesh.memoryUsage();
+    EXPECT_EQ(meshUsage.usedBytes, mesh.getVertexCount() * 3 * sizeof(double) + mesh.getHexCount() * 33);
+
+    ConcurrentVertexTable vertexTable(100);
+    EXPECT_EQ(vertexTable.memoryUsage().reservedBytes, vertexTable.getCapacity() * sizeof(std::uint64_t));
+
+    ShardPlan plan(atoms, 1.4, 1);
+    MemoryUsage shards = plan.memoryUsage();
+    EXPECT_GE(shards.usedBytes, atoms.size() * sizeof(std::size_t));
+}
+
+TEST(MemoryUsageTest, JobEstimateCoversMeasuredFootprint) {
+    const std::size_t count = 20000;
+    SyntheticMoleculeGenerator generator(SyntheticShape::Globular, count, 8);
+    auto parsed = generator.generate();
+    auto atoms = AtomBuilder().buildAtoms(parsed);
+    LinearOctree tree(generator.getExtent());
+    tree.build(atoms);
+    tree.balance();
+    HexMesh mesh = HexMeshExtractor(1).extract(tree);
+
+    const std::size_t measured = (memoryUsage(parsed) + memoryUsage(atoms) + tree.memoryUsage() +
+                                  mesh.memoryUsage()).reservedBytes;
+    const std::size_t estimate = estimateJobMemory(count);
+    EXPECT_GE(estimate, measured);
+    EXPECT_LE(estimate, 4 * measured);
+    EXPECT_LT(estimateJobMemory(count), estimateJobMemory(2 * count));
+}
+
+TEST(CountingMemoryResourceTest, TracksCurrentAndPeakBytes) {
+    CountingMemoryResource resource;
+    {
+        std::pmr::vector<std::uint64_t> values(&resource);
+        values.reserve(1000);
+        EXPECT_EQ(resource.getCurrentBytes(), 8000u);
+        EXPECT_EQ(resource.getAllocationCount(), 1u);
+        {
+            std::pmr::vector<std::uint64_t> scratch(500, 0, &resource);
+            EXPECT_EQ(resource.getPeakBytes(), 12000u);
+        }
+        EXPECT_EQ(resource.getCurrentBytes(), 8000u);
+        EXPECT_EQ(resource.getPeakBytes(), 12000u);
+        resource.resetPeak();
+        EXPECT_EQ(resource.getPeakBytes(), 8000u);
+    }
+    EXPECT_EQ(resource.getCurrentBytes(), 0u);
+}
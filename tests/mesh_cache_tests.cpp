@@ -0,0 +1,306 @@
+#include <gtest/gtest.h>
+#include "biomesh/biomesh.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <iterator>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace BioMesh;
+namespace fs = std::filesystem;
+
+namespace {
+
+class MeshCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory_ = ::testing::TempDir() + "biomesh_mesh_cache_" +
+                     ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        fs::remove_all(directory_);
+    }
+
+    void TearDown() override { fs::remove_all(directory_); }
+
+    static std::vector<Atom> makeAtoms(std::size_t count, std::uint64_t seed) {
+        SyntheticMoleculeGenerator generator(SyntheticShape::Globular, count, seed);
+        return AtomBuilder().buildAtoms(generator.generate());
+    }
+
+    static BoundingBox extentOf(std::size_t count, std::uint64_t seed) {
+        return SyntheticMoleculeGenerator(SyntheticShape::Globular, count, seed).getExtent();
+    }
+
+    std::string directory_;
+};
+
+std::size_t countEntryFiles(const std::string& directory) {
+    std::size_t count = 0;
+    for (const auto& file : fs::directory_iterator(directory)) {
+        count += file.path().extension() == ".bmc" ? 1 : 0;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(MurmurHash3Test, MatchesReferenceVectors) {
+    EXPECT_EQ(MurmurHash3::hash("", 0), (Hash128{0, 0}));
+    EXPECT_EQ(MurmurHash3::hash("hello", 5), (Hash128{0xcbd8a7b341bd9b02ULL, 0x5b1e906a48ae1d19ULL}));
+    const std::string fox = "The quick brown fox jumps over the lazy dog";
+    EXPECT_EQ(MurmurHash3::hash(fox.data(), fox.size()), (Hash128{0xe34bbc7bbc071b6cULL, 0x7a433ca9c49a9347ULL}));
+
+    std::uint8_t bytes[40];
+    for (int i = 0; i < 40; ++i) {
+        bytes[i] = static_cast<std::uint8_t>(i);
+    }
+    EXPECT_EQ(MurmurHash3::hash(bytes, sizeof(bytes), 42), (Hash128{0xae8e6b705c22d1daULL, 0xa4794c6f0ee89ef1ULL}));
+    EXPECT_EQ(MurmurHash3::hash("hello", 5).toHex(), "cbd8a7b341bd9b025b1e906a48ae1d19");
+}
+
+TEST(MurmurHash3Test, IncrementalUpdatesMatchOneShot) {
+    const std::string text = "The quick brown fox jumps over the lazy dog, then naps in the sun.";
+    const Hash128 expected = MurmurHash3::hash(text.data(), text.size(), 7);
+    for (std::size_t split = 0; split <= text.size(); ++split) {
+        MurmurHash3 hasher(7);
+        hasher.update(text.data(), split);
+        for (std::size_t i = split; i < text.size(); ++i) {
+            hasher.update(text.data() + i, 1);
+        }
+        EXPECT_EQ(hasher.finish(), expected) << "split at " << split;
+    }
+}
+
+TEST_F(MeshCacheTest, KeyCoversAtomsAndParameters) {
+    auto atoms = makeAtoms(500, 1);
+    const BoundingBox root = extentOf(500, 1);
+    const MeshingParameters parameters;
+    const Hash128 key = MeshCache::computeKey(atoms, root, parameters);
+    EXPECT_EQ(MeshCache::computeKey(atoms, root, parameters), key);
+
+    MeshingParameters deeper = parameters;
+    deeper.maxLevel = 11;
+    EXPECT_NE(MeshCache::computeKey(atoms, root, deeper), key);
+    MeshingParameters unbalanced = parameters;
+    unbalanced.balance = false;
+    EXPECT_NE(MeshCache::computeKey(atoms, root, unbalanced), key);
+
+    BoundingBox wider = root;
+    wider.expand(1.0);
+    EXPECT_NE(MeshCache::computeKey(atoms, wider, parameters), key);
+
+    auto moved = atoms;
+    moved[250].setX(moved[250].getX() + 1e-9);
+    EXPECT_NE(MeshCache::computeKey(moved, root, parameters), key);
+    auto heavier = atoms;
+    heavier[0].setAtomicMass(heavier[0].getAtomicMass() + 1.0);
+    EXPECT_NE(MeshCache::computeKey(heavier, root, parameters), key);
+}
+
+TEST_F(MeshCacheTest, RepeatRequestsHitAndMatchFreshBuild) {
+    const auto atoms = makeAtoms(4000, 2);
+    const BoundingBox root = extentOf(4000, 2);
+    MeshingParameters parameters;
+    parameters.maxAtomsPerLeaf = 6;
+
+    MeshCache cache(directory_, 64 << 20);
+    CachedMesh first = cache.getOrCompute(atoms, root, parameters, 2);
+    EXPECT_EQ(cache.getMissCount(), 1u);
+    EXPECT_EQ(cache.getEntryCount(), 1u);
+    EXPECT_EQ(countEntryFiles(directory_), 1u);
+
+    CachedMesh second = cache.getOrCompute(atoms, root, parameters, 2);
+    EXPECT_EQ(cache.getHitCount(), 1u);
+
+    const auto& a = first.tree.getLeaves();
+    const auto& b = second.tree.getLeaves();
+    ASSERT_EQ(a.size(), b.size());
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].key, b[i].key);
+        EXPECT_EQ(a[i].level, b[i].level);
+        EXPECT_EQ(a[i].firstAtom, b[i].firstAtom);
+        EXPECT_EQ(a[i].atomCount, b[i].atomCount);
+    }
+    EXPECT_EQ(first.tree.getAtomOrder(), second.tree.getAtomOrder());
+    EXPECT_EQ(first.tree.getAtomKeys(), second.tree.getAtomKeys());
+    EXPECT_EQ(second.tree.getMaxAtomsPerLeaf(), 6u);
+    EXPECT_EQ(first.mesh.vertices, second.mesh.vertices);
+    EXPECT_EQ(first.mesh.hexahedra, second.mesh.hexahedra);
+    EXPECT_EQ(first.mesh.levels, second.mesh.levels);
+
+    // A restored tree still answers queries
+    const Atom& probe = atoms[17];
+    EXPECT_NE(second.tree.findLeaf(second.tree.getEncoder().encode(probe.getX(), probe.getY(), probe.getZ())),
+              LinearOctree::npos);
+}
+
+TEST_F(MeshCacheTest, EntriesPersistAcrossInstances) {
+    const auto atoms = makeAtoms(1000, 3);
+    const BoundingBox root = extentOf(1000, 3);
+    {
+        MeshCache cache(directory_, 64 << 20);
+        cache.getOrCompute(atoms, root, MeshingParameters(), 1);
+    }
+    MeshCache reopened(directory_, 64 << 20);
+    EXPECT_EQ(reopened.getEntryCount(), 1u);
+    EXPECT_GT(reopened.getSizeBytes(), 0u);
+    EXPECT_TRUE(reopened.load(MeshCache::computeKey(atoms, root, MeshingParameters())).has_value());
+}
+
+TEST_F(MeshCacheTest, EvictsLeastRecentlyUsed) {
+    const BoundingBox root = extentOf(1500, 10);
+    std::vector<std::vector<Atom>> jobs;
+    for (std::uint64_t seed = 10; seed < 13; ++seed) {
+        auto atoms = makeAtoms(1500, seed);
+        for (auto& atom : atoms) {
+            atom.setCoordinates(atom.getX() * 0.9, atom.getY() * 0.9, atom.getZ() * 0.9);
+        }
+        jobs.push_back(std::move(atoms));
+    }
+
+    // Size the cache for two entries of this size
+    std::size_t entryBytes;
+    {
+        MeshCache probe(directory_ + "_probe", 1 << 30);
+        probe.getOrCompute(jobs[0], root, MeshingParameters(), 1);
+        entryBytes = probe.getSizeBytes();
+        probe.clear();
+    }
+    fs::remove_all(directory_ + "_probe");
+
+    MeshCache cache(directory_, entryBytes * 5 / 2);
+    cache.getOrCompute(jobs[0], root, MeshingParameters(), 1);
+    cache.getOrCompute(jobs[1], root, MeshingParameters(), 1);
+    ASSERT_TRUE(cache.load(MeshCache::computeKey(jobs[0], root, MeshingParameters())).has_value());
+    cache.getOrCompute(jobs[2], root, MeshingParameters(), 1);  // evicts jobs[1]
+
+    EXPECT_EQ(cache.getEntryCount(), 2u);
+    EXPECT_LE(cache.getSizeBytes(), cache.getCapacityBytes());
+    EXPECT_EQ(countEntryFiles(directory_), 2u);
+    EXPECT_TRUE(cache.load(MeshCache::computeKey(jobs[0], root, MeshingParameters())).has_value());
+    EXPECT_FALSE(cache.load(MeshCache::computeKey(jobs[1], root, MeshingParameters())).has_value());
+    EXPECT_TRUE(cache.load(MeshCache::computeKey(jobs[2], root, MeshingParameters())).has_value());
+
+    MeshCache tiny(directory_ + "_tiny", 16);
+    CachedMesh result = tiny.getOrCompute(jobs[0], root, MeshingParameters(), 1);
+    EXPECT_GT(result.mesh.getHexCount(), 0u);
+    EXPECT_EQ(tiny.getEntryCount(), 0u);
+    fs::remove_all(directory_ + "_tiny");
+}
+
+TEST_F(MeshCacheTest, CorruptEntriesAreMisses) {
+    const auto atoms = makeAtoms(800, 4);
+    const BoundingBox root = extentOf(800, 4);
+    MeshCache cache(directory_, 64 << 20);
+    cache.getOrCompute(atoms, root, MeshingParameters(), 1);
+    const Hash128 key = MeshCache::computeKey(atoms, root, MeshingParameters());
+
+    const std::string path = directory_ + "/" + key.toHex() + ".bmc";
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(200);
+        file.put('\x7f');
+    }
+    EXPECT_FALSE(cache.load(key).has_value());
+    EXPECT_FALSE(fs::exists(path));
+    EXPECT_EQ(cache.getEntryCount(), 0u);
+    EXPECT_EQ(cache.getSizeBytes(), 0u);
+}
+
+TEST_F(MeshCacheTest, ConcurrentMissesOnOneKeyAllSucceed) {
+    const auto atoms = makeAtoms(1500, 5);
+    const BoundingBox root = extentOf(1500, 5);
+    const MeshingParameters parameters;
+    MeshCache cache(directory_, 64 << 20);
+
+    // Like identical requests in one server batch: every thread misses, computes and stores
+    std::vector<CachedMesh> results(8, CachedMesh{LinearOctree(root, 1), HexMesh()});
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < results.size(); ++t) {
+        threads.emplace_back([&, t]() { results[t] = cache.getOrCompute(atoms, root, parameters, 1); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& result : results) {
+        EXPECT_EQ(result.mesh.hexahedra, results.front().mesh.hexahedra);
+    }
+    EXPECT_EQ(cache.getStoreFailureCount(), 0u);
+    EXPECT_EQ(cache.getEntryCount(), 1u);
+    EXPECT_EQ(countEntryFiles(directory_), 1u);
+
+    // The stored entry is whole, and no temporaries are left behind
+    const auto loaded = cache.load(MeshCache::computeKey(atoms, root, parameters));
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->mesh.hexahedra, results.front().mesh.hexahedra);
+    EXPECT_EQ(std::distance(fs::directory_iterator(directory_), fs::directory_iterator()), 1);
+}
+
+TEST_F(MeshCacheTest, LookupsRaceStoresAndEvictions) {
+    const BoundingBox root = extentOf(1000, 20);
+    const MeshingParameters parameters;
+    std::vector<std::vector<Atom>> jobs;
+    std::vector<CachedMesh> expected;
+    std::size_t entryBytes = 0;
+    for (std::uint64_t seed = 20; seed < 23; ++seed) {
+        auto atoms = makeAtoms(1000, seed);
+        for (auto& atom : atoms) {
+            atom.setCoordinates(atom.getX() * 0.9, atom.getY() * 0.9, atom.getZ() * 0.9);
+        }
+        MeshCache probe(directory_ + "_probe", 1 << 30);
+        expected.push_back(probe.getOrCompute(atoms, root, parameters, 1));
+        entryBytes = std::max(entryBytes, probe.getSizeBytes());
+        probe.clear();
+        jobs.push_back(std::move(atoms));
+    }
+    fs::remove_all(directory_ + "_probe");
+
+    // Room for one entry: every store evicts, while readers decode outside the index lock
+    MeshCache small(directory_ + "_small", entryBytes * 3 / 2);
+    std::atomic<bool> done{false};
+    std::atomic<int> wrong{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            for (std::size_t i = 0; !done.load(); ++i) {
+                const std::size_t job = i % jobs.size();
+                const auto loaded = small.load(MeshCache::computeKey(jobs[job], root, parameters));
+                if (loaded && loaded->mesh.hexahedra != expected[job].mesh.hexahedra) {
+                    ++wrong;
+                }
+            }
+        });
+    }
+    for (int round = 0; round < 30; ++round) {
+        const std::size_t job = static_cast<std::size_t>(round) % jobs.size();
+        small.store(MeshCache::computeKey(jobs[job], root, parameters), expected[job].tree, expected[job].mesh);
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(wrong.load(), 0);
+    EXPECT_EQ(small.getEntryCount(), 1u);
+    EXPECT_LE(small.getSizeBytes(), small.getCapacityBytes());
+    EXPECT_EQ(countEntryFiles(directory_ + "_small"), 1u);
+    fs::remove_all(directory_ + "_small");
+}
+
+TEST_F(MeshCacheTest, StoreFailuresStillReturnResult) {
+    const auto atoms = makeAtoms(500, 6);
+    const BoundingBox root = extentOf(500, 6);
+    MeshCache cache(directory_, 64 << 20);
+    fs::remove_all(directory_);
+
+    const CachedMesh result = cache.getOrCompute(atoms, root, MeshingParameters(), 1);
+    EXPECT_GT(result.mesh.getHexCount(), 0u);
+    EXPECT_EQ(cache.getStoreFailureCount(), 1u);
+    EXPECT_EQ(cache.getEntryCount(), 0u);
+}
+
+TEST_F(MeshCacheTest, RejectsZeroCapacity) {
+    EXPECT_THROW(MeshCache(directory_, 0), std::invalid_argument);
+}
@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+#include "biomesh/biomesh.h"
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace BioMesh;
+namespace fs = std::filesystem;
+
+namespace {
+
+class MeshServerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        socketPath_ = ::testing::TempDir() + "biomesh_server_" +
+                      ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".sock";
+        fs::remove(socketPath_);
+    }
+
+    void TearDown() override { fs::remove(socketPath_); }
+
+    static std::vector<Atom> makeAtoms(std::size_t count, std::uint64_t seed) {
+        return SyntheticMoleculeGenerator(SyntheticShape::Globular, count, seed).generate();
+    }
+
+    // Mesh in-process the way the server does when no root is supplied
+    static HexMesh meshDirectly(const std::vector<Atom>& parsed, const MeshingParameters& parameters) {
+        const std::vector<Atom> atoms = AtomBuilder().buildAtoms(parsed);
+        BoundingBox root;
+        root.calculateFromAtoms(atoms);
+        root.expand(1.0);
+        LinearOctree tree(root, parameters.maxLevel, parameters.maxAtomsPerLeaf);
+        tree.build(atoms);
+        if (parameters.balance) {
+            tree.balance();
+        }
+        return HexMeshExtractor(1).extract(tree, parameters.occupiedLeavesOnly);
+    }
+
+    static void expectSameMesh(const HexMesh& actual, const HexMesh& expected) {
+        EXPECT_EQ(actual.vertices, expected.vertices);
+        EXPECT_EQ(actual.hexahedra, expected.hexahedra);
+        EXPECT_EQ(actual.levels, expected.levels);
+    }
+
+    // Send a frame header announcing size bytes and no payload; returns the size of the
+    // server's reply frame, or 0 without waiting for one
+    std::uint64_t sendBareHeader(std::uint64_t size, bool awaitReply) const {
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, socketPath_.c_str(), sizeof(address.sun_path) - 1);
+        EXPECT_EQ(::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+        EXPECT_EQ(::send(fd, &size, sizeof(size), 0), static_cast<ssize_t>(sizeof(size)));
+        std::uint64_t reply = 0;
+        if (awaitReply && ::recv(fd, &reply, sizeof(reply), MSG_WAITALL) != static_cast<ssize_t>(sizeof(reply))) {
+            reply = 0;
+        }
+        ::close(fd);
+        return reply;
+    }
+
+    std::string socketPath_;
+};
+
+} // namespace
+
+TEST_F(MeshServerTest, ServesMeshMatchingDirectExtraction) {
+    MeshServer server(socketPath_);
+    server.start();
+    EXPECT_TRUE(server.isRunning());
+    EXPECT_TRUE(fs::exists(socketPath_));
+
+    const auto atoms = makeAtoms(2000, 1);
+    MeshingParameters parameters;
+    parameters.maxLevel = 6;
+    MeshClient client(socketPath_);
+    const HexMesh mesh = client.mesh(atoms, parameters);
+    EXPECT_GT(mesh.getHexCount(), 0u);
+    expectSameMesh(mesh, meshDirectly(atoms, parameters));
+
+    // The connection stays open for further requests
+    parameters.balance = false;
+    parameters.occupiedLeavesOnly = true;
+    expectSameMesh(client.mesh(atoms, parameters), meshDirectly(atoms, parameters));
+
+    server.stop();
+    EXPECT_FALSE(server.isRunning());
+    EXPECT_FALSE(fs::exists(socketPath_));
+}
+
+TEST_F(MeshServerTest, HonoursExplicitRoot) {
+    MeshServer server(socketPath_);
+    server.start();
+
+    const auto atoms = makeAtoms(500, 2);
+    const BoundingBox root(-100, -100, -100, 100, 100, 100);
+    MeshingParameters parameters;
+    parameters.maxLevel = 5;
+    const HexMesh mesh = MeshClient(socketPath_).mesh(atoms, parameters, &root);
+
+    LinearOctree tree(root, parameters.maxLevel, parameters.maxAtomsPerLeaf);
+    tree.build(AtomBuilder().buildAtoms(atoms));
+    tree.balance();
+    expectSameMesh(mesh, HexMeshExtractor(1).extract(tree));
+}
+
+TEST_F(MeshServerTest, BatchesConcurrentClients) {
+    MeshServerOptions options;
+    options.workerSlots = 4;
+    options.largeJobAtoms = 3000;
+    options.batchWindow = std::chrono::milliseconds(50);
+    MeshServer server(socketPath_, options);
+    server.start();
+
+    constexpr int kClients = 6;
+    MeshingParameters parameters;
+    parameters.maxLevel = 6;
+    std::vector<std::vector<Atom>> inputs;
+    for (int i = 0; i < kClients; ++i) {
+        inputs.push_back(makeAtoms(i == 0 ? 4000 : 300 + 100 * i, 10 + i));
+    }
+
+    std::vector<HexMesh> results(kClients);
+    std::vector<std::thread> clients;
+    for (int i = 0; i < kClients; ++i) {
+        clients.emplace_back([&, i]() { results[i] = MeshClient(socketPath_).mesh(inputs[i], parameters); });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    for (int i = 0; i < kClients; ++i) {
+        expectSameMesh(results[i], meshDirectly(inputs[i], parameters));
+    }
+
+    const MeshServerStats stats = MeshClient(socketPath_).getStats();
+    EXPECT_EQ(stats.requests, static_cast<std::uint64_t>(kClients));
+    EXPECT_EQ(stats.errors, 0u);
+    EXPECT_GE(stats.batches, 1u);
+    EXPECT_LE(stats.batches, static_cast<std::uint64_t>(kClients));
+    EXPECT_EQ(stats.largeJobs, 1u);
+    std::uint64_t atoms = 0;
+    for (const auto& input : inputs) {
+        atoms += input.size();
+    }
+    EXPECT_EQ(stats.atoms, atoms);
+}
+
+TEST_F(MeshServerTest, ReportsErrorsAndKeepsServing) {
+    MeshServer server(socketPath_);
+    server.start();
+    MeshClient client(socketPath_);
+
+    std::vector<Atom> atoms = makeAtoms(100, 3);
+    atoms[7] = Atom(atoms[7].getX(), atoms[7].getY(), atoms[7].getZ(), "Xx");
+    EXPECT_THROW(client.mesh(atoms), std::runtime_error);
+
+    const BoundingBox tooSmall(0, 0, 0, 1, 1, 1);
+    EXPECT_THROW(client.mesh(makeAtoms(100, 3), MeshingParameters(), &tooSmall), std::runtime_error);
+
+    EXPECT_NO_THROW(client.mesh(makeAtoms(100, 3)));
+    const MeshServerStats stats = client.getStats();
+    EXPECT_EQ(stats.requests, 3u);
+    EXPECT_EQ(stats.errors, 2u);
+}
+
+TEST_F(MeshServerTest, RejectsOversizedRequests) {
+    MeshServerOptions options;
+    options.maxRequestBytes = 1024;
+    MeshServer server(socketPath_, options);
+    server.start();
+
+    EXPECT_THROW(MeshClient(socketPath_).mesh(makeAtoms(1000, 4)), std::runtime_error);
+    EXPECT_NO_THROW(MeshClient(socketPath_).mesh(makeAtoms(10, 4)));
+}
+
+TEST_F(MeshServerTest, SurvivesHugeLengthHeaders) {
+    // Over the default limit: rejected with an error frame before any buffering
+    {
+        MeshServer server(socketPath_);
+        server.start();
+        EXPECT_GT(sendBareHeader(std::uint64_t{1} << 40, true), 0u);
+        EXPECT_NO_THROW(MeshClient(socketPath_).getStats());
+    }
+
+    // Under an unlimited limit the buffer grows only with received bytes, so a bare
+    // header for a terabyte frame neither commits the memory nor takes the daemon down
+    MeshServerOptions options;
+    options.maxRequestBytes = std::numeric_limits<std::size_t>::max();
+    MeshServer server(socketPath_, options);
+    server.start();
+    sendBareHeader(std::uint64_t{1} << 40, false);
+    EXPECT_NO_THROW(MeshClient(socketPath_).mesh(makeAtoms(10, 4)));
+}
+
+TEST_F(MeshServerTest, AnswersFromCache) {
+    MeshServerOptions options;
+    options.cacheDirectory = ::testing::TempDir() + "biomesh_server_cache";
+    fs::remove_all(options.cacheDirectory);
+    {
+        MeshServer server(socketPath_, options);
+        server.start();
+        MeshClient client(socketPath_);
+        const auto atoms = makeAtoms(1000, 5);
+        const HexMesh first = client.mesh(atoms);
+        const HexMesh second = client.mesh(atoms);
+        expectSameMesh(second, first);
+        expectSameMesh(first, meshDirectly(atoms, MeshingParameters()));
+        EXPECT_EQ(client.getStats().cacheHits, 1u);
+    }
+    fs::remove_all(options.cacheDirectory);
+}
+
+TEST_F(MeshServerTest, ShutdownRequestStopsServer) {
+    MeshServer server(socketPath_);
+    server.start();
+    std::thread waiter([&]() { server.wait(); });
+
+    MeshClient(socketPath_).requestShutdown();
+    waiter.join();
+    EXPECT_FALSE(server.isRunning());
+    EXPECT_FALSE(fs::exists(socketPath_));
+    EXPECT_THROW(MeshClient client(socketPath_), std::runtime_error);
+
+    // A stopped server can be started again
+    server.start();
+    EXPECT_NO_THROW(MeshClient(socketPath_).getStats());
+}
+
+TEST_F(MeshServerTest, ValidatesSocketPath) {
+    EXPECT_THROW(MeshServer(std::string(200, 'x')), std::invalid_argument);
+    EXPECT_THROW(MeshServer(""), std::invalid_argument);
+    EXPECT_THROW(MeshClient(std::string(200, 'x')), std::invalid_argument);
+}
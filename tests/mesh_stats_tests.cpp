@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include "biomesh/biomesh.h"
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+std::vector<Atom> makeAtoms(const SyntheticMoleculeGenerator& generator) {
+    return AtomBuilder().buildAtoms(generator.generate());
+}
+
+} // namespace
+
+TEST(MeshStatisticsTest, CountsMatchTreeAndMesh) {
+    SyntheticMoleculeGenerator generator(SyntheticShape::Capsid, 8000, 3);
+    auto atoms = makeAtoms(generator);
+
+    MeshStatistics stats;
+    LinearOctree tree(generator.getExtent(), 8, 6);
+    tree.setStatistics(&stats);
+    tree.build(atoms);
+    const std::size_t splits = tree.balance();
+
+    HexMeshExtractor extractor(2);
+    extractor.setStatistics(&stats);
+    HexMesh mesh = extractor.extract(tree);
+
+    EXPECT_EQ(stats.atoms, atoms.size());
+    EXPECT_EQ(stats.maxLevel, 8u);
+    EXPECT_EQ(stats.maxAtomsPerLeaf, 6u);
+    EXPECT_EQ(stats.vertices, mesh.getVertexCount());
+
+    std::size_t leaves = 0, occupied = 0, hexahedra = 0, balanceSplits = 0;
+    for (std::size_t level = 0; level < stats.levels.size(); ++level) {
+        const auto& counters = stats.levels[level];
+        leaves += counters.leaves;
+        occupied += counters.occupiedLeaves;
+        hexahedra += counters.hexahedra;
+        balanceSplits += counters.balanceSplits;
+        EXPECT_LE(counters.occupiedLeaves, counters.leaves);
+        EXPECT_GE(counters.buildSeconds, 0.0);
+        std::size_t leavesAtLevel = 0;
+        for (const auto& leaf : tree.getLeaves()) {
+            leavesAtLevel += leaf.level == level ? 1 : 0;
+        }
+        EXPECT_EQ(counters.leaves, leavesAtLevel) << "level " << level;
+        EXPECT_EQ(counters.hexahedra, leavesAtLevel) << "level " << level;
+    }
+    EXPECT_EQ(leaves, tree.getLeaves().size());
+    EXPECT_EQ(hexahedra, mesh.getHexCount());
+    EXPECT_EQ(balanceSplits, splits);
+    EXPECT_GT(splits, 0u);
+    EXPECT_GT(stats.balancePasses, 0u);
+
+    ASSERT_EQ(stats.leafOccupancy.size(), 8u);
+    EXPECT_EQ(std::accumulate(stats.leafOccupancy.begin(), stats.leafOccupancy.end(), std::size_t{0}), leaves);
+    EXPECT_EQ(leaves - stats.leafOccupancy[0], occupied);
+    EXPECT_GT(stats.buildSeconds, 0.0);
+    EXPECT_GT(stats.meshInsertSeconds, 0.0);
+}
+
+TEST(MeshStatisticsTest, BuildNodeCountsFollowRefinement) {
+    SyntheticMoleculeGenerator generator(SyntheticShape::Globular, 3000, 9);
+    auto atoms = makeAtoms(generator);
+
+    MeshStatistics stats;
+    LinearOctree tree(generator.getExtent());
+    tree.setStatistics(&stats);
+    tree.build(atoms);
+
+    // Before balancing every leaf comes from build(): each non-leaf node has eight children
+    ASSERT_GE(stats.levels.size(), 2u);
+    EXPECT_EQ(stats.levels[0].nodes, 1u);
+    for (std::size_t level = 0; level + 1 < stats.levels.size(); ++level) {
+        const std::size_t internal = stats.levels[level].nodes - stats.levels[level].leaves;
+        EXPECT_EQ(stats.levels[level + 1].nodes, 8 * internal) << "level " << level;
+    }
+}
+
+TEST(MeshStatisticsTest, DetachedTreeRecordsNothing) {
+    SyntheticMoleculeGenerator generator(SyntheticShape::Fibre, 2000, 1);
+    auto atoms = makeAtoms(generator);
+
+    MeshStatistics stats;
+    LinearOctree tree(generator.getExtent());
+    tree.setStatistics(&stats);
+    tree.setStatistics(nullptr);
+    tree.build(atoms);
+    tree.balance();
+    EXPECT_TRUE(stats.levels.empty());
+    EXPECT_EQ(stats.buildSeconds, 0.0);
+}
+
+TEST(MeshStatisticsTest, OverfullLeavesGoToOverflowBucket) {
+    // Identical positions cannot be separated, so the leaf at maxLevel keeps all of them
+    std::vector<Atom> atoms(20, Atom(1.0, 1.0, 1.0, "C"));
+    MeshStatistics stats;
+    LinearOctree tree(BoundingBox(0, 0, 0, 4, 4, 4), 3, 4);
+    tree.setStatistics(&stats);
+    tree.build(atoms);
+    ASSERT_EQ(stats.leafOccupancy.size(), 6u);
+    EXPECT_EQ(stats.leafOccupancy.back(), 1u);
+    EXPECT_EQ(stats.levels[3].occupiedLeaves, 1u);
+}
+
+TEST(MeshStatisticsTest, WritesJson) {
+    SyntheticMoleculeGenerator generator(SyntheticShape::WaterBox, 1500, 2);
+    auto atoms = makeAtoms(generator);
+    MeshStatistics stats;
+    LinearOctree tree(generator.getExtent());
+    tree.setStatistics(&stats);
+    tree.build(atoms);
+    tree.balance();
+
+    std::ostringstream out;
+    stats.writeJson(out);
+    const std::string json = out.str();
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_NE(json.find("\"atoms\": 1500"), std::string::npos);
+    EXPECT_NE(json.find("\"levels\": ["), std::string::npos);
+    EXPECT_NE(json.find("{\"level\": 0, \"nodes\": 1,"), std::string::npos);
+    EXPECT_NE(json.find("\"leafOccupancy\": ["), std::string::npos);
+    EXPECT_NE(json.find("\"seconds\": {\"build\": "), std::string::npos);
+
+    const std::string path = ::testing::TempDir() + "biomesh_mesh_stats.json";
+    stats.writeJson(path);
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    EXPECT_EQ(contents.str(), json);
+    std::remove(path.c_str());
+
+    EXPECT_THROW(stats.writeJson(std::string("/nonexistent/dir/stats.json")), std::runtime_error);
+
+    stats.reset();
+    EXPECT_TRUE(stats.levels.empty());
+    EXPECT_EQ(stats.atoms, 0u);
+}
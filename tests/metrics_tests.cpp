@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+#include "biomesh/biomesh.h"
+#include <arpa/inet.h>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+std::string readAll(int fd, const std::string& request) {
+    ::send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+    std::string response;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<std::size_t>(received));
+    }
+    ::close(fd);
+    return response;
+}
+
+std::string httpGetTcp(std::uint16_t port, const std::string& path) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return "";
+    }
+    return readAll(fd, "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n");
+}
+
+std::string httpGetUnix(const std::string& socketPath) {
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return "";
+    }
+    return readAll(fd, "GET /metrics HTTP/1.1\r\n\r\n");
+}
+
+bool contains(const std::string& text, const std::string& needle) {
+    return text.find(needle) != std::string::npos;
+}
+
+} // namespace
+
+TEST(MetricsTest, CountersSumAcrossThreads) {
+    MetricsRegistry registry;
+    Counter& counter = registry.counter("test_events_total", "Events");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&counter]() {
+            for (int i = 0; i < 10000; ++i) {
+                counter.add();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counter.getValue(), 80000u);
+    EXPECT_EQ(&registry.counter("test_events_total", "Events"), &counter);
+}
+
+TEST(MetricsTest, GaugesTrackValueAndHighWater) {
+    MetricsRegistry registry;
+    Gauge& depth = registry.gauge("test_depth", "Depth");
+    depth.add(5);
+    depth.add(-2);
+    EXPECT_EQ(depth.getValue(), 3);
+    depth.set(10);
+    EXPECT_EQ(depth.getValue(), 10);
+
+    Gauge& peak = registry.gauge("test_peak_bytes", "Peak");
+    peak.updateMax(100);
+    peak.updateMax(40);
+    EXPECT_EQ(peak.getValue(), 100);
+}
+
+TEST(MetricsTest, HistogramsBucketObservations) {
+    Histogram histogram({1.0, 2.0, 4.0});
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&histogram]() {
+            for (double value : {0.5, 1.0, 1.5, 3.0, 10.0}) {
+                histogram.observe(value);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const Histogram::Snapshot snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.bucketCounts, (std::vector<std::uint64_t>{8, 4, 4, 4}));
+    EXPECT_EQ(snapshot.count, 20u);
+    EXPECT_DOUBLE_EQ(snapshot.sum, 64.0);
+
+    EXPECT_THROW(Histogram({2.0, 1.0}), std::invalid_argument);
+    EXPECT_EQ(Histogram::exponentialBounds(1.0, 2.0, 4), (std::vector<double>{1.0, 2.0, 4.0, 8.0}));
+}
+
+TEST(MetricsTest, WritesPrometheusText) {
+    MetricsRegistry registry;
+    registry.counter("test_atoms_total", "Atoms processed", {{"stage", "build"}}).add(42);
+    registry.counter("test_atoms_total", "Atoms processed", {{"stage", "say \"hi\""}}).add(1);
+    registry.gauge("test_queue_depth", "Queued jobs").set(-3);
+    Histogram& latency = registry.histogram("test_seconds", "Latency", {{"stage", "extract"}}, {0.1, 1.0});
+    latency.observe(0.05);
+    latency.observe(0.5);
+    latency.observe(5.0);
+
+    const std::string text = registry.scrape();
+    EXPECT_TRUE(contains(text, "# HELP test_atoms_total Atoms processed\n# TYPE test_atoms_total counter\n"));
+    EXPECT_TRUE(contains(text, "test_atoms_total{stage=\"build\"} 42\n"));
+    EXPECT_TRUE(contains(text, "test_atoms_total{stage=\"say \\\"hi\\\"\"} 1\n"));
+    EXPECT_TRUE(contains(text, "# TYPE test_queue_depth gauge\ntest_queue_depth -3\n"));
+    EXPECT_TRUE(contains(text, "# TYPE test_seconds histogram\n"));
+    EXPECT_TRUE(contains(text, "test_seconds_bucket{stage=\"extract\",le=\"0.10000000000000001\"} 1\n"));
+    EXPECT_TRUE(contains(text, "test_seconds_bucket{stage=\"extract\",le=\"1\"} 2\n"));
+    EXPECT_TRUE(contains(text, "test_seconds_bucket{stage=\"extract\",le=\"+Inf\"} 3\n"));
+    EXPECT_TRUE(contains(text, "test_seconds_sum{stage=\"extract\"} 5.5499999999999998\n"));
+    EXPECT_TRUE(contains(text, "test_seconds_count{stage=\"extract\"} 3\n"));
+}
+
+TEST(MetricsTest, RejectsInvalidRegistrations) {
+    MetricsRegistry registry;
+    EXPECT_THROW(registry.counter("9lives", "Bad"), std::invalid_argument);
+    EXPECT_THROW(registry.counter("bad-name", "Bad"), std::invalid_argument);
+    EXPECT_THROW(registry.counter("ok_total", "Ok", {{"bad label", "x"}}), std::invalid_argument);
+    registry.counter("shared_name", "Counter");
+    EXPECT_THROW(registry.gauge("shared_name", "Gauge"), std::invalid_argument);
+}
+
+TEST(MetricsTest, LibraryStagesAreInstrumented) {
+    const std::uint64_t atomsBefore = stageAtoms("octree_build").getValue();
+    const std::uint64_t extractsBefore = stageSeconds("extract").snapshot().count;
+
+    SyntheticMoleculeGenerator generator(SyntheticShape::Globular, 500, 1);
+    const auto atoms = AtomBuilder().buildAtoms(generator.generate());
+    LinearOctree tree(generator.getExtent(), 6);
+    tree.build(atoms);
+    tree.balance();
+    HexMeshExtractor(1).extract(tree);
+
+    EXPECT_EQ(stageAtoms("octree_build").getValue(), atomsBefore + 500);
+    EXPECT_EQ(stageSeconds("extract").snapshot().count, extractsBefore + 1);
+    const std::string text = MetricsRegistry::global().scrape();
+    EXPECT_TRUE(contains(text, "biomesh_stage_seconds_count{stage=\"octree_balance\"}"));
+}
+
+TEST(MetricsTest, EndpointServesTcpScrapes) {
+    MetricsRegistry registry;
+    registry.counter("test_scrapes_total", "Scrapes").add(7);
+    MetricsEndpoint endpoint("0", registry);
+    endpoint.start();
+    ASSERT_NE(endpoint.getPort(), 0);
+
+    const std::string response = httpGetTcp(endpoint.getPort(), "/metrics");
+    EXPECT_TRUE(contains(response, "HTTP/1.1 200 OK\r\n"));
+    EXPECT_TRUE(contains(response, "text/plain; version=0.0.4"));
+    EXPECT_TRUE(contains(response, "test_scrapes_total 7\n"));
+    EXPECT_TRUE(contains(httpGetTcp(endpoint.getPort(), "/other"), "HTTP/1.1 404"));
+
+    endpoint.stop();
+    EXPECT_EQ(httpGetTcp(endpoint.getPort(), "/metrics"), "");
+}
+
+TEST(MetricsTest, EndpointServesUnixSocketScrapes) {
+    const std::string path = ::testing::TempDir() + "biomesh_metrics_test.sock";
+    MetricsRegistry registry;
+    registry.gauge("test_up", "Up").set(1);
+    MetricsEndpoint endpoint("unix:" + path, registry);
+    endpoint.start();
+    EXPECT_EQ(endpoint.getPort(), 0);
+    EXPECT_TRUE(contains(httpGetUnix(path), "test_up 1\n"));
+    endpoint.stop();
+    EXPECT_NE(::access(path.c_str(), F_OK), 0);
+
+    // A regular file at the path is neither replaced nor removed
+    { std::ofstream(path) << "keep"; }
+    MetricsEndpoint blocked("unix:" + path, registry);
+    EXPECT_THROW(blocked.start(), std::runtime_error);
+    std::ifstream kept(path);
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(kept), {}), "keep");
+    ::unlink(path.c_str());
+
+    EXPECT_THROW(MetricsEndpoint("not-a-port"), std::invalid_argument);
+    EXPECT_THROW(MetricsEndpoint("70000"), std::invalid_argument);
+    EXPECT_THROW(MetricsEndpoint("unix:"), std::invalid_argument);
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "biomesh/pipeline.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace BioMesh;
+
+// Test fixture for AtomPipeline functionality
+class PipelineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const char* elements[] = {"C", "N", "O", "H", "S"};
+        for (int i = 0; i < 1000; ++i) {
+            atoms.emplace_back(i * 0.1, -i * 0.2, (i % 7) * 1.5, elements[i % 5]);
+        }
+    }
+
+    std::vector<Atom> atoms;
+    AtomBuilder builder;
+};
+
+TEST(BoundedChannelTest, ZeroCapacityThrows) {
+    EXPECT_THROW(BoundedChannel<int>(0), std::invalid_argument);
+}
+
+TEST(BoundedChannelTest, FifoOrderAndCloseDrains) {
+    BoundedChannel<int> channel(4);
+    EXPECT_TRUE(channel.push(1));
+    EXPECT_TRUE(channel.push(2));
+    channel.close();
+
+    // Pushing after close is rejected, queued items are still delivered
+    EXPECT_FALSE(channel.push(3));
+    EXPECT_EQ(channel.pop().value(), 1);
+    EXPECT_EQ(channel.pop().value(), 2);
+    EXPECT_FALSE(channel.pop().has_value());
+}
+
+TEST_F(PipelineTest, RequiresSource) {
+    AtomPipeline pipeline;
+    EXPECT_THROW(pipeline.run(), std::logic_error);
+    EXPECT_THROW(AtomPipeline(0), std::invalid_argument);
+}
+
+TEST_F(PipelineTest, BuildStageMatchesBatchBuild) {
+    std::vector<Atom> streamed;
+    std::vector<std::size_t> sequences;
+
+    AtomPipeline pipeline(2);
+    pipeline.setSource(AtomPipeline::makeChunkedSource(atoms, 64))
+            .addStage("build", AtomPipeline::makeBuildStage(builder))
+            .setSink([&](AtomChunk&& chunk) {
+                sequences.push_back(chunk.sequence);
+                streamed.insert(streamed.end(), chunk.atoms.begin(), chunk.atoms.end());
+            });
+    pipeline.run();
+
+    auto expected = builder.buildAtoms(atoms);
+    ASSERT_EQ(streamed.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(streamed[i].getX(), expected[i].getX());
+        EXPECT_EQ(streamed[i].getChemicalElement(), expected[i].getChemicalElement());
+        EXPECT_EQ(streamed[i].getAtomicRadius(), expected[i].getAtomicRadius());
+        EXPECT_EQ(streamed[i].getAtomicMass(), expected[i].getAtomicMass());
+    }
+
+    // Chunks arrive in input order
+    ASSERT_EQ(sequences.size(), 16u);
+    EXPECT_TRUE(std::is_sorted(sequences.begin(), sequences.end()));
+}
+
+TEST_F(PipelineTest, BoundsStageMatchesCalculateFromAtoms) {
+    BoundingBox streamedBounds;
+    AtomPipeline pipeline;
+    pipeline.setSource(AtomPipeline::makeChunkedSource(atoms, 100))
+            .addStage("build", AtomPipeline::makeBuildStage(builder))
+            .addStage("bounds", AtomPipeline::makeBoundsStage(streamedBounds));
+    EXPECT_EQ(pipeline.getStageCount(), 2u);
+    pipeline.run();
+
+    BoundingBox expected;
+    expected.calculateFromAtoms(atoms);
+    EXPECT_EQ(streamedBounds.getMinX(), expected.getMinX());
+    EXPECT_EQ(streamedBounds.getMinY(), expected.getMinY());
+    EXPECT_EQ(streamedBounds.getMaxZ(), expected.getMaxZ());
+}
+
+TEST_F(PipelineTest, BackpressureBoundsInFlightChunks) {
+    const std::size_t capacity = 1;
+    const std::size_t stageCount = 2;
+    std::atomic<std::size_t> produced{0};
+    std::atomic<std::size_t> consumed{0};
+    std::size_t maxInFlight = 0;
+
+    auto source = AtomPipeline::makeChunkedSource(atoms, 10);
+    AtomPipeline pipeline(capacity);
+    pipeline.setSource([&](AtomChunk& chunk) {
+                bool more = source(chunk);
+                if (more) {
+                    ++produced;
+                }
+                return more;
+            })
+            .addStage("first", [](AtomChunk&) {})
+            .addStage("second", [](AtomChunk&) {})
+            .setSink([&](AtomChunk&&) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                maxInFlight = std::max(maxInFlight, produced.load() - consumed.load());
+                ++consumed;
+            });
+    pipeline.run();
+
+    EXPECT_EQ(consumed.load(), 100u);
+    // Each channel holds `capacity` chunks and each thread holds at most one more
+    EXPECT_LE(maxInFlight, (stageCount + 1) * capacity + stageCount + 2);
+}
+
+TEST_F(PipelineTest, StageExceptionIsRethrown) {
+    atoms.emplace_back(0.0, 0.0, 0.0, "Xx");
+
+    AtomPipeline pipeline(1);
+    pipeline.setSource(AtomPipeline::makeChunkedSource(atoms, 16))
+            .addStage("build", AtomPipeline::makeBuildStage(builder))
+            .setSink([](AtomChunk&&) {});
+    EXPECT_THROW(pipeline.run(), std::runtime_error);
+}
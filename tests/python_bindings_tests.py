@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""Tests of the biomesh Python module; exits with 77 (skipped) when NumPy is unavailable.
+
+Set BIOMESH_REQUIRE_NUMPY=1 to fail instead of skipping, e.g. in CI.
+"""
+
+import os
+import sys
+import unittest
+
+try:
+    import numpy as np
+except ImportError:
+    if os.environ.get("BIOMESH_REQUIRE_NUMPY"):
+        raise
+    print("NumPy not available; skipping Python binding tests")
+    sys.exit(77)
+
+import biomesh
+
+SYMBOLS = ["C", "N", "O", "H", "S"]
+
+
+def make_arrays(count, seed=1):
+    rng = np.random.default_rng(seed)
+    coordinates = rng.uniform(-20.0, 20.0, size=(count, 3))
+    element_ids = rng.integers(0, len(SYMBOLS), size=count, dtype=np.int32)
+    return coordinates, element_ids
+
+
+class AtomArrayTest(unittest.TestCase):
+    def test_from_arrays_reads_strided_input(self):
+        coordinates, element_ids = make_arrays(1000)
+        # A Fortran-ordered copy has non-contiguous rows; it must be read in place correctly
+        strided = np.asfortranarray(coordinates)
+        atoms = biomesh.AtomArray.from_arrays(strided, element_ids, SYMBOLS)
+        self.assertEqual(len(atoms), 1000)
+        np.testing.assert_array_equal(atoms.coordinates, coordinates)
+        expected_radii = np.array([{"C": 1.70, "N": 1.55, "O": 1.52, "H": 1.20, "S": 1.80}[SYMBOLS[i]]
+                                   for i in element_ids])
+        np.testing.assert_array_equal(atoms.radii, expected_radii)
+
+    def test_coordinates_are_a_view(self):
+        coordinates, element_ids = make_arrays(10)
+        atoms = biomesh.AtomArray.from_arrays(coordinates, element_ids, SYMBOLS)
+        view = atoms.coordinates
+        self.assertFalse(view.flags["OWNDATA"])
+        self.assertGreater(view.strides[0], 3 * 8)
+        view[0, 0] = 123.0
+        self.assertEqual(atoms.coordinates[0, 0], 123.0)
+        # The view keeps the container alive
+        del atoms
+        self.assertEqual(view[0, 0], 123.0)
+
+    def test_rejects_bad_input(self):
+        coordinates, element_ids = make_arrays(10)
+        with self.assertRaises(ValueError):
+            biomesh.AtomArray.from_arrays(coordinates[:, :2], element_ids, SYMBOLS)
+        with self.assertRaises(ValueError):
+            biomesh.AtomArray.from_arrays(coordinates, element_ids[:5], SYMBOLS)
+        with self.assertRaises(IndexError):
+            biomesh.AtomArray.from_arrays(coordinates, element_ids + 10, SYMBOLS)
+        with self.assertRaises(RuntimeError):
+            biomesh.AtomArray.from_arrays(coordinates, element_ids, ["Xx"] * len(SYMBOLS))
+
+
+class MeshingTest(unittest.TestCase):
+    def test_bounds_from_coordinates(self):
+        coordinates, _ = make_arrays(500)
+        bounds = biomesh.BoundingBox.from_coordinates(coordinates)
+        self.assertEqual(bounds.min, tuple(coordinates.min(axis=0)))
+        self.assertEqual(bounds.max, tuple(coordinates.max(axis=0)))
+
+    def test_octree_and_mesh_views(self):
+        coordinates, element_ids = make_arrays(2000)
+        atoms = biomesh.AtomArray.from_arrays(coordinates, element_ids, SYMBOLS)
+        root = atoms.bounds()
+        root.expand(1.0)
+        tree = biomesh.LinearOctree(root, max_level=6)
+        tree.build(atoms)
+        tree.balance()
+
+        counts = tree.leaf_atom_counts
+        self.assertEqual(len(counts), len(tree))
+        self.assertEqual(int(counts.sum()), 2000)
+        self.assertFalse(counts.flags["WRITEABLE"])
+        self.assertTrue(np.all(np.diff(tree.leaf_keys.astype(np.int64)) > 0))
+        self.assertEqual(sorted(tree.atom_order.tolist()), list(range(2000)))
+
+        mesh = biomesh.extract(tree, threads=1)
+        vertices = mesh.vertices
+        hexahedra = mesh.hexahedra
+        self.assertEqual(vertices.shape[1], 3)
+        self.assertEqual(hexahedra.shape, (len(tree), 8))
+        self.assertEqual(mesh.levels.shape, (len(tree),))
+        self.assertLess(int(hexahedra.max()), len(vertices))
+        self.assertFalse(vertices.flags["OWNDATA"])
+        self.assertTrue(np.all(vertices >= np.array(root.min)))
+
+    def test_live_views_block_rebuilding(self):
+        coordinates, element_ids = make_arrays(1000)
+        atoms = biomesh.AtomArray.from_arrays(coordinates, element_ids, SYMBOLS)
+        root = atoms.bounds()
+        root.expand(1.0)
+        tree = biomesh.LinearOctree(root, max_level=6)
+        tree.build(atoms)
+
+        counts = tree.leaf_atom_counts
+        window = tree.atom_order[10:20]
+        kept = tree.leaf_keys.copy()
+        with self.assertRaises(RuntimeError):
+            tree.balance()
+        with self.assertRaises(RuntimeError):
+            tree.build(atoms)
+        # Views derived from a view keep it alive
+        del counts
+        with self.assertRaises(RuntimeError):
+            tree.balance()
+        self.assertEqual(len(window), 10)
+
+        del window
+        tree.balance()
+        tree.build(atoms)
+        np.testing.assert_array_equal(tree.leaf_keys, kept)
+        # A finished extraction does not hold the tree
+        biomesh.extract(tree, threads=1)
+        tree.balance()
+
+
+if __name__ == "__main__":
+    unittest.main()
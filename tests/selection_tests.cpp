@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "biomesh/biomesh.h"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+std::vector<Atom> makeAtoms() {
+    SyntheticMoleculeGenerator generator(SyntheticShape::Globular, 3000, 11);
+    return AtomBuilder().buildAtoms(generator.generate());
+}
+
+AtomBitset bruteForce(const std::vector<Atom>& atoms, bool (*predicate)(const Atom&)) {
+    AtomBitset expected(atoms.size());
+    for (std::size_t i = 0; i < atoms.size(); ++i) {
+        expected.set(i, predicate(atoms[i]));
+    }
+    return expected;
+}
+
+} // namespace
+
+TEST(SelectionTest, BitsetOperations) {
+    AtomBitset a(130);
+    a.set(0);
+    a.set(64);
+    a.set(129);
+    EXPECT_EQ(a.count(), 3u);
+    EXPECT_TRUE(a.test(129));
+    EXPECT_EQ(a.toIndices(), (std::vector<std::uint32_t>{0, 64, 129}));
+
+    AtomBitset b(130, true);
+    EXPECT_EQ(b.count(), 130u);
+    b &= a;
+    EXPECT_EQ(b, a);
+    b.flip();
+    EXPECT_EQ(b.count(), 127u);
+    b |= a;
+    EXPECT_EQ(b, AtomBitset(130, true));
+    b.set(64, false);
+    EXPECT_FALSE(b.test(64));
+    EXPECT_THROW(b &= AtomBitset(10), std::invalid_argument);
+}
+
+TEST(SelectionTest, ColumnPredicatesMatchBruteForce) {
+    const auto atoms = makeAtoms();
+    const AtomColumns columns = AtomColumns::fromAtoms(atoms);
+    ASSERT_EQ(columns.size(), atoms.size());
+
+    EXPECT_EQ(SelectionQuery::compile("not hydrogen").evaluate(columns),
+              bruteForce(atoms, [](const Atom& a) { return a.getChemicalElement() != "H"; }));
+    EXPECT_EQ(SelectionQuery::compile("heavy").evaluate(columns),
+              SelectionQuery::compile("not element H").evaluate(columns));
+    EXPECT_EQ(SelectionQuery::compile("element C N and x > 0").evaluate(columns),
+              bruteForce(atoms, [](const Atom& a) {
+                  return (a.getChemicalElement() == "C" || a.getChemicalElement() == "N") && a.getX() > 0.0;
+              }));
+    EXPECT_EQ(SelectionQuery::compile("mass >= 14 or (z < -2.5 and radius <= 1.6)").evaluate(columns),
+              bruteForce(atoms, [](const Atom& a) {
+                  return a.getAtomicMass() >= 14.0 || (a.getZ() < -2.5 && a.getAtomicRadius() <= 1.6);
+              }));
+
+    const AtomBitset range = SelectionQuery::compile("index 10 to 19 or index 2999").evaluate(columns);
+    EXPECT_EQ(range.count(), 11u);
+    EXPECT_TRUE(range.test(10));
+    EXPECT_TRUE(range.test(19));
+    EXPECT_FALSE(range.test(20));
+    EXPECT_TRUE(range.test(2999));
+    EXPECT_EQ(SelectionQuery::compile("all").evaluate(columns).count(), atoms.size());
+    EXPECT_EQ(SelectionQuery::compile("none or element Xx").evaluate(columns).count(), 0u);
+}
+
+TEST(SelectionTest, WithinMatchesBruteForce) {
+    const auto atoms = makeAtoms();
+    const AtomColumns columns = AtomColumns::fromAtoms(atoms);
+    const AtomBitset ligand = SelectionQuery::compile("index 0 to 9").evaluate(columns);
+
+    const AtomBitset actual = SelectionQuery::compile("within 4.5 of ligand").evaluate(columns, {{"ligand", ligand}});
+    AtomBitset expected(atoms.size());
+    for (std::size_t i = 0; i < atoms.size(); ++i) {
+        for (std::uint32_t j : ligand.toIndices()) {
+            const double dx = atoms[i].getX() - atoms[j].getX();
+            const double dy = atoms[i].getY() - atoms[j].getY();
+            const double dz = atoms[i].getZ() - atoms[j].getZ();
+            if (dx * dx + dy * dy + dz * dz <= 4.5 * 4.5) {
+                expected.set(i);
+                break;
+            }
+        }
+    }
+    EXPECT_EQ(actual, expected);
+    EXPECT_GT(actual.count(), ligand.count());
+
+    const AtomBitset shell =
+        SelectionQuery::compile("heavy and within 4.5 of ligand and not ligand").evaluate(columns, {{"ligand", ligand}});
+    EXPECT_FALSE(shell.test(0));
+    EXPECT_EQ(SelectionQuery::compile("within 0 of index 5").evaluate(columns).count(), 1u);
+    EXPECT_EQ(SelectionQuery::compile("within 3 of none").evaluate(columns).count(), 0u);
+}
+
+TEST(SelectionTest, NeighborIndexQueries) {
+    AtomColumns columns;
+    columns.x = {0.0, 10.0, -3.0};
+    columns.y = {0.0, 0.0, 0.0};
+    columns.z = {0.0, 0.0, 0.0};
+    AtomBitset subset(3);
+    subset.set(0);
+    subset.set(1);
+    const NeighborIndex index(columns, subset, 2.0);
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_TRUE(index.anyWithin(1.5, 0.0, 0.0, 2.0));
+    EXPECT_TRUE(index.anyWithin(10.0, 0.0, 2.0, 2.0));
+    EXPECT_FALSE(index.anyWithin(-3.0, 0.0, 0.0, 2.0));
+    EXPECT_FALSE(index.anyWithin(5.0, 0.0, 0.0, 2.0));
+    EXPECT_FALSE(index.anyWithin(1e300, 0.0, 0.0, 2.0));
+    EXPECT_THROW(NeighborIndex(columns, subset, 0.0), std::invalid_argument);
+}
+
+TEST(SelectionTest, CompilesToPostfixPlan) {
+    const SelectionQuery query = SelectionQuery::compile("protein and not (hydrogen or mass < 2)");
+    EXPECT_EQ(query.describe(), "set protein\nelement H\ncompare mass < 2\nor\nnot\nand\n");
+    EXPECT_EQ(query.getPlan().size(), 6u);
+    EXPECT_EQ(query.getText(), "protein and not (hydrogen or mass < 2)");
+}
+
+TEST(SelectionTest, ReportsErrors) {
+    for (const char* text : {"", "and", "element", "x 3", "x < ", "(all", "all)", "within 3 all", "index 5 to 2",
+                             "mass = 3", "x < y", "element C #"}) {
+        EXPECT_THROW(SelectionQuery::compile(text), std::invalid_argument) << text;
+    }
+    try {
+        SelectionQuery::compile("all and or none");
+        FAIL();
+    } catch (const std::invalid_argument& error) {
+        EXPECT_NE(std::string(error.what()).find("position 8"), std::string::npos) << error.what();
+    }
+
+    const AtomColumns columns = AtomColumns::fromAtoms(makeAtoms());
+    const SelectionQuery query = SelectionQuery::compile("ligand");
+    EXPECT_THROW(query.evaluate(columns), std::invalid_argument);
+    EXPECT_THROW(query.evaluate(columns, {{"ligand", AtomBitset(5)}}), std::invalid_argument);
+}
+
+TEST(SelectionTest, SelectionsFeedBoundsAndOctree) {
+    const auto atoms = makeAtoms();
+    const AtomColumns columns = AtomColumns::fromAtoms(atoms);
+    const std::vector<std::uint32_t> selected = SelectionQuery::compile("heavy and x > 0").evaluate(columns).toIndices();
+    ASSERT_FALSE(selected.empty());
+
+    std::vector<Atom> subset;
+    for (std::uint32_t i : selected) {
+        subset.push_back(atoms[i]);
+    }
+    BoundingBox expected;
+    expected.calculateFromAtoms(subset);
+    BoundingBox bounds;
+    bounds.calculateFromAtoms(atoms, selected);
+    EXPECT_EQ(bounds.getMinX(), expected.getMinX());
+    EXPECT_EQ(bounds.getMaxZ(), expected.getMaxZ());
+    EXPECT_THROW(BoundingBox().calculateFromAtoms(atoms, {static_cast<std::uint32_t>(atoms.size())}),
+                 std::out_of_range);
+
+    bounds.expand(1.0);
+    LinearOctree copied(bounds, 6);
+    copied.build(subset);
+    LinearOctree inPlace(bounds, 6);
+    inPlace.build(atoms, selected);
+    ASSERT_EQ(inPlace.getLeaves().size(), copied.getLeaves().size());
+    for (std::size_t i = 0; i < copied.getAtomOrder().size(); ++i) {
+        EXPECT_EQ(inPlace.getAtomOrder()[i], selected[copied.getAtomOrder()[i]]);
+    }
+    const HexMesh mesh = HexMeshExtractor(1).extract(inPlace);
+    EXPECT_EQ(mesh.getHexCount(), inPlace.getLeaves().size());
+}
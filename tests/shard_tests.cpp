@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "biomesh/shard.h"
+#include "AtomBuilder.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace BioMesh;
+
+// Test fixture for sharded meshing support
+class ShardTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const char* elements[] = {"C", "N", "O", "S"};
+        std::vector<Atom> parsed;
+        for (int i = 0; i < 10; ++i) {
+            for (int j = 0; j < 10; ++j) {
+                for (int k = 0; k < 10; ++k) {
+                    parsed.emplace_back(i * 1.1, j * 0.9, k * 1.3, elements[(i + j + k) % 4]);
+                }
+            }
+        }
+        atoms = AtomBuilder().buildAtoms(parsed);
+    }
+
+    std::vector<Atom> atoms;
+};
+
+TEST_F(ShardTest, InvalidArgumentsThrow) {
+    EXPECT_THROW(ShardPlan(atoms, -1.0), std::invalid_argument);
+    EXPECT_THROW(ShardPlan(atoms, 1.4, 0), std::invalid_argument);
+    EXPECT_THROW(ShardedLauncher(0, 4), std::invalid_argument);
+}
+
+TEST_F(ShardTest, EveryAtomOwnedExactlyOnce) {
+    ShardPlan plan(atoms, 1.4, 2);
+    ASSERT_EQ(plan.getShards().size(), 64u);
+    EXPECT_DOUBLE_EQ(plan.getHaloWidth(), 1.80 + 1.4);
+
+    std::vector<int> ownerCount(atoms.size(), 0);
+    for (const auto& shard : plan.getShards()) {
+        for (std::size_t i = 0; i < shard.ownedCount; ++i) {
+            std::size_t atomIndex = shard.atomIndices[i];
+            ++ownerCount[atomIndex];
+            EXPECT_TRUE(shard.ownedRegion.contains(atoms[atomIndex]));
+            EXPECT_EQ(plan.getOwningShard(atoms[atomIndex].getX(), atoms[atomIndex].getY(),
+                                          atoms[atomIndex].getZ()), shard.index);
+        }
+    }
+    for (int count : ownerCount) {
+        EXPECT_EQ(count, 1);
+    }
+}
+
+TEST_F(ShardTest, HaloContainsAllNearbyAtoms) {
+    ShardPlan plan(atoms, 1.4);
+    for (const auto& shard : plan.getShards()) {
+        std::vector<std::size_t> visible(shard.atomIndices);
+        std::sort(visible.begin(), visible.end());
+        for (std::size_t i = 0; i < atoms.size(); ++i) {
+            bool inHalo = shard.haloRegion.contains(atoms[i]);
+            EXPECT_EQ(inHalo, std::binary_search(visible.begin(), visible.end(), i));
+        }
+    }
+    EXPECT_THROW(plan.getOwningShard(100.0, 0.0, 0.0), std::out_of_range);
+}
+
+TEST_F(ShardTest, WorkersStitchToGlobalResult) {
+    ShardPlan plan(atoms, 1.4);
+    ShardedLauncher launcher(3, 7);
+
+    // Each worker reports the radius-inflated bounds and count of its owned atoms
+    auto results = launcher.run(plan, atoms, [](const ShardView& shard, double* output, std::size_t) {
+        BoundingBox bounds;
+        for (std::size_t i = 0; i < shard.ownedCount; ++i) {
+            bounds.addPoint(shard.x[i] - shard.radius[i], shard.y[i] - shard.radius[i], shard.z[i] - shard.radius[i]);
+            bounds.addPoint(shard.x[i] + shard.radius[i], shard.y[i] + shard.radius[i], shard.z[i] + shard.radius[i]);
+        }
+        output[0] = bounds.getMinX();
+        output[1] = bounds.getMinY();
+        output[2] = bounds.getMinZ();
+        output[3] = bounds.getMaxX();
+        output[4] = bounds.getMaxY();
+        output[5] = bounds.getMaxZ();
+        output[6] = static_cast<double>(shard.ownedCount);
+        return std::size_t{7};
+    });
+
+    ASSERT_EQ(results.size(), 8u);
+    BoundingBox stitched;
+    double ownedTotal = 0.0;
+    for (const auto& result : results) {
+        ASSERT_EQ(result.size(), 7u);
+        stitched.addPoint(result[0], result[1], result[2]);
+        stitched.addPoint(result[3], result[4], result[5]);
+        ownedTotal += result[6];
+    }
+
+    BoundingBox expected;
+    for (const auto& atom : atoms) {
+        double r = atom.getAtomicRadius();
+        expected.addPoint(atom.getX() - r, atom.getY() - r, atom.getZ() - r);
+        expected.addPoint(atom.getX() + r, atom.getY() + r, atom.getZ() + r);
+    }
+    EXPECT_EQ(ownedTotal, static_cast<double>(atoms.size()));
+    EXPECT_DOUBLE_EQ(stitched.getMinX(), expected.getMinX());
+    EXPECT_DOUBLE_EQ(stitched.getMaxY(), expected.getMaxY());
+    EXPECT_DOUBLE_EQ(stitched.getMaxZ(), expected.getMaxZ());
+}
+
+TEST_F(ShardTest, WorkerFailureIsReported) {
+    ShardPlan plan(atoms, 1.4);
+    ShardedLauncher launcher(2, 1);
+
+    EXPECT_THROW(launcher.run(plan, atoms, [](const ShardView& shard, double*, std::size_t) -> std::size_t {
+        if (shard.spec->index == 5) {
+            throw std::runtime_error("worker failure");
+        }
+        return 0;
+    }), std::runtime_error);
+
+    // Writing past the result slot is rejected
+    EXPECT_THROW(launcher.run(plan, atoms, [](const ShardView&, double*, std::size_t capacity) {
+        return capacity + 1;
+    }), std::runtime_error);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "biomesh/biomesh.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+// Two models; model 1 has chains A (ALA 1, GLY 2, GLY 2A) and B (HOH 100, HOH 101); model 2 has chain A (ALA 1)
+StructureHierarchy makeHierarchy() {
+    StructureHierarchy hierarchy;
+    const std::vector<std::pair<AtomIdentity, int>> residues = {
+        {{1, "A", "ALA", 1, ' '}, 5}, {{1, "A", "GLY", 2, ' '}, 4}, {{1, "A", "GLY", 2, 'A'}, 4},
+        {{1, "B", "HOH", 100, ' '}, 3}, {{1, "B", "HOH", 101, ' '}, 3}, {{2, "A", "ALA", 1, ' '}, 5},
+    };
+    for (const auto& [identity, atoms] : residues) {
+        for (int i = 0; i < atoms; ++i) {
+            hierarchy.addAtom(identity);
+        }
+    }
+    return hierarchy;
+}
+
+} // namespace
+
+TEST(StructureTest, PacksNames) {
+    EXPECT_EQ(packName("A"), PackedName{'A'});
+    EXPECT_EQ(packName("ALA"), packName("ALA "));
+    EXPECT_NE(packName("ALA"), packName("AL"));
+    EXPECT_EQ(unpackName(packName("HOH")), "HOH");
+    EXPECT_EQ(unpackName(packName("ABCDEFGH")), "ABCDEFGH");
+    EXPECT_EQ(unpackName(packName("")), "");
+    EXPECT_THROW(packName("ABCDEFGHI"), std::invalid_argument);
+}
+
+TEST(StructureTest, BuildsOffsetArrays) {
+    const StructureHierarchy hierarchy = makeHierarchy();
+    EXPECT_EQ(hierarchy.getModelCount(), 2u);
+    EXPECT_EQ(hierarchy.getChainCount(), 3u);
+    EXPECT_EQ(hierarchy.getResidueCount(), 6u);
+    EXPECT_EQ(hierarchy.getAtomCount(), 24u);
+
+    EXPECT_EQ(hierarchy.getModelChainOffsets(), (std::vector<std::uint32_t>{0, 2, 3}));
+    EXPECT_EQ(hierarchy.getChainResidueOffsets(), (std::vector<std::uint32_t>{0, 3, 5, 6}));
+    EXPECT_EQ(hierarchy.getResidueAtomOffsets(), (std::vector<std::uint32_t>{0, 5, 9, 13, 16, 19, 24}));
+    EXPECT_EQ(hierarchy.getChainAtomOffsets(), (std::vector<std::uint32_t>{0, 13, 19, 24}));
+
+    EXPECT_EQ(hierarchy.getModelNumber(1), 2);
+    EXPECT_EQ(hierarchy.getChainId(1), "B");
+    EXPECT_EQ(hierarchy.getResidueName(2), "GLY");
+    EXPECT_EQ(hierarchy.getResidueNumber(2), 2);
+    EXPECT_EQ(hierarchy.getInsertionCode(2), 'A');
+
+    const IndexRange model0 = hierarchy.getModelAtoms(0);
+    EXPECT_EQ(model0.begin, 0u);
+    EXPECT_EQ(model0.end, 19u);
+    EXPECT_EQ(hierarchy.getChainAtoms(2).size(), 5u);
+    EXPECT_EQ(hierarchy.getResidueAtoms(3).begin, 13u);
+    EXPECT_EQ(hierarchy.getChainResidues(1).size(), 2u);
+    EXPECT_EQ(hierarchy.getModelChains(1).begin, 2u);
+    EXPECT_GT(hierarchy.memoryUsage().usedBytes, 0u);
+}
+
+TEST(StructureTest, FindsContainingGroups) {
+    const StructureHierarchy hierarchy = makeHierarchy();
+    EXPECT_EQ(hierarchy.findResidueOfAtom(0), 0u);
+    EXPECT_EQ(hierarchy.findResidueOfAtom(4), 0u);
+    EXPECT_EQ(hierarchy.findResidueOfAtom(5), 1u);
+    EXPECT_EQ(hierarchy.findResidueOfAtom(23), 5u);
+    EXPECT_EQ(hierarchy.findChainOfResidue(4), 1u);
+    EXPECT_EQ(hierarchy.findChainOfResidue(5), 2u);
+    EXPECT_THROW(hierarchy.findResidueOfAtom(24), std::out_of_range);
+    EXPECT_THROW(hierarchy.findChainOfResidue(6), std::out_of_range);
+}
+
+TEST(StructureTest, SelectionsFeedQueries) {
+    const StructureHierarchy hierarchy = makeHierarchy();
+    const AtomBitset chainA = hierarchy.selectChains({"A"});
+    EXPECT_EQ(chainA.count(), 18u);
+    EXPECT_FALSE(chainA.test(13));
+    EXPECT_TRUE(chainA.test(19));
+    const AtomBitset water = hierarchy.selectResidueNames({"HOH", "WAT"});
+    EXPECT_EQ(water.count(), 6u);
+
+    std::vector<Atom> atoms;
+    for (std::size_t i = 0; i < hierarchy.getAtomCount(); ++i) {
+        atoms.emplace_back(static_cast<double>(i), 0.0, 0.0, i % 2 ? "H" : "C");
+    }
+    const AtomBitset selected = SelectionQuery::compile("(chainA or water) and not hydrogen")
+                                    .evaluate(AtomColumns::fromAtoms(atoms), {{"chainA", chainA}, {"water", water}});
+    EXPECT_EQ(selected.count(), 12u);
+}
+
+TEST(StructureTest, PerChainBoundsAreContiguousLoops) {
+    const StructureHierarchy hierarchy = makeHierarchy();
+    std::vector<Atom> atoms;
+    for (std::size_t i = 0; i < hierarchy.getAtomCount(); ++i) {
+        atoms.emplace_back(static_cast<double>(i), -static_cast<double>(i), 1.0, "C");
+    }
+    for (std::size_t c = 0; c < hierarchy.getChainCount(); ++c) {
+        const IndexRange range = hierarchy.getChainAtoms(c);
+        BoundingBox box;
+        for (std::uint32_t a = range.begin; a < range.end; ++a) {
+            box.addPoint(atoms[a].getX(), atoms[a].getY(), atoms[a].getZ());
+        }
+        EXPECT_EQ(box.getMinX(), static_cast<double>(range.begin));
+        EXPECT_EQ(box.getMaxX(), static_cast<double>(range.end - 1));
+    }
+}
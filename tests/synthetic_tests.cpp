@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "biomesh/synthetic.h"
+#include "AtomBuilder.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+const SyntheticShape kShapes[] = {
+    SyntheticShape::Globular, SyntheticShape::Capsid, SyntheticShape::Fibre, SyntheticShape::WaterBox,
+};
+
+} // namespace
+
+TEST(SyntheticMoleculeGeneratorTest, RejectsEmptyStructure) {
+    EXPECT_THROW(SyntheticMoleculeGenerator(SyntheticShape::Globular, 0), std::invalid_argument);
+    EXPECT_THROW(SyntheticMoleculeGenerator::parseShape("cube"), std::invalid_argument);
+}
+
+TEST(SyntheticMoleculeGeneratorTest, ShapeNamesRoundTrip) {
+    for (auto shape : kShapes) {
+        EXPECT_EQ(SyntheticMoleculeGenerator::parseShape(SyntheticMoleculeGenerator::getShapeName(shape)), shape);
+    }
+}
+
+TEST(SyntheticMoleculeGeneratorTest, SeedDeterminesStructure) {
+    SyntheticMoleculeGenerator a(SyntheticShape::Globular, 1000, 7);
+    SyntheticMoleculeGenerator b(SyntheticShape::Globular, 1000, 7);
+    SyntheticMoleculeGenerator c(SyntheticShape::Globular, 1000, 8);
+    auto atomsA = a.generate();
+    auto atomsB = b.generate();
+    auto atomsC = c.generate();
+    ASSERT_EQ(atomsA.size(), 1000u);
+    std::size_t differing = 0;
+    for (std::size_t i = 0; i < atomsA.size(); ++i) {
+        EXPECT_EQ(atomsA[i].getCoordinates(), atomsB[i].getCoordinates());
+        EXPECT_EQ(atomsA[i].getChemicalElement(), atomsB[i].getChemicalElement());
+        differing += atomsA[i].getCoordinates() != atomsC[i].getCoordinates() ? 1 : 0;
+    }
+    EXPECT_GT(differing, 990u);
+}
+
+TEST(SyntheticMoleculeGeneratorTest, ChunkingDoesNotChangeAtoms) {
+    for (auto shape : kShapes) {
+        SyntheticMoleculeGenerator generator(shape, 1001, 3);
+        auto whole = generator.generate();
+
+        auto source = generator.makeSource(128);
+        std::vector<Atom> streamed;
+        AtomChunk chunk;
+        while (source(chunk)) {
+            EXPECT_LE(chunk.atoms.size(), 128u);
+            streamed.insert(streamed.end(), chunk.atoms.begin(), chunk.atoms.end());
+        }
+        ASSERT_EQ(streamed.size(), whole.size());
+        for (std::size_t i = 0; i < whole.size(); ++i) {
+            EXPECT_EQ(streamed[i].getCoordinates(), whole[i].getCoordinates());
+        }
+    }
+}
+
+TEST(SyntheticMoleculeGeneratorTest, AtomsStayInsideExtent) {
+    for (auto shape : kShapes) {
+        SyntheticMoleculeGenerator generator(shape, 5000, 11);
+        BoundingBox extent = generator.getExtent();
+        for (const auto& atom : generator.generate()) {
+            ASSERT_TRUE(extent.contains(atom)) << SyntheticMoleculeGenerator::getShapeName(shape);
+        }
+    }
+}
+
+TEST(SyntheticMoleculeGeneratorTest, CapsidIsHollow) {
+    SyntheticMoleculeGenerator generator(SyntheticShape::Capsid, 200000, 5);
+    const double outer = generator.getExtent().getMaxX();
+    double innermost = outer;
+    for (const auto& atom : generator.generate()) {
+        innermost = std::min(innermost, std::sqrt(atom.getX() * atom.getX() + atom.getY() * atom.getY() +
+                                                  atom.getZ() * atom.getZ()));
+    }
+    // 30 Angstrom shell, or 30% of the radius for capsids smaller than 100 Angstrom
+    EXPECT_NEAR(outer - innermost, std::min(30.0, 0.3 * outer), 0.5);
+    EXPECT_GT(innermost, 0.5 * outer);
+}
+
+TEST(SyntheticMoleculeGeneratorTest, ProteinCompositionIsRealistic) {
+    SyntheticMoleculeGenerator generator(SyntheticShape::Fibre, 100000, 2);
+    std::map<std::string, std::size_t> counts;
+    auto atoms = generator.generate();
+    for (const auto& atom : atoms) {
+        ++counts[atom.getChemicalElement()];
+    }
+    const double total = static_cast<double>(atoms.size());
+    EXPECT_NEAR(counts["H"] / total, 0.49, 0.01);
+    EXPECT_NEAR(counts["C"] / total, 0.32, 0.01);
+    EXPECT_NEAR(counts["N"] / total, 0.085, 0.01);
+    EXPECT_NEAR(counts["O"] / total, 0.10, 0.01);
+    EXPECT_GT(counts["S"], 0u);
+
+    // Every generated element is known to AtomBuilder
+    EXPECT_NO_THROW(AtomBuilder().buildAtoms(atoms));
+}
+
+TEST(SyntheticMoleculeGeneratorTest, WaterMoleculeGeometry) {
+    SyntheticMoleculeGenerator generator(SyntheticShape::WaterBox, 3000, 9);
+    auto atoms = generator.generate();
+    for (std::size_t i = 0; i + 2 < atoms.size(); i += 3) {
+        ASSERT_EQ(atoms[i].getChemicalElement(), "O");
+        ASSERT_EQ(atoms[i + 1].getChemicalElement(), "H");
+        ASSERT_EQ(atoms[i + 2].getChemicalElement(), "H");
+        double v1[3];
+        double v2[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            v1[axis] = atoms[i + 1].getCoordinates()[axis] - atoms[i].getCoordinates()[axis];
+            v2[axis] = atoms[i + 2].getCoordinates()[axis] - atoms[i].getCoordinates()[axis];
+        }
+        const double n1 = std::sqrt(v1[0] * v1[0] + v1[1] * v1[1] + v1[2] * v1[2]);
+        const double n2 = std::sqrt(v2[0] * v2[0] + v2[1] * v2[1] + v2[2] * v2[2]);
+        EXPECT_NEAR(n1, 0.9572, 1e-9);
+        EXPECT_NEAR(n2, 0.9572, 1e-9);
+        const double angle = std::acos((v1[0] * v2[0] + v1[1] * v2[1] + v1[2] * v2[2]) / (n1 * n2));
+        EXPECT_NEAR(angle * 180.0 / 3.14159265358979323846, 104.52, 0.01);
+    }
+}
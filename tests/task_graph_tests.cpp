@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include "biomesh/task_graph.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+// Thread-safe log of task start events
+struct StartLog {
+    std::mutex mutex;
+    std::vector<std::string> names;
+
+    TaskGraph::Work record(const std::string& name, int sleepMs = 0) {
+        return [this, name, sleepMs](unsigned) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                names.push_back(name);
+            }
+            if (sleepMs > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(sleepMs));
+            }
+        };
+    }
+
+    std::size_t position(const std::string& name) const {
+        return static_cast<std::size_t>(std::find(names.begin(), names.end(), name) - names.begin());
+    }
+};
+
+} // namespace
+
+TEST(TaskGraphTest, RejectsInvalidTasks) {
+    TaskGraph graph;
+    EXPECT_THROW(graph.addTask("negative", [](unsigned) {}, -1.0), std::invalid_argument);
+    EXPECT_THROW(graph.addTask("serial", [](unsigned) {}, 1.0, 0), std::invalid_argument);
+    TaskId a = graph.addTask("a", [](unsigned) {});
+    EXPECT_THROW(graph.addDependency(a, 5), std::out_of_range);
+    EXPECT_EQ(graph.getTaskCount(), 1u);
+    EXPECT_EQ(graph.getTaskName(a), "a");
+}
+
+TEST(TaskGraphTest, CostGrowsWithAtomsAndVolume) {
+    BoundingBox small(0, 0, 0, 10, 10, 10);
+    BoundingBox large(0, 0, 0, 100, 100, 100);
+    EXPECT_LT(TaskGraph::estimateCost(10, small), TaskGraph::estimateCost(10000, small));
+    EXPECT_LT(TaskGraph::estimateCost(10, small), TaskGraph::estimateCost(10, large));
+    EXPECT_EQ(TaskGraph::estimateCost(0, BoundingBox()), 0.0);
+}
+
+TEST(TaskSchedulerTest, RespectsDependencies) {
+    StartLog log;
+    TaskGraph graph;
+    // Two jobs with four dependent stages each
+    for (int job = 0; job < 2; ++job) {
+        TaskId previous = 0;
+        for (int stage = 0; stage < 4; ++stage) {
+            std::string name = "job" + std::to_string(job) + "-stage" + std::to_string(stage);
+            TaskId id = graph.addTask(name, log.record(name), 1.0 + job);
+            if (stage > 0) {
+                graph.addDependency(previous, id);
+            }
+            previous = id;
+        }
+    }
+
+    TaskScheduler scheduler(3);
+    scheduler.run(graph);
+    ASSERT_EQ(log.names.size(), 8u);
+    for (int job = 0; job < 2; ++job) {
+        for (int stage = 1; stage < 4; ++stage) {
+            std::string prefix = "job" + std::to_string(job) + "-stage";
+            EXPECT_LT(log.position(prefix + std::to_string(stage - 1)), log.position(prefix + std::to_string(stage)));
+        }
+    }
+
+    // Workers are reused by a second run
+    log.names.clear();
+    scheduler.run(graph);
+    EXPECT_EQ(log.names.size(), 8u);
+}
+
+TEST(TaskSchedulerTest, CriticalPathRunsFirst) {
+    StartLog log;
+    TaskGraph graph;
+    TaskId a = graph.addTask("a", log.record("a"), 10.0);
+    TaskId b = graph.addTask("b", log.record("b"), 10.0);
+    graph.addTask("c", log.record("c"), 15.0);
+    graph.addDependency(a, b);
+
+    // The chain a->b (20) outranks c (15), and b (10) then yields to c
+    TaskScheduler scheduler(1);
+    scheduler.run(graph);
+    EXPECT_EQ(log.names, (std::vector<std::string>{"a", "c", "b"}));
+}
+
+TEST(TaskSchedulerTest, GrantsParallelSlots) {
+    TaskGraph graph;
+    std::atomic<unsigned> granted{0};
+    graph.addTask("wide", [&](unsigned threads) { granted = threads; }, 1.0, 16);
+
+    TaskScheduler scheduler(4);
+    scheduler.run(graph);
+    EXPECT_EQ(granted.load(), 4u);
+}
+
+TEST(TaskSchedulerTest, SmallTasksBackfillAroundWideTask) {
+    StartLog log;
+    TaskGraph graph;
+    graph.addTask("long", log.record("long", 50), 100.0);
+    graph.addTask("wide", log.record("wide"), 100.0, 2);
+    graph.addTask("small", log.record("small"), 1.0);
+
+    // "wide" outranks "small" but must wait for "long" to free its slot; "small" fills the gap
+    TaskScheduler scheduler(2);
+    scheduler.run(graph);
+    ASSERT_EQ(log.names.size(), 3u);
+    EXPECT_LT(log.position("small"), log.position("wide"));
+    EXPECT_LT(log.position("long"), log.position("wide"));
+}
+
+TEST(TaskSchedulerTest, PropagatesTaskFailure) {
+    TaskGraph graph;
+    std::atomic<bool> dependentRan{false};
+    TaskId failing = graph.addTask("failing", [](unsigned) { throw std::runtime_error("stage failed"); });
+    TaskId dependent = graph.addTask("dependent", [&](unsigned) { dependentRan = true; });
+    graph.addDependency(failing, dependent);
+
+    TaskScheduler scheduler(2);
+    EXPECT_THROW(scheduler.run(graph), std::runtime_error);
+    EXPECT_FALSE(dependentRan.load());
+}
+
+TEST(TaskSchedulerTest, ParallelForRunsOnWorkers) {
+    TaskScheduler scheduler(4);
+    std::mutex mutex;
+    std::vector<std::thread::id> workerIds;
+    std::vector<std::thread::id> iterationIds;
+    std::vector<std::atomic<int>> visits(64);
+
+    TaskGraph graph;
+    std::atomic<int> started{0};
+    for (int t = 0; t < 4; ++t) {
+        // Each probe holds its worker until all four run, so every worker reports its id once
+        graph.addTask("probe", [&](unsigned) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                workerIds.push_back(std::this_thread::get_id());
+            }
+            ++started;
+            while (started.load() < 4) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    scheduler.run(graph);
+
+    TaskGraph wide;
+    wide.addTask("wide", [&](unsigned threads) {
+        EXPECT_EQ(threads, 4u);
+        scheduler.parallelFor(visits.size(), [&](std::size_t i) {
+            ++visits[i];
+            std::lock_guard<std::mutex> lock(mutex);
+            iterationIds.push_back(std::this_thread::get_id());
+        });
+    }, 1.0, 4);
+    scheduler.run(wide);
+
+    for (const auto& count : visits) {
+        EXPECT_EQ(count.load(), 1);
+    }
+    for (const auto& id : iterationIds) {
+        EXPECT_NE(std::find(workerIds.begin(), workerIds.end(), id), workerIds.end());
+    }
+}
+
+TEST(TaskSchedulerTest, ParallelForPropagatesFailure) {
+    TaskScheduler scheduler(2);
+    std::atomic<int> ran{0};
+    EXPECT_THROW(scheduler.parallelFor(8,
+                                       [&](std::size_t i) {
+                                           ++ran;
+                                           if (i == 3) {
+                                               throw std::runtime_error("block failed");
+                                           }
+                                       }),
+                 std::runtime_error);
+    EXPECT_EQ(ran.load(), 8);
+    scheduler.parallelFor(0, [](std::size_t) { FAIL(); });
+}
+
+TEST(TaskSchedulerTest, RejectsCycles) {
+    TaskGraph graph;
+    TaskId a = graph.addTask("a", [](unsigned) {});
+    TaskId b = graph.addTask("b", [](unsigned) {});
+    graph.addDependency(a, b);
+    graph.addDependency(b, a);
+
+    TaskScheduler scheduler(2);
+    EXPECT_THROW(scheduler.run(graph), std::logic_error);
+}
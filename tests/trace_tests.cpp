@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "biomesh/trace.h"
+#include "AtomBuilder.h"
+#include <atomic>
+#include <cstring>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace BioMesh;
+
+namespace {
+
+// Each test starts from an empty, enabled tracer and leaves it disabled
+class TracerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Tracer::instance().clear();
+        Tracer::instance().setEnabled(true);
+    }
+
+    void TearDown() override {
+        Tracer::instance().setEnabled(false);
+        Tracer::instance().clear();
+    }
+
+    static std::size_t countNamed(const std::vector<TraceEvent>& events, const char* name) {
+        std::size_t count = 0;
+        for (const auto& event : events) {
+            count += std::strcmp(event.name, name) == 0 ? 1 : 0;
+        }
+        return count;
+    }
+};
+
+} // namespace
+
+TEST_F(TracerTest, DisabledTracerRecordsNothing) {
+    Tracer::instance().setEnabled(false);
+    {
+        TraceScope scope("disabled");
+    }
+    EXPECT_TRUE(Tracer::instance().collect().empty());
+}
+
+TEST_F(TracerTest, NestedScopesAreContained) {
+    {
+        TraceScope outer("outer");
+        TraceScope inner("inner");
+    }
+    auto events = Tracer::instance().collect();
+    ASSERT_EQ(events.size(), 2u);
+    const TraceEvent& outer = std::strcmp(events[0].name, "outer") == 0 ? events[0] : events[1];
+    const TraceEvent& inner = std::strcmp(events[0].name, "inner") == 0 ? events[0] : events[1];
+    EXPECT_LE(outer.startNs, inner.startNs);
+    EXPECT_GE(outer.startNs + outer.durationNs, inner.startNs + inner.durationNs);
+    EXPECT_EQ(outer.threadIndex, inner.threadIndex);
+}
+
+TEST_F(TracerTest, ThreadsRecordIntoSeparateBuffers) {
+    // Threads stay alive until all have recorded, so none inherits another's buffer
+    std::atomic<int> recorded{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&recorded]() {
+            for (int i = 0; i < 100; ++i) {
+                TraceScope scope("work");
+            }
+            ++recorded;
+            while (recorded.load() < 4) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto events = Tracer::instance().collect();
+    EXPECT_EQ(countNamed(events, "work"), 400u);
+    std::set<std::uint32_t> threadIndices;
+    for (const auto& event : events) {
+        threadIndices.insert(event.threadIndex);
+    }
+    EXPECT_EQ(threadIndices.size(), 4u);
+    for (std::size_t i = 1; i < events.size(); ++i) {
+        EXPECT_LE(events[i - 1].startNs, events[i].startNs);
+    }
+}
+
+TEST_F(TracerTest, ExitedThreadsHandBuffersOn) {
+    // Thread-per-call code must not grow the tracer by one buffer per thread
+    std::thread([]() { TraceScope scope("warm"); }).join();
+    const std::size_t buffers = Tracer::instance().getBufferCount();
+    for (int t = 0; t < 50; ++t) {
+        std::thread([]() { TraceScope scope("call"); }).join();
+    }
+    EXPECT_EQ(Tracer::instance().getBufferCount(), buffers);
+
+    // Events of exited threads are kept until overwritten or cleared
+    const auto events = Tracer::instance().collect();
+    EXPECT_EQ(countNamed(events, "call"), 50u);
+    EXPECT_EQ(countNamed(events, "warm"), 1u);
+}
+
+TEST_F(TracerTest, RingBufferKeepsNewestEvents) {
+    std::thread([]() {
+        Tracer& tracer = Tracer::instance();
+        for (std::size_t i = 0; i < Tracer::kBufferCapacity + 10; ++i) {
+            tracer.record(i < 10 ? "old" : "new", i, i + 1);
+        }
+    }).join();
+
+    auto events = Tracer::instance().collect();
+    EXPECT_EQ(events.size(), Tracer::kBufferCapacity);
+    EXPECT_EQ(countNamed(events, "old"), 0u);
+    EXPECT_EQ(Tracer::instance().getDroppedCount(), 10u);
+}
+
+TEST_F(TracerTest, ExportsChromeTraceJson) {
+    std::thread([]() {
+        Tracer::instance().setThreadName("worker \"A\"");
+        TraceScope scope(Tracer::instance().intern(std::string("stage ") + "1"));
+    }).join();
+
+    std::ostringstream out;
+    Tracer::instance().writeChromeTrace(out);
+    const std::string json = out.str();
+    EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+    EXPECT_NE(json.find("\"name\":\"stage 1\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"worker \\\"A\\\"\"}"), std::string::npos);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+
+    EXPECT_THROW(Tracer::instance().writeChromeTrace("/nonexistent/dir/trace.json"), std::runtime_error);
+}
+
+#ifdef BIOMESH_TRACING
+TEST_F(TracerTest, BulkOperationsAreInstrumented) {
+    std::vector<Atom> atoms = {Atom(0, 0, 0, "C"), Atom(1, 1, 1, "O")};
+    AtomBuilder().buildAtoms(atoms);
+    EXPECT_EQ(countNamed(Tracer::instance().collect(), "AtomBuilder::buildAtoms"), 1u);
+}
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @file biomesh_server.cpp
+ * @brief Local meshing daemon: serves MeshClient requests on a Unix domain socket
+ *
+ * Runs until SIGINT or SIGTERM, or until a client sends a shutdown request. Queued jobs
+ * are finished and the socket file is removed before exiting. With --metrics, Prometheus
+ * metrics are served over HTTP at /metrics on a loopback port or a Unix socket
+ * ("unix:<path>").
+ */
+
+#include "biomesh/biomesh.h"
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using namespace BioMesh;
+
+namespace {
+
+volatile std::sig_atomic_t gStopSignal = 0;
+
+void onStopSignal(int) {
+    gStopSignal = 1;
+}
+
+struct Options {
+    std::string socketPath = "/tmp/biomesh.sock";
+    std::string metricsAddress;
+    MeshServerOptions server;
+};
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--socket") {
+            options.socketPath = value();
+        } else if (arg == "--metrics") {
+            options.metricsAddress = value();
+        } else if (arg == "--workers") {
+            options.server.workerSlots = static_cast<unsigned>(std::stoul(value()));
+        } else if (arg == "--large-job-atoms") {
+            options.server.largeJobAtoms = std::stoul(value());
+        } else if (arg == "--batch-window-us") {
+            options.server.batchWindow = std::chrono::microseconds(std::stol(value()));
+        } else if (arg == "--cache-dir") {
+            options.server.cacheDirectory = value();
+        } else if (arg == "--cache-mb") {
+            options.server.cacheBytes = std::stoul(value()) << 20;
+        } else {
+            throw std::invalid_argument(
+                "Usage: biomesh-server [--socket PATH] [--metrics PORT|unix:PATH] [--workers N] "
+                "[--large-job-atoms N] [--batch-window-us N] [--cache-dir DIR] [--cache-mb N]");
+        }
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const Options options = parseOptions(argc, argv);
+        MeshServer server(options.socketPath, options.server);
+
+        std::signal(SIGINT, onStopSignal);
+        std::signal(SIGTERM, onStopSignal);
+        server.start();
+        std::cout << "biomesh-server listening on " << server.getSocketPath() << std::endl;
+
+        std::unique_ptr<MetricsEndpoint> metrics;
+        if (!options.metricsAddress.empty()) {
+            metrics = std::make_unique<MetricsEndpoint>(options.metricsAddress);
+            metrics->start();
+            if (metrics->getPort() != 0) {
+                std::cout << "metrics at http://127.0.0.1:" << metrics->getPort() << "/metrics" << std::endl;
+            } else {
+                std::cout << "metrics at " << options.metricsAddress << std::endl;
+            }
+        }
+
+        while (!gStopSignal && !server.waitFor(std::chrono::milliseconds(200))) {
+        }
+        server.stop();
+
+        const MeshServerStats stats = server.getStats();
+        std::cout << "biomesh-server stopped after " << stats.requests << " requests (" << stats.errors
+                  << " errors, " << stats.batches << " batches, " << stats.cacheHits << " cache hits)"
+                  << std::endl;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}